@@ -23,6 +23,7 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
+#include "ns3/pointer.h"
 
 namespace ns3 {
 
@@ -46,6 +47,12 @@ CsmaChannel::GetTypeId (void)
                    TimeValue (Seconds (0)),
                    MakeTimeAccessor (&CsmaChannel::m_delay),
                    MakeTimeChecker ())
+    .AddAttribute ("LinkErrorModel",
+                   "The LinkErrorModel deciding which receivers lose the packets sent; "
+                   "devices are identified by their device id on the channel.",
+                   PointerValue (),
+                   MakePointerAccessor (&CsmaChannel::m_linkErrorModel),
+                   MakePointerChecker<LinkErrorModel> ())
   ;
   return tid;
 }
@@ -228,11 +235,24 @@ CsmaChannel::TransmitEnd ()
     {
       if (it->IsActive ())
         {
-          // schedule reception events
-          Simulator::ScheduleWithContext (it->devicePtr->GetNode ()->GetId (),
-                                          m_delay,
-                                          &CsmaNetDevice::Receive, it->devicePtr,
-                                          m_currentPkt->Copy (), m_deviceList[m_currentSrc].devicePtr);
+          if (m_linkErrorModel != 0 && devId != m_currentSrc
+              && m_linkErrorModel->IsCorrupt (m_currentPkt, m_currentSrc, devId))
+            {
+              // the packet never reaches the receiver, which only reports the drop
+              NS_LOG_LOGIC ("Packet lost on the link to device " << devId);
+              Simulator::ScheduleWithContext (it->devicePtr->GetNode ()->GetId (),
+                                              m_delay,
+                                              &CsmaNetDevice::ReceiveDropped, it->devicePtr,
+                                              m_currentPkt);
+            }
+          else
+            {
+              // schedule reception events
+              Simulator::ScheduleWithContext (it->devicePtr->GetNode ()->GetId (),
+                                              m_delay,
+                                              &CsmaNetDevice::Receive, it->devicePtr,
+                                              m_currentPkt->Copy (), m_deviceList[m_currentSrc].devicePtr);
+            }
         }
       devId++;
     }
@@ -25,6 +25,7 @@
 #include "ns3/ptr.h"
 #include "ns3/nstime.h"
 #include "ns3/data-rate.h"
+#include "ns3/error-model.h"
 
 namespace ns3 {
 
@@ -318,6 +319,11 @@ private:
    */
   Time          m_delay;
 
+  /**
+   * The losses between the devices of the channel, if any
+   */
+  Ptr<LinkErrorModel> m_linkErrorModel;
+
   /**
    * List of the net devices that have been or are currently connected
    * to the channel.
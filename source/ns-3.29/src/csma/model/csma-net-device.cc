@@ -856,6 +856,13 @@ CsmaNetDevice::Receive (Ptr<Packet> packet, Ptr<CsmaNetDevice> senderDevice)
     }
 }
 
+void
+CsmaNetDevice::ReceiveDropped (Ptr<const Packet> packet)
+{
+  NS_LOG_FUNCTION (this << packet);
+  m_phyRxDropTrace (packet);
+}
+
 Ptr<Queue<Packet> >
 CsmaNetDevice::GetQueue (void) const 
 { 
@@ -169,6 +169,19 @@ public:
    */
   void Receive (Ptr<Packet> p, Ptr<CsmaNetDevice> sender);
 
+  /**
+   * Report a packet lost by the LinkErrorModel of the connected channel
+   * on its way to this device.
+   *
+   * The channel calls it when the last bit of the packet would have
+   * arrived.  The packet is not received, and the PhyRxDrop trace fires
+   * as for a packet dropped by the receive error model.
+   *
+   * \see CsmaChannel
+   * \param p the lost packet
+   */
+  void ReceiveDropped (Ptr<const Packet> p);
+
   /**
    * Is the send side of the network device enabled?
    *
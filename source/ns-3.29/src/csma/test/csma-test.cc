@@ -0,0 +1,185 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdlib>
+#include <map>
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/drop-tail-queue.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include "ns3/csma-net-device.h"
+#include "ns3/csma-channel.h"
+#include "ns3/error-model.h"
+#include "ns3/pointer.h"
+#include "ns3/enum.h"
+#include "ns3/double.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup csma-test
+ * \ingroup tests
+ *
+ * \brief Test class for the LinkErrorModel of a CsmaChannel
+ *
+ * Each receiver of a packet is decided on its own link: the packets
+ * lost on a link must fire the PhyRxDrop trace of that receiver only,
+ * when they would have arrived, and still reach the other receivers.
+ */
+class CsmaLinkErrorTest : public TestCase
+{
+public:
+  CsmaLinkErrorTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Send a packet to all the devices of the channel
+   *
+   * \param device the transmitting device
+   */
+  void SendPacket (Ptr<CsmaNetDevice> device);
+  /**
+   * \brief Count a packet received by a device
+   *
+   * \param context the index of the device
+   * \param p the packet
+   */
+  void Received (std::string context, Ptr<const Packet> p);
+  /**
+   * \brief Count a packet dropped by a device
+   *
+   * \param context the index of the device
+   * \param p the packet
+   */
+  void Dropped (std::string context, Ptr<const Packet> p);
+
+  std::vector<uint32_t> m_received;    //!< packets received, by device
+  std::vector<uint32_t> m_dropped;     //!< packets dropped, by device
+  std::map<uint64_t, Time> m_arrivals; //!< arrival times on the perfect link, by packet uid
+  std::multimap<uint64_t, Time> m_drops; //!< drop times, by packet uid
+};
+
+CsmaLinkErrorTest::CsmaLinkErrorTest ()
+  : TestCase ("CSMA LinkErrorModel")
+{
+}
+
+void
+CsmaLinkErrorTest::SendPacket (Ptr<CsmaNetDevice> device)
+{
+  device->Send (Create<Packet> (100), device->GetBroadcast (), 0x800);
+}
+
+void
+CsmaLinkErrorTest::Received (std::string context, Ptr<const Packet> p)
+{
+  uint32_t device = std::atoi (context.c_str ());
+  if (device == 3)
+    {
+      m_arrivals[p->GetUid ()] = Simulator::Now ();
+    }
+  m_received[device]++;
+}
+
+void
+CsmaLinkErrorTest::Dropped (std::string context, Ptr<const Packet> p)
+{
+  m_drops.insert (std::make_pair (p->GetUid (), Simulator::Now ()));
+  m_dropped[std::atoi (context.c_str ())]++;
+}
+
+void
+CsmaLinkErrorTest::DoRun (void)
+{
+  const uint32_t nDevices = 4;
+  m_received.assign (nDevices, 0);
+  m_dropped.assign (nDevices, 0);
+
+  Ptr<LinkErrorModel> em = CreateObject<LinkErrorModel> ();
+  em->SetAttribute ("ErrorUnit", EnumValue (RateErrorModel::ERROR_UNIT_PACKET));
+  em->SetAttribute ("ErrorRate", DoubleValue (0));
+  em->SetRate (0, 1, 1);
+  em->SetRate (0, 2, 0.5);
+  em->AssignStreams (20);
+
+  Ptr<CsmaChannel> channel = CreateObject<CsmaChannel> ();
+  channel->SetAttribute ("DataRate", DataRateValue (DataRate ("1Mb/s")));
+  channel->SetAttribute ("Delay", TimeValue (MicroSeconds (10)));
+  channel->SetAttribute ("LinkErrorModel", PointerValue (em));
+  std::vector<Ptr<CsmaNetDevice> > devices;
+  for (uint32_t i = 0; i < nDevices; i++)
+    {
+      Ptr<Node> node = CreateObject<Node> ();
+      Ptr<CsmaNetDevice> device = CreateObject<CsmaNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      device->SetQueue (CreateObject<DropTailQueue<Packet> > ());
+      node->AddDevice (device);
+      device->Attach (channel);
+      std::ostringstream oss;
+      oss << i;
+      device->TraceConnect ("MacRx", oss.str (), MakeCallback (&CsmaLinkErrorTest::Received, this));
+      device->TraceConnect ("PhyRxDrop", oss.str (), MakeCallback (&CsmaLinkErrorTest::Dropped, this));
+      devices.push_back (device);
+    }
+
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      Simulator::Schedule (MilliSeconds (i), &CsmaLinkErrorTest::SendPacket, this, devices[0]);
+    }
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      Simulator::Schedule (Seconds (2) + MilliSeconds (i), &CsmaLinkErrorTest::SendPacket, this, devices[1]);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_received[1], 0, "Packets received on a lossy link");
+  NS_TEST_ASSERT_MSG_EQ (m_dropped[1], 1000, "Lost packets not reported by the receiver");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_received[2], 500, 60, "Wrong number of packets on a half-lossy link");
+  NS_TEST_ASSERT_MSG_EQ (m_received[2] + m_dropped[2], 1010, "Lost packets not reported by the receiver");
+  NS_TEST_ASSERT_MSG_EQ (m_received[3], 1010, "Packets lost on a perfect link");
+  NS_TEST_ASSERT_MSG_EQ (m_dropped[3], 0, "Packets dropped on a perfect link");
+  NS_TEST_ASSERT_MSG_EQ (m_received[0], 10, "Packets lost on the reverse link");
+  NS_TEST_ASSERT_MSG_EQ (m_dropped[0], 0, "Drops reported by the transmitter");
+  // the receivers of a packet are reached at the same time
+  for (std::multimap<uint64_t, Time>::const_iterator i = m_drops.begin (); i != m_drops.end (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (i->second, m_arrivals[i->first], "Lost packet " << i->first << " not reported at its arrival time");
+    }
+}
+
+/**
+ * \ingroup csma-test
+ * \ingroup tests
+ *
+ * \brief TestSuite for the CSMA module
+ */
+class CsmaTestSuite : public TestSuite
+{
+public:
+  CsmaTestSuite ();
+};
+
+CsmaTestSuite::CsmaTestSuite ()
+  : TestSuite ("devices-csma", UNIT)
+{
+  AddTestCase (new CsmaLinkErrorTest, TestCase::QUICK);
+}
+
+static CsmaTestSuite g_csmaTestSuite; //!< Static variable for test initialization
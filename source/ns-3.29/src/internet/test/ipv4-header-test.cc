@@ -41,6 +41,7 @@
 #include "ns3/internet-stack-helper.h"
 
 #include <string>
+#include <cstring>
 #include <sstream>
 #include <limits>
 #include <netinet/in.h>
@@ -265,6 +266,62 @@ Ipv4HeaderTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that the checksum of a received header, updated after a
+ * TTL decrement, is the one a new header would get.
+ */
+class Ipv4HeaderTtlChecksumTest : public TestCase
+{
+public:
+  virtual void DoRun (void);
+  Ipv4HeaderTtlChecksumTest ();
+};
+
+Ipv4HeaderTtlChecksumTest::Ipv4HeaderTtlChecksumTest ()
+  : TestCase ("IPv4 Header checksum update on TTL decrement")
+{
+}
+
+void
+Ipv4HeaderTtlChecksumTest::DoRun (void)
+{
+  Ipv4Header sent;
+  sent.EnableChecksum ();
+  sent.SetSource (Ipv4Address ("10.1.2.3"));
+  sent.SetDestination (Ipv4Address ("192.168.200.7"));
+  sent.SetProtocol (17);
+  sent.SetPayloadSize (1000);
+  sent.SetIdentification (4242);
+  sent.SetDontFragment ();
+  sent.SetTtl (64);
+  Ptr<Packet> p = Create<Packet> (1000);
+  p->AddHeader (sent);
+
+  for (uint8_t ttl = 63; ttl > 0; --ttl)
+    {
+      Ipv4Header received;
+      received.EnableChecksum ();
+      p->RemoveHeader (received);
+      NS_TEST_ASSERT_MSG_EQ (received.IsChecksumOk (), true, "Bad checksum at TTL " << static_cast<uint32_t> (ttl + 1));
+      received.SetTtl (ttl);
+
+      // the checksum written must be the one computed from scratch
+      Ipv4Header expected = sent;
+      expected.SetTtl (ttl);
+      Ptr<Packet> reference = Create<Packet> (1000);
+      reference->AddHeader (expected);
+      p->AddHeader (received);
+      uint8_t got[20];
+      uint8_t want[20];
+      p->CopyData (got, 20);
+      reference->CopyData (want, 20);
+      NS_TEST_ASSERT_MSG_EQ (std::memcmp (got, want, 20), 0, "Wrong header at TTL " << static_cast<uint32_t> (ttl));
+    }
+}
+
 /**
  * \ingroup internet-test
  * \ingroup tests
@@ -277,6 +334,7 @@ public:
   Ipv4HeaderTestSuite () : TestSuite ("ipv4-header", UNIT)
   {
     AddTestCase (new Ipv4HeaderTest, TestCase::QUICK);
+    AddTestCase (new Ipv4HeaderTtlChecksumTest, TestCase::QUICK);
   }
 };
 
@@ -40,6 +40,7 @@
 #include <ns3/multi-model-spectrum-channel.h>
 #include <ns3/friis-spectrum-propagation-loss.h>
 #include <ns3/trace-fading-loss-model.h>
+#include <ns3/lte-pathloss-cache.h>
 #include <ns3/isotropic-antenna-model.h>
 #include <ns3/lte-ue-net-device.h>
 #include <ns3/ff-mac-scheduler.h>
@@ -75,7 +76,8 @@ NS_OBJECT_ENSURE_REGISTERED (LteHelper);
 LteHelper::LteHelper (void)
   : m_fadingStreamsAssigned (false),
     m_imsiCounter (0),
-    m_cellIdCounter {1}
+    m_cellIdCounter {1},
+    m_cachePathloss (false)
 {
   NS_LOG_FUNCTION (this);
   m_enbNetDeviceFactory.SetTypeId (LteEnbNetDevice::GetTypeId ());
@@ -166,6 +168,14 @@ TypeId LteHelper::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&LteHelper::m_usePdschForCqiGeneration),
                    MakeBooleanChecker ())
+    .AddAttribute ("CachePathloss",
+                   "If true, the path loss of each pair of static nodes is computed once "
+                   "for all the carriers, and for both the downlink and the uplink if "
+                   "the path loss model has no Frequency attribute. Only valid with "
+                   "path loss models which are deterministic and reciprocal.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LteHelper::m_cachePathloss),
+                   MakeBooleanChecker ())
     .AddAttribute ("EnbComponentCarrierManager",
                    "The type of Component Carrier Manager to be used for eNBs. "
                    "The allowed values for this attributes are the type names "
@@ -204,6 +214,8 @@ LteHelper::DoDispose ()
   NS_LOG_FUNCTION (this);
   m_downlinkChannel = 0;
   m_uplinkChannel = 0;
+  m_downlinkPathlossCache = 0;
+  m_uplinkPathlossCache = 0;
   m_componentCarrierPhyParams.clear();
   Object::DoDispose ();
 }
@@ -242,6 +254,12 @@ LteHelper::ChannelModelInitialization (void)
       NS_LOG_LOGIC (this << " using a PropagationLossModel in DL");
       Ptr<PropagationLossModel> dlPlm = m_downlinkPathlossModel->GetObject<PropagationLossModel> ();
       NS_ASSERT_MSG (dlPlm != 0, " " << m_downlinkPathlossModel << " is neither PropagationLossModel nor SpectrumPropagationLossModel");
+      if (m_cachePathloss)
+        {
+          m_downlinkPathlossCache = CreateObject<LtePathlossCache> ();
+          m_downlinkPathlossCache->SetPathlossModel (dlPlm);
+          dlPlm = m_downlinkPathlossCache;
+        }
       m_downlinkChannel->AddPropagationLossModel (dlPlm);
     }
 
@@ -257,6 +275,21 @@ LteHelper::ChannelModelInitialization (void)
       NS_LOG_LOGIC (this << " using a PropagationLossModel in UL");
       Ptr<PropagationLossModel> ulPlm = m_uplinkPathlossModel->GetObject<PropagationLossModel> ();
       NS_ASSERT_MSG (ulPlm != 0, " " << m_uplinkPathlossModel << " is neither PropagationLossModel nor SpectrumPropagationLossModel");
+      if (m_cachePathloss)
+        {
+          struct TypeId::AttributeInformation info;
+          if (ulPlm->GetInstanceTypeId ().LookupAttributeByName ("Frequency", &info))
+            {
+              m_uplinkPathlossCache = CreateObject<LtePathlossCache> ();
+              m_uplinkPathlossCache->SetPathlossModel (ulPlm);
+            }
+          else
+            {
+              NS_LOG_LOGIC (this << " sharing the path loss cache between DL and UL");
+              m_uplinkPathlossCache = m_downlinkPathlossCache;
+            }
+          ulPlm = m_uplinkPathlossCache;
+        }
       m_uplinkChannel->AddPropagationLossModel (ulPlm);
     }
   if (!m_fadingModelType.empty ())
@@ -727,6 +760,11 @@ LteHelper::InstallSingleEnbDevice (Ptr<Node> n)
         {
           NS_LOG_WARN ("UL propagation model does not have a Frequency attribute");
         }
+      if (m_downlinkPathlossCache != 0)
+        {
+          m_downlinkPathlossCache->Flush ();
+          m_uplinkPathlossCache->Flush ();
+        }
     }  //end for
   rrc->SetForwardUpCallback (MakeCallback (&LteEnbNetDevice::Receive, dev));
   dev->Initialize ();
@@ -52,6 +52,7 @@ class SpectrumChannel;
 class EpcHelper;
 class PropagationLossModel;
 class SpectrumPropagationLossModel;
+class LtePathlossCache;
 
 /**
  * \ingroup lte
@@ -741,6 +742,13 @@ private:
   Ptr<Object>  m_downlinkPathlossModel;
   /// The path loss model used in the uplink channel.
   Ptr<Object> m_uplinkPathlossModel;
+  /// The cache of the downlink path loss model, if enabled.
+  Ptr<LtePathlossCache> m_downlinkPathlossCache;
+  /**
+   * The cache of the uplink path loss model, if enabled. It is the
+   * downlink cache if the path loss does not depend on the frequency.
+   */
+  Ptr<LtePathlossCache> m_uplinkPathlossCache;
 
   /// Factory of MAC scheduler object.
   ObjectFactory m_schedulerFactory;
@@ -828,6 +836,12 @@ private:
    * DL-CQI will be calculated from PDCCH as signal and PDCCH as interference.
    */
   bool m_usePdschForCqiGeneration;
+  /**
+   * The `CachePathloss` attribute. If true, the path loss of each pair of
+   * static nodes is computed once for all the carriers, and for both the
+   * downlink and the uplink if it does not depend on the frequency.
+   */
+  bool m_cachePathloss;
 
   /**
    * The `UseCa` attribute. If true, Carrier Aggregation is enabled.
@@ -37,9 +37,22 @@
 #include <ns3/node.h>
 #include <ns3/buildings-helper.h>
 #include <ns3/lte-spectrum-value-helper.h>
+#include <ns3/lte-spectrum-signal-parameters.h>
+#include <ns3/spectrum-converter.h>
+#include <ns3/spectrum-propagation-loss-model.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/antenna-model.h>
+#include <ns3/pointer.h>
+#include <ns3/core-config.h>
+#ifdef HAVE_PTHREAD_H
+#include <ns3/system-thread.h>
+#endif /* HAVE_PTHREAD_H */
 
 #include <fstream>
+#include <sstream>
 #include <limits>
+#include <cmath>
+#include <algorithm>
 
 namespace ns3 {
 
@@ -48,6 +61,7 @@ NS_LOG_COMPONENT_DEFINE ("RadioEnvironmentMapHelper");
 NS_OBJECT_ENSURE_REGISTERED (RadioEnvironmentMapHelper);
 
 RadioEnvironmentMapHelper::RadioEnvironmentMapHelper ()
+  : m_running (false)
 {
 }
 
@@ -62,6 +76,8 @@ void
 RadioEnvironmentMapHelper::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
+  m_signals.clear ();
+  m_channel = 0;
 }
 
 TypeId
@@ -144,6 +160,19 @@ RadioEnvironmentMapHelper::GetTypeId (void)
                    IntegerValue (-1),
                    MakeIntegerAccessor (&RadioEnvironmentMapHelper::m_rbId),
                    MakeIntegerChecker<int32_t> ())
+    .AddAttribute ("DirectComputation",
+                   "If true, the REM is computed directly from the signals transmitted "
+                   "during one subframe and the loss models of the channel, rather than "
+                   "measured by listeners over successive simulator iterations",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RadioEnvironmentMapHelper::m_directComputation),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Threads",
+                   "The number of threads, including the simulation thread, which "
+                   "compute the REM when DirectComputation is true",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&RadioEnvironmentMapHelper::m_nThreads),
+                   MakeUintegerChecker<uint32_t> (1, std::numeric_limits<uint16_t>::max ()))
   ;
   return tid;
 }
@@ -225,6 +254,14 @@ RadioEnvironmentMapHelper::DelayedInstall ()
     {
       m_maxPointsPerIteration = m_xRes * m_yRes;
     }
+
+  if (m_directComputation)
+    {
+      Simulator::Schedule (Seconds (0.0001),
+                           &RadioEnvironmentMapHelper::StartCapture,
+                           this);
+      return;
+    }
   
   for (uint32_t i = 0; i < m_maxPointsPerIteration; ++i)
     {
@@ -351,5 +388,311 @@ RadioEnvironmentMapHelper::Finalize ()
     }
 }
 
+void
+RadioEnvironmentMapHelper::StartCapture ()
+{
+  NS_LOG_FUNCTION (this);
+  m_rxSpectrumModel = LteSpectrumValueHelper::GetSpectrumModel (m_earfcn, m_bandwidth);
+  m_channel->TraceConnectWithoutContext ("TxSigParams",
+                                         MakeCallback (&RadioEnvironmentMapHelper::CaptureSignal, this));
+  Simulator::Schedule (Seconds (0.0005), &RadioEnvironmentMapHelper::ComputeMap, this);
+}
+
+void
+RadioEnvironmentMapHelper::CaptureSignal (Ptr<SpectrumSignalParameters> params)
+{
+  NS_LOG_FUNCTION (this << params);
+  // the same signals as the ones RemSpectrumPhy measures
+  if (m_useDataChannel)
+    {
+      if (DynamicCast<LteSpectrumSignalParametersDataFrame> (params) == 0)
+        {
+          return;
+        }
+    }
+  else if (DynamicCast<LteSpectrumSignalParametersDlCtrlFrame> (params) == 0)
+    {
+      return;
+    }
+
+  Ptr<const SpectrumValue> psd = params->psd;
+  if (psd->GetSpectrumModelUid () != m_rxSpectrumModel->GetUid ())
+    {
+      if (psd->GetSpectrumModel ()->IsOrthogonal (*m_rxSpectrumModel))
+        {
+          NS_LOG_LOGIC ("signal orthogonal to the map");
+          return;
+        }
+      SpectrumConverter converter (psd->GetSpectrumModel (), m_rxSpectrumModel);
+      psd = converter.Convert (psd);
+    }
+
+  RemSignal signal;
+  signal.mobility = params->txPhy->GetMobility ();
+  signal.antenna = params->txAntenna;
+  signal.psd.assign (psd->ConstValuesBegin (), psd->ConstValuesEnd ());
+  m_signals.push_back (signal);
+}
+
+void
+RadioEnvironmentMapHelper::ComputeMap ()
+{
+  NS_LOG_FUNCTION (this << m_signals.size ());
+  m_channel->TraceDisconnectWithoutContext ("TxSigParams",
+                                            MakeCallback (&RadioEnvironmentMapHelper::CaptureSignal, this));
+
+  // what MultiModelSpectrumChannel::StartTx applies to the listeners
+  PointerValue propagationLoss;
+  m_channel->GetAttribute ("PropagationLossModel", propagationLoss);
+  Ptr<PropagationLossModel> loss = propagationLoss.Get<PropagationLossModel> ();
+  Ptr<SpectrumPropagationLossModel> spectrumLoss = m_channel->GetSpectrumPropagationLossModel ();
+  DoubleValue maxLossDb;
+  m_channel->GetAttribute ("MaxLossDb", maxLossDb);
+  DoubleValue maxRange (0);
+  m_channel->GetAttributeFailSafe ("MaxRange", maxRange);
+
+  m_bandWidths.clear ();
+  for (Bands::const_iterator it = m_rxSpectrumModel->Begin (); it != m_rxSpectrumModel->End (); ++it)
+    {
+      m_bandWidths.push_back (it->fh - it->fl);
+    }
+
+#ifdef HAVE_PTHREAD_H
+  m_batches = 0;
+  m_busyWorkers = 0;
+  m_stop = false;
+  for (uint32_t k = 0; k + 1 < m_nThreads; k++)
+    {
+      Ptr<SystemThread> worker = Create<SystemThread> (MakeCallback (&RadioEnvironmentMapHelper::Work, this).Bind (k));
+      worker->Start ();
+      m_workers.push_back (worker);
+    }
+#endif /* HAVE_PTHREAD_H */
+
+  Ptr<MobilityModel> bmm = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityBuildingInfo> buildingInfo = CreateObject<MobilityBuildingInfo> ();
+  bmm->AggregateObject (buildingInfo); // operation usually done by BuildingsHelper::Install
+
+  // same points, in the same order, as the iterations of DelayedInstall
+  for (double x = m_xMin; x < m_xMax + 0.5*m_xStep; x += m_xStep)
+    {
+      for (double y = m_yMin; y < m_yMax + 0.5*m_yStep; y += m_yStep)
+        {
+          Vector position (x, y, m_z);
+          bmm->SetPosition (position);
+          BuildingsHelper::MakeConsistent (bmm);
+          m_batchPositions.push_back (position);
+
+          for (std::vector<RemSignal>::const_iterator signal = m_signals.begin ();
+               signal != m_signals.end ();
+               ++signal)
+            {
+              double pathLossDb = 0;
+              double power = 0;
+              if (signal->mobility != 0)
+                {
+                  if (maxRange.Get () > 0
+                      && CalculateDistance (signal->mobility->GetPosition (), position) > maxRange.Get ())
+                    {
+                      pathLossDb = std::numeric_limits<double>::infinity ();
+                    }
+                  else
+                    {
+                      if (signal->antenna != 0)
+                        {
+                          Angles txAngles (position, signal->mobility->GetPosition ());
+                          pathLossDb -= signal->antenna->GetGainDb (txAngles);
+                        }
+                      if (loss != 0)
+                        {
+                          pathLossDb -= loss->CalcRxPower (0, signal->mobility, bmm);
+                        }
+                      if (pathLossDb > maxLossDb.Get ())
+                        {
+                          pathLossDb = std::numeric_limits<double>::infinity ();
+                        }
+                      else if (spectrumLoss != 0)
+                        {
+                          Ptr<SpectrumValue> psd = Create<SpectrumValue> (m_rxSpectrumModel);
+                          std::copy (signal->psd.begin (), signal->psd.end (), psd->ValuesBegin ());
+                          *psd *= std::pow (10.0, (-pathLossDb) / 10.0);
+                          psd = spectrumLoss->CalcRxPowerSpectralDensity (psd, signal->mobility, bmm);
+                          power = (m_rbId >= 0) ? (*psd)[m_rbId] * 180000 : Integral (*psd);
+                        }
+                    }
+                }
+              m_batchLoss.push_back (pathLossDb);
+              if (spectrumLoss != 0)
+                {
+                  m_batchPower.push_back (power);
+                }
+            }
+
+          if (m_batchPositions.size () == m_maxPointsPerIteration)
+            {
+              ComputeBatch ();
+            }
+        }
+    }
+  if (!m_batchPositions.empty ())
+    {
+      ComputeBatch ();
+    }
+  WriteBatch ();
+
+#ifdef HAVE_PTHREAD_H
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_stop = true;
+    m_start.notify_all ();
+  }
+  for (std::vector<Ptr<SystemThread> >::iterator it = m_workers.begin (); it != m_workers.end (); ++it)
+    {
+      (*it)->Join ();
+    }
+  m_workers.clear ();
+#endif /* HAVE_PTHREAD_H */
+
+  Finalize ();
+}
+
+void
+RadioEnvironmentMapHelper::ComputeBatch ()
+{
+  NS_LOG_FUNCTION (this << m_batchPositions.size ());
+  WriteBatch ();
+  m_runPositions.swap (m_batchPositions);
+  m_runLoss.swap (m_batchLoss);
+  m_runPower.swap (m_batchPower);
+  m_batchPositions.clear ();
+  m_batchLoss.clear ();
+  m_batchPower.clear ();
+
+#ifdef HAVE_PTHREAD_H
+  if (!m_workers.empty ())
+    {
+      m_shareOutput.assign (m_workers.size (), std::string ());
+      std::lock_guard<std::mutex> lock (m_mutex);
+      m_busyWorkers = m_workers.size ();
+      ++m_batches;
+      m_start.notify_all ();
+    }
+  else
+#endif /* HAVE_PTHREAD_H */
+    {
+      m_shareOutput.assign (1, std::string ());
+      ComputeShare (0);
+    }
+  m_running = true;
+}
+
+void
+RadioEnvironmentMapHelper::WriteBatch ()
+{
+  NS_LOG_FUNCTION (this << m_running);
+  if (!m_running)
+    {
+      return;
+    }
+#ifdef HAVE_PTHREAD_H
+  if (!m_workers.empty ())
+    {
+      std::unique_lock<std::mutex> lock (m_mutex);
+      while (m_busyWorkers > 0)
+        {
+          m_done.wait (lock);
+        }
+    }
+#endif /* HAVE_PTHREAD_H */
+  for (std::vector<std::string>::const_iterator it = m_shareOutput.begin ();
+       it != m_shareOutput.end ();
+       ++it)
+    {
+      m_outFile << *it;
+    }
+  m_outFile.flush ();
+  m_running = false;
+}
+
+void
+RadioEnvironmentMapHelper::ComputeShare (uint32_t share)
+{
+  uint32_t nShares = m_shareOutput.size ();
+  uint32_t nPoints = m_runPositions.size ();
+  uint32_t begin = static_cast<uint64_t> (nPoints) * share / nShares;
+  uint32_t end = static_cast<uint64_t> (nPoints) * (share + 1) / nShares;
+  uint32_t nSignals = m_signals.size ();
+  std::ostringstream output;
+  for (uint32_t i = begin; i < end; i++)
+    {
+      // as RemSpectrumPhy::StartRx and RemSpectrumPhy::GetSinr
+      double referenceSignalPower = 0;
+      double sumPower = 0;
+      for (uint32_t j = 0; j < nSignals; j++)
+        {
+          double power = 0;
+          if (!m_runPower.empty ())
+            {
+              power = m_runPower[i * nSignals + j];
+            }
+          else
+            {
+              double pathGainLinear = std::pow (10.0, (-m_runLoss[i * nSignals + j]) / 10.0);
+              const std::vector<double> &psd = m_signals[j].psd;
+              if (m_rbId >= 0)
+                {
+                  power = (psd[m_rbId] * pathGainLinear) * 180000;
+                }
+              else
+                {
+                  for (uint32_t k = 0; k < psd.size (); k++)
+                    {
+                      power += (psd[k] * pathGainLinear) * m_bandWidths[k];
+                    }
+                }
+            }
+          sumPower += power;
+          if (power > referenceSignalPower)
+            {
+              referenceSignalPower = power;
+            }
+        }
+      const Vector &pos = m_runPositions[i];
+      output << pos.x << "\t"
+             << pos.y << "\t"
+             << pos.z << "\t"
+             << referenceSignalPower / (sumPower - referenceSignalPower + m_noisePower)
+             << "\n";
+    }
+  m_shareOutput[share] = output.str ();
+}
+
+#ifdef HAVE_PTHREAD_H
+void
+RadioEnvironmentMapHelper::Work (uint32_t share)
+{
+  uint64_t batches = 0;
+  std::unique_lock<std::mutex> lock (m_mutex);
+  while (true)
+    {
+      while (!m_stop && m_batches == batches)
+        {
+          m_start.wait (lock);
+        }
+      if (m_stop)
+        {
+          return;
+        }
+      batches = m_batches;
+      lock.unlock ();
+      ComputeShare (share);
+      lock.lock ();
+      if (--m_busyWorkers == 0)
+        {
+          m_done.notify_one ();
+        }
+    }
+}
+#endif /* HAVE_PTHREAD_H */
 
 } // namespace ns3
@@ -24,7 +24,15 @@
 
 
 #include <ns3/object.h>
+#include <ns3/vector.h>
+#include <ns3/core-config.h>
 #include <fstream>
+#include <vector>
+#include <string>
+#ifdef HAVE_PTHREAD_H
+#include <mutex>
+#include <condition_variable>
+#endif /* HAVE_PTHREAD_H */
 
 
 namespace ns3 {
@@ -33,8 +41,12 @@ class RemSpectrumPhy;
 class Node;
 class NetDevice;
 class SpectrumChannel;
+class SpectrumModel;
+class SpectrumSignalParameters;
 //class BuildingsMobilityModel;
 class MobilityModel;
+class AntennaModel;
+class SystemThread;
 
 /** 
  * \ingroup lte
@@ -42,6 +54,12 @@ class MobilityModel;
  * Generates a 2D map of the SINR from the strongest transmitter in the
  * downlink of an LTE FDD system. For instructions on usage, please refer to
  * the User Documentation.
+ *
+ * By default, the map is measured by RemSpectrumPhy listeners attached to
+ * the channel, moved over the map in successive simulator iterations. With
+ * the DirectComputation attribute, the signals transmitted during a single
+ * subframe are recorded instead, and the map is computed from them and the
+ * loss models of the channel, without any further simulator event.
  */
 class RadioEnvironmentMapHelper : public Object
 {
@@ -108,6 +126,61 @@ private:
   /// Called when the map generation procedure has been completed.
   void Finalize ();
 
+  /**
+   * Scheduled by DelayedInstall() in the direct computation mode, 0.1
+   * milliseconds later, like the first iteration. Start recording the
+   * signals transmitted on the channel, and schedule a call to
+   * ComputeMap() in 0.5 milliseconds.
+   */
+  void StartCapture ();
+
+  /**
+   * Record a signal transmitted on the channel, if the map is made of
+   * signals of its kind.
+   *
+   * \param params the parameters of the signal
+   */
+  void CaptureSignal (Ptr<SpectrumSignalParameters> params);
+
+  /**
+   * Compute the whole map from the recorded signals, and write it to the
+   * output file, a batch of at most `MaxPointsPerIteration` points at a
+   * time. The loss models of the channel are evaluated in the simulation
+   * thread, since they are not thread-safe in general (e.g., they may draw
+   * random variables or cache values). With more than one thread, the
+   * worker threads meanwhile compute the SINR of the previous batch.
+   */
+  void ComputeMap ();
+
+  /**
+   * Start the computation of the SINR of the points of the current batch,
+   * on the worker threads if any, once the previous batch is written.
+   */
+  void ComputeBatch ();
+
+  /// Write the SINR of the points of the batch being computed, if any.
+  void WriteBatch ();
+
+  /**
+   * Compute the SINR of a share of the points of the batch being
+   * computed, and format the output lines. Only plain values are read
+   * here, since the reference counts of the simulation objects are not
+   * thread-safe.
+   *
+   * \param share the index of the share
+   */
+  void ComputeShare (uint32_t share);
+
+#ifdef HAVE_PTHREAD_H
+  /**
+   * Entry point of a worker thread: compute its share of every batch
+   * until the map is complete
+   *
+   * \param share the index of the share of the worker
+   */
+  void Work (uint32_t share);
+#endif /* HAVE_PTHREAD_H */
+
   /// A complete Radio Environment Map is composed of many of this structure.
   struct RemPoint 
   {
@@ -152,6 +225,59 @@ private:
   bool m_useDataChannel;  ///< The `UseDataChannel` attribute.
   int32_t m_rbId;         ///< The `RbId` attribute.
 
+  bool m_directComputation;  ///< The `DirectComputation` attribute.
+  uint32_t m_nThreads;       ///< The `Threads` attribute.
+
+  /// A signal recorded in the direct computation mode.
+  struct RemSignal
+  {
+    /// Position of the transmitter in the environment.
+    Ptr<MobilityModel> mobility;
+    /// Antenna of the transmitter.
+    Ptr<AntennaModel> antenna;
+    /// Transmitted PSD, converted to the spectrum model of the map.
+    std::vector<double> psd;
+  };
+
+  /// The spectrum model of the map.
+  Ptr<const SpectrumModel> m_rxSpectrumModel;
+  /// Width of the bands of the spectrum model of the map.
+  std::vector<double> m_bandWidths;
+  /// Signals from which the map is computed.
+  std::vector<RemSignal> m_signals;
+  /// Positions of the points of the current batch.
+  std::vector<Vector> m_batchPositions;
+  /**
+   * Path loss in dB from each signal to each point of the current batch,
+   * infinite if the signal is not received.
+   */
+  std::vector<double> m_batchLoss;
+  /**
+   * Received power from each signal to each point of the current batch,
+   * when a spectrum propagation loss model is used.
+   */
+  std::vector<double> m_batchPower;
+  /// Positions of the points of the batch being computed.
+  std::vector<Vector> m_runPositions;
+  /// Path loss from each signal to each point of the batch being computed.
+  std::vector<double> m_runLoss;
+  /// Received power from each signal to each point of the batch being computed.
+  std::vector<double> m_runPower;
+  /// Output lines of each share of the batch being computed.
+  std::vector<std::string> m_shareOutput;
+  /// Whether a batch is being computed, and not yet written.
+  bool m_running;
+
+#ifdef HAVE_PTHREAD_H
+  std::vector<Ptr<SystemThread> > m_workers; ///< the worker threads
+  std::mutex m_mutex; ///< protects the fields below
+  std::condition_variable m_start; ///< notified when a batch starts or the map is complete
+  std::condition_variable m_done; ///< notified when the last worker is done with a batch
+  uint64_t m_batches; ///< the number of batches started on the workers
+  uint32_t m_busyWorkers; ///< the number of workers still computing the current batch
+  bool m_stop; ///< tells the workers to exit
+#endif /* HAVE_PTHREAD_H */
+
 }; // end of `class RadioEnvironmentMapHelper`
 
 
@@ -514,23 +514,7 @@ CqaFfMacScheduler::GetRbgSize (int dlbandwidth)
 unsigned int
 CqaFfMacScheduler::LcActivePerFlow (uint16_t rnti)
 {
-  std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it;
-  unsigned int lcActive = 0;
-  for (it = m_rlcBufferReq.begin (); it != m_rlcBufferReq.end (); it++)
-    {
-      if (((*it).first.m_rnti == rnti) && (((*it).second.m_rlcTransmissionQueueSize > 0)
-                                           || ((*it).second.m_rlcRetransmissionQueueSize > 0)
-                                           || ((*it).second.m_rlcStatusPduSize > 0) ))
-        {
-          lcActive++;
-        }
-      if ((*it).first.m_rnti > rnti)
-        {
-          break;
-        }
-    }
-  return (lcActive);
-
+  return FfMacDlCandidates::CountActiveLcs (m_rlcBufferReq, rnti);
 }
 
 
@@ -1163,106 +1147,42 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
   std::map<LteFlowId_t, int> UeToAmountOfDataToTransfer;
   //Initialize the map per UE, how much resources is already assigned to the user
   std::map<LteFlowId_t, int> UeToAmountOfAssignedResources;
-  // prepare values to calculate FF metric, this metric will be the same for all flows(logical channels) that belong to the same RNTI
-  std::map < uint16_t, uint8_t > sbCqiSum;
+  // the state of a UE is the same for all its flows (logical channels),
+  // and does not change during the scheduling of the TTI: look it up once
+  // per TTI and RNTI
+  m_dlCandidates.Start (m_amc, rbgSize);
 
   for( std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator itrbr = m_rlcBufferReq.begin ();
        itrbr!=m_rlcBufferReq.end (); itrbr++)
     {
 
       LteFlowId_t flowId = itrbr->first;                // Prepare data for the scheduling mechanism
-      // check first the channel conditions for this UE, if CQI!=0
-      std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
-      itCqi = m_a30CqiRxed.find ((*itrbr).first.m_rnti);
-      std::map <uint16_t,uint8_t>::iterator itTxMode;
-      itTxMode = m_uesTxMode.find ((*itrbr).first.m_rnti);
-      if (itTxMode == m_uesTxMode.end ())
+      if (m_dlCandidates.GetN () == 0 || m_dlCandidates.Get (m_dlCandidates.GetN () - 1).rnti != flowId.m_rnti)
         {
-          NS_FATAL_ERROR ("No Transmission Mode info on user " << (*itrbr).first.m_rnti);
-        }
-      int nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
-
-      uint8_t cqiSum = 0;
-      for (int k = 0; k < numberOfRBGs; k++)
-        {
-          for (uint8_t j = 0; j < nLayer; j++)
+          FfMacDlCandidate& candidate = m_dlCandidates.Add (flowId.m_rnti,
+                                                            rntiAllocated.find (flowId.m_rnti) != rntiAllocated.end (),
+                                                            HarqProcessAvailability (flowId.m_rnti),
+                                                            m_uesTxMode, m_a30CqiRxed, m_rlcBufferReq);
+          // check first the channel conditions for this UE, if CQI!=0
+          if (!candidate.txModeKnown)
             {
-              if (itCqi == m_a30CqiRxed.end ())
-                {
-                  cqiSum += 1;  // no info on this user -> lowest MCS
-                }
-              else
-                {
-                  cqiSum += (*itCqi).second.m_higherLayerSelected.at (k).m_sbCqi.at(j);
-                }
+              NS_FATAL_ERROR ("No Transmission Mode info on user " << flowId.m_rnti);
             }
+          candidate.selected = FfMacDlCandidates::GetCqiSum (candidate, numberOfRBGs) != 0;
         }
 
-      if (cqiSum == 0)
+      if (!m_dlCandidates.Get (m_dlCandidates.GetN () - 1).selected)
         {
           NS_LOG_INFO ("Skip this flow, CQI==0, rnti:"<<(*itrbr).first.m_rnti);
           continue;
         }
       
       // map: UE, to the amount of traffic they have to transfer
-      int amountOfDataToTransfer =  8*((int)m_rlcBufferReq.find (flowId)->second.m_rlcRetransmissionQueueSize +
-                                       (int)m_rlcBufferReq.find (flowId)->second.m_rlcTransmissionQueueSize);
+      int amountOfDataToTransfer =  8*((int)itrbr->second.m_rlcRetransmissionQueueSize +
+                                       (int)itrbr->second.m_rlcTransmissionQueueSize);
 
       UeToAmountOfDataToTransfer.insert (std::pair<LteFlowId_t,int>(flowId,amountOfDataToTransfer));
       UeToAmountOfAssignedResources.insert (std::pair<LteFlowId_t,int>(flowId,0));
-
-      uint8_t sum = 0;
-      for (int i = 0; i < numberOfRBGs; i++)
-        {
-          std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
-          itCqi = m_a30CqiRxed.find ((*itrbr).first.m_rnti);
-          std::map <uint16_t,uint8_t>::iterator itTxMode;
-          itTxMode = m_uesTxMode.find ((*itrbr).first.m_rnti);
-          if (itTxMode == m_uesTxMode.end ())
-            {
-              NS_FATAL_ERROR ("No Transmission Mode info on user " << (*itrbr).first.m_rnti);
-            }
-          int nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
-          std::vector <uint8_t> sbCqis;
-          if (itCqi == m_a30CqiRxed.end ())
-            {
-              for (uint8_t k = 0; k < nLayer; k++)
-                {
-                  sbCqis.push_back (1);                        // start with lowest value
-                }
-            }
-          else
-            {
-              sbCqis = (*itCqi).second.m_higherLayerSelected.at (i).m_sbCqi;
-            }
-
-          uint8_t cqi1 = sbCqis.at (0);
-          uint8_t cqi2 = 0;
-          if (sbCqis.size () > 1)
-            {
-              cqi2 = sbCqis.at (1);
-            }
-
-          uint8_t sbCqi = 0;
-          if ((cqi1 > 0)||(cqi2 > 0))               // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
-            {
-              for (uint8_t k = 0; k < nLayer; k++)
-                {
-                  if (sbCqis.size () > k)
-                    {
-                      sbCqi = sbCqis.at (k);
-                    }
-                  else
-                    {
-                      // no info on this subband
-                      sbCqi = 0;
-                    }
-                  sum += sbCqi;
-                }
-            }               // end if cqi
-        }        // end of rbgNum
-
-      sbCqiSum.insert (std::pair<uint16_t, uint8_t> ((*itrbr).first.m_rnti, sum));
     }
 
   // availableRBGs - set that contains indexes of available resource block groups
@@ -1330,7 +1250,7 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
               uint8_t worstCQIAmongRBGsAllocatedForThisUser = 15;
               int numberOfRBGAllocatedForThisUser = 0;
               LogicalChannelConfigListElement_s lc = m_ueLogicalChannelsConfigList.find (flowId)->second;
-              std::map <uint16_t,SbMeasResult_s>::iterator itRntiCQIsMap = m_a30CqiRxed.find (flowId.m_rnti);
+              const SbMeasResult_s* sbMeas = m_dlCandidates.Find (flowId.m_rnti)->sbMeas;
 
               std::map <uint16_t, CqasFlowPerf_t>::iterator itStats;
 
@@ -1350,13 +1270,13 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
               if (tbr_weight < 1.0)
                 tbr_weight = 1.0;
 
-              if (itRntiCQIsMap != m_a30CqiRxed.end ())
+              if (sbMeas != 0)
                 {
                   for(std::set<int>::iterator it=availableRBGs.begin (); it!=availableRBGs.end (); it++)
                     {
                       try
                         {
-                          int val = (itRntiCQIsMap->second.m_higherLayerSelected.at (*it).m_sbCqi.at (0));
+                          int val = (sbMeas->m_higherLayerSelected.at (*it).m_sbCqi.at (0));
                           if (val==0)
                             val=1;                                             //if no info, use minimum
                           if (*it == currentRB)
@@ -1398,11 +1318,11 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
                     }
                 }
 
-              int mcsForThisUser = m_amc->GetMcsFromCqi (worstCQIAmongRBGsAllocatedForThisUser);
+              int mcsForThisUser = m_dlCandidates.GetMcs (worstCQIAmongRBGsAllocatedForThisUser);
               int tbSize = m_amc->GetDlTbSizeFromMcs (mcsForThisUser, (numberOfRBGAllocatedForThisUser+1) * rbgSize)/8;                           // similar to calculation of TB size (size of TB in bytes according to table 7.1.7.2.1-1 of 36.213)
 
 
-              double achievableRate = (( m_amc->GetDlTbSizeFromMcs (mcsForThisUser, rbgSize)/ 8) / 0.001);
+              double achievableRate = m_dlCandidates.GetMcsRate (mcsForThisUser);
               double pf_weight = achievableRate / (*itStats).second.secondLastAveragedThroughput;
 
               UeToAmountOfAssignedResources.find (flowId)->second = 8*tbSize;
@@ -28,6 +28,7 @@
 #include <ns3/ff-mac-csched-sap.h>
 #include <ns3/ff-mac-sched-sap.h>
 #include <ns3/ff-mac-scheduler.h>
+#include <ns3/ff-mac-dl-candidates.h>
 #include <vector>
 #include <map>
 #include <set>
@@ -306,6 +307,12 @@ private:
   */
   std::map <uint16_t, CqasFlowPerf_t> m_flowStatsDl;
 
+  /**
+  * The candidates of the DL scheduling, one per RNTI with an RLC buffer
+  * status report, kept across the TTIs to reuse the storage
+  */
+  FfMacDlCandidates m_dlCandidates;
+
   /**
   * Map of UE statistics (per RNTI basis)
   */
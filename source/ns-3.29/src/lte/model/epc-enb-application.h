@@ -35,6 +35,7 @@
 #include <ns3/epc-enb-s1-sap.h>
 #include <ns3/epc-s1ap-sap.h>
 #include <map>
+#include <unordered_map>
 
 namespace ns3 {
 class EpcEnbS1SapUser;
@@ -274,16 +275,18 @@ private:
   Ipv4Address m_sgwS1uAddress;
 
   /**
-   * map of maps telling for each RNTI and BID the corresponding  S1-U TEID
+   * map of maps telling for each RNTI and BID the corresponding  S1-U TEID,
+   * hashed by RNTI since it is looked up for every uplink packet
    * 
    */
-  std::map<uint16_t, std::map<uint8_t, uint32_t> > m_rbidTeidMap;  
+  std::unordered_map<uint16_t, std::map<uint8_t, uint32_t> > m_rbidTeidMap;  
 
   /**
-   * map telling for each S1-U TEID the corresponding RNTI,BID
+   * map telling for each S1-U TEID the corresponding RNTI,BID,
+   * hashed since it is looked up for every downlink packet
    * 
    */
-  std::map<uint32_t, EpsFlowId_t> m_teidRbidMap;
+  std::unordered_map<uint32_t, EpsFlowId_t> m_teidRbidMap;
  
   /**
    * UDP port to be used for GTP
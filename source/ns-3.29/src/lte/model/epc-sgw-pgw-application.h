@@ -37,6 +37,7 @@
 #include <ns3/epc-s1ap-sap.h>
 #include <ns3/epc-s11-sap.h>
 #include <map>
+#include <unordered_map>
 
 namespace ns3 {
 
@@ -288,14 +289,16 @@ public:
   Ptr<VirtualNetDevice> m_tunDevice;
 
   /**
-   * Map telling for each UE IPv4 address the corresponding UE info 
+   * Map telling for each UE IPv4 address the corresponding UE info,
+   * hashed since it is looked up for every downlink packet
    */
-  std::map<Ipv4Address, Ptr<UeInfo> > m_ueInfoByAddrMap;
+  std::unordered_map<Ipv4Address, Ptr<UeInfo>, Ipv4AddressHash> m_ueInfoByAddrMap;
 
   /**
-   * Map telling for each UE IPv6 address the corresponding UE info 
+   * Map telling for each UE IPv6 address the corresponding UE info,
+   * hashed since it is looked up for every downlink packet
    */
-  std::map<Ipv6Address, Ptr<UeInfo> > m_ueInfoByAddrMap6;
+  std::unordered_map<Ipv6Address, Ptr<UeInfo>, Ipv6AddressHash> m_ueInfoByAddrMap6;
 
   /**
    * Map telling for each IMSI the corresponding UE info 
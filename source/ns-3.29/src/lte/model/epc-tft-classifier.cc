@@ -40,6 +40,63 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("EpcTftClassifier");
 
+/// maximum number of flows cached by a classifier
+static const uint32_t MAX_CACHED_FLOWS = 4096;
+
+/**
+ * Read the ports at the start of the UDP or TCP header of an IP packet
+ *
+ * \param p the IP packet
+ * \param ipHeaderSize the size of the IP header
+ * \param sourcePort the source port, unchanged if the packet is too short
+ * \param destinationPort the destination port, unchanged if the packet is too short
+ */
+static void
+ReadPorts (Ptr<Packet> p, uint32_t ipHeaderSize, uint16_t &sourcePort, uint16_t &destinationPort)
+{
+  // the IP header is at most 60 bytes long, and both the UDP and the TCP
+  // headers start with the source and destination ports
+  uint8_t buffer[64];
+  NS_ASSERT (ipHeaderSize + 4 <= sizeof (buffer));
+  if (p->CopyData (buffer, ipHeaderSize + 4) == ipHeaderSize + 4)
+    {
+      sourcePort = (buffer[ipHeaderSize] << 8) | buffer[ipHeaderSize + 1];
+      destinationPort = (buffer[ipHeaderSize + 2] << 8) | buffer[ipHeaderSize + 3];
+    }
+}
+
+bool
+EpcTftClassifier::FlowId::operator == (const FlowId &other) const
+{
+  return m_direction == other.m_direction
+         && m_ipType == other.m_ipType
+         && m_tos == other.m_tos
+         && m_localPort == other.m_localPort
+         && m_remotePort == other.m_remotePort
+         && m_localAddressIpv4 == other.m_localAddressIpv4
+         && m_remoteAddressIpv4 == other.m_remoteAddressIpv4
+         && m_localAddressIpv6 == other.m_localAddressIpv6
+         && m_remoteAddressIpv6 == other.m_remoteAddressIpv6;
+}
+
+size_t
+EpcTftClassifier::FlowIdHash::operator () (const FlowId &flow) const
+{
+  size_t hash = (flow.m_direction << 16) ^ (flow.m_tos << 8) ^ flow.m_ipType;
+  hash = hash * 31 + ((flow.m_localPort << 16) | flow.m_remotePort);
+  if (flow.m_ipType == 0x04)
+    {
+      hash = hash * 31 + flow.m_localAddressIpv4.Get ();
+      hash = hash * 31 + flow.m_remoteAddressIpv4.Get ();
+    }
+  else
+    {
+      hash = hash * 31 + Ipv6AddressHash () (flow.m_localAddressIpv6);
+      hash = hash * 31 + Ipv6AddressHash () (flow.m_remoteAddressIpv6);
+    }
+  return hash;
+}
+
 EpcTftClassifier::EpcTftClassifier ()
 {
   NS_LOG_FUNCTION (this);
@@ -50,6 +107,7 @@ EpcTftClassifier::Add (Ptr<EpcTft> tft, uint32_t id)
 {
   NS_LOG_FUNCTION (this << tft << id);
   m_tftMap[id] = tft;
+  m_flowCache.clear ();
 
   // simple sanity check: there shouldn't be more than 16 bearers (hence TFTs) per UE
   NS_ASSERT (m_tftMap.size () <= 16);
@@ -60,6 +118,7 @@ EpcTftClassifier::Delete (uint32_t id)
 {
   NS_LOG_FUNCTION (this << id);
   m_tftMap.erase (id);
+  m_flowCache.clear ();
 }
 
  
@@ -68,41 +127,26 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction)
 {
   NS_LOG_FUNCTION (this << p << p->GetSize () << direction);
 
-  Ptr<Packet> pCopy = p->Copy ();
+  // the headers are peeked and the ports read in place: the packet is
+  // never copied, since it is about to be tunneled as is
 
   uint8_t ipType;
-  pCopy->CopyData (&ipType, 1);
+  p->CopyData (&ipType, 1);
   ipType = (ipType>>4) & 0x0f;
 
-  Ipv4Address localAddressIpv4;
-  Ipv4Address remoteAddressIpv4;
+  FlowId flow;
+  flow.m_direction = direction;
+  flow.m_ipType = ipType;
+  flow.m_localPort = 0;
+  flow.m_remotePort = 0;
 
-  Ipv6Address localAddressIpv6;
-  Ipv6Address remoteAddressIpv6;
-
-  uint8_t protocol;
-  uint8_t tos;
-
-  uint16_t localPort = 0;
-  uint16_t remotePort = 0;
+  uint16_t sourcePort = 0;
+  uint16_t destinationPort = 0;
 
   if (ipType == 0x04)
     {
       Ipv4Header ipv4Header;
-      pCopy->RemoveHeader (ipv4Header);
-
-      if (direction ==  EpcTft::UPLINK)
-        {
-          localAddressIpv4 = ipv4Header.GetSource ();
-          remoteAddressIpv4 = ipv4Header.GetDestination ();
-        }
-      else
-        {
-          NS_ASSERT (direction ==  EpcTft::DOWNLINK);
-          remoteAddressIpv4 = ipv4Header.GetSource ();
-          localAddressIpv4 = ipv4Header.GetDestination ();
-        }
-      NS_LOG_INFO ("local address: " << localAddressIpv4 << " remote address: " << remoteAddressIpv4);
+      p->PeekHeader (ipv4Header);
 
       uint16_t payloadSize = ipv4Header.GetPayloadSize ();
       uint16_t fragmentOffset = ipv4Header.GetFragmentOffset ();
@@ -111,8 +155,8 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction)
       // NS_LOG_DEBUG ("PayloadSize = " << payloadSize);
       // NS_LOG_DEBUG ("fragmentOffset " << fragmentOffset << " isLastFragment " << isLastFragment);
 
-      protocol = ipv4Header.GetProtocol ();
-      tos = ipv4Header.GetTos ();
+      uint8_t protocol = ipv4Header.GetProtocol ();
+      flow.m_tos = ipv4Header.GetTos ();
 
       // Port info only can be get if it is the first fragment and
       // there is enough data in the payload
@@ -120,46 +164,10 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction)
       // i.e. it is the first one but it is not the last one
       if (fragmentOffset == 0)
         {
-          if (protocol == UdpL4Protocol::PROT_NUMBER && payloadSize >= 8)
-            {
-              UdpHeader udpHeader;
-              pCopy->RemoveHeader (udpHeader);
-              if (direction ==  EpcTft::UPLINK)
-                {
-                  localPort = udpHeader.GetSourcePort ();
-                  remotePort = udpHeader.GetDestinationPort ();
-                }
-              else
-                {
-                  remotePort = udpHeader.GetSourcePort ();
-                  localPort = udpHeader.GetDestinationPort ();
-                }
-              if (!isLastFragment)
-                {
-                  std::tuple<uint32_t, uint32_t, uint8_t, uint16_t> fragmentKey =
-                      std::make_tuple (ipv4Header.GetSource ().Get (),
-                                       ipv4Header.GetDestination ().Get (),
-                                       protocol,
-                                       ipv4Header.GetIdentification ());
-
-                  m_classifiedIpv4Fragments[fragmentKey] = std::make_pair (localPort, remotePort);
-                }
-            }
-          else if (protocol == TcpL4Protocol::PROT_NUMBER && payloadSize >= 20)
+          if ((protocol == UdpL4Protocol::PROT_NUMBER && payloadSize >= 8)
+              || (protocol == TcpL4Protocol::PROT_NUMBER && payloadSize >= 20))
             {
-              TcpHeader tcpHeader;
-              pCopy->RemoveHeader (tcpHeader);
-              if (direction ==  EpcTft::UPLINK)
-                {
-                  localPort = tcpHeader.GetSourcePort ();
-                  remotePort = tcpHeader.GetDestinationPort ();
-                }
-              else
-                {
-                  remotePort = tcpHeader.GetSourcePort ();
-                  localPort = tcpHeader.GetDestinationPort ();
-                }
-
+              ReadPorts (p, ipv4Header.GetSerializedSize (), sourcePort, destinationPort);
               if (!isLastFragment)
                 {
                   std::tuple<uint32_t, uint32_t, uint8_t, uint16_t> fragmentKey =
@@ -168,7 +176,7 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction)
                                        protocol,
                                        ipv4Header.GetIdentification ());
 
-                  m_classifiedIpv4Fragments[fragmentKey] = std::make_pair (localPort, remotePort);
+                  m_classifiedIpv4Fragments[fragmentKey] = std::make_pair (sourcePort, destinationPort);
                 }
             }
 
@@ -192,8 +200,8 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction)
 
           if (it != m_classifiedIpv4Fragments.end ())
             {
-              localPort = it->second.first;
-              remotePort = it->second.second;
+              sourcePort = it->second.first;
+              destinationPort = it->second.second;
 
               if (isLastFragment)
                 {
@@ -201,118 +209,118 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction)
                 }
             }
         }
-    }
-  else if (ipType == 0x06)
-    {
-      Ipv6Header ipv6Header;
-      pCopy->RemoveHeader (ipv6Header);
 
       if (direction ==  EpcTft::UPLINK)
         {
-          localAddressIpv6 = ipv6Header.GetSourceAddress ();
-          remoteAddressIpv6 = ipv6Header.GetDestinationAddress ();
+          flow.m_localAddressIpv4 = ipv4Header.GetSource ();
+          flow.m_remoteAddressIpv4 = ipv4Header.GetDestination ();
+          flow.m_localPort = sourcePort;
+          flow.m_remotePort = destinationPort;
         }
       else
         {
           NS_ASSERT (direction ==  EpcTft::DOWNLINK);
-          remoteAddressIpv6 = ipv6Header.GetSourceAddress ();
-          localAddressIpv6 = ipv6Header.GetDestinationAddress ();
+          flow.m_remoteAddressIpv4 = ipv4Header.GetSource ();
+          flow.m_localAddressIpv4 = ipv4Header.GetDestination ();
+          flow.m_remotePort = sourcePort;
+          flow.m_localPort = destinationPort;
         }
-      NS_LOG_INFO ("local address: " << localAddressIpv6 << " remote address: " << remoteAddressIpv6);
 
-      protocol = ipv6Header.GetNextHeader ();
-      tos = ipv6Header.GetTrafficClass ();
+      NS_LOG_INFO ("Classifying packet:"
+          << " localAddr="  << flow.m_localAddressIpv4
+          << " remoteAddr=" << flow.m_remoteAddressIpv4
+          << " localPort="  << flow.m_localPort
+          << " remotePort=" << flow.m_remotePort
+          << " tos=0x" << (uint16_t) flow.m_tos );
+    }
+  else if (ipType == 0x06)
+    {
+      Ipv6Header ipv6Header;
+      p->PeekHeader (ipv6Header);
+
+      uint8_t protocol = ipv6Header.GetNextHeader ();
+      flow.m_tos = ipv6Header.GetTrafficClass ();
 
-      if (protocol == UdpL4Protocol::PROT_NUMBER)
+      if (protocol == UdpL4Protocol::PROT_NUMBER || protocol == TcpL4Protocol::PROT_NUMBER)
         {
-          UdpHeader udpHeader;
-          pCopy->RemoveHeader (udpHeader);
+          ReadPorts (p, ipv6Header.GetSerializedSize (), sourcePort, destinationPort);
+        }
 
-          if (direction ==  EpcTft::UPLINK)
-            {
-              localPort = udpHeader.GetSourcePort ();
-              remotePort = udpHeader.GetDestinationPort ();
-            }
-          else
-            {
-              remotePort = udpHeader.GetSourcePort ();
-              localPort = udpHeader.GetDestinationPort ();
-            }
+      if (direction ==  EpcTft::UPLINK)
+        {
+          flow.m_localAddressIpv6 = ipv6Header.GetSourceAddress ();
+          flow.m_remoteAddressIpv6 = ipv6Header.GetDestinationAddress ();
+          flow.m_localPort = sourcePort;
+          flow.m_remotePort = destinationPort;
         }
-      else if (protocol == TcpL4Protocol::PROT_NUMBER)
+      else
         {
-          TcpHeader tcpHeader;
-          pCopy->RemoveHeader (tcpHeader);
-          if (direction ==  EpcTft::UPLINK)
-            {
-              localPort = tcpHeader.GetSourcePort ();
-              remotePort = tcpHeader.GetDestinationPort ();
-            }
-          else
-            {
-              remotePort = tcpHeader.GetSourcePort ();
-              localPort = tcpHeader.GetDestinationPort ();
-            }
+          NS_ASSERT (direction ==  EpcTft::DOWNLINK);
+          flow.m_remoteAddressIpv6 = ipv6Header.GetSourceAddress ();
+          flow.m_localAddressIpv6 = ipv6Header.GetDestinationAddress ();
+          flow.m_remotePort = sourcePort;
+          flow.m_localPort = destinationPort;
         }
+
+      NS_LOG_INFO ("Classifying packet:"
+          << " localAddr="  << flow.m_localAddressIpv6
+          << " remoteAddr=" << flow.m_remoteAddressIpv6
+          << " localPort="  << flow.m_localPort
+          << " remotePort=" << flow.m_remotePort
+          << " tos=0x" << (uint16_t) flow.m_tos );
     }
   else
     {
       NS_ABORT_MSG ("EpcTftClassifier::Classify - Unknown IP type...");
     }
 
+  std::unordered_map<FlowId, uint32_t, FlowIdHash>::const_iterator cached = m_flowCache.find (flow);
+  if (cached != m_flowCache.end ())
+    {
+      NS_LOG_LOGIC ("flow already classified with TFT ID = " << cached->second);
+      return cached->second;
+    }
 
-  if (ipType == 0x04)
+  uint32_t id = Match (flow);
+  if (m_flowCache.size () >= MAX_CACHED_FLOWS)
     {
-      NS_LOG_INFO ("Classifying packet:"
-          << " localAddr="  << localAddressIpv4
-          << " remoteAddr=" << remoteAddressIpv4
-          << " localPort="  << localPort
-          << " remotePort=" << remotePort
-          << " tos=0x" << (uint16_t) tos );
-
-      // now it is possible to classify the packet!
-      // we use a reverse iterator since filter priority is not implemented properly.
-      // This way, since the default bearer is expected to be added first, it will be evaluated last.
-      std::map <uint32_t, Ptr<EpcTft> >::const_reverse_iterator it;
-      NS_LOG_LOGIC ("TFT MAP size: " << m_tftMap.size ());
-
-      for (it = m_tftMap.rbegin (); it != m_tftMap.rend (); ++it)
-        {
-          NS_LOG_LOGIC ("TFT id: " << it->first );
-          NS_LOG_LOGIC (" Ptr<EpcTft>: " << it->second);
-          Ptr<EpcTft> tft = it->second;
-          if (tft->Matches (direction, remoteAddressIpv4, localAddressIpv4, remotePort, localPort, tos))
-            {
-              NS_LOG_LOGIC ("matches with TFT ID = " << it->first);
-              return it->first; // the id of the matching TFT
-            }
-        }
+      // a host opening a new flow per packet should not make the cache grow for ever
+      m_flowCache.clear ();
     }
-  else if (ipType == 0x06)
+  m_flowCache[flow] = id;
+  return id;
+}
+
+uint32_t
+EpcTftClassifier::Match (const FlowId &flow) const
+{
+  NS_LOG_FUNCTION (this);
+
+  // now it is possible to classify the packet!
+  // we use a reverse iterator since filter priority is not implemented properly.
+  // This way, since the default bearer is expected to be added first, it will be evaluated last.
+  std::map <uint32_t, Ptr<EpcTft> >::const_reverse_iterator it;
+  NS_LOG_LOGIC ("TFT MAP size: " << m_tftMap.size ());
+
+  for (it = m_tftMap.rbegin (); it != m_tftMap.rend (); ++it)
     {
-      NS_LOG_INFO ("Classifying packet:"
-          << " localAddr="  << localAddressIpv6
-          << " remoteAddr=" << remoteAddressIpv6
-          << " localPort="  << localPort
-          << " remotePort=" << remotePort
-          << " tos=0x" << (uint16_t) tos );
-
-      // now it is possible to classify the packet!
-      // we use a reverse iterator since filter priority is not implemented properly.
-      // This way, since the default bearer is expected to be added first, it will be evaluated last.
-      std::map <uint32_t, Ptr<EpcTft> >::const_reverse_iterator it;
-      NS_LOG_LOGIC ("TFT MAP size: " << m_tftMap.size ());
-
-      for (it = m_tftMap.rbegin (); it != m_tftMap.rend (); ++it)
+      NS_LOG_LOGIC ("TFT id: " << it->first );
+      NS_LOG_LOGIC (" Ptr<EpcTft>: " << it->second);
+      bool matches;
+      if (flow.m_ipType == 0x04)
         {
-          NS_LOG_LOGIC ("TFT id: " << it->first );
-          NS_LOG_LOGIC (" Ptr<EpcTft>: " << it->second);
-          Ptr<EpcTft> tft = it->second;
-          if (tft->Matches (direction, remoteAddressIpv6, localAddressIpv6, remotePort, localPort, tos))
-            {
-              NS_LOG_LOGIC ("matches with TFT ID = " << it->first);
-              return it->first; // the id of the matching TFT
-            }
+          matches = it->second->Matches (flow.m_direction, flow.m_remoteAddressIpv4, flow.m_localAddressIpv4,
+                                         flow.m_remotePort, flow.m_localPort, flow.m_tos);
+        }
+      else
+        {
+          matches = it->second->Matches (flow.m_direction, flow.m_remoteAddressIpv6, flow.m_localAddressIpv6,
+                                         flow.m_remotePort, flow.m_localPort, flow.m_tos);
+        }
+      if (matches)
+        {
+          NS_LOG_LOGIC ("matches with TFT ID = " << it->first);
+          return it->first; // the id of the matching TFT
         }
     }
   NS_LOG_LOGIC ("no match");
@@ -26,8 +26,11 @@
 #include "ns3/ptr.h"
 #include "ns3/simple-ref-count.h"
 #include "ns3/epc-tft.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv6-address.h"
 
 #include <map>
+#include <unordered_map>
 
 
 namespace ns3 {
@@ -50,6 +53,12 @@ class Packet;
  *
  * When we cannot cache the port info, the TFT of the default bearer is used. This may happen
  * if there is reordering or losses of IP packets.
+ *
+ * The result of the classification only depends on the addresses, ports
+ * and type of service of the packet, so it is cached in a hash table for
+ * each flow: the TFTs are matched once per flow rather than once per
+ * packet. The cache is flushed whenever a TFT is added or deleted; the
+ * TFTs themselves must not be modified once added to the classifier.
  */
 class EpcTftClassifier : public SimpleRefCount<EpcTftClassifier>
 {
@@ -85,9 +94,49 @@ public:
   uint32_t Classify (Ptr<Packet> p, EpcTft::Direction direction);
   
 protected:
-  
+
+  /// the fields of an IP packet which a TFT is matched against
+  struct FlowId
+  {
+    EpcTft::Direction m_direction; ///< the direction of the packet
+    uint8_t m_ipType; ///< the IP version, 4 or 6
+    uint8_t m_tos; ///< the type of service
+    uint16_t m_localPort; ///< the local port
+    uint16_t m_remotePort; ///< the remote port
+    Ipv4Address m_localAddressIpv4; ///< the local IPv4 address
+    Ipv4Address m_remoteAddressIpv4; ///< the remote IPv4 address
+    Ipv6Address m_localAddressIpv6; ///< the local IPv6 address
+    Ipv6Address m_remoteAddressIpv6; ///< the remote IPv6 address
+
+    /**
+     * \param other the flow to compare with
+     * \return true if both flows are the same
+     */
+    bool operator == (const FlowId &other) const;
+  };
+
+  /// hash function of the flows
+  struct FlowIdHash
+  {
+    /**
+     * \param flow the flow
+     * \return the hash of the flow
+     */
+    size_t operator () (const FlowId &flow) const;
+  };
+
+  /**
+   * Match a flow against the TFTs, from the last one added to the first one
+   *
+   * \param flow the flow
+   * \return the identifier of the first TFT that matches the flow; 0 if no TFT matched.
+   */
+  uint32_t Match (const FlowId &flow) const;
+
   std::map <uint32_t, Ptr<EpcTft> > m_tftMap; ///< TFT map
 
+  std::unordered_map<FlowId, uint32_t, FlowIdHash> m_flowCache; ///< TFT id of the flows already classified
+
   std::map < std::tuple<uint32_t, uint32_t, uint8_t, uint16_t>,
              std::pair<uint32_t, uint32_t> >
       m_classifiedIpv4Fragments; ///< Map with already classified IPv4 Fragments
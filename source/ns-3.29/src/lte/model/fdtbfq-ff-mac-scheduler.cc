@@ -396,23 +396,7 @@ FdTbfqFfMacScheduler::GetRbgSize (int dlbandwidth)
 unsigned int
 FdTbfqFfMacScheduler::LcActivePerFlow (uint16_t rnti)
 {
-  std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it;
-  unsigned int lcActive = 0;
-  for (it = m_rlcBufferReq.begin (); it != m_rlcBufferReq.end (); it++)
-    {
-      if (((*it).first.m_rnti == rnti) && (((*it).second.m_rlcTransmissionQueueSize > 0)
-                                           || ((*it).second.m_rlcRetransmissionQueueSize > 0)
-                                           || ((*it).second.m_rlcStatusPduSize > 0) ))
-        {
-          lcActive++;
-        }
-      if ((*it).first.m_rnti > rnti)
-        {
-          break;
-        }
-    }
-  return (lcActive);
-
+  return FfMacDlCandidates::CountActiveLcs (m_rlcBufferReq, rnti);
 }
 
 
@@ -977,74 +961,58 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
         }
     }
 
-  std::set <uint16_t> allocatedRnti;   // store UEs which are already assigned RBGs
+  // the channel conditions and the buffers of the UEs do not change
+  // during the scheduling of the TTI: check once per TTI which UEs can be
+  // scheduled, instead of once per selected UE
+  m_dlCandidates.Start (m_amc, rbgSize);
+  for (std::map <uint16_t, fdtbfqsFlowPerf_t>::iterator it = m_flowStatsDl.begin (); it != m_flowStatsDl.end (); it++)
+    {
+      FfMacDlCandidate& candidate = m_dlCandidates.Add ((*it).first,
+                                                        rntiAllocated.find ((*it).first) != rntiAllocated.end (),
+                                                        HarqProcessAvailability ((*it).first),
+                                                        m_uesTxMode, m_a30CqiRxed, m_rlcBufferReq);
+      if (candidate.allocated || !candidate.harqAvailable)
+        {
+          // UE already allocated for HARQ or without HARQ process available -> drop it
+          if (candidate.allocated)
+            {
+              NS_LOG_DEBUG (this << " RNTI discared for HARQ tx" << (uint16_t)(*it).first);
+            }
+          if (!candidate.harqAvailable)
+            {
+              NS_LOG_DEBUG (this << " RNTI discared for HARQ id" << (uint16_t)(*it).first);
+            }
+          continue;
+        }
+      // check first the channel conditions for this UE, if CQI!=0
+      if (!candidate.txModeKnown)
+        {
+          NS_FATAL_ERROR ("No Transmission Mode info on user " << (*it).first);
+        }
+      if (FfMacDlCandidates::GetCqiSum (candidate, rbgNum) == 0)
+        {
+          NS_LOG_INFO ("Skip this flow, CQI==0, rnti:"<<(*it).first);
+          continue;
+        }
+      // the flag is cleared once the UE is assigned RBGs
+      candidate.selected = candidate.lcActive;
+    }
+
   std::set <uint8_t> allocatedRbg;  // store RBGs which are already allocated to UE
 
   int totalRbg = 0;
   while (totalRbg < rbgNum)
     {
       // select UE with largest metric
-      std::map <uint16_t, fdtbfqsFlowPerf_t>::iterator it;
+      std::map <uint16_t, fdtbfqsFlowPerf_t>::iterator it = m_flowStatsDl.begin ();
       std::map <uint16_t, fdtbfqsFlowPerf_t>::iterator itMax = m_flowStatsDl.end ();
+      FfMacDlCandidate* candidateMax = 0;
       double metricMax = 0.0;
       bool firstRnti = true;
-      for (it = m_flowStatsDl.begin (); it != m_flowStatsDl.end (); it++)
+      for (uint32_t c = 0; c < m_dlCandidates.GetN (); c++, it++)
         {
-          std::set <uint16_t>::iterator itRnti = rntiAllocated.find ((*it).first);
-          if ((itRnti != rntiAllocated.end ())||(!HarqProcessAvailability ((*it).first)))
-            {
-              // UE already allocated for HARQ or without HARQ process available -> drop it
-              if (itRnti != rntiAllocated.end ())
-                {
-                  NS_LOG_DEBUG (this << " RNTI discared for HARQ tx" << (uint16_t)(*it).first);
-                }
-              if (!HarqProcessAvailability ((*it).first))
-                {
-                  NS_LOG_DEBUG (this << " RNTI discared for HARQ id" << (uint16_t)(*it).first);
-                }
-              continue;
-           }
-          // check first the channel conditions for this UE, if CQI!=0
-          std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
-          itCqi = m_a30CqiRxed.find ((*it).first);
-          std::map <uint16_t,uint8_t>::iterator itTxMode;
-          itTxMode = m_uesTxMode.find ((*it).first);
-          if (itTxMode == m_uesTxMode.end ())
-            {
-              NS_FATAL_ERROR ("No Transmission Mode info on user " << (*it).first);
-            }
-          int nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
-
-          uint8_t cqiSum = 0;
-          for (int k = 0; k < rbgNum; k++)
-            {
-              for (uint8_t j = 0; j < nLayer; j++)
-                {
-                  if (itCqi == m_a30CqiRxed.end ())
-                    {
-                      cqiSum += 1;  // no info on this user -> lowest MCS
-                    }
-                  else
-                    {
-                      cqiSum += (*itCqi).second.m_higherLayerSelected.at (k).m_sbCqi.at(j);
-                    }
-                }
-            }
-
-          if (cqiSum == 0)
-            {
-              NS_LOG_INFO ("Skip this flow, CQI==0, rnti:"<<(*it).first);
-              continue;
-            }
-
-          if (LcActivePerFlow ((*it).first) == 0)
-            {
-              continue;
-            }
-
-          std::set <uint16_t>::iterator rnti;
-          rnti = allocatedRnti.find((*it).first);
-          if (rnti != allocatedRnti.end ())  //  already allocated RBGs to this UE
+          FfMacDlCandidate& candidate = m_dlCandidates.Get (c);
+          if (!candidate.selected)
             {
               continue;
             }
@@ -1055,6 +1023,7 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
            {
              metricMax = metric;
              itMax = it;
+             candidateMax = &candidate;
              firstRnti = false;
              continue;
            }
@@ -1062,6 +1031,7 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
           {
             metricMax = metric;
             itMax = it;
+            candidateMax = &candidate;
           } 
        } // end for m_flowStatsDl
   
@@ -1072,7 +1042,7 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
         }
 
       // mark this UE as "allocated"
-      allocatedRnti.insert((*itMax).first);
+      candidateMax->selected = false;
 
       // calculate the maximum number of byte that the scheduler can assigned to this UE
       uint32_t budget = 0;
@@ -1098,10 +1068,9 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
           uint32_t rlcBufSize = 0;
           uint8_t lcid = 0;
           std::map<LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator itRlcBuf;
-          for (itRlcBuf = m_rlcBufferReq.begin (); itRlcBuf != m_rlcBufferReq.end (); itRlcBuf++)
+          for (itRlcBuf = m_rlcBufferReq.lower_bound (LteFlowId_t ((*itMax).first, 0)); itRlcBuf != m_rlcBufferReq.end () && (*itRlcBuf).first.m_rnti == (*itMax).first; itRlcBuf++)
             {
-              if ( (*itRlcBuf).first.m_rnti == (*itMax).first )
-                lcid = (*itRlcBuf).first.m_lcId;
+              lcid = (*itRlcBuf).first.m_lcId;
             }
           LteFlowId_t flow ((*itMax).first, lcid);
           itRlcBuf = m_rlcBufferReq.find (flow);
@@ -1119,15 +1088,7 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
         {
           totalRbg++;
 
-          std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
-          itCqi = m_a30CqiRxed.find ((*itMax).first);
-          std::map <uint16_t,uint8_t>::iterator itTxMode;
-          itTxMode = m_uesTxMode.find ((*itMax).first);
-          if (itTxMode == m_uesTxMode.end ())
-            {
-              NS_FATAL_ERROR ("No Transmission Mode info on user " << (*it).first);
-            }
-          int nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
+          int nLayer = candidateMax->nLayer;
 
           // find RBG with largest achievableRate
           double achievableRateMax = 0.0;
@@ -1145,45 +1106,12 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
               if ((m_ffrSapProvider->IsDlRbgAvailableForUe (k, (*itMax).first)) == false)
                 continue;
 
-              std::vector <uint8_t> sbCqi;
-              if (itCqi == m_a30CqiRxed.end ())
-                {
-                  for (uint8_t k = 0; k < nLayer; k++)
-                    {
-                      sbCqi.push_back (1);  // start with lowest value
-                    }
-                }
-              else
-                {
-                  sbCqi = (*itCqi).second.m_higherLayerSelected.at (k).m_sbCqi;
-                }
-              uint8_t cqi1 = sbCqi.at (0);
-              uint8_t cqi2 = 0;
-              if (sbCqi.size () > 1)
-                {
-                  cqi2 = sbCqi.at (1);
-                }
-
-              if ((cqi1 > 0)||(cqi2 > 0)) // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
+              if (FfMacDlCandidates::IsCqiInRange (*candidateMax, k)) // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
                 {
-                  if (LcActivePerFlow ((*itMax).first) > 0)
+                  if (candidateMax->lcActive)
                     {
                       // this UE has data to transmit
-	              double achievableRate = 0.0;
-                      for (uint8_t j = 0; j < nLayer; j++) 
-                        {
-                          uint8_t mcs = 0; 
-                          if (sbCqi.size () > j)
-                            {                       
-                              mcs = m_amc->GetMcsFromCqi (sbCqi.at (j));
-                            }
-                          else
-                            {
-                              // no info on this subband -> worst MCS
-                              mcs = 0;
-                            }
-                          achievableRate += ((m_amc->GetDlTbSizeFromMcs (mcs, rbgSize) / 8) / 0.001); // = TB size / TTI
-                        }
+                      double achievableRate = m_dlCandidates.GetAchievableRate (*candidateMax, k);
 
                       if ( achievableRate > achievableRateMax )
                         {
@@ -1228,19 +1156,19 @@ FdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
 
           // calculate tb size
           std::vector <uint8_t> worstCqi (2, 15);
-          if (itCqi != m_a30CqiRxed.end ())
+          if (candidateMax->sbMeas != 0)
             {
               for (uint16_t k = 0; k < (*itMap).second.size (); k++)
                 {
-                  if ((*itCqi).second.m_higherLayerSelected.size () > (*itMap).second.at (k))
+                  if (candidateMax->sbMeas->m_higherLayerSelected.size () > (*itMap).second.at (k))
                     {
                       for (uint8_t j = 0; j < nLayer; j++) 
                         {
-                          if ((*itCqi).second.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.size () > j)
+                          if (candidateMax->sbMeas->m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.size () > j)
                             {
-                              if (((*itCqi).second.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.at (j)) < worstCqi.at (j))
+                              if ((candidateMax->sbMeas->m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.at (j)) < worstCqi.at (j))
                                 {
-                                  worstCqi.at (j) = ((*itCqi).second.m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.at (j));
+                                  worstCqi.at (j) = (candidateMax->sbMeas->m_higherLayerSelected.at ((*itMap).second.at (k)).m_sbCqi.at (j));
                                 }
                             }
                           else
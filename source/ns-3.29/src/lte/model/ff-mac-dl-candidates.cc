@@ -0,0 +1,235 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ff-mac-dl-candidates.h"
+#include <ns3/lte-amc.h>
+#include <ns3/log.h>
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FfMacDlCandidates");
+
+/// Orders the candidates by RNTI
+static bool
+CandidateRntiLess (const FfMacDlCandidate& candidate, uint16_t rnti)
+{
+  return candidate.rnti < rnti;
+}
+
+FfMacDlCandidates::FfMacDlCandidates ()
+  : m_rbgSize (0)
+{
+}
+
+void
+FfMacDlCandidates::Start (Ptr<LteAmc> amc, int rbgSize)
+{
+  NS_LOG_FUNCTION (this << amc << rbgSize);
+  m_candidates.clear ();
+  if (amc == m_amc && rbgSize == m_rbgSize)
+    {
+      return;
+    }
+  m_amc = amc;
+  m_rbgSize = rbgSize;
+  m_mcsRate.resize (29);
+  for (uint8_t mcs = 0; mcs < 29; mcs++)
+    {
+      m_mcsRate[mcs] = (m_amc->GetDlTbSizeFromMcs (mcs, rbgSize) / 8) / 0.001;
+    }
+  m_cqiMcs.resize (16);
+  for (uint8_t cqi = 0; cqi < 16; cqi++)
+    {
+      m_cqiMcs[cqi] = m_amc->GetMcsFromCqi (cqi);
+    }
+}
+
+FfMacDlCandidate&
+FfMacDlCandidates::Add (uint16_t rnti, bool allocated, bool harqAvailable,
+                        const std::map <uint16_t, uint8_t>& txModes,
+                        const std::map <uint16_t, SbMeasResult_s>& a30Cqis,
+                        const RlcBufferMap& rlcBuffers)
+{
+  NS_ASSERT_MSG (m_candidates.empty () || m_candidates.back ().rnti < rnti,
+                 "Candidates must be added in increasing RNTI order");
+  FfMacDlCandidate candidate;
+  candidate.rnti = rnti;
+  candidate.allocated = allocated;
+  candidate.harqAvailable = harqAvailable;
+  std::map <uint16_t, uint8_t>::const_iterator itTxMode = txModes.find (rnti);
+  candidate.txModeKnown = itTxMode != txModes.end ();
+  candidate.nLayer = candidate.txModeKnown ? TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second) : 0;
+  candidate.lcActive = CountActiveLcs (rlcBuffers, rnti) > 0;
+  std::map <uint16_t, SbMeasResult_s>::const_iterator itCqi = a30Cqis.find (rnti);
+  candidate.sbMeas = itCqi != a30Cqis.end () ? &(*itCqi).second : 0;
+  candidate.selected = false;
+  candidate.metric = 0.0;
+  m_candidates.push_back (candidate);
+  return m_candidates.back ();
+}
+
+uint32_t
+FfMacDlCandidates::GetN () const
+{
+  return m_candidates.size ();
+}
+
+FfMacDlCandidate&
+FfMacDlCandidates::Get (uint32_t i)
+{
+  return m_candidates[i];
+}
+
+FfMacDlCandidate*
+FfMacDlCandidates::Find (uint16_t rnti)
+{
+  std::vector <FfMacDlCandidate>::iterator it = std::lower_bound (m_candidates.begin (), m_candidates.end (), rnti, CandidateRntiLess);
+  if (it == m_candidates.end () || (*it).rnti != rnti)
+    {
+      return 0;
+    }
+  return &(*it);
+}
+
+const std::vector <uint8_t>*
+FfMacDlCandidates::GetSbCqi (const FfMacDlCandidate& candidate, int rbg)
+{
+  if (candidate.sbMeas == 0)
+    {
+      return 0;
+    }
+  return &candidate.sbMeas->m_higherLayerSelected.at (rbg).m_sbCqi;
+}
+
+bool
+FfMacDlCandidates::IsCqiInRange (const FfMacDlCandidate& candidate, int rbg)
+{
+  const std::vector <uint8_t>* sbCqi = GetSbCqi (candidate, rbg);
+  if (sbCqi == 0)
+    {
+      // start with lowest value
+      return candidate.nLayer > 0;
+    }
+  uint8_t cqi1 = sbCqi->at (0);
+  uint8_t cqi2 = sbCqi->size () > 1 ? sbCqi->at (1) : 0;
+  return (cqi1 > 0) || (cqi2 > 0);
+}
+
+uint8_t
+FfMacDlCandidates::GetSbCqiSum (const FfMacDlCandidate& candidate, int rbg)
+{
+  if (!IsCqiInRange (candidate, rbg))
+    {
+      return 0;
+    }
+  const std::vector <uint8_t>* sbCqi = GetSbCqi (candidate, rbg);
+  uint8_t sum = 0;
+  for (uint8_t k = 0; k < candidate.nLayer; k++)
+    {
+      if (sbCqi == 0)
+        {
+          sum += 1;
+        }
+      else if (sbCqi->size () > k)
+        {
+          sum += sbCqi->at (k);
+        }
+    }
+  return sum;
+}
+
+uint8_t
+FfMacDlCandidates::GetCqiSum (const FfMacDlCandidate& candidate, int rbgNum)
+{
+  uint8_t cqiSum = 0;
+  for (int k = 0; k < rbgNum; k++)
+    {
+      for (uint8_t j = 0; j < candidate.nLayer; j++)
+        {
+          if (candidate.sbMeas == 0)
+            {
+              cqiSum += 1;  // no info on this user -> lowest MCS
+            }
+          else
+            {
+              cqiSum += candidate.sbMeas->m_higherLayerSelected.at (k).m_sbCqi.at (j);
+            }
+        }
+    }
+  return cqiSum;
+}
+
+double
+FfMacDlCandidates::GetAchievableRate (const FfMacDlCandidate& candidate, int rbg) const
+{
+  const std::vector <uint8_t>* sbCqi = GetSbCqi (candidate, rbg);
+  double achievableRate = 0.0;
+  for (uint8_t k = 0; k < candidate.nLayer; k++)
+    {
+      uint8_t mcs = 0;
+      if (sbCqi == 0)
+        {
+          mcs = GetMcs (1);
+        }
+      else if (sbCqi->size () > k)
+        {
+          mcs = GetMcs (sbCqi->at (k));
+        }
+      else
+        {
+          // no info on this subband -> worst MCS
+          mcs = 0;
+        }
+      achievableRate += m_mcsRate[mcs];
+    }
+  return achievableRate;
+}
+
+double
+FfMacDlCandidates::GetMcsRate (uint8_t mcs) const
+{
+  return m_mcsRate.at (mcs);
+}
+
+uint8_t
+FfMacDlCandidates::GetMcs (uint8_t cqi) const
+{
+  NS_ASSERT_MSG (cqi <= 15, "CQI must be in [0..15] = " << (uint32_t) cqi);
+  return m_cqiMcs[cqi];
+}
+
+unsigned int
+FfMacDlCandidates::CountActiveLcs (const RlcBufferMap& rlcBuffers, uint16_t rnti)
+{
+  unsigned int lcActive = 0;
+  for (RlcBufferMap::const_iterator it = rlcBuffers.lower_bound (LteFlowId_t (rnti, 0)); it != rlcBuffers.end (); it++)
+    {
+      if ((*it).first.m_rnti > rnti)
+        {
+          break;
+        }
+      if (((*it).second.m_rlcTransmissionQueueSize > 0)
+          || ((*it).second.m_rlcRetransmissionQueueSize > 0)
+          || ((*it).second.m_rlcStatusPduSize > 0))
+        {
+          lcActive++;
+        }
+    }
+  return lcActive;
+}
+
+} // namespace ns3
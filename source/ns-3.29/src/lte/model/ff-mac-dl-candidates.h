@@ -0,0 +1,182 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FF_MAC_DL_CANDIDATES_H
+#define FF_MAC_DL_CANDIDATES_H
+
+#include <ns3/ptr.h>
+#include <ns3/lte-common.h>
+#include <ns3/ff-mac-common.h>
+#include <ns3/ff-mac-sched-sap.h>
+#include <vector>
+#include <map>
+
+namespace ns3 {
+
+class LteAmc;
+
+/**
+ * \ingroup lte
+ *
+ * \brief The state of a UE during the DL RBG allocation of a TTI
+ */
+struct FfMacDlCandidate
+{
+  uint16_t rnti; ///< the RNTI of the UE
+  bool allocated; ///< whether the UE is already allocated for a HARQ retransmission
+  bool harqAvailable; ///< whether a HARQ process is available
+  bool txModeKnown; ///< whether the transmission mode of the UE is known
+  uint8_t nLayer; ///< the number of layers, 0 if the transmission mode is unknown
+  bool lcActive; ///< whether the UE has data to transmit
+  const SbMeasResult_s* sbMeas; ///< the subband CQIs, 0 if none was received
+  bool selected; ///< scratch flag of the scheduler
+  double metric; ///< scratch metric of the scheduler
+};
+
+/**
+ * \ingroup lte
+ *
+ * \brief The UEs which a FF MAC scheduler considers for the allocation of
+ * the DL RBGs of a TTI
+ *
+ * The state of a UE does not change during the RBG allocation of a TTI,
+ * so the schedulers look it up once per TTI here, in a flat array, rather
+ * than in their maps once per RBG and UE. The array keeps its storage
+ * across the TTIs, and so do the tables of the achievable rates, which
+ * are only rebuilt when the AMC or the RBG size change.
+ */
+class FfMacDlCandidates
+{
+public:
+  /// The RLC buffer status reports of the scheduler, per flow
+  typedef std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters> RlcBufferMap;
+
+  FfMacDlCandidates ();
+
+  /**
+   * Forget the candidates of the previous TTI
+   *
+   * \param amc the AMC of the scheduler
+   * \param rbgSize the number of RBs of an RBG
+   */
+  void Start (Ptr<LteAmc> amc, int rbgSize);
+
+  /**
+   * Add a candidate. The candidates must be added in increasing RNTI
+   * order.
+   *
+   * \param rnti the RNTI of the UE
+   * \param allocated whether the UE is already allocated for a HARQ retransmission
+   * \param harqAvailable whether a HARQ process is available
+   * \param txModes the transmission modes of the UEs
+   * \param a30Cqis the subband CQIs of the UEs
+   * \param rlcBuffers the RLC buffer status reports
+   * \return the new candidate
+   */
+  FfMacDlCandidate& Add (uint16_t rnti, bool allocated, bool harqAvailable,
+                         const std::map <uint16_t, uint8_t>& txModes,
+                         const std::map <uint16_t, SbMeasResult_s>& a30Cqis,
+                         const RlcBufferMap& rlcBuffers);
+
+  /**
+   * \return the number of candidates
+   */
+  uint32_t GetN () const;
+
+  /**
+   * \param i the index of a candidate, in the order they were added
+   * \return the candidate
+   */
+  FfMacDlCandidate& Get (uint32_t i);
+
+  /**
+   * \param rnti the RNTI of a UE
+   * \return the candidate of the UE, 0 if the UE is not a candidate
+   */
+  FfMacDlCandidate* Find (uint16_t rnti);
+
+  /**
+   * \param candidate a candidate
+   * \param rbg the index of an RBG
+   * \return the subband CQIs of the RBG, 0 if no CQI was received
+   */
+  static const std::vector <uint8_t>* GetSbCqi (const FfMacDlCandidate& candidate, int rbg);
+
+  /**
+   * \param candidate a candidate
+   * \param rbg the index of an RBG
+   * \return whether the CQI of the first or the second layer of the RBG
+   * is in range (CQI == 0 means "out of range", see table 7.2.3-1 of
+   * 36.213); the lowest CQI is assumed if no CQI was received
+   */
+  static bool IsCqiInRange (const FfMacDlCandidate& candidate, int rbg);
+
+  /**
+   * \param candidate a candidate
+   * \param rbg the index of an RBG
+   * \return the sum over the layers of the subband CQIs of the RBG, 0 for
+   * the layers without information, the lowest CQI if no CQI was received
+   */
+  static uint8_t GetSbCqiSum (const FfMacDlCandidate& candidate, int rbg);
+
+  /**
+   * \param candidate a candidate
+   * \param rbgNum the number of RBGs
+   * \return the sum over all the RBGs and layers of the subband CQIs, the
+   * lowest CQI if no CQI was received; like in the schedulers, the sum is
+   * kept in 8 bits
+   */
+  static uint8_t GetCqiSum (const FfMacDlCandidate& candidate, int rbgNum);
+
+  /**
+   * \param candidate a candidate
+   * \param rbg the index of an RBG
+   * \return the achievable rate of the candidate on the RBG (= TB size / TTI)
+   */
+  double GetAchievableRate (const FfMacDlCandidate& candidate, int rbg) const;
+
+  /**
+   * \param mcs an MCS
+   * \return the achievable rate of a layer of an RBG with this MCS
+   */
+  double GetMcsRate (uint8_t mcs) const;
+
+  /**
+   * \param cqi a CQI
+   * \return the MCS of the CQI
+   */
+  uint8_t GetMcs (uint8_t cqi) const;
+
+  /**
+   * Count the active logical channels of a UE
+   *
+   * \param rlcBuffers the RLC buffer status reports
+   * \param rnti the RNTI of the UE
+   * \return the number of logical channels of the UE with data to transmit
+   */
+  static unsigned int CountActiveLcs (const RlcBufferMap& rlcBuffers, uint16_t rnti);
+
+private:
+  std::vector <FfMacDlCandidate> m_candidates; ///< the candidates of the TTI
+  Ptr<LteAmc> m_amc; ///< the AMC the tables were built with
+  int m_rbgSize; ///< the RBG size the tables were built with
+  std::vector <double> m_mcsRate; ///< achievable rate of a layer of an RBG for each MCS
+  std::vector <uint8_t> m_cqiMcs; ///< MCS of each CQI
+};
+
+} // namespace ns3
+
+#endif /* FF_MAC_DL_CANDIDATES_H */
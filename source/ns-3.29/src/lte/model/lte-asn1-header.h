@@ -25,6 +25,7 @@
 
 #include <bitset>
 #include <string>
+#include <vector>
 
 namespace ns3 {
 
@@ -68,7 +69,7 @@ protected:
   mutable uint8_t m_serializationPendingBits; //!< pending bits
   mutable uint8_t m_numSerializationPendingBits; //!< number of pending bits
   mutable bool m_isDataSerialized; //!< true if data is serialized
-  mutable Buffer m_serializationResult; //!< serialization result
+  mutable std::vector<uint8_t> m_serializationResult; //!< serialization result
 
   /**
    * Function to write in m_serializationResult, after resizing its size
@@ -78,6 +79,15 @@ protected:
 
   // Serialization functions
 
+  /**
+   * Serialize the least significant bits of a value, most significant
+   * bit first. The bits are appended to the pending bits an octet at a
+   * time, rather than bit by bit.
+   * \param value value to serialize
+   * \param numBits number of bits to serialize, at most 32
+   */
+  void SerializeBits (uint32_t value, int numBits) const;
+
   /**
    * Serialize a bool
    * \param value value to serialize
@@ -263,6 +273,17 @@ protected:
 
   // Deserialization functions
 
+  /**
+   * Deserialize a value, most significant bit first, reading the buffer
+   * an octet at a time
+   * \param value buffer to store the result
+   * \param numBits number of bits to deserialize, at most 32
+   * \param bIterator buffer iterator
+   * \returns the modified buffer iterator
+   */
+  Buffer::Iterator DeserializeBits (uint32_t *value, int numBits,
+                                    Buffer::Iterator bIterator);
+
   /**
    * Deserialize a bitset
    * \param data buffer to store the result
@@ -0,0 +1,166 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "lte-pathloss-cache.h"
+#include <ns3/log.h>
+#include <ns3/mobility-model.h>
+#include <ns3/constant-acceleration-mobility-model.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LtePathlossCache");
+
+NS_OBJECT_ENSURE_REGISTERED (LtePathlossCache);
+
+TypeId
+LtePathlossCache::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LtePathlossCache")
+    .SetParent<PropagationLossModel> ()
+    .SetGroupName ("Lte")
+    .AddConstructor<LtePathlossCache> ()
+  ;
+  return tid;
+}
+
+LtePathlossCache::LtePathlossCache ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LtePathlossCache::~LtePathlossCache ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+LtePathlossCache::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::map<const MobilityModel *, Endpoint>::iterator it = m_endpoints.begin (); it != m_endpoints.end (); ++it)
+    {
+      it->second.mobility->TraceDisconnectWithoutContext ("CourseChange",
+                                                          MakeCallback (&LtePathlossCache::CourseChanged, this));
+    }
+  m_endpoints.clear ();
+  m_model = 0;
+  PropagationLossModel::DoDispose ();
+}
+
+void
+LtePathlossCache::SetPathlossModel (Ptr<PropagationLossModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  m_model = model;
+  Flush ();
+}
+
+Ptr<PropagationLossModel>
+LtePathlossCache::GetPathlossModel (void) const
+{
+  return m_model;
+}
+
+void
+LtePathlossCache::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::map<const MobilityModel *, Endpoint>::iterator it = m_endpoints.begin (); it != m_endpoints.end (); ++it)
+    {
+      it->second.gains.clear ();
+    }
+}
+
+double
+LtePathlossCache::DoCalcRxPower (double txPowerDbm,
+                                 Ptr<MobilityModel> a,
+                                 Ptr<MobilityModel> b) const
+{
+  NS_ASSERT_MSG (m_model != 0, "No pathloss model to cache");
+  Endpoint &endpointA = GetEndpoint (a);
+  Endpoint &endpointB = GetEndpoint (b);
+  if (endpointA.moving || endpointB.moving)
+    {
+      return m_model->CalcRxPower (txPowerDbm, a, b);
+    }
+  std::map<const MobilityModel *, double>::const_iterator it = endpointA.gains.find (PeekPointer (b));
+  if (it != endpointA.gains.end ())
+    {
+      return txPowerDbm + it->second;
+    }
+  double gain = m_model->CalcRxPower (0, a, b);
+  NS_LOG_LOGIC ("caching the gain " << gain << " dB of " << a << " and " << b);
+  endpointA.gains[PeekPointer (b)] = gain;
+  endpointB.gains[PeekPointer (a)] = gain;
+  return txPowerDbm + gain;
+}
+
+int64_t
+LtePathlossCache::DoAssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  if (m_model == 0)
+    {
+      return 0;
+    }
+  return m_model->AssignStreams (stream);
+}
+
+LtePathlossCache::Endpoint &
+LtePathlossCache::GetEndpoint (Ptr<MobilityModel> mobility) const
+{
+  std::map<const MobilityModel *, Endpoint>::iterator it = m_endpoints.find (PeekPointer (mobility));
+  if (it != m_endpoints.end ())
+    {
+      return it->second;
+    }
+  Endpoint &endpoint = m_endpoints[PeekPointer (mobility)];
+  endpoint.mobility = mobility;
+  endpoint.moving = IsMoving (mobility);
+  mobility->TraceConnectWithoutContext ("CourseChange",
+                                        MakeCallback (&LtePathlossCache::CourseChanged, this));
+  return endpoint;
+}
+
+void
+LtePathlossCache::CourseChanged (Ptr<const MobilityModel> mobility) const
+{
+  NS_LOG_FUNCTION (this << mobility);
+  std::map<const MobilityModel *, Endpoint>::iterator it = m_endpoints.find (PeekPointer (mobility));
+  NS_ASSERT (it != m_endpoints.end ());
+  Endpoint &endpoint = it->second;
+  for (std::map<const MobilityModel *, double>::const_iterator peer = endpoint.gains.begin (); peer != endpoint.gains.end (); ++peer)
+    {
+      if (peer->first != PeekPointer (mobility))
+        {
+          m_endpoints[peer->first].gains.erase (PeekPointer (mobility));
+        }
+    }
+  endpoint.gains.clear ();
+  endpoint.moving = IsMoving (mobility);
+}
+
+bool
+LtePathlossCache::IsMoving (Ptr<const MobilityModel> mobility)
+{
+  Vector velocity = mobility->GetVelocity ();
+  // the velocity of a ConstantAccelerationMobilityModel changes without
+  // course change notifications
+  return velocity.x != 0 || velocity.y != 0 || velocity.z != 0
+         || DynamicCast<const ConstantAccelerationMobilityModel> (mobility) != 0;
+}
+
+} // namespace ns3
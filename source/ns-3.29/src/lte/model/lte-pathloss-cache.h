@@ -0,0 +1,117 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LTE_PATHLOSS_CACHE_H
+#define LTE_PATHLOSS_CACHE_H
+
+#include <map>
+#include <ns3/propagation-loss-model.h>
+
+namespace ns3 {
+
+class MobilityModel;
+
+/**
+ * \ingroup lte
+ *
+ * \brief Caches the gain of a pathloss model for each pair of mobility
+ * models
+ *
+ * The gain of a pair is computed once with a 0 dBm tx power, and reused in
+ * both directions until the "CourseChange" trace source of the mobility
+ * model of either end fires. The pairs with an end which has a non-null
+ * velocity are not cached, since its position changes without
+ * notifications.
+ *
+ * The cache is keyed by mobility model, so that all the PHYs of a node,
+ * e.g. the PHYs of the component carriers of an eNB or a UE, share its
+ * entries. It is only valid with a pathloss model which is deterministic
+ * for a given position of the ends, whose loss does not depend on the tx
+ * power, and which is reciprocal. It is set up by the LteHelper when its
+ * CachePathloss attribute is true.
+ */
+class LtePathlossCache : public PropagationLossModel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  LtePathlossCache ();
+  virtual ~LtePathlossCache ();
+
+  /**
+   * Set the cached pathloss model, and flush the cache
+   *
+   * \param model the pathloss model
+   */
+  void SetPathlossModel (Ptr<PropagationLossModel> model);
+  /**
+   * \return the cached pathloss model
+   */
+  Ptr<PropagationLossModel> GetPathlossModel (void) const;
+  /**
+   * Flush the cache, e.g. after a change of the attributes of the pathloss
+   * model
+   */
+  void Flush (void);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
+
+  /// The cache state of a mobility model
+  struct Endpoint
+  {
+    Ptr<MobilityModel> mobility; ///< the mobility model
+    bool moving; ///< whether the mobility model has a non-null velocity
+    std::map<const MobilityModel *, double> gains; ///< the gain to each cached peer, in dB
+  };
+
+  /**
+   * Get the cache state of a mobility model, tracking its course changes
+   * when it is first seen
+   *
+   * \param mobility the mobility model
+   * \return the cache state of the mobility model
+   */
+  Endpoint & GetEndpoint (Ptr<MobilityModel> mobility) const;
+  /**
+   * Invalidate the cached gains of a mobility model
+   *
+   * \param mobility the mobility model whose course changed
+   */
+  void CourseChanged (Ptr<const MobilityModel> mobility) const;
+  /**
+   * \param mobility the mobility model
+   * \return whether the mobility model has a non-null velocity
+   */
+  static bool IsMoving (Ptr<const MobilityModel> mobility);
+
+  Ptr<PropagationLossModel> m_model; ///< the cached pathloss model
+  mutable std::map<const MobilityModel *, Endpoint> m_endpoints; ///< the cache state of the mobility models seen
+};
+
+} // namespace ns3
+
+#endif /* LTE_PATHLOSS_CACHE_H */
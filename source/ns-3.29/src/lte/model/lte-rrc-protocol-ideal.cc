@@ -177,13 +177,13 @@ LteUeRrcProtocolIdeal::SetEnbRrcSapProvider ()
 
   // walk list of all nodes to get the peer eNB
   Ptr<LteEnbNetDevice> enbDev;
-  NodeList::Iterator listEnd = NodeList::End ();
+  NodeList::PeekIterator listEnd = NodeList::PeekEnd ();
   bool found = false;
-  for (NodeList::Iterator i = NodeList::Begin (); 
+  for (NodeList::PeekIterator i = NodeList::PeekBegin (); 
        (i != listEnd) && (!found); 
        ++i)
     {
-      Ptr<Node> node = *i;
+      Node *node = *i;
       int nDevs = node->GetNDevices ();
       for (int j = 0; 
            (j < nDevs) && (!found);
@@ -334,9 +334,9 @@ LteEnbRrcProtocolIdeal::DoSendSystemInformation (uint16_t cellId, LteRrcSap::Sys
   NS_LOG_FUNCTION (this << cellId);
   // walk list of all nodes to get UEs with this cellId
   Ptr<LteUeRrc> ueRrc;
-  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
+  for (NodeList::PeekIterator i = NodeList::PeekBegin (); i != NodeList::PeekEnd (); ++i)
     {
-      Ptr<Node> node = *i;
+      Node *node = *i;
       int nDevs = node->GetNDevices ();
       for (int j = 0; j < nDevs; ++j)
         {
@@ -0,0 +1,187 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "lte-subframe-batch.h"
+#include <ns3/core-config.h>
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/simulation-singleton.h>
+#include <ns3/global-value.h>
+#include <ns3/uinteger.h>
+#ifdef HAVE_PTHREAD_H
+#include <ns3/system-thread.h>
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LteSubframeBatch");
+
+/**
+ * \ingroup lte
+ * The number of threads computing the jobs of the LTE PHYs
+ */
+static GlobalValue g_lteSubframeThreads ("LteSubframeThreads",
+                                         "The number of threads, including the simulation thread, "
+                                         "which compute the jobs the LTE PHYs post at the same time "
+                                         "(e.g., the UE CQI feedbacks). 0 computes them in place.",
+                                         UintegerValue (0),
+                                         MakeUintegerChecker<uint32_t> ());
+
+LteSubframeBatch::LteSubframeBatch ()
+{
+  NS_LOG_FUNCTION (this);
+  UintegerValue nThreads;
+  g_lteSubframeThreads.GetValue (nThreads);
+  m_nThreads = nThreads.Get ();
+
+#ifdef HAVE_PTHREAD_H
+  m_flushes = 0;
+  m_busyWorkers = 0;
+  m_stop = false;
+  for (uint32_t k = 1; k < m_nThreads; k++)
+    {
+      Ptr<SystemThread> worker = Create<SystemThread> (MakeCallback (&LteSubframeBatch::Work, this).Bind (k));
+      worker->Start ();
+      m_workers.push_back (worker);
+    }
+#endif
+}
+
+LteSubframeBatch::~LteSubframeBatch ()
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_stop = true;
+  }
+  m_start.notify_all ();
+  for (std::vector<Ptr<SystemThread> >::iterator it = m_workers.begin (); it != m_workers.end (); ++it)
+    {
+      (*it)->Join ();
+    }
+#endif
+}
+
+bool
+LteSubframeBatch::IsEnabled (void)
+{
+  return SimulationSingleton<LteSubframeBatch>::Get ()->m_nThreads > 0;
+}
+
+void
+LteSubframeBatch::Post (Callback<void> compute, Callback<void> apply)
+{
+  SimulationSingleton<LteSubframeBatch>::Get ()->DoPost (compute, apply);
+}
+
+void
+LteSubframeBatch::DoPost (Callback<void> compute, Callback<void> apply)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (m_nThreads > 0, "Jobs posted while LteSubframeThreads is 0");
+  if (m_jobs.empty ())
+    {
+      Simulator::ScheduleWithContext (Simulator::NO_CONTEXT, Seconds (0),
+                                      &LteSubframeBatch::Flush, this);
+    }
+  Job job;
+  job.compute = compute;
+  job.apply = apply;
+  m_jobs.push_back (job);
+}
+
+void
+LteSubframeBatch::Compute (uint32_t first)
+{
+  NS_ASSERT (m_nThreads > 0);
+  for (uint32_t i = first; i < m_running.size (); i += m_nThreads)
+    {
+      m_running[i].compute ();
+    }
+}
+
+#ifdef HAVE_PTHREAD_H
+void
+LteSubframeBatch::Work (uint32_t first)
+{
+  uint64_t flushes = 0;
+  std::unique_lock<std::mutex> lock (m_mutex);
+  while (true)
+    {
+      while (!m_stop && m_flushes == flushes)
+        {
+          m_start.wait (lock);
+        }
+      if (m_stop)
+        {
+          return;
+        }
+      flushes = m_flushes;
+      lock.unlock ();
+      Compute (first);
+      lock.lock ();
+      if (--m_busyWorkers == 0)
+        {
+          m_done.notify_one ();
+        }
+    }
+}
+#endif
+
+void
+LteSubframeBatch::Flush (void)
+{
+  NS_LOG_FUNCTION (this << m_jobs.size ());
+  m_running.swap (m_jobs);
+
+#ifdef HAVE_PTHREAD_H
+  if (m_running.size () > 1 && !m_workers.empty ())
+    {
+      // the mutex also publishes the jobs to the workers, and their
+      // results back to the simulation thread
+      {
+        std::lock_guard<std::mutex> lock (m_mutex);
+        m_busyWorkers = m_workers.size ();
+        m_flushes++;
+      }
+      m_start.notify_all ();
+      Compute (0);
+      std::unique_lock<std::mutex> lock (m_mutex);
+      while (m_busyWorkers > 0)
+        {
+          m_done.wait (lock);
+        }
+    }
+  else
+    {
+      Compute (0);
+    }
+#else
+  for (std::vector<Job>::iterator it = m_running.begin (); it != m_running.end (); ++it)
+    {
+      it->compute ();
+    }
+#endif
+
+  for (std::vector<Job>::iterator it = m_running.begin (); it != m_running.end (); ++it)
+    {
+      it->apply ();
+    }
+  m_running.clear ();
+}
+
+} // namespace ns3
@@ -0,0 +1,130 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LTE_SUBFRAME_BATCH_H
+#define LTE_SUBFRAME_BATCH_H
+
+#include <vector>
+#include <ns3/core-config.h>
+#include <ns3/callback.h>
+#include <ns3/ptr.h>
+
+#ifdef HAVE_PTHREAD_H
+#include <mutex>
+#include <condition_variable>
+#endif /* HAVE_PTHREAD_H */
+
+namespace ns3 {
+
+class SystemThread;
+
+/**
+ * \ingroup lte
+ *
+ * \brief Runs on several threads the work the LTE PHYs of the different
+ * cells post at the same simulation time
+ *
+ * All the UEs compute their CQI feedbacks at the end of the DL control
+ * region of the same subframe, from SINRs which only depend on their own
+ * cell. Each job is split in two parts:
+ *   - the compute part, run on a worker thread, which may only read the
+ *     simulation state and write the job's own output;
+ *   - the apply part, run afterwards in the simulation thread, in the
+ *     order the jobs were posted, which publishes the output (e.g., sends
+ *     the control messages).
+ *
+ * The jobs posted at the same time are run by an event scheduled with
+ * Simulator::ScheduleNow, i.e., after the events already scheduled at
+ * that time. The results are thus the same whatever the number of
+ * threads.
+ *
+ * The number of threads is set by the "LteSubframeThreads" global value,
+ * read when the batch is first used in a simulation. With 0 (the
+ * default), the batch is disabled and the PHYs run their jobs in place.
+ * The worker threads are started along with the batch and live until the
+ * end of the simulation: each flush only wakes them up and waits for them
+ * to finish their share. Without thread support, the jobs are posted but
+ * run in the simulation thread.
+ */
+class LteSubframeBatch
+{
+public:
+  LteSubframeBatch ();
+  ~LteSubframeBatch ();
+
+  /**
+   * \return true if the PHYs should post their jobs to the batch
+   */
+  static bool IsEnabled (void);
+
+  /**
+   * Post a job, run with the other jobs posted at the same simulation time
+   *
+   * \param compute the part run on a worker thread
+   * \param apply the part run in the simulation thread
+   */
+  static void Post (Callback<void> compute, Callback<void> apply);
+
+private:
+  /// A posted job
+  struct Job
+  {
+    Callback<void> compute; ///< the part run on a worker thread
+    Callback<void> apply; ///< the part run in the simulation thread
+  };
+
+  /**
+   * Post a job
+   *
+   * \param compute the part run on a worker thread
+   * \param apply the part run in the simulation thread
+   */
+  void DoPost (Callback<void> compute, Callback<void> apply);
+  /// Run the jobs posted at the current simulation time
+  void Flush (void);
+  /**
+   * Run the compute part of a share of the jobs being flushed
+   *
+   * \param first the index of the first job of the share
+   */
+  void Compute (uint32_t first);
+
+  uint32_t m_nThreads; ///< the number of threads, including the simulation thread
+  std::vector<Job> m_jobs; ///< the jobs posted since the last flush
+  std::vector<Job> m_running; ///< the jobs being flushed
+
+#ifdef HAVE_PTHREAD_H
+  /**
+   * Entry point of a worker thread: compute its share of every flush
+   * until the batch is destroyed
+   *
+   * \param first the index of the first job of the share of the worker
+   */
+  void Work (uint32_t first);
+
+  std::vector<Ptr<SystemThread> > m_workers; ///< the worker threads
+  std::mutex m_mutex; ///< protects the fields below
+  std::condition_variable m_start; ///< notified when a flush starts or the batch is destroyed
+  std::condition_variable m_done; ///< notified when the last worker is done with a flush
+  uint64_t m_flushes; ///< the number of flushes started on the workers
+  uint32_t m_busyWorkers; ///< the number of workers still computing the current flush
+  bool m_stop; ///< tells the workers to exit
+#endif /* HAVE_PTHREAD_H */
+};
+
+} // namespace ns3
+
+#endif /* LTE_SUBFRAME_BATCH_H */
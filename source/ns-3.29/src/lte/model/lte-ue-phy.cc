@@ -28,6 +28,7 @@
 #include <ns3/simulator.h>
 #include <ns3/double.h>
 #include "lte-ue-phy.h"
+#include "lte-subframe-batch.h"
 #include "lte-enb-phy.h"
 #include "lte-net-device.h"
 #include "lte-ue-net-device.h"
@@ -494,23 +495,13 @@ LteUePhy::GenerateCqiRsrpRsrq (const SpectrumValue& sinr)
       // check periodic wideband CQI
       if (Simulator::Now () > m_p10CqiLast + m_p10CqiPeriodicity)
         {
-          Ptr<LteUeNetDevice> thisDevice = GetDevice ()->GetObject<LteUeNetDevice> ();
-          Ptr<DlCqiLteControlMessage> msg = CreateDlCqiFeedbackMessage (sinr);
-          if (msg)
-            {
-              DoSendLteControlMessage (msg);
-            }
+          SendDlCqiFeedback (sinr);
           m_p10CqiLast = Simulator::Now ();
         }
       // check aperiodic high-layer configured subband CQI
       if  (Simulator::Now () > m_a30CqiLast + m_a30CqiPeriodicity)
         {
-          Ptr<LteUeNetDevice> thisDevice = GetDevice ()->GetObject<LteUeNetDevice> ();
-          Ptr<DlCqiLteControlMessage> msg = CreateDlCqiFeedbackMessage (sinr);
-          if (msg)
-            {
-              DoSendLteControlMessage (msg);
-            }
+          SendDlCqiFeedback (sinr);
           m_a30CqiLast = Simulator::Now ();
         }
     }
@@ -705,21 +696,62 @@ LteUePhy::CreateDlCqiFeedbackMessage (const SpectrumValue& sinr)
 {
   NS_LOG_FUNCTION (this);
 
+  DlCqiReport report;
+  if (!PrepareDlCqiReport (sinr, report))
+    {
+      return Create<DlCqiLteControlMessage> ();
+    }
+  ComputeDlCqiReport (report);
+  return BuildDlCqiFeedbackMessage (report);
+}
+
+bool
+LteUePhy::PrepareDlCqiReport (const SpectrumValue& sinr, DlCqiReport& report) const
+{
+  NS_LOG_FUNCTION (this);
+
+  if (Simulator::Now () > m_p10CqiLast + m_p10CqiPeriodicity)
+    {
+      report.m_type = CqiListElement_s::P10; // Peridic CQI using PUCCH wideband
+      report.m_rbgSize = m_dlBandwidth;
+    }
+  else if (Simulator::Now () > m_a30CqiLast + m_a30CqiPeriodicity)
+    {
+      report.m_type = CqiListElement_s::A30; // Aperidic CQI using PUSCH
+      report.m_rbgSize = GetRbgSize ();
+    }
+  else
+    {
+      return false;
+    }
 
   // apply transmission mode gain
   NS_ASSERT (m_transmissionMode < m_txModeGain.size ());
-  SpectrumValue newSinr = sinr;
-  newSinr *= m_txModeGain.at (m_transmissionMode);
+  report.m_sinr = sinr;
+  report.m_sinr *= m_txModeGain.at (m_transmissionMode);
+  report.m_rnti = m_rnti;
+  report.m_nLayer = TransmissionModesLayers::TxMode2LayerNum (m_transmissionMode);
+  return true;
+}
+
+void
+LteUePhy::ComputeDlCqiReport (DlCqiReport& report) const
+{
+  report.m_cqi = m_amc->CreateCqiFeedbacks (report.m_sinr, report.m_rbgSize);
+}
+
+Ptr<DlCqiLteControlMessage>
+LteUePhy::BuildDlCqiFeedbackMessage (const DlCqiReport& report) const
+{
+  NS_LOG_FUNCTION (this);
 
   // CREATE DlCqiLteControlMessage
   Ptr<DlCqiLteControlMessage> msg = Create<DlCqiLteControlMessage> ();
   CqiListElement_s dlcqi;
-  std::vector<int> cqi;
-  if (Simulator::Now () > m_p10CqiLast + m_p10CqiPeriodicity)
+  const std::vector<int> &cqi = report.m_cqi;
+  int nLayer = report.m_nLayer;
+  if (report.m_type == CqiListElement_s::P10)
     {
-      cqi = m_amc->CreateCqiFeedbacks (newSinr, m_dlBandwidth);
-
-      int nLayer = TransmissionModesLayers::TxMode2LayerNum (m_transmissionMode);
       int nbSubChannels = cqi.size ();
       double cqiSum = 0.0;
       int activeSubChannels = 0;
@@ -733,7 +765,7 @@ LteUePhy::CreateDlCqiFeedbackMessage (const SpectrumValue& sinr)
             }
           NS_LOG_DEBUG (this << " subch " << i << " cqi " <<  cqi.at (i));
         }
-      dlcqi.m_rnti = m_rnti;
+      dlcqi.m_rnti = report.m_rnti;
       dlcqi.m_ri = 1; // not yet used
       dlcqi.m_cqiType = CqiListElement_s::P10; // Peridic CQI using PUCCH wideband
       NS_ASSERT_MSG (nLayer > 0, " nLayer negative");
@@ -754,12 +786,10 @@ LteUePhy::CreateDlCqiFeedbackMessage (const SpectrumValue& sinr)
       dlcqi.m_wbPmi = 0; // not yet used
       // dl.cqi.m_sbMeasResult others CQI report modes: not yet implemented
     }
-  else if (Simulator::Now () > m_a30CqiLast + m_a30CqiPeriodicity)
+  else
     {
-      cqi = m_amc->CreateCqiFeedbacks (newSinr, GetRbgSize ());
-      int nLayer = TransmissionModesLayers::TxMode2LayerNum (m_transmissionMode);
       int nbSubChannels = cqi.size ();
-      int rbgSize = GetRbgSize ();
+      int rbgSize = report.m_rbgSize;
       double cqiSum = 0.0;
       int cqiNum = 0;
       SbMeasResult_s rbgMeas;
@@ -787,7 +817,7 @@ LteUePhy::CreateDlCqiFeedbackMessage (const SpectrumValue& sinr)
               cqiNum = 0;
             }
         }
-      dlcqi.m_rnti = m_rnti;
+      dlcqi.m_rnti = report.m_rnti;
       dlcqi.m_ri = 1; // not yet used
       dlcqi.m_cqiType = CqiListElement_s::A30; // Aperidic CQI using PUSCH
       //dlcqi.m_wbCqi.push_back ((uint16_t) cqiSum / nbSubChannels);
@@ -799,6 +829,56 @@ LteUePhy::CreateDlCqiFeedbackMessage (const SpectrumValue& sinr)
   return msg;
 }
 
+void
+LteUePhy::SendDlCqiFeedback (const SpectrumValue& sinr)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (!LteSubframeBatch::IsEnabled ())
+    {
+      Ptr<DlCqiLteControlMessage> msg = CreateDlCqiFeedbackMessage (sinr);
+      if (msg)
+        {
+          DoSendLteControlMessage (msg);
+        }
+      return;
+    }
+
+  // the CQIs of all the UEs are computed together, and the messages are
+  // sent in the order of the reports
+  DlCqiReport report;
+  if (!PrepareDlCqiReport (sinr, report))
+    {
+      return;
+    }
+  if (m_dlCqiReports.empty ())
+    {
+      LteSubframeBatch::Post (MakeCallback (&LteUePhy::ComputeDlCqiReports, this),
+                              MakeCallback (&LteUePhy::SendDlCqiReports, this));
+    }
+  m_dlCqiReports.push_back (report);
+}
+
+void
+LteUePhy::ComputeDlCqiReports (void)
+{
+  for (std::list<DlCqiReport>::iterator it = m_dlCqiReports.begin (); it != m_dlCqiReports.end (); ++it)
+    {
+      ComputeDlCqiReport (*it);
+    }
+}
+
+void
+LteUePhy::SendDlCqiReports (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::list<DlCqiReport>::const_iterator it = m_dlCqiReports.begin (); it != m_dlCqiReports.end (); ++it)
+    {
+      DoSendLteControlMessage (BuildDlCqiFeedbackMessage (*it));
+    }
+  m_dlCqiReports.clear ();
+}
+
 
 void
 LteUePhy::ReportUeMeasurements ()
@@ -371,6 +371,49 @@ private:
    */
   void GenerateCqiRsrpRsrq (const SpectrumValue& sinr);
 
+  /// A DL CQI report, whose CQIs may be computed by the LteSubframeBatch
+  struct DlCqiReport
+  {
+    CqiListElement_s::CqiType_e m_type; ///< P10 (wideband) or A30 (subband)
+    SpectrumValue m_sinr; ///< the SINR, including the transmission mode gain
+    uint16_t m_rnti; ///< the RNTI
+    int m_nLayer; ///< the number of layers
+    uint8_t m_rbgSize; ///< the number of RBs the CQIs are computed over
+    std::vector<int> m_cqi; ///< the CQI of each RB
+  };
+
+  /**
+   * Prepare a DL CQI report, whose type depends on the periodicities
+   *
+   * \param sinr the SINR values perceived from the eNB
+   * \param report the report to prepare
+   * \return false if no CQI report is due
+   */
+  bool PrepareDlCqiReport (const SpectrumValue& sinr, DlCqiReport& report) const;
+  /**
+   * Compute the CQIs of a DL CQI report. Only reads the state of the PHY,
+   * so that it can run on a worker thread.
+   *
+   * \param report the report
+   */
+  void ComputeDlCqiReport (DlCqiReport& report) const;
+  /**
+   * \param report a computed DL CQI report
+   * \return a DL CQI control message containing the report
+   */
+  Ptr<DlCqiLteControlMessage> BuildDlCqiFeedbackMessage (const DlCqiReport& report) const;
+  /**
+   * Send the DL CQI feedback, either in place or through the
+   * LteSubframeBatch
+   *
+   * \param sinr the SINR values perceived from the eNB
+   */
+  void SendDlCqiFeedback (const SpectrumValue& sinr);
+  /// Compute the CQIs of the queued DL CQI reports
+  void ComputeDlCqiReports (void);
+  /// Send the queued DL CQI reports
+  void SendDlCqiReports (void);
+
 
   /**
    * \brief Layer-1 filtering of RSRP and RSRQ measurements and reporting to
@@ -487,6 +530,8 @@ private:
   Time m_a30CqiPeriodicity;
   Time m_a30CqiLast; ///< last aperiodic CQI
 
+  std::list<DlCqiReport> m_dlCqiReports; ///< the DL CQI reports posted to the LteSubframeBatch
+
   LteUePhySapProvider* m_uePhySapProvider; ///< UE Phy SAP provider
   LteUePhySapUser* m_uePhySapUser; ///< UE Phy SAP user
 
@@ -25,6 +25,7 @@
 #include <ns3/ff-mac-csched-sap.h>
 #include <ns3/ff-mac-sched-sap.h>
 #include <ns3/ff-mac-scheduler.h>
+#include <ns3/ff-mac-dl-candidates.h>
 #include <vector>
 #include <map>
 #include <ns3/nstime.h>
@@ -319,6 +320,12 @@ private:
   */
   std::map <uint16_t, pfsFlowPerf_t> m_flowStatsDl;
 
+  /**
+  * The candidates of the DL RBG allocation, in the order of m_flowStatsDl,
+  * kept across the TTIs to reuse the storage
+  */
+  FfMacDlCandidates m_dlCandidates;
+
   /**
   * Map of UE statistics (per RNTI basis)
   */
@@ -396,23 +396,7 @@ TdTbfqFfMacScheduler::GetRbgSize (int dlbandwidth)
 unsigned int
 TdTbfqFfMacScheduler::LcActivePerFlow (uint16_t rnti)
 {
-  std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it;
-  unsigned int lcActive = 0;
-  for (it = m_rlcBufferReq.begin (); it != m_rlcBufferReq.end (); it++)
-    {
-      if (((*it).first.m_rnti == rnti) && (((*it).second.m_rlcTransmissionQueueSize > 0)
-                                           || ((*it).second.m_rlcRetransmissionQueueSize > 0)
-                                           || ((*it).second.m_rlcStatusPduSize > 0) ))
-        {
-          lcActive++;
-        }
-      if ((*it).first.m_rnti > rnti)
-        {
-          break;
-        }
-    }
-  return (lcActive);
-
+  return FfMacDlCandidates::CountActiveLcs (m_rlcBufferReq, rnti);
 }
 
 
@@ -984,17 +968,21 @@ TdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
   std::map <uint16_t, tdtbfqsFlowPerf_t>::iterator itMax = m_flowStatsDl.end ();
   double metricMax = 0.0;
   bool firstRnti = true;
+  m_dlCandidates.Start (m_amc, rbgSize);
   for (it = m_flowStatsDl.begin (); it != m_flowStatsDl.end (); it++)
     {
-      std::set <uint16_t>::iterator itRnti = rntiAllocated.find ((*it).first);
-      if ((itRnti != rntiAllocated.end ())||(!HarqProcessAvailability ((*it).first)))
+      const FfMacDlCandidate& candidate = m_dlCandidates.Add ((*it).first,
+                                                              rntiAllocated.find ((*it).first) != rntiAllocated.end (),
+                                                              HarqProcessAvailability ((*it).first),
+                                                              m_uesTxMode, m_a30CqiRxed, m_rlcBufferReq);
+      if (candidate.allocated || !candidate.harqAvailable)
         {
           // UE already allocated for HARQ or without HARQ process available -> drop it
-          if (itRnti != rntiAllocated.end ())
+          if (candidate.allocated)
             {
               NS_LOG_DEBUG (this << " RNTI discared for HARQ tx" << (uint16_t)(*it).first);
             }
-          if (!HarqProcessAvailability ((*it).first))
+          if (!candidate.harqAvailable)
             {
               NS_LOG_DEBUG (this << " RNTI discared for HARQ id" << (uint16_t)(*it).first);
             }
@@ -1003,32 +991,12 @@ TdTbfqFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::S
 
 
       // check first the channel conditions for this UE, if CQI!=0
-      std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
-      itCqi = m_a30CqiRxed.find ((*it).first);
-      std::map <uint16_t,uint8_t>::iterator itTxMode;
-      itTxMode = m_uesTxMode.find ((*it).first);
-      if (itTxMode == m_uesTxMode.end ())
+      if (!candidate.txModeKnown)
         {
           NS_FATAL_ERROR ("No Transmission Mode info on user " << (*it).first);
         }
-      int nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
-
-      uint8_t cqiSum = 0;
-      for (int k = 0; k < rbgNum; k++)
-        {
-          for (uint8_t j = 0; j < nLayer; j++)
-            {
-              if (itCqi == m_a30CqiRxed.end ())
-                {
-                  cqiSum += 1;  // no info on this user -> lowest MCS
-                }
-              else
-                {
-                  cqiSum += (*itCqi).second.m_higherLayerSelected.at (k).m_sbCqi.at(j);
-                }
-            }
-        }
 
+      uint8_t cqiSum = FfMacDlCandidates::GetCqiSum (candidate, rbgNum);
       if (cqiSum == 0)
         {
           NS_LOG_INFO ("Skip this flow, CQI==0, rnti:"<<(*it).first);
@@ -27,14 +27,200 @@
 #include <ns3/string.h>
 #include <ns3/double.h>
 #include "ns3/uinteger.h"
+#include <ns3/abort.h>
 #include <fstream>
+#include <cstring>
 #include <ns3/simulator.h>
 
+#ifdef HAVE_MMAP
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif /* HAVE_MMAP */
+
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("TraceFadingLossModel");
 
 NS_OBJECT_ENSURE_REGISTERED (TraceFadingLossModel);
+
+/// The magic number at the start of the binary fading traces
+static const char g_binaryTraceMagic[8] = {'L', 'T', 'E', 'F', 'A', 'D', 'E', '1'};
+
+/// The header of the binary fading traces
+struct BinaryTraceHeader
+{
+  char magic[8]; ///< the magic number
+  uint32_t rbNum; ///< the number of RBs
+  uint32_t samplesNum; ///< the number of samples per RB
+};
+
+/**
+ * The samples of a fading trace file, loaded once and shared read-only by
+ * all the TraceFadingLossModel instances using the same file. Binary
+ * traces are mapped in memory where the system allows it, and read
+ * otherwise; text traces are parsed.
+ *
+ * Both formats are read as a sequence of samples, of which the RbNum
+ * first runs of SamplesNum samples are used, one run per RB, whatever
+ * the number of samples per RB of the file.
+ */
+class TraceFadingLossModel::SharedTrace : public SimpleRefCount<TraceFadingLossModel::SharedTrace>
+{
+public:
+  /**
+   * \param fileName the name of the trace file
+   * \param rbNum the number of RBs used
+   * \param samplesNum the number of samples per RB used
+   * \return the trace, loaded if not already used by another instance
+   */
+  static Ptr<const SharedTrace> Get (std::string fileName, uint32_t rbNum, uint32_t samplesNum);
+  ~SharedTrace ();
+
+  /**
+   * \param rb the RB
+   * \param sample the index of the sample
+   * \return the fading of the RB, in dB
+   */
+  double GetSample (uint32_t rb, uint32_t sample) const
+  {
+    NS_ASSERT (rb < m_rbNum && sample < m_samplesNum);
+    return m_samples[rb * m_samplesNum + sample];
+  }
+
+private:
+  /// The key of a trace: the file name, the number of RBs and of samples
+  typedef std::pair<std::string, std::pair<uint32_t, uint32_t> > Key;
+  /// \return the traces in use
+  static std::map<Key, SharedTrace *> & GetTraces (void);
+
+  /**
+   * \param key the key of the trace
+   */
+  SharedTrace (Key key);
+  /**
+   * Load a binary trace, by mapping it in memory if possible
+   * \return false if the file is not a binary trace
+   */
+  bool Load (void);
+  /// Parse a text trace
+  void Parse (void);
+
+  Key m_key; ///< the key of the trace
+  uint32_t m_rbNum; ///< the number of RBs used
+  uint32_t m_samplesNum; ///< the number of samples per RB used
+  const double *m_samples; ///< the samples
+  std::vector<double> m_parsed; ///< the samples, unless mapped
+  void *m_map; ///< the mapping of a binary trace, if any
+  size_t m_mapLength; ///< the length of the mapping
+};
+
+std::map<TraceFadingLossModel::SharedTrace::Key, TraceFadingLossModel::SharedTrace *> &
+TraceFadingLossModel::SharedTrace::GetTraces (void)
+{
+  static std::map<Key, SharedTrace *> traces;
+  return traces;
+}
+
+Ptr<const TraceFadingLossModel::SharedTrace>
+TraceFadingLossModel::SharedTrace::Get (std::string fileName, uint32_t rbNum, uint32_t samplesNum)
+{
+  Key key (fileName, std::make_pair (rbNum, samplesNum));
+  std::map<Key, SharedTrace *>::const_iterator it = GetTraces ().find (key);
+  if (it != GetTraces ().end ())
+    {
+      NS_LOG_LOGIC ("Sharing the loaded fading trace " << fileName);
+      return Ptr<const SharedTrace> (it->second);
+    }
+  Ptr<SharedTrace> trace = Ptr<SharedTrace> (new SharedTrace (key), false);
+  GetTraces ()[key] = PeekPointer (trace);
+  return trace;
+}
+
+TraceFadingLossModel::SharedTrace::SharedTrace (Key key)
+  : m_key (key),
+    m_rbNum (key.second.first),
+    m_samplesNum (key.second.second),
+    m_samples (0),
+    m_map (0),
+    m_mapLength (0)
+{
+  if (!Load ())
+    {
+      Parse ();
+    }
+}
+
+TraceFadingLossModel::SharedTrace::~SharedTrace ()
+{
+  GetTraces ().erase (m_key);
+#ifdef HAVE_MMAP
+  if (m_map != 0)
+    {
+      munmap (m_map, m_mapLength);
+    }
+#endif /* HAVE_MMAP */
+}
+
+bool
+TraceFadingLossModel::SharedTrace::Load (void)
+{
+  const std::string &fileName = m_key.first;
+  std::ifstream in (fileName.c_str (), std::ios::in | std::ios::binary);
+  NS_ABORT_MSG_IF (!in.good (), "Fading trace file " << fileName << " not found");
+  BinaryTraceHeader header;
+  in.read (reinterpret_cast<char *> (&header), sizeof (header));
+  if (!in.good ()
+      || std::memcmp (header.magic, g_binaryTraceMagic, sizeof (g_binaryTraceMagic)) != 0)
+    {
+      return false;
+    }
+  uint64_t samples = static_cast<uint64_t> (m_rbNum) * m_samplesNum;
+  NS_ABORT_MSG_IF (static_cast<uint64_t> (header.rbNum) * header.samplesNum < samples,
+                   "Fading trace " << fileName << " has " << header.rbNum << " RBs of "
+                   << header.samplesNum << " samples, less than RbNum * SamplesNum samples");
+#ifdef HAVE_MMAP
+  in.close ();
+  int fd = open (fileName.c_str (), O_RDONLY);
+  NS_ABORT_MSG_IF (fd < 0, "Fading trace file " << fileName << " not found");
+  struct stat st;
+  m_mapLength = sizeof (header) + sizeof (double) * samples;
+  NS_ABORT_MSG_IF (fstat (fd, &st) != 0 || static_cast<size_t> (st.st_size) < m_mapLength,
+                   "Fading trace " << fileName << " is truncated");
+  m_map = mmap (0, m_mapLength, PROT_READ, MAP_SHARED, fd, 0);
+  close (fd);
+  NS_ABORT_MSG_IF (m_map == MAP_FAILED, "Cannot map the fading trace " << fileName);
+  NS_LOG_LOGIC ("Mapped the binary fading trace " << fileName);
+  m_samples = reinterpret_cast<const double *> (static_cast<const char *> (m_map) + sizeof (header));
+#else
+  m_parsed.resize (samples);
+  in.read (reinterpret_cast<char *> (&m_parsed[0]), sizeof (double) * samples);
+  NS_ABORT_MSG_IF (!in.good (), "Fading trace " << fileName << " is truncated");
+  NS_LOG_LOGIC ("Read the binary fading trace " << fileName);
+  m_samples = m_parsed.data ();
+#endif /* HAVE_MMAP */
+  return true;
+}
+
+void
+TraceFadingLossModel::SharedTrace::Parse (void)
+{
+  const std::string &fileName = m_key.first;
+  std::ifstream ifTraceFile;
+  ifTraceFile.open (fileName.c_str (), std::ifstream::in);
+  NS_ABORT_MSG_IF (!ifTraceFile.good (), "Fading trace file " << fileName << " not found");
+  m_parsed.reserve (m_rbNum * m_samplesNum);
+  for (uint32_t i = 0; i < m_rbNum * m_samplesNum; i++)
+    {
+      double sample;
+      ifTraceFile >> sample;
+      m_parsed.push_back (sample);
+    }
+  NS_LOG_LOGIC ("Parsed the text fading trace " << fileName);
+  m_samples = m_parsed.data ();
+}
   
 
 
@@ -48,7 +234,7 @@ TraceFadingLossModel::TraceFadingLossModel ()
 
 TraceFadingLossModel::~TraceFadingLossModel ()
 {
-  m_fadingTrace.clear ();
+  m_fadingTrace = 0;
   m_windowOffsetsMap.clear ();
   m_startVariableMap.clear ();
 }
@@ -120,30 +306,33 @@ void
 TraceFadingLossModel::LoadTrace ()
 {
   NS_LOG_FUNCTION (this << "Loading Fading Trace " << m_traceFile);
-  std::ifstream ifTraceFile;
-  ifTraceFile.open (m_traceFile.c_str (), std::ifstream::in);
-  m_fadingTrace.clear ();
-  if (!ifTraceFile.good ())
-    {
-      NS_LOG_INFO (this << " File: " << m_traceFile);
-      NS_ASSERT_MSG(ifTraceFile.good (), " Fading trace file not found");
-    }
+  m_fadingTrace = SharedTrace::Get (m_traceFile, m_rbNum, m_samplesNum);
+  m_timeGranularity = m_traceLength.GetMilliSeconds () / m_samplesNum;
+  m_lastWindowUpdate = Simulator::Now ();
+}
 
-//   NS_LOG_INFO (this << " length " << m_traceLength.GetSeconds ());
-//   NS_LOG_INFO (this << " RB " << (uint32_t)m_rbNum << " samples " << m_samplesNum);
-  for (uint32_t i = 0; i < m_rbNum; i++)
+void
+TraceFadingLossModel::ConvertTrace (std::string textFile, std::string binaryFile, uint32_t rbNum, uint32_t samplesNum)
+{
+  NS_LOG_FUNCTION (textFile << binaryFile << rbNum << samplesNum);
+  std::ifstream in (textFile.c_str ());
+  NS_ABORT_MSG_IF (!in.good (), "Fading trace file " << textFile << " not found");
+  std::ofstream out (binaryFile.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  NS_ABORT_MSG_IF (!out.good (), "Cannot create the fading trace file " << binaryFile);
+
+  BinaryTraceHeader header;
+  std::memcpy (header.magic, g_binaryTraceMagic, sizeof (g_binaryTraceMagic));
+  header.rbNum = rbNum;
+  header.samplesNum = samplesNum;
+  out.write (reinterpret_cast<const char *> (&header), sizeof (header));
+  for (uint32_t i = 0; i < rbNum * samplesNum; i++)
     {
-      FadingTraceSample rbTimeFadingTrace;
-      for (uint32_t j = 0; j < m_samplesNum; j++)
-        {
-          double sample;
-          ifTraceFile >> sample;
-          rbTimeFadingTrace.push_back (sample);
-        }
-      m_fadingTrace.push_back (rbTimeFadingTrace);
+      double sample;
+      in >> sample;
+      NS_ABORT_MSG_IF (in.fail (), "Fading trace " << textFile << " has less than " << rbNum * samplesNum << " samples");
+      out.write (reinterpret_cast<const char *> (&sample), sizeof (sample));
     }
-  m_timeGranularity = m_traceLength.GetMilliSeconds () / m_samplesNum;
-  m_lastWindowUpdate = Simulator::Now ();
+  NS_ABORT_MSG_IF (!out.good (), "Cannot write the fading trace file " << binaryFile);
 }
 
 
@@ -201,7 +390,7 @@ TraceFadingLossModel::DoCalcRxPowerSpectralDensity (
   //double speed = std::sqrt (std::pow (aSpeedVector.x-bSpeedVector.x,2) + std::pow (aSpeedVector.y-bSpeedVector.y,2));
 
   NS_LOG_LOGIC (this << *rxPsd);
-  NS_ASSERT (!m_fadingTrace.empty ());
+  NS_ASSERT (m_fadingTrace != 0);
   int now_ms = static_cast<int> (Simulator::Now ().GetMilliSeconds () * m_timeGranularity);
   int lastUpdate_ms = static_cast<int> (m_lastWindowUpdate.GetMilliSeconds () * m_timeGranularity);
   int index = ((*itOff).second + now_ms - lastUpdate_ms) % m_samplesNum;
@@ -211,7 +400,7 @@ TraceFadingLossModel::DoCalcRxPowerSpectralDensity (
       NS_ASSERT (subChannel < 100);
       if (*vit != 0.)
         {
-          double fading = m_fadingTrace.at (subChannel).at (index);
+          double fading = m_fadingTrace->GetSample (subChannel, index);
           NS_LOG_INFO (this << " FADING now " << now_ms << " offset " << (*itOff).second << " id " << index << " fading " << fading);
           double power = *vit; // in Watt/Hz
           power = 10 * std::log10 (180000 * power); // in dB
@@ -70,8 +70,30 @@ public:
   */
   int64_t AssignStreams (int64_t stream);
 
+  /**
+   * \brief Convert a fading trace from the text format to the binary format
+   *
+   * The binary traces are mapped in memory where the system supports
+   * it, rather than parsed, and shared by all the instances using the
+   * same file. As for the text traces, RB i uses the samples
+   * i * SamplesNum to (i + 1) * SamplesNum - 1 of the file, so both
+   * formats give the same fading whatever SamplesNum. A binary trace is
+   * made of the "LTEFADE1" magic, the number of RBs and the number of
+   * samples per RB as 32-bit integers, and the samples of each RB as
+   * doubles, all in the byte order of the host.
+   *
+   * \param textFile the name of the text trace
+   * \param binaryFile the name of the binary trace to write
+   * \param rbNum the number of RBs of the trace
+   * \param samplesNum the number of samples per RB
+   */
+  static void ConvertTrace (std::string textFile, std::string binaryFile, uint32_t rbNum, uint32_t samplesNum);
+
   
 private:
+  /// The samples of a fading trace file, shared read-only by the instances
+  class SharedTrace;
+
   /**
    * \param txPsd set of values vs frequency representing the
    *              transmission power. See SpectrumChannel for details.
@@ -112,20 +134,9 @@ private:
   
   mutable std::map <ChannelRealizationId_t, Ptr<UniformRandomVariable> > m_startVariableMap; ///< start variable map
   
-  /**
-   * Vector with fading samples in time domain (for a fixed RB)
-   */
-  typedef std::vector<double> FadingTraceSample;
-  /**
-   * Vector collecting the time fading traces in the frequency domain (per RB)
-   */
-  typedef std::vector<FadingTraceSample> FadingTrace;
-
-
-  
   std::string m_traceFile; ///< the trace file name
   
-  FadingTrace m_fadingTrace; ///< fading trace
+  Ptr<const SharedTrace> m_fadingTrace; ///< fading trace, shared with the instances using the same file
 
   
   Time m_traceLength; ///< the trace time
@@ -0,0 +1,325 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ctime>
+#include <iostream>
+#include <ns3/test.h>
+#include <ns3/object-factory.h>
+#include <ns3/boolean.h>
+#include <ns3/ff-mac-scheduler.h>
+#include <ns3/ff-mac-csched-sap.h>
+#include <ns3/ff-mac-sched-sap.h>
+#include <ns3/lte-fr-no-op-algorithm.h>
+
+using namespace ns3;
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * Sink of the configuration and scheduling indications of the scheduler,
+ * which keeps a checksum of the DCIs
+ */
+class LteFfMacSchedulerBenchmarkSapUser : public FfMacCschedSapUser,
+                                          public FfMacSchedSapUser
+{
+public:
+  LteFfMacSchedulerBenchmarkSapUser ();
+
+  virtual void CschedCellConfigCnf (const struct CschedCellConfigCnfParameters& params);
+  virtual void CschedUeConfigCnf (const struct CschedUeConfigCnfParameters& params);
+  virtual void CschedLcConfigCnf (const struct CschedLcConfigCnfParameters& params);
+  virtual void CschedLcReleaseCnf (const struct CschedLcReleaseCnfParameters& params);
+  virtual void CschedUeReleaseCnf (const struct CschedUeReleaseCnfParameters& params);
+  virtual void CschedUeConfigUpdateInd (const struct CschedUeConfigUpdateIndParameters& params);
+  virtual void CschedCellConfigUpdateInd (const struct CschedCellConfigUpdateIndParameters& params);
+  virtual void SchedDlConfigInd (const struct SchedDlConfigIndParameters& params);
+  virtual void SchedUlConfigInd (const struct SchedUlConfigIndParameters& params);
+
+  uint64_t m_checksum; ///< the checksum of the DCIs
+  uint32_t m_nDlDcis; ///< the number of DL DCIs
+  uint32_t m_nUlDcis; ///< the number of UL DCIs
+
+private:
+  /**
+   * Add a value to the checksum
+   * \param value the value
+   */
+  void Add (uint64_t value);
+};
+
+LteFfMacSchedulerBenchmarkSapUser::LteFfMacSchedulerBenchmarkSapUser ()
+  : m_checksum (0),
+    m_nDlDcis (0),
+    m_nUlDcis (0)
+{
+}
+
+void
+LteFfMacSchedulerBenchmarkSapUser::Add (uint64_t value)
+{
+  m_checksum = m_checksum * 1000003 + value;
+}
+
+void
+LteFfMacSchedulerBenchmarkSapUser::CschedCellConfigCnf (const struct CschedCellConfigCnfParameters& params)
+{
+}
+
+void
+LteFfMacSchedulerBenchmarkSapUser::CschedUeConfigCnf (const struct CschedUeConfigCnfParameters& params)
+{
+}
+
+void
+LteFfMacSchedulerBenchmarkSapUser::CschedLcConfigCnf (const struct CschedLcConfigCnfParameters& params)
+{
+}
+
+void
+LteFfMacSchedulerBenchmarkSapUser::CschedLcReleaseCnf (const struct CschedLcReleaseCnfParameters& params)
+{
+}
+
+void
+LteFfMacSchedulerBenchmarkSapUser::CschedUeReleaseCnf (const struct CschedUeReleaseCnfParameters& params)
+{
+}
+
+void
+LteFfMacSchedulerBenchmarkSapUser::CschedUeConfigUpdateInd (const struct CschedUeConfigUpdateIndParameters& params)
+{
+}
+
+void
+LteFfMacSchedulerBenchmarkSapUser::CschedCellConfigUpdateInd (const struct CschedCellConfigUpdateIndParameters& params)
+{
+}
+
+void
+LteFfMacSchedulerBenchmarkSapUser::SchedDlConfigInd (const struct SchedDlConfigIndParameters& params)
+{
+  for (std::vector<BuildDataListElement_s>::const_iterator it = params.m_buildDataList.begin (); it != params.m_buildDataList.end (); ++it)
+    {
+      m_nDlDcis++;
+      Add (it->m_rnti);
+      Add (it->m_dci.m_rbBitmap);
+      for (uint32_t i = 0; i < it->m_dci.m_tbsSize.size (); i++)
+        {
+          Add (it->m_dci.m_tbsSize.at (i));
+          Add (it->m_dci.m_mcs.at (i));
+        }
+    }
+}
+
+void
+LteFfMacSchedulerBenchmarkSapUser::SchedUlConfigInd (const struct SchedUlConfigIndParameters& params)
+{
+  for (std::vector<UlDciListElement_s>::const_iterator it = params.m_dciList.begin (); it != params.m_dciList.end (); ++it)
+    {
+      m_nUlDcis++;
+      Add (it->m_rnti);
+      Add (it->m_rbStart);
+      Add (it->m_rbLen);
+      Add (it->m_tbSize);
+      Add (it->m_mcs);
+    }
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * Benchmark the scheduling cost per TTI of a FF MAC scheduler, driven
+ * directly through its SAPs with synthetic RLC buffer, subband CQI and
+ * BSR reports.
+ */
+class LteFfMacSchedulerBenchmarkTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param schedulerType the type of the scheduler
+   * \param nUes the number of UEs
+   * \param nTtis the number of TTIs to schedule
+   */
+  LteFfMacSchedulerBenchmarkTestCase (std::string schedulerType, uint16_t nUes, uint32_t nTtis);
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Send the periodic reports of all the UEs
+   * \param period the index of the reporting period
+   */
+  void Report (uint32_t period);
+
+  std::string m_schedulerType; ///< the type of the scheduler
+  uint16_t m_nUes; ///< the number of UEs
+  uint32_t m_nTtis; ///< the number of TTIs to schedule
+  FfMacCschedSapProvider* m_cschedSapProvider; ///< the CSCHED SAP of the scheduler
+  FfMacSchedSapProvider* m_schedSapProvider; ///< the SCHED SAP of the scheduler
+};
+
+static const uint8_t g_benchmarkBandwidth = 100; ///< the bandwidth in RBs
+static const uint8_t g_benchmarkRbgs = 25; ///< the number of RBGs
+
+LteFfMacSchedulerBenchmarkTestCase::LteFfMacSchedulerBenchmarkTestCase (std::string schedulerType, uint16_t nUes, uint32_t nTtis)
+  : TestCase ("Benchmark the " + schedulerType + " scheduler"),
+    m_schedulerType (schedulerType),
+    m_nUes (nUes),
+    m_nTtis (nTtis),
+    m_cschedSapProvider (0),
+    m_schedSapProvider (0)
+{
+}
+
+void
+LteFfMacSchedulerBenchmarkTestCase::Report (uint32_t period)
+{
+  FfMacSchedSapProvider::SchedDlCqiInfoReqParameters cqiParams;
+  FfMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters bsrParams;
+  for (uint16_t rnti = 1; rnti <= m_nUes; rnti++)
+    {
+      FfMacSchedSapProvider::SchedDlRlcBufferReqParameters rlcParams = FfMacSchedSapProvider::SchedDlRlcBufferReqParameters ();
+      rlcParams.m_rnti = rnti;
+      rlcParams.m_logicalChannelIdentity = 3;
+      rlcParams.m_rlcTransmissionQueueSize = (rnti * 7 + period * 13) % 5 == 0 ? 0 : 200 + (rnti * 97 + period * 31) % 3000;
+      m_schedSapProvider->SchedDlRlcBufferReq (rlcParams);
+
+      CqiListElement_s cqi;
+      cqi.m_rnti = rnti;
+      cqi.m_ri = 1;
+      cqi.m_cqiType = CqiListElement_s::A30;
+      cqi.m_wbPmi = 0;
+      cqi.m_wbCqi.push_back (1 + (rnti * 3 + period) % 15);
+      for (uint8_t rbg = 0; rbg < g_benchmarkRbgs; rbg++)
+        {
+          HigherLayerSelected_s sb;
+          sb.m_sbPmi = 0;
+          sb.m_sbCqi.push_back (1 + (rnti * 7 + rbg * 3 + period) % 15);
+          cqi.m_sbMeasResult.m_higherLayerSelected.push_back (sb);
+        }
+      cqiParams.m_cqiList.push_back (cqi);
+
+      MacCeListElement_s bsr;
+      bsr.m_rnti = rnti;
+      bsr.m_macCeType = MacCeListElement_s::BSR;
+      bsr.m_macCeValue.m_bufferStatus.resize (4, 0);
+      bsr.m_macCeValue.m_bufferStatus.at (0) = (rnti + period) % 4 == 0 ? 0 : 10 + (rnti * 5 + period) % 30;
+      bsrParams.m_macCeList.push_back (bsr);
+    }
+  m_schedSapProvider->SchedDlCqiInfoReq (cqiParams);
+  m_schedSapProvider->SchedUlMacCtrlInfoReq (bsrParams);
+}
+
+void
+LteFfMacSchedulerBenchmarkTestCase::DoRun (void)
+{
+  ObjectFactory factory;
+  factory.SetTypeId (m_schedulerType);
+  factory.Set ("HarqEnabled", BooleanValue (false));
+  Ptr<FfMacScheduler> scheduler = factory.Create<FfMacScheduler> ();
+  Ptr<LteFfrAlgorithm> ffr = CreateObject<LteFrNoOpAlgorithm> ();
+  ffr->SetDlBandwidth (g_benchmarkBandwidth);
+  ffr->SetUlBandwidth (g_benchmarkBandwidth);
+  scheduler->SetLteFfrSapProvider (ffr->GetLteFfrSapProvider ());
+  ffr->SetLteFfrSapUser (scheduler->GetLteFfrSapUser ());
+  LteFfMacSchedulerBenchmarkSapUser sapUser;
+  scheduler->SetFfMacCschedSapUser (&sapUser);
+  scheduler->SetFfMacSchedSapUser (&sapUser);
+  m_cschedSapProvider = scheduler->GetFfMacCschedSapProvider ();
+  m_schedSapProvider = scheduler->GetFfMacSchedSapProvider ();
+  scheduler->Initialize ();
+  ffr->Initialize ();
+
+  FfMacCschedSapProvider::CschedCellConfigReqParameters cellParams = FfMacCschedSapProvider::CschedCellConfigReqParameters ();
+  cellParams.m_dlBandwidth = g_benchmarkBandwidth;
+  cellParams.m_ulBandwidth = g_benchmarkBandwidth;
+  m_cschedSapProvider->CschedCellConfigReq (cellParams);
+  for (uint16_t rnti = 1; rnti <= m_nUes; rnti++)
+    {
+      FfMacCschedSapProvider::CschedUeConfigReqParameters ueParams = FfMacCschedSapProvider::CschedUeConfigReqParameters ();
+      ueParams.m_rnti = rnti;
+      ueParams.m_transmissionMode = 0;
+      m_cschedSapProvider->CschedUeConfigReq (ueParams);
+
+      FfMacCschedSapProvider::CschedLcConfigReqParameters lcParams = FfMacCschedSapProvider::CschedLcConfigReqParameters ();
+      lcParams.m_rnti = rnti;
+      LogicalChannelConfigListElement_s lc = LogicalChannelConfigListElement_s ();
+      lc.m_logicalChannelIdentity = 3;
+      lc.m_logicalChannelGroup = 0;
+      lc.m_direction = LogicalChannelConfigListElement_s::DIR_BOTH;
+      lc.m_qosBearerType = LogicalChannelConfigListElement_s::QBT_NON_GBR;
+      lc.m_qci = 9;
+      lc.m_eRabMaximulBitrateDl = 100000 + (rnti % 7) * 50000;
+      lc.m_eRabGuaranteedBitrateDl = lc.m_eRabMaximulBitrateDl;
+      lc.m_eRabMaximulBitrateUl = lc.m_eRabMaximulBitrateDl;
+      lc.m_eRabGuaranteedBitrateUl = lc.m_eRabMaximulBitrateDl;
+      lcParams.m_logicalChannelConfigList.push_back (lc);
+      m_cschedSapProvider->CschedLcConfigReq (lcParams);
+    }
+
+  clock_t start = clock ();
+  for (uint32_t tti = 0; tti < m_nTtis; tti++)
+    {
+      if (tti % 10 == 0)
+        {
+          Report (tti / 10);
+        }
+      uint16_t sfnSf = ((1 + (tti / 10) % 1024) << 4) | (1 + tti % 10);
+      FfMacSchedSapProvider::SchedDlTriggerReqParameters dlParams;
+      dlParams.m_sfnSf = sfnSf;
+      m_schedSapProvider->SchedDlTriggerReq (dlParams);
+      FfMacSchedSapProvider::SchedUlTriggerReqParameters ulParams;
+      ulParams.m_sfnSf = sfnSf;
+      m_schedSapProvider->SchedUlTriggerReq (ulParams);
+    }
+  clock_t elapsed = clock () - start;
+  std::cout << "lte-ff-mac-scheduler-perf: " << m_schedulerType << ", " << m_nUes << " UEs: "
+            << 1e3 * elapsed / CLOCKS_PER_SEC / m_nTtis << " ms per TTI" << std::endl;
+
+  NS_TEST_EXPECT_MSG_GT (sapUser.m_nDlDcis, 0, "No DL DCIs");
+  NS_TEST_EXPECT_MSG_GT (sapUser.m_nUlDcis, 0, "No UL DCIs");
+
+  scheduler->Dispose ();
+  ffr->Dispose ();
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * FF MAC schedulers performance test suite
+ */
+class LteFfMacSchedulerPerformanceTestSuite : public TestSuite
+{
+public:
+  LteFfMacSchedulerPerformanceTestSuite ();
+};
+
+LteFfMacSchedulerPerformanceTestSuite::LteFfMacSchedulerPerformanceTestSuite ()
+  : TestSuite ("lte-ff-mac-scheduler-perf", PERFORMANCE)
+{
+  AddTestCase (new LteFfMacSchedulerBenchmarkTestCase ("ns3::PfFfMacScheduler", 500, 200), TestCase::QUICK);
+  AddTestCase (new LteFfMacSchedulerBenchmarkTestCase ("ns3::FdMtFfMacScheduler", 500, 200), TestCase::QUICK);
+  AddTestCase (new LteFfMacSchedulerBenchmarkTestCase ("ns3::TdMtFfMacScheduler", 500, 200), TestCase::QUICK);
+  AddTestCase (new LteFfMacSchedulerBenchmarkTestCase ("ns3::PssFfMacScheduler", 500, 200), TestCase::QUICK);
+  AddTestCase (new LteFfMacSchedulerBenchmarkTestCase ("ns3::CqaFfMacScheduler", 500, 200), TestCase::QUICK);
+  AddTestCase (new LteFfMacSchedulerBenchmarkTestCase ("ns3::TdTbfqFfMacScheduler", 500, 200), TestCase::QUICK);
+  AddTestCase (new LteFfMacSchedulerBenchmarkTestCase ("ns3::FdTbfqFfMacScheduler", 500, 200), TestCase::QUICK);
+}
+
+static LteFfMacSchedulerPerformanceTestSuite g_lteFfMacSchedulerPerformanceTestSuite; ///< the performance test suite
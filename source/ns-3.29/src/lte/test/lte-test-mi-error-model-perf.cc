@@ -0,0 +1,154 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ctime>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <vector>
+#include <ns3/test.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/lte-spectrum-value-helper.h>
+#include <ns3/lte-mi-error-model.h>
+#include <ns3/lte-amc.h>
+
+using namespace ns3;
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * Benchmark the evaluation of the BLER of all the MCSs of an RBG, as done
+ * by the MI error model AMC, when the MI is computed for each MCS and when
+ * it is computed once per modulation.
+ */
+class LteMiErrorModelBenchmarkTestCase : public TestCase
+{
+public:
+  LteMiErrorModelBenchmarkTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param name the name of the method
+   * \param perMcs whether the MI is computed for each MCS
+   * \param harq whether the TBs are retransmissions
+   * \return the sum of the BLERs computed
+   */
+  double Bench (std::string name, bool perMcs, bool harq);
+
+  std::vector<SpectrumValue> m_sinrs; ///< the SINRs to evaluate
+};
+
+LteMiErrorModelBenchmarkTestCase::LteMiErrorModelBenchmarkTestCase ()
+  : TestCase ("Benchmark the MI error model")
+{
+}
+
+double
+LteMiErrorModelBenchmarkTestCase::Bench (std::string name, bool perMcs, bool harq)
+{
+  const uint8_t rbgSize = 3;
+  HarqProcessInfoList_t miHistory;
+  if (harq)
+    {
+      HarqProcessInfoElement_t el;
+      el.m_mi = 0.5;
+      el.m_rv = 0;
+      el.m_infoBits = 1000;
+      el.m_codeBits = 2000;
+      miHistory.push_back (el);
+    }
+  Ptr<LteAmc> amc = CreateObject<LteAmc> ();
+  double sum = 0;
+  clock_t start = clock ();
+  for (std::vector<SpectrumValue>::const_iterator sinr = m_sinrs.begin (); sinr != m_sinrs.end (); ++sinr)
+    {
+      std::vector<int> map;
+      for (uint32_t rb = 0; rb + rbgSize <= sinr->GetSpectrumModel ()->GetNumBands (); rb += rbgSize)
+        {
+          map.clear ();
+          for (uint8_t i = 0; i < rbgSize; i++)
+            {
+              map.push_back (rb + i);
+            }
+          double mi = 0;
+          for (uint8_t mcs = 0; mcs <= 28; mcs++)
+            {
+              uint16_t size = amc->GetDlTbSizeFromMcs (mcs, rbgSize) / 8;
+              if (perMcs)
+                {
+                  sum += LteMiErrorModel::GetTbDecodificationStats (*sinr, map, size, mcs, miHistory).tbler;
+                  continue;
+                }
+              if (mcs == 0 || mcs == MI_QPSK_MAX_ID + 1 || mcs == MI_16QAM_MAX_ID + 1)
+                {
+                  mi = LteMiErrorModel::Mib (*sinr, map, mcs);
+                }
+              sum += LteMiErrorModel::GetTbDecodificationStats (mi, size, mcs, miHistory).tbler;
+            }
+        }
+    }
+  clock_t elapsed = clock () - start;
+  std::cout << "lte-mi-error-model-perf: " << name << ": "
+            << 1e3 * elapsed / CLOCKS_PER_SEC << " ms" << std::endl;
+  return sum;
+}
+
+void
+LteMiErrorModelBenchmarkTestCase::DoRun (void)
+{
+  Ptr<SpectrumModel> model = LteSpectrumValueHelper::GetSpectrumModel (100, 100);
+  for (uint32_t i = 0; i < 2000; i++)
+    {
+      SpectrumValue sinr (model);
+      for (uint32_t rb = 0; rb < model->GetNumBands (); rb++)
+        {
+          // from -5 dB to 30 dB, varying across the RBs and the samples
+          double sinrDb = -5 + 35 * (0.5 + 0.5 * std::sin (0.37 * rb + 0.11 * i));
+          sinr[rb] = std::pow (10.0, sinrDb / 10);
+        }
+      m_sinrs.push_back (sinr);
+    }
+
+  double perMcs = Bench ("MI per MCS", true, false);
+  double perModulation = Bench ("MI per modulation", false, false);
+  NS_TEST_ASSERT_MSG_EQ (perModulation, perMcs, "Different BLERs");
+
+  perMcs = Bench ("MI per MCS, HARQ", true, true);
+  perModulation = Bench ("MI per modulation, HARQ", false, true);
+  NS_TEST_ASSERT_MSG_EQ (perModulation, perMcs, "Different BLERs with HARQ");
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * LteMiErrorModel performance test suite
+ */
+class LteMiErrorModelPerformanceTestSuite : public TestSuite
+{
+public:
+  LteMiErrorModelPerformanceTestSuite ();
+};
+
+LteMiErrorModelPerformanceTestSuite::LteMiErrorModelPerformanceTestSuite ()
+  : TestSuite ("lte-mi-error-model-perf", PERFORMANCE)
+{
+  AddTestCase (new LteMiErrorModelBenchmarkTestCase, TestCase::QUICK);
+}
+
+static LteMiErrorModelPerformanceTestSuite g_lteMiErrorModelPerformanceTestSuite; ///< the performance test suite
@@ -0,0 +1,364 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <vector>
+#include <ns3/test.h>
+#include <ns3/simulator.h>
+#include <ns3/config.h>
+#include <ns3/boolean.h>
+#include <ns3/uinteger.h>
+#include <ns3/string.h>
+#include <ns3/type-id.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/constant-velocity-mobility-model.h>
+#include <ns3/mobility-helper.h>
+#include <ns3/lte-helper.h>
+#include <ns3/lte-pathloss-cache.h>
+
+using namespace ns3;
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * A log distance pathloss model which counts its invocations
+ */
+class LtePathlossCacheTestLossModel : public PropagationLossModel
+{
+public:
+  LtePathlossCacheTestLossModel ();
+
+  uint32_t m_calls; ///< the number of invocations
+
+private:
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
+
+  Ptr<PropagationLossModel> m_model; ///< the log distance model
+};
+
+LtePathlossCacheTestLossModel::LtePathlossCacheTestLossModel ()
+  : m_calls (0)
+{
+  m_model = CreateObject<LogDistancePropagationLossModel> ();
+}
+
+double
+LtePathlossCacheTestLossModel::DoCalcRxPower (double txPowerDbm,
+                                              Ptr<MobilityModel> a,
+                                              Ptr<MobilityModel> b) const
+{
+  const_cast<LtePathlossCacheTestLossModel *> (this)->m_calls++;
+  return m_model->CalcRxPower (txPowerDbm, a, b);
+}
+
+int64_t
+LtePathlossCacheTestLossModel::DoAssignStreams (int64_t stream)
+{
+  return 0;
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * Check that the LtePathlossCache computes the gain of a pair of static
+ * nodes once for both directions, and recomputes it after a course change
+ * or when a node moves.
+ */
+class LtePathlossCacheUnitTestCase : public TestCase
+{
+public:
+  LtePathlossCacheUnitTestCase ();
+  virtual ~LtePathlossCacheUnitTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LtePathlossCacheUnitTestCase::LtePathlossCacheUnitTestCase ()
+  : TestCase ("Check the caching and the invalidation of the path loss")
+{
+}
+
+LtePathlossCacheUnitTestCase::~LtePathlossCacheUnitTestCase ()
+{
+}
+
+void
+LtePathlossCacheUnitTestCase::DoRun (void)
+{
+  Ptr<LtePathlossCacheTestLossModel> model = CreateObject<LtePathlossCacheTestLossModel> ();
+  Ptr<LogDistancePropagationLossModel> reference = CreateObject<LogDistancePropagationLossModel> ();
+  Ptr<LtePathlossCache> cache = CreateObject<LtePathlossCache> ();
+  cache->SetPathlossModel (model);
+
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0, 0, 30));
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  b->SetPosition (Vector (200, 100, 1.5));
+
+  double gain = reference->CalcRxPower (0, a, b);
+  NS_TEST_ASSERT_MSG_EQ (cache->CalcRxPower (0, a, b), gain, "Wrong gain");
+  NS_TEST_ASSERT_MSG_EQ (cache->CalcRxPower (0, a, b), gain, "Wrong cached gain");
+  NS_TEST_ASSERT_MSG_EQ (cache->CalcRxPower (0, b, a), gain, "Wrong reciprocal gain");
+  NS_TEST_ASSERT_MSG_EQ (cache->CalcRxPower (23, b, a), 23 + gain, "Wrong gain with a tx power");
+  NS_TEST_ASSERT_MSG_EQ (model->m_calls, 1, "The gain was not cached");
+
+  // a course change invalidates the pair
+  b->SetPosition (Vector (400, 100, 1.5));
+  gain = reference->CalcRxPower (0, a, b);
+  NS_TEST_ASSERT_MSG_EQ (cache->CalcRxPower (0, b, a), gain, "Wrong gain after a course change");
+  NS_TEST_ASSERT_MSG_EQ (cache->CalcRxPower (0, a, b), gain, "Wrong cached gain after a course change");
+  NS_TEST_ASSERT_MSG_EQ (model->m_calls, 2, "The gain was not recomputed once after a course change");
+
+  // the pairs with a moving node are not cached
+  Ptr<ConstantVelocityMobilityModel> c = CreateObject<ConstantVelocityMobilityModel> ();
+  c->SetPosition (Vector (0, 100, 1.5));
+  c->SetVelocity (Vector (10, 0, 0));
+  NS_TEST_ASSERT_MSG_EQ (cache->CalcRxPower (0, a, c), reference->CalcRxPower (0, a, c), "Wrong gain of a moving node");
+  NS_TEST_ASSERT_MSG_EQ (cache->CalcRxPower (0, a, c), reference->CalcRxPower (0, a, c), "Wrong gain of a moving node");
+  NS_TEST_ASSERT_MSG_EQ (model->m_calls, 4, "The gain of a moving node was cached");
+
+  // until it stops
+  c->SetVelocity (Vector (0, 0, 0));
+  gain = reference->CalcRxPower (0, a, c);
+  NS_TEST_ASSERT_MSG_EQ (cache->CalcRxPower (0, a, c), gain, "Wrong gain of a stopped node");
+  NS_TEST_ASSERT_MSG_EQ (cache->CalcRxPower (0, c, a), gain, "Wrong cached gain of a stopped node");
+  NS_TEST_ASSERT_MSG_EQ (model->m_calls, 5, "The gain of a stopped node was not cached");
+
+  cache->Flush ();
+  cache->CalcRxPower (0, a, b);
+  NS_TEST_ASSERT_MSG_EQ (model->m_calls, 6, "The cache was not flushed");
+
+  cache->Dispose ();
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * Make sure that the RSRP and SINR measured by the UEs, with several
+ * carriers, a UE which moves and another which changes position, are the
+ * same with and without the path loss cache.
+ */
+class LtePathlossCacheSystemTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param pathlossModel the type of the path loss model
+   */
+  LtePathlossCacheSystemTestCase (std::string pathlossModel);
+  virtual ~LtePathlossCacheSystemTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /// A measurement of a UE
+  struct Measurement
+  {
+    int64_t time; ///< the time in ns
+    uint16_t cellId; ///< the cell ID
+    uint16_t rnti; ///< the RNTI
+    double rsrp; ///< the RSRP
+    double sinr; ///< the SINR
+    uint8_t componentCarrierId; ///< the component carrier ID
+
+    /**
+     * \param other the other measurement
+     * \return whether this measurement is ordered before the other one
+     */
+    bool operator < (const Measurement &other) const
+    {
+      if (time != other.time)
+        {
+          return time < other.time;
+        }
+      if (cellId != other.cellId)
+        {
+          return cellId < other.cellId;
+        }
+      if (rnti != other.rnti)
+        {
+          return rnti < other.rnti;
+        }
+      if (componentCarrierId != other.componentCarrierId)
+        {
+          return componentCarrierId < other.componentCarrierId;
+        }
+      if (rsrp != other.rsrp)
+        {
+          return rsrp < other.rsrp;
+        }
+      return sinr < other.sinr;
+    }
+  };
+
+  /**
+   * Run the scenario
+   * \param cachePathloss the value of the CachePathloss attribute of the LteHelper
+   * \return the measurements of the UEs, sorted, since the order of the
+   * receivers of a channel, hence of the measurements made at the same
+   * time, changes from one run to the next
+   */
+  std::vector<Measurement> Run (bool cachePathloss);
+  /**
+   * Record a measurement
+   * \param cellId the cell ID
+   * \param rnti the RNTI
+   * \param rsrp the RSRP
+   * \param sinr the SINR
+   * \param componentCarrierId the component carrier ID
+   */
+  void ReportRsrpSinr (uint16_t cellId, uint16_t rnti, double rsrp, double sinr, uint8_t componentCarrierId);
+
+  std::string m_pathlossModel; ///< the type of the path loss model
+  std::vector<Measurement> m_measurements; ///< the measurements of the current run
+};
+
+LtePathlossCacheSystemTestCase::LtePathlossCacheSystemTestCase (std::string pathlossModel)
+  : TestCase ("Check that the path loss cache does not change the measurements with " + pathlossModel),
+    m_pathlossModel (pathlossModel)
+{
+}
+
+LtePathlossCacheSystemTestCase::~LtePathlossCacheSystemTestCase ()
+{
+}
+
+void
+LtePathlossCacheSystemTestCase::ReportRsrpSinr (uint16_t cellId, uint16_t rnti, double rsrp, double sinr, uint8_t componentCarrierId)
+{
+  Measurement measurement;
+  measurement.time = Simulator::Now ().GetNanoSeconds ();
+  measurement.cellId = cellId;
+  measurement.rnti = rnti;
+  measurement.rsrp = rsrp;
+  measurement.sinr = sinr;
+  measurement.componentCarrierId = componentCarrierId;
+  m_measurements.push_back (measurement);
+}
+
+std::vector<LtePathlossCacheSystemTestCase::Measurement>
+LtePathlossCacheSystemTestCase::Run (bool cachePathloss)
+{
+  Config::Reset ();
+  Config::SetDefault ("ns3::LteHelper::UseIdealRrc", BooleanValue (true));
+  Config::SetDefault ("ns3::LteHelper::UseCa", BooleanValue (true));
+  Config::SetDefault ("ns3::LteHelper::NumberOfComponentCarriers", UintegerValue (2));
+  Config::SetDefault ("ns3::LteHelper::EnbComponentCarrierManager", StringValue ("ns3::RrComponentCarrierManager"));
+  m_measurements.clear ();
+
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetAttribute ("PathlossModel", TypeIdValue (TypeId::LookupByName (m_pathlossModel)));
+  lteHelper->SetAttribute ("CachePathloss", BooleanValue (cachePathloss));
+
+  NodeContainer enbNodes;
+  NodeContainer ueNodes;
+  NodeContainer movingUeNodes;
+  enbNodes.Create (2);
+  ueNodes.Create (4);
+  movingUeNodes.Create (1);
+
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0, 0, 30));
+  positionAlloc->Add (Vector (1000, 0, 30));
+  for (uint32_t i = 0; i < ueNodes.GetN (); i++)
+    {
+      positionAlloc->Add (Vector (100 + 250 * i, 50, 1.5));
+    }
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.Install (enbNodes);
+  mobility.Install (ueNodes);
+  mobility.SetMobilityModel ("ns3::ConstantVelocityMobilityModel");
+  mobility.Install (movingUeNodes);
+  Ptr<ConstantVelocityMobilityModel> movingUe = movingUeNodes.Get (0)->GetObject<ConstantVelocityMobilityModel> ();
+  movingUe->SetPosition (Vector (300, -50, 1.5));
+  movingUe->SetVelocity (Vector (20, 0, 0));
+  ueNodes.Add (movingUeNodes);
+
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+  int64_t stream = lteHelper->AssignStreams (enbDevs, 1);
+  lteHelper->AssignStreams (ueDevs, 1 + stream);
+  for (uint32_t i = 0; i < ueDevs.GetN (); i++)
+    {
+      lteHelper->Attach (ueDevs.Get (i), enbDevs.Get (i < 2 ? 0 : 1));
+    }
+
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/ComponentCarrierMapUe/*/LteUePhy/ReportCurrentCellRsrpSinr",
+                                 MakeCallback (&LtePathlossCacheSystemTestCase::ReportRsrpSinr, this));
+
+  // a static UE changes position
+  Ptr<MobilityModel> jumpingUe = ueNodes.Get (1)->GetObject<MobilityModel> ();
+  Simulator::Schedule (MilliSeconds (150), &MobilityModel::SetPosition, jumpingUe, Vector (500, 200, 1.5));
+
+  Simulator::Stop (MilliSeconds (300));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  std::sort (m_measurements.begin (), m_measurements.end ());
+  return m_measurements;
+}
+
+void
+LtePathlossCacheSystemTestCase::DoRun (void)
+{
+  std::vector<Measurement> reference = Run (false);
+  NS_TEST_ASSERT_MSG_GT (reference.size (), 0, "No measurements");
+  std::vector<Measurement> cached = Run (true);
+  NS_TEST_ASSERT_MSG_EQ (cached.size (), reference.size (), "Wrong number of measurements");
+  for (uint32_t i = 0; i < cached.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (cached[i].time, reference[i].time, "Wrong time of measurement " << i);
+      NS_TEST_ASSERT_MSG_EQ (cached[i].cellId, reference[i].cellId, "Wrong cell of measurement " << i);
+      NS_TEST_ASSERT_MSG_EQ (cached[i].rnti, reference[i].rnti, "Wrong RNTI of measurement " << i);
+      NS_TEST_ASSERT_MSG_EQ ((uint32_t) cached[i].componentCarrierId, (uint32_t) reference[i].componentCarrierId, "Wrong carrier of measurement " << i);
+      NS_TEST_ASSERT_MSG_EQ (cached[i].rsrp, reference[i].rsrp, "Wrong RSRP of measurement " << i);
+      NS_TEST_ASSERT_MSG_EQ (cached[i].sinr, reference[i].sinr, "Wrong SINR of measurement " << i);
+    }
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * LtePathlossCache test suite
+ */
+class LtePathlossCacheTestSuite : public TestSuite
+{
+public:
+  LtePathlossCacheTestSuite ();
+};
+
+LtePathlossCacheTestSuite::LtePathlossCacheTestSuite ()
+  : TestSuite ("lte-pathloss-cache", SYSTEM)
+{
+  AddTestCase (new LtePathlossCacheUnitTestCase, TestCase::QUICK);
+  // shared between the DL and the UL
+  AddTestCase (new LtePathlossCacheSystemTestCase ("ns3::LogDistancePropagationLossModel"), TestCase::QUICK);
+  // one cache per direction
+  AddTestCase (new LtePathlossCacheSystemTestCase ("ns3::FriisPropagationLossModel"), TestCase::QUICK);
+}
+
+static LtePathlossCacheTestSuite g_ltePathlossCacheTestSuite; ///< the test suite
@@ -0,0 +1,160 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <fstream>
+#include <sstream>
+#include <ns3/test.h>
+#include <ns3/simulator.h>
+#include <ns3/string.h>
+#include <ns3/double.h>
+#include <ns3/integer.h>
+#include <ns3/uinteger.h>
+#include <ns3/boolean.h>
+#include <ns3/node-container.h>
+#include <ns3/net-device-container.h>
+#include <ns3/mobility-helper.h>
+#include <ns3/spectrum-channel.h>
+#include <ns3/lte-helper.h>
+#include <ns3/radio-environment-map-helper.h>
+
+using namespace ns3;
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * Check that the REM computed directly from the loss models of the channel
+ * is the same as the one measured by the REM listeners, whatever the
+ * number of threads.
+ */
+class LteRadioEnvironmentMapTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param rbId the resource block of the map, -1 for the whole band
+   */
+  LteRadioEnvironmentMapTestCase (int32_t rbId);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Generate a REM of two sector eNBs
+   * \param directComputation whether the REM is computed directly
+   * \param nThreads the number of threads of the direct computation
+   * \return the contents of the REM output file
+   */
+  std::string Generate (bool directComputation, uint32_t nThreads);
+
+  int32_t m_rbId; ///< the resource block of the map
+};
+
+LteRadioEnvironmentMapTestCase::LteRadioEnvironmentMapTestCase (int32_t rbId)
+  : TestCase ("Direct REM computation, RbId " + std::to_string (rbId)),
+    m_rbId (rbId)
+{
+}
+
+std::string
+LteRadioEnvironmentMapTestCase::Generate (bool directComputation, uint32_t nThreads)
+{
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetAttribute ("PathlossModel", StringValue ("ns3::LogDistancePropagationLossModel"));
+  lteHelper->SetEnbAntennaModelType ("ns3::CosineAntennaModel");
+  lteHelper->SetEnbAntennaModelAttribute ("Beamwidth", DoubleValue (65));
+
+  NodeContainer enbNodes;
+  enbNodes.Create (2);
+  Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+  positions->Add (Vector (0, 0, 30));
+  positions->Add (Vector (400, 100, 30));
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positions);
+  mobility.Install (enbNodes);
+  lteHelper->SetEnbAntennaModelAttribute ("Orientation", DoubleValue (0));
+  lteHelper->InstallEnbDevice (enbNodes.Get (0));
+  lteHelper->SetEnbAntennaModelAttribute ("Orientation", DoubleValue (180));
+  lteHelper->InstallEnbDevice (enbNodes.Get (1));
+
+  std::ostringstream channelPath;
+  channelPath << "/ChannelList/" << lteHelper->GetDownlinkSpectrumChannel ()->GetId ();
+  std::string outputFile = CreateTempDirFilename ("rem.out");
+
+  Ptr<RadioEnvironmentMapHelper> remHelper = CreateObject<RadioEnvironmentMapHelper> ();
+  remHelper->SetAttribute ("ChannelPath", StringValue (channelPath.str ()));
+  remHelper->SetAttribute ("OutputFile", StringValue (outputFile));
+  remHelper->SetAttribute ("XMin", DoubleValue (-300.0));
+  remHelper->SetAttribute ("XMax", DoubleValue (700.0));
+  remHelper->SetAttribute ("XRes", UintegerValue (31));
+  remHelper->SetAttribute ("YMin", DoubleValue (-200.0));
+  remHelper->SetAttribute ("YMax", DoubleValue (300.0));
+  remHelper->SetAttribute ("YRes", UintegerValue (23));
+  remHelper->SetAttribute ("MaxPointsPerIteration", UintegerValue (100));
+  remHelper->SetAttribute ("RbId", IntegerValue (m_rbId));
+  remHelper->SetAttribute ("DirectComputation", BooleanValue (directComputation));
+  remHelper->SetAttribute ("Threads", UintegerValue (nThreads));
+  remHelper->Install ();
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  std::ifstream input (outputFile.c_str ());
+  std::ostringstream contents;
+  contents << input.rdbuf ();
+  return contents.str ();
+}
+
+void
+LteRadioEnvironmentMapTestCase::DoRun (void)
+{
+  std::string measured = Generate (false, 1);
+  std::string computed = Generate (true, 1);
+  std::string computedByThreads = Generate (true, 3);
+
+  std::istringstream lines (measured);
+  std::string line;
+  uint32_t nLines = 0;
+  while (std::getline (lines, line))
+    {
+      nLines++;
+    }
+  NS_TEST_ASSERT_MSG_EQ (nLines, 31 * 23, "Wrong number of points in the REM");
+  NS_TEST_ASSERT_MSG_EQ (computed, measured, "The computed REM is not the measured one");
+  NS_TEST_ASSERT_MSG_EQ (computedByThreads, computed, "The REM depends on the number of threads");
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * Radio environment map test suite
+ */
+class LteRadioEnvironmentMapTestSuite : public TestSuite
+{
+public:
+  LteRadioEnvironmentMapTestSuite ();
+};
+
+LteRadioEnvironmentMapTestSuite::LteRadioEnvironmentMapTestSuite ()
+  : TestSuite ("lte-radio-environment-map", SYSTEM)
+{
+  AddTestCase (new LteRadioEnvironmentMapTestCase (-1), TestCase::QUICK);
+  AddTestCase (new LteRadioEnvironmentMapTestCase (10), TestCase::QUICK);
+}
+
+static LteRadioEnvironmentMapTestSuite g_lteRadioEnvironmentMapTestSuite; ///< the test suite
@@ -0,0 +1,227 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ctime>
+#include <iostream>
+#include <ns3/test.h>
+#include <ns3/packet.h>
+#include <ns3/lte-rrc-header.h>
+#include <ns3/lte-rrc-sap.h>
+
+using namespace ns3;
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * Benchmark of the ASN.1 encoding and decoding of the RRC messages
+ * exchanged during a handover: the measurement report of the UE, the
+ * handover preparation information sent over X2, and the RRC connection
+ * reconfiguration with mobility control information.
+ */
+class LteRrcHeaderBenchmarkTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param nIterations the number of encodings and decodings of each message
+   */
+  LteRrcHeaderBenchmarkTestCase (uint32_t nIterations);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \return the radio resource configuration of a UE with a SRB and a DRB
+   */
+  static LteRrcSap::RadioResourceConfigDedicated CreateRadioResourceConfigDedicated (void);
+
+  /**
+   * Encode a message in a packet and decode it back, the given number of
+   * times, adding the time spent to the encoding and decoding totals
+   *
+   * \param msg the message
+   * \return the size of the encoded message in bytes
+   */
+  template <class H, class M>
+  uint32_t RoundTrip (M msg);
+
+  uint32_t m_nIterations; ///< the number of encodings and decodings of each message
+  clock_t m_encodingTime; ///< the total encoding time
+  clock_t m_decodingTime; ///< the total decoding time
+};
+
+LteRrcHeaderBenchmarkTestCase::LteRrcHeaderBenchmarkTestCase (uint32_t nIterations)
+  : TestCase ("Benchmark the encoding and decoding of the handover RRC messages"),
+    m_nIterations (nIterations),
+    m_encodingTime (0),
+    m_decodingTime (0)
+{
+}
+
+LteRrcSap::RadioResourceConfigDedicated
+LteRrcHeaderBenchmarkTestCase::CreateRadioResourceConfigDedicated (void)
+{
+  LteRrcSap::RadioResourceConfigDedicated rrcd;
+
+  LteRrcSap::SrbToAddMod srb;
+  srb.srbIdentity = 1;
+  srb.logicalChannelConfig.priority = 1;
+  srb.logicalChannelConfig.prioritizedBitRateKbps = 100;
+  srb.logicalChannelConfig.bucketSizeDurationMs = 100;
+  srb.logicalChannelConfig.logicalChannelGroup = 0;
+  rrcd.srbToAddModList.push_back (srb);
+
+  LteRrcSap::DrbToAddMod drb;
+  drb.epsBearerIdentity = 5;
+  drb.drbIdentity = 1;
+  drb.logicalChannelIdentity = 3;
+  drb.rlcConfig.choice = LteRrcSap::RlcConfig::AM;
+  drb.logicalChannelConfig.priority = 13;
+  drb.logicalChannelConfig.prioritizedBitRateKbps = 256;
+  drb.logicalChannelConfig.bucketSizeDurationMs = 50;
+  drb.logicalChannelConfig.logicalChannelGroup = 3;
+  rrcd.drbToAddModList.push_back (drb);
+
+  rrcd.havePhysicalConfigDedicated = true;
+  rrcd.physicalConfigDedicated.haveSoundingRsUlConfigDedicated = true;
+  rrcd.physicalConfigDedicated.soundingRsUlConfigDedicated.type = LteRrcSap::SoundingRsUlConfigDedicated::SETUP;
+  rrcd.physicalConfigDedicated.soundingRsUlConfigDedicated.srsBandwidth = 0;
+  rrcd.physicalConfigDedicated.soundingRsUlConfigDedicated.srsConfigIndex = 17;
+  rrcd.physicalConfigDedicated.haveAntennaInfoDedicated = true;
+  rrcd.physicalConfigDedicated.antennaInfo.transmissionMode = 1;
+  rrcd.physicalConfigDedicated.havePdschConfigDedicated = true;
+  rrcd.physicalConfigDedicated.pdschConfigDedicated.pa = LteRrcSap::PdschConfigDedicated::dB0;
+
+  return rrcd;
+}
+
+template <class H, class M>
+uint32_t
+LteRrcHeaderBenchmarkTestCase::RoundTrip (M msg)
+{
+  uint32_t size = 0;
+  for (uint32_t i = 0; i < m_nIterations; i++)
+    {
+      Ptr<Packet> packet = Create<Packet> ();
+      clock_t start = clock ();
+      H source;
+      source.SetMessage (msg);
+      packet->AddHeader (source);
+      clock_t encoded = clock ();
+      H destination;
+      packet->RemoveHeader (destination);
+      m_encodingTime += encoded - start;
+      m_decodingTime += clock () - encoded;
+      size = packet->GetSize () + destination.GetSerializedSize ();
+    }
+  return size;
+}
+
+void
+LteRrcHeaderBenchmarkTestCase::DoRun (void)
+{
+  LteRrcSap::MeasurementReport report;
+  report.measResults.measId = 1;
+  report.measResults.rsrpResult = 56;
+  report.measResults.rsrqResult = 20;
+  report.measResults.haveMeasResultNeighCells = true;
+  for (uint16_t cellId = 2; cellId <= 5; cellId++)
+    {
+      LteRrcSap::MeasResultEutra neighbour;
+      neighbour.physCellId = cellId;
+      neighbour.haveCgiInfo = false;
+      neighbour.haveRsrpResult = true;
+      neighbour.rsrpResult = 40 + cellId;
+      neighbour.haveRsrqResult = true;
+      neighbour.rsrqResult = 15 + cellId;
+      report.measResults.measResultListEutra.push_back (neighbour);
+    }
+  report.measResults.haveScellsMeas = false;
+
+  LteRrcSap::HandoverPreparationInfo preparation;
+  preparation.asConfig.sourceDlCarrierFreq = 100;
+  preparation.asConfig.sourceUeIdentity = 7;
+  preparation.asConfig.sourceRadioResourceConfig = CreateRadioResourceConfigDedicated ();
+  preparation.asConfig.sourceMasterInformationBlock.dlBandwidth = 100;
+  preparation.asConfig.sourceMasterInformationBlock.systemFrameNumber = 0;
+  preparation.asConfig.sourceSystemInformationBlockType1.cellAccessRelatedInfo.plmnIdentityInfo.plmnIdentity = 0;
+  preparation.asConfig.sourceSystemInformationBlockType1.cellAccessRelatedInfo.cellIdentity = 1;
+  preparation.asConfig.sourceSystemInformationBlockType1.cellAccessRelatedInfo.csgIndication = false;
+  preparation.asConfig.sourceSystemInformationBlockType1.cellAccessRelatedInfo.csgIdentity = 0;
+  preparation.asConfig.sourceSystemInformationBlockType2.freqInfo.ulCarrierFreq = 18100;
+  preparation.asConfig.sourceSystemInformationBlockType2.freqInfo.ulBandwidth = 100;
+  preparation.asConfig.sourceSystemInformationBlockType2.radioResourceConfigCommon.rachConfigCommon.preambleInfo.numberOfRaPreambles = 52;
+  preparation.asConfig.sourceSystemInformationBlockType2.radioResourceConfigCommon.rachConfigCommon.raSupervisionInfo.preambleTransMax = 50;
+  preparation.asConfig.sourceSystemInformationBlockType2.radioResourceConfigCommon.rachConfigCommon.raSupervisionInfo.raResponseWindowSize = 3;
+  preparation.asConfig.sourceMeasConfig.haveQuantityConfig = false;
+  preparation.asConfig.sourceMeasConfig.haveMeasGapConfig = false;
+  preparation.asConfig.sourceMeasConfig.haveSmeasure = false;
+  preparation.asConfig.sourceMeasConfig.haveSpeedStatePars = false;
+
+  LteRrcSap::RrcConnectionReconfiguration command;
+  command.rrcTransactionIdentifier = 1;
+  command.haveMeasConfig = false;
+  command.haveMobilityControlInfo = true;
+  command.mobilityControlInfo.targetPhysCellId = 2;
+  command.mobilityControlInfo.haveCarrierFreq = true;
+  command.mobilityControlInfo.carrierFreq.dlCarrierFreq = 100;
+  command.mobilityControlInfo.carrierFreq.ulCarrierFreq = 18100;
+  command.mobilityControlInfo.haveCarrierBandwidth = true;
+  command.mobilityControlInfo.carrierBandwidth.dlBandwidth = 100;
+  command.mobilityControlInfo.carrierBandwidth.ulBandwidth = 100;
+  command.mobilityControlInfo.newUeIdentity = 9;
+  command.mobilityControlInfo.haveRachConfigDedicated = true;
+  command.mobilityControlInfo.rachConfigDedicated.raPreambleIndex = 53;
+  command.mobilityControlInfo.rachConfigDedicated.raPrachMaskIndex = 0;
+  command.mobilityControlInfo.radioResourceConfigCommon.rachConfigCommon.preambleInfo.numberOfRaPreambles = 52;
+  command.mobilityControlInfo.radioResourceConfigCommon.rachConfigCommon.raSupervisionInfo.preambleTransMax = 50;
+  command.mobilityControlInfo.radioResourceConfigCommon.rachConfigCommon.raSupervisionInfo.raResponseWindowSize = 3;
+  command.haveRadioResourceConfigDedicated = true;
+  command.radioResourceConfigDedicated = CreateRadioResourceConfigDedicated ();
+  command.haveNonCriticalExtension = false;
+
+  uint32_t bytes = 0;
+  bytes += RoundTrip<MeasurementReportHeader> (report);
+  bytes += RoundTrip<HandoverPreparationInfoHeader> (preparation);
+  bytes += RoundTrip<RrcConnectionReconfigurationHeader> (command);
+
+  std::cout << "lte-rrc-header-perf: " << bytes << " bytes per handover: encoding "
+            << 1e6 * m_encodingTime / CLOCKS_PER_SEC / m_nIterations << " us, decoding "
+            << 1e6 * m_decodingTime / CLOCKS_PER_SEC / m_nIterations << " us per handover" << std::endl;
+
+  NS_TEST_EXPECT_MSG_GT (bytes, 0, "No bytes encoded");
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * RRC header performance test suite
+ */
+class LteRrcHeaderPerformanceTestSuite : public TestSuite
+{
+public:
+  LteRrcHeaderPerformanceTestSuite ();
+};
+
+LteRrcHeaderPerformanceTestSuite::LteRrcHeaderPerformanceTestSuite ()
+  : TestSuite ("lte-rrc-header-perf", PERFORMANCE)
+{
+  AddTestCase (new LteRrcHeaderBenchmarkTestCase (20000), TestCase::QUICK);
+}
+
+static LteRrcHeaderPerformanceTestSuite g_lteRrcHeaderPerformanceTestSuite; ///< the performance test suite
@@ -0,0 +1,317 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+#include <ns3/core-config.h>
+#include <ns3/test.h>
+#include <ns3/simulator.h>
+#include <ns3/config.h>
+#include <ns3/boolean.h>
+#include <ns3/uinteger.h>
+#include <ns3/enum.h>
+#include <ns3/global-value.h>
+#include <ns3/mobility-helper.h>
+#include <ns3/lte-helper.h>
+#include <ns3/lte-enb-mac.h>
+#include <ns3/lte-amc.h>
+#include <ns3/lte-subframe-batch.h>
+#ifdef HAVE_PTHREAD_H
+#include <ns3/system-thread.h>
+#endif
+
+using namespace ns3;
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * Make sure that the DL scheduling decisions, which depend on the CQI
+ * feedbacks of the UEs, are the same whether the CQIs are computed in
+ * place or by the LteSubframeBatch, with one or several threads.
+ */
+class LteSubframeBatchTestCase : public TestCase
+{
+public:
+  LteSubframeBatchTestCase ();
+  virtual ~LteSubframeBatchTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /// A DL scheduling decision
+  struct Decision
+  {
+    int64_t time; ///< the time in ns
+    uint32_t enb; ///< the index of the eNB
+    uint16_t rnti; ///< the RNTI
+    uint8_t mcs; ///< the MCS of the first TB
+    uint16_t size; ///< the size of the first TB
+  };
+
+  /**
+   * Run a two-cell scenario
+   * \param nThreads the value of the LteSubframeThreads global value
+   * \return the DL scheduling decisions
+   */
+  std::vector<Decision> Run (uint32_t nThreads);
+  /**
+   * Record a DL scheduling decision
+   * \param path the trace path
+   * \param info the decision
+   */
+  void DlScheduling (std::string path, DlSchedulingCallbackInfo info);
+
+  std::vector<Decision> m_decisions; ///< the decisions of the current run
+};
+
+LteSubframeBatchTestCase::LteSubframeBatchTestCase ()
+  : TestCase ("Check that batching the CQI computation does not change the results")
+{
+}
+
+LteSubframeBatchTestCase::~LteSubframeBatchTestCase ()
+{
+}
+
+void
+LteSubframeBatchTestCase::DlScheduling (std::string path, DlSchedulingCallbackInfo info)
+{
+  Decision decision;
+  decision.time = Simulator::Now ().GetNanoSeconds ();
+  decision.rnti = info.rnti;
+  decision.mcs = info.mcsTb1;
+  decision.size = info.sizeTb1;
+  // the eNBs are the first two nodes
+  decision.enb = path.find ("/NodeList/0/") == 0 ? 0 : 1;
+  m_decisions.push_back (decision);
+}
+
+std::vector<LteSubframeBatchTestCase::Decision>
+LteSubframeBatchTestCase::Run (uint32_t nThreads)
+{
+  Config::Reset ();
+  GlobalValue::Bind ("LteSubframeThreads", UintegerValue (nThreads));
+  Config::SetDefault ("ns3::LteHelper::UseIdealRrc", BooleanValue (true));
+  Config::SetDefault ("ns3::LteAmc::AmcModel", EnumValue (LteAmc::MiErrorModel));
+  m_decisions.clear ();
+
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetSchedulerType ("ns3::PfFfMacScheduler");
+
+  NodeContainer enbNodes;
+  NodeContainer ueNodes;
+  enbNodes.Create (2);
+  ueNodes.Create (6);
+
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0, 0, 0));
+  positionAlloc->Add (Vector (1000, 0, 0));
+  for (uint32_t i = 0; i < ueNodes.GetN (); i++)
+    {
+      positionAlloc->Add (Vector (100 + 130 * i, 50, 0));
+    }
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.Install (enbNodes);
+  mobility.Install (ueNodes);
+
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+  // the runs share the random variable streams
+  int64_t stream = lteHelper->AssignStreams (enbDevs, 1);
+  lteHelper->AssignStreams (ueDevs, 1 + stream);
+  for (uint32_t i = 0; i < ueDevs.GetN (); i++)
+    {
+      lteHelper->Attach (ueDevs.Get (i), enbDevs.Get (i < 3 ? 0 : 1));
+    }
+  EpsBearer bearer (EpsBearer::NGBR_VIDEO_TCP_DEFAULT);
+  lteHelper->ActivateDataRadioBearer (ueDevs, bearer);
+
+  Config::Connect ("/NodeList/*/DeviceList/*/ComponentCarrierMap/*/LteEnbMac/DlScheduling",
+                   MakeCallback (&LteSubframeBatchTestCase::DlScheduling, this));
+
+  Simulator::Stop (MilliSeconds (300));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  GlobalValue::Bind ("LteSubframeThreads", UintegerValue (0));
+
+  return m_decisions;
+}
+
+void
+LteSubframeBatchTestCase::DoRun (void)
+{
+  std::vector<Decision> reference = Run (0);
+  NS_TEST_ASSERT_MSG_GT (reference.size (), 0, "No DL scheduling decisions");
+
+  uint32_t nThreads[] = {1, 4};
+  for (uint32_t n = 0; n < 2; n++)
+    {
+      std::vector<Decision> decisions = Run (nThreads[n]);
+      NS_TEST_ASSERT_MSG_EQ (decisions.size (), reference.size (), "Wrong number of decisions with " << nThreads[n] << " threads");
+      for (uint32_t i = 0; i < decisions.size (); i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (decisions[i].time, reference[i].time, "Wrong time of decision " << i << " with " << nThreads[n] << " threads");
+          NS_TEST_ASSERT_MSG_EQ (decisions[i].enb, reference[i].enb, "Wrong eNB of decision " << i << " with " << nThreads[n] << " threads");
+          NS_TEST_ASSERT_MSG_EQ (decisions[i].rnti, reference[i].rnti, "Wrong RNTI of decision " << i << " with " << nThreads[n] << " threads");
+          NS_TEST_ASSERT_MSG_EQ ((uint32_t) decisions[i].mcs, (uint32_t) reference[i].mcs, "Wrong MCS of decision " << i << " with " << nThreads[n] << " threads");
+          NS_TEST_ASSERT_MSG_EQ (decisions[i].size, reference[i].size, "Wrong TB size of decision " << i << " with " << nThreads[n] << " threads");
+        }
+    }
+}
+
+#ifdef HAVE_PTHREAD_H
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * Make sure that the batch shares the compute parts of the jobs between
+ * its threads, and runs their apply parts in the simulation thread, in
+ * the order they were posted, flush after flush.
+ */
+class LteSubframeBatchThreadsTestCase : public TestCase
+{
+public:
+  LteSubframeBatchThreadsTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /// Post the jobs of a subframe
+  void PostJobs (void);
+  /**
+   * Compute part of a job
+   * \param job the index of the job
+   */
+  void Compute (uint32_t job);
+  /**
+   * Apply part of a job
+   * \param job the index of the job
+   */
+  void Apply (uint32_t job);
+
+  /// the number of jobs posted per subframe
+  static const uint32_t JOBS_PER_SUBFRAME = 12;
+
+  SystemThread::ThreadId m_simulationThread; ///< the simulation thread
+  std::vector<SystemThread::ThreadId> m_computeThreads; ///< the thread which computed each job
+  std::vector<uint8_t> m_computed; ///< whether each job was computed, not packed in bits since the threads write it concurrently
+  std::vector<uint32_t> m_applied; ///< the jobs in the order they were applied
+  bool m_appliedInSimulationThread; ///< whether all the jobs were applied in the simulation thread
+};
+
+LteSubframeBatchThreadsTestCase::LteSubframeBatchThreadsTestCase ()
+  : TestCase ("Check that the batch computes the jobs on its threads")
+{
+}
+
+void
+LteSubframeBatchThreadsTestCase::PostJobs (void)
+{
+  uint32_t first = m_computeThreads.size ();
+  m_computeThreads.resize (first + JOBS_PER_SUBFRAME);
+  m_computed.resize (first + JOBS_PER_SUBFRAME, 0);
+  for (uint32_t job = first; job < first + JOBS_PER_SUBFRAME; job++)
+    {
+      LteSubframeBatch::Post (MakeCallback (&LteSubframeBatchThreadsTestCase::Compute, this).Bind (job),
+                              MakeCallback (&LteSubframeBatchThreadsTestCase::Apply, this).Bind (job));
+    }
+}
+
+void
+LteSubframeBatchThreadsTestCase::Compute (uint32_t job)
+{
+  // each job only writes its own slots
+  m_computeThreads[job] = SystemThread::Self ();
+  m_computed[job] = 1;
+}
+
+void
+LteSubframeBatchThreadsTestCase::Apply (uint32_t job)
+{
+  m_appliedInSimulationThread = m_appliedInSimulationThread && SystemThread::Equals (m_simulationThread);
+  NS_TEST_EXPECT_MSG_EQ ((uint32_t) m_computed[job], 1, "Job " << job << " applied before being computed");
+  m_applied.push_back (job);
+}
+
+void
+LteSubframeBatchThreadsTestCase::DoRun (void)
+{
+  const uint32_t nThreads = 4;
+  const uint32_t nSubframes = 100;
+  GlobalValue::Bind ("LteSubframeThreads", UintegerValue (nThreads));
+  m_simulationThread = SystemThread::Self ();
+  m_appliedInSimulationThread = true;
+  for (uint32_t i = 0; i < nSubframes; i++)
+    {
+      Simulator::Schedule (MilliSeconds (i), &LteSubframeBatchThreadsTestCase::PostJobs, this);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  GlobalValue::Bind ("LteSubframeThreads", UintegerValue (0));
+
+  NS_TEST_ASSERT_MSG_EQ (m_applied.size (), nSubframes * JOBS_PER_SUBFRAME, "Wrong number of jobs applied");
+  for (uint32_t job = 0; job < m_applied.size (); job++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_applied[job], job, "Jobs not applied in the order they were posted");
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_appliedInSimulationThread, true, "Jobs applied outside the simulation thread");
+
+  // the jobs are shared out round robin between the threads, the
+  // simulation thread taking the first one of each subframe, and the same
+  // workers compute the same share of every subframe
+  for (uint32_t job = 0; job < m_computeThreads.size (); job++)
+    {
+      uint32_t share = job % JOBS_PER_SUBFRAME % nThreads;
+      bool inSimulationThread = pthread_equal (m_computeThreads[job], m_simulationThread) != 0;
+      NS_TEST_ASSERT_MSG_EQ (inSimulationThread, (share == 0), "Job " << job << " computed by the wrong thread");
+      NS_TEST_ASSERT_MSG_EQ ((pthread_equal (m_computeThreads[job], m_computeThreads[share]) != 0), true,
+                             "Job " << job << " not computed by the thread of its share");
+    }
+  for (uint32_t k = 1; k < nThreads; k++)
+    {
+      for (uint32_t l = 0; l < k; l++)
+        {
+          NS_TEST_ASSERT_MSG_EQ ((pthread_equal (m_computeThreads[k], m_computeThreads[l]) != 0), false,
+                                 "Shares " << k << " and " << l << " computed by the same thread");
+        }
+    }
+}
+#endif /* HAVE_PTHREAD_H */
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * LteSubframeBatch test suite
+ */
+class LteSubframeBatchTestSuite : public TestSuite
+{
+public:
+  LteSubframeBatchTestSuite ();
+};
+
+LteSubframeBatchTestSuite::LteSubframeBatchTestSuite ()
+  : TestSuite ("lte-subframe-batch", SYSTEM)
+{
+  AddTestCase (new LteSubframeBatchTestCase, TestCase::QUICK);
+#ifdef HAVE_PTHREAD_H
+  AddTestCase (new LteSubframeBatchThreadsTestCase, TestCase::QUICK);
+#endif
+}
+
+static LteSubframeBatchTestSuite g_lteSubframeBatchTestSuite; ///< the test suite
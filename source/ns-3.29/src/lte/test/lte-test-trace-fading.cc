@@ -0,0 +1,147 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <string>
+#include <ns3/test.h>
+#include <ns3/string.h>
+#include <ns3/uinteger.h>
+#include <ns3/nstime.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/lte-spectrum-value-helper.h>
+#include <ns3/trace-fading-loss-model.h>
+
+using namespace ns3;
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * Make sure that a fading trace converted to the binary format gives the
+ * same fading as the text trace, including when the binary trace is
+ * shared by several models, and when the models use less samples than
+ * the trace has.
+ */
+class LteTraceFadingBinaryTestCase : public TestCase
+{
+public:
+  /**
+   * \param samplesNum the SamplesNum attribute of the models, at most
+   * the 1000 samples per RB of the trace
+   */
+  LteTraceFadingBinaryTestCase (uint32_t samplesNum);
+  virtual ~LteTraceFadingBinaryTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param fileName the trace file
+   * \return a fading model using the trace
+   */
+  Ptr<TraceFadingLossModel> CreateModel (std::string fileName);
+
+  uint32_t m_samplesNum; ///< the SamplesNum attribute of the models
+};
+
+LteTraceFadingBinaryTestCase::LteTraceFadingBinaryTestCase (uint32_t samplesNum)
+  : TestCase ("Check the binary fading traces with SamplesNum " + std::to_string (samplesNum)),
+    m_samplesNum (samplesNum)
+{
+}
+
+LteTraceFadingBinaryTestCase::~LteTraceFadingBinaryTestCase ()
+{
+}
+
+Ptr<TraceFadingLossModel>
+LteTraceFadingBinaryTestCase::CreateModel (std::string fileName)
+{
+  Ptr<TraceFadingLossModel> model = CreateObject<TraceFadingLossModel> ();
+  model->SetAttribute ("TraceFilename", StringValue (fileName));
+  model->SetAttribute ("TraceLength", TimeValue (Seconds (1.0)));
+  model->SetAttribute ("SamplesNum", UintegerValue (m_samplesNum));
+  model->SetAttribute ("WindowSize", TimeValue (Seconds (0.5)));
+  model->SetAttribute ("RbNum", UintegerValue (6));
+  model->AssignStreams (1);
+  model->Initialize ();
+  return model;
+}
+
+void
+LteTraceFadingBinaryTestCase::DoRun (void)
+{
+  std::string textFile = CreateTempDirFilename ("fading-trace.fad");
+  std::string binaryFile = CreateTempDirFilename ("fading-trace.bin");
+  std::ofstream out (textFile.c_str ());
+  for (uint32_t rb = 0; rb < 6; rb++)
+    {
+      for (uint32_t i = 0; i < 1000; i++)
+        {
+          out << -0.5 * rb + 0.01 * (i % 300) - 1.5 << " ";
+        }
+      out << std::endl;
+    }
+  out.close ();
+  TraceFadingLossModel::ConvertTrace (textFile, binaryFile, 6, 1000);
+
+  Ptr<TraceFadingLossModel> text = CreateModel (textFile);
+  Ptr<TraceFadingLossModel> binary = CreateModel (binaryFile);
+  Ptr<TraceFadingLossModel> shared = CreateModel (binaryFile);
+
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<SpectrumValue> txPsd = Create<SpectrumValue> (LteSpectrumValueHelper::GetSpectrumModel (100, 6));
+  (*txPsd) = 1e-9;
+  Ptr<SpectrumValue> rxText = text->CalcRxPowerSpectralDensity (txPsd, a, b);
+  Ptr<SpectrumValue> rxBinary = binary->CalcRxPowerSpectralDensity (txPsd, a, b);
+  Ptr<SpectrumValue> rxShared = shared->CalcRxPowerSpectralDensity (txPsd, a, b);
+  for (uint32_t rb = 0; rb < 6; rb++)
+    {
+      NS_TEST_EXPECT_MSG_NE ((*rxText)[rb], (*txPsd)[rb], "No fading on RB " << rb);
+      NS_TEST_EXPECT_MSG_EQ ((*rxBinary)[rb], (*rxText)[rb], "Wrong fading of the binary trace on RB " << rb);
+      NS_TEST_EXPECT_MSG_EQ ((*rxShared)[rb], (*rxText)[rb], "Wrong fading of the shared binary trace on RB " << rb);
+    }
+
+  text->Dispose ();
+  binary->Dispose ();
+  shared->Dispose ();
+  std::remove (textFile.c_str ());
+  std::remove (binaryFile.c_str ());
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * TraceFadingLossModel test suite
+ */
+class LteTraceFadingTestSuite : public TestSuite
+{
+public:
+  LteTraceFadingTestSuite ();
+};
+
+LteTraceFadingTestSuite::LteTraceFadingTestSuite ()
+  : TestSuite ("lte-trace-fading", UNIT)
+{
+  AddTestCase (new LteTraceFadingBinaryTestCase (1000), TestCase::QUICK);
+  AddTestCase (new LteTraceFadingBinaryTestCase (400), TestCase::QUICK);
+}
+
+static LteTraceFadingTestSuite g_lteTraceFadingTestSuite; ///< the test suite
@@ -26,10 +26,15 @@
 #include "ns3/test.h"
 #include "ns3/ptr.h"
 #include "ns3/packet.h"
+#include "ns3/random-variable-stream.h"
 
 #include "ns3/lte-rrc-header.h"
 #include "ns3/lte-rrc-sap.h"
 
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE ("Asn1EncodingTest");
@@ -133,6 +138,11 @@ public:
    * \param rrcd2 LteRrcSap::RadioResourceConfigDedicated # 2
    */
   void AssertEqualRadioResourceConfigDedicated (LteRrcSap::RadioResourceConfigDedicated rrcd1, LteRrcSap::RadioResourceConfigDedicated rrcd2);
+  /**
+   * \brief Assert the serialized contents of the packet
+   * \param hex the expected contents, as space separated hex octets
+   */
+  void AssertPacketContents (std::string hex);
 
 protected:
   Ptr<Packet> packet; ///< the packet
@@ -142,6 +152,24 @@ RrcHeaderTestCase::RrcHeaderTestCase (std::string s) : TestCase (s)
 {
 }
 
+void
+RrcHeaderTestCase::AssertPacketContents (std::string hex)
+{
+  uint32_t psize = packet->GetSize ();
+  std::vector<uint8_t> buffer (psize);
+  packet->CopyData (buffer.data (), psize);
+  std::ostringstream oss;
+  for (uint32_t i = 0; i < psize; i++)
+    {
+      if (i > 0)
+        {
+          oss << " ";
+        }
+      oss << std::hex << std::setw (2) << std::setfill ('0') << (uint32_t) buffer[i];
+    }
+  NS_TEST_ASSERT_MSG_EQ (oss.str (), hex, "Serialized packet contents");
+}
+
 LteRrcSap::RadioResourceConfigDedicated
 RrcHeaderTestCase::CreateRadioResourceConfigDedicated ()
 {
@@ -329,6 +357,9 @@ RrcConnectionRequestTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the serialized contents against the reference encoding
+  AssertPacketContents ("48 3f ec af ec a6");
+
   // Remove header
   RrcConnectionRequestHeader destination;
   packet->RemoveHeader (destination);
@@ -382,6 +413,10 @@ RrcConnectionSetupTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the serialized contents against the reference encoding
+  AssertPacketContents ("7f 81 c8 ce 14 e0 b8 80 80 4d 98 46 10 84 28 1a "
+                        "60 00 30 04 00");
+
   // remove header
   RrcConnectionSetupHeader destination;
   packet->RemoveHeader (destination);
@@ -435,6 +470,9 @@ RrcConnectionSetupCompleteTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the serialized contents against the reference encoding
+  AssertPacketContents ("26 40");
+
   // Remove header
   RrcConnectionSetupCompleteHeader destination;
   packet->RemoveHeader (destination);
@@ -487,6 +525,9 @@ RrcConnectionReconfigurationCompleteTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the serialized contents against the reference encoding
+  AssertPacketContents ("15");
+
   // remove header
   RrcConnectionReconfigurationCompleteHeader destination;
   packet->RemoveHeader (destination);
@@ -650,6 +691,13 @@ RrcConnectionReconfigurationTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the serialized contents against the reference encoding
+  AssertPacketContents ("24 1a 3f e8 6c c0 08 3e 00 0a 9e 60 90 20 98 3b "
+                        "a0 00 23 40 53 e8 26 78 2a 04 3e 49 4c 81 1c 42 "
+                        "62 90 67 5a 21 e2 ae 70 a6 13 40 90 00 0c 00 05 "
+                        "99 00 00 b4 00 00 02 00 00 00 00 08 08 9c 8c e1 "
+                        "4e 0b 88 08 04 d9 84 61 08 42 81 a6 00 03 00 40");
+
   // remove header
   RrcConnectionReconfigurationHeader destination;
   packet->RemoveHeader (destination);
@@ -768,6 +816,13 @@ HandoverPreparationInfoTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the serialized contents against the reference encoding
+  AssertPacketContents ("08 00 00 39 19 c2 9c 17 10 10 09 b3 08 c2 10 85 "
+                        "03 4c 00 06 00 80 00 05 b0 02 a0 88 44 8c 00 00 "
+                        "00 00 00 a4 00 00 02 14 00 00 00 00 00 01 00 00 "
+                        "00 1e 00 00 00 00 00 00 7e 11 00 08 00 00 60 00 "
+                        "55 e0 00 00 30");
+
   // remove header
   HandoverPreparationInfoHeader destination;
   packet->RemoveHeader (destination);
@@ -829,6 +884,9 @@ RrcConnectionReestablishmentRequestTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the serialized contents against the reference encoding
+  AssertPacketContents ("00 01 81 50 00 04");
+
   // remove header
   RrcConnectionReestablishmentRequestHeader destination;
   packet->RemoveHeader (destination);
@@ -883,6 +941,10 @@ RrcConnectionReestablishmentTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the serialized contents against the reference encoding
+  AssertPacketContents ("10 1c 8c e1 4e 0b 88 08 04 d9 84 61 08 42 81 a6 "
+                        "00 03 00 40");
+
   // remove header
   RrcConnectionReestablishmentHeader destination;
   packet->RemoveHeader (destination);
@@ -935,6 +997,9 @@ RrcConnectionReestablishmentCompleteTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the serialized contents against the reference encoding
+  AssertPacketContents ("1e 00");
+
   // remove header
   RrcConnectionReestablishmentCompleteHeader destination;
   packet->RemoveHeader (destination);
@@ -986,6 +1051,9 @@ RrcConnectionRejectTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the serialized contents against the reference encoding
+  AssertPacketContents ("40 20");
+
   // remove header
   RrcConnectionRejectHeader destination;
   packet->RemoveHeader (destination);
@@ -1054,6 +1122,9 @@ MeasurementReportTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the serialized contents against the reference encoding
+  AssertPacketContents ("08 02 42 4a 82 09 00 e0 00 00 06 00 05 68 56");
+
   // remove header
   MeasurementReportHeader destination;
   packet->RemoveHeader (destination);
@@ -1115,6 +1186,261 @@ MeasurementReportTestCase::DoRun (void)
   packet = 0;
 }
 
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Header made of a list of fields, encoded with the ASN.1 primitives
+ */
+class Asn1PrimitivesTestHeader : public Asn1Header
+{
+public:
+  /// The kind of a field
+  enum Kind
+  {
+    INTEGER,
+    BOOLEAN,
+    BITSTRING8,
+    BITSTRING27,
+    SEQUENCE5
+  };
+
+  /// A field of the header
+  struct Field
+  {
+    Kind kind; ///< the kind of the field
+    int nmin; ///< the lower bound of an integer
+    int nmax; ///< the upper bound of an integer
+    uint32_t value; ///< the value, relative to the lower bound for an integer
+  };
+
+  /**
+   * Constructor
+   * \param fields the fields
+   */
+  Asn1PrimitivesTestHeader (std::vector<Field> fields);
+
+  // Inherited from Asn1Header
+  virtual void PreSerialize (void) const;
+  virtual uint32_t Deserialize (Buffer::Iterator bIterator);
+  virtual void Print (std::ostream &os) const;
+
+  std::vector<Field> m_fields; ///< the fields
+};
+
+Asn1PrimitivesTestHeader::Asn1PrimitivesTestHeader (std::vector<Field> fields)
+  : m_fields (fields)
+{
+}
+
+void
+Asn1PrimitivesTestHeader::PreSerialize (void) const
+{
+  m_serializationResult.clear ();
+  for (std::vector<Field>::const_iterator it = m_fields.begin (); it != m_fields.end (); ++it)
+    {
+      switch (it->kind)
+        {
+        case INTEGER:
+          SerializeInteger (it->nmin + it->value, it->nmin, it->nmax);
+          break;
+        case BOOLEAN:
+          SerializeBoolean (it->value != 0);
+          break;
+        case BITSTRING8:
+          SerializeBitstring (std::bitset<8> (it->value));
+          break;
+        case BITSTRING27:
+          SerializeBitstring (std::bitset<27> (it->value));
+          break;
+        case SEQUENCE5:
+          SerializeSequence (std::bitset<5> (it->value), true);
+          break;
+        }
+    }
+  FinalizeSerialization ();
+}
+
+uint32_t
+Asn1PrimitivesTestHeader::Deserialize (Buffer::Iterator bIterator)
+{
+  Buffer::Iterator start = bIterator;
+  for (std::vector<Field>::iterator it = m_fields.begin (); it != m_fields.end (); ++it)
+    {
+      switch (it->kind)
+        {
+        case INTEGER:
+          {
+            int n = it->nmin;
+            bIterator = DeserializeInteger (&n, it->nmin, it->nmax, bIterator);
+            it->value = n - it->nmin;
+          }
+          break;
+        case BOOLEAN:
+          {
+            bool value;
+            bIterator = DeserializeBoolean (&value, bIterator);
+            it->value = value ? 1 : 0;
+          }
+          break;
+        case BITSTRING8:
+          {
+            std::bitset<8> value;
+            bIterator = DeserializeBitstring (&value, bIterator);
+            it->value = value.to_ulong ();
+          }
+          break;
+        case BITSTRING27:
+          {
+            std::bitset<27> value;
+            bIterator = DeserializeBitstring (&value, bIterator);
+            it->value = value.to_ulong ();
+          }
+          break;
+        case SEQUENCE5:
+          {
+            std::bitset<5> value;
+            bIterator = DeserializeSequence (&value, true, bIterator);
+            it->value = value.to_ulong ();
+          }
+          break;
+        }
+    }
+  return bIterator.GetDistanceFrom (start);
+}
+
+void
+Asn1PrimitivesTestHeader::Print (std::ostream &os) const
+{
+  os << m_fields.size () << " fields";
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test the ASN.1 primitives against a bit by bit reference encoding
+ * of random fields, which are not aligned on octets
+ */
+class Asn1PrimitivesTestCase : public TestCase
+{
+public:
+  Asn1PrimitivesTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Append a value to a string of bits, most significant bit first
+   * \param bits the string of bits
+   * \param value the value
+   * \param numBits the number of bits of the value
+   */
+  static void AppendBits (std::string &bits, uint32_t value, int numBits);
+};
+
+Asn1PrimitivesTestCase::Asn1PrimitivesTestCase ()
+  : TestCase ("Testing the ASN.1 primitives against a reference encoding")
+{
+}
+
+void
+Asn1PrimitivesTestCase::AppendBits (std::string &bits, uint32_t value, int numBits)
+{
+  for (int i = numBits - 1; i >= 0; i--)
+    {
+      bits += ((value >> i) & 1) ? '1' : '0';
+    }
+}
+
+void
+Asn1PrimitivesTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (1);
+
+  for (uint32_t header = 0; header < 100; header++)
+    {
+      // Build random fields, and their reference encoding (ITU-T X.691,
+      // unaligned variant)
+      std::vector<Asn1PrimitivesTestHeader::Field> fields;
+      std::string bits;
+      uint32_t numFields = random->GetInteger (1, 40);
+      for (uint32_t i = 0; i < numFields; i++)
+        {
+          Asn1PrimitivesTestHeader::Field field;
+          field.kind = static_cast<Asn1PrimitivesTestHeader::Kind> (random->GetInteger (0, 4));
+          field.nmin = 0;
+          field.nmax = 0;
+          switch (field.kind)
+            {
+            case Asn1PrimitivesTestHeader::INTEGER:
+              {
+                field.nmin = static_cast<int> (random->GetInteger (0, 100)) - 50;
+                uint32_t range = random->GetInteger (1, 1 << random->GetInteger (0, 20));
+                field.nmax = field.nmin + range - 1;
+                field.value = random->GetInteger (0, range - 1);
+                int numBits = 0;
+                while ((1u << numBits) < range)
+                  {
+                    numBits++;
+                  }
+                AppendBits (bits, field.value, numBits);
+              }
+              break;
+            case Asn1PrimitivesTestHeader::BOOLEAN:
+              field.value = random->GetInteger (0, 1);
+              AppendBits (bits, field.value, 1);
+              break;
+            case Asn1PrimitivesTestHeader::BITSTRING8:
+              field.value = random->GetInteger (0, 0xff);
+              AppendBits (bits, field.value, 8);
+              break;
+            case Asn1PrimitivesTestHeader::BITSTRING27:
+              field.value = random->GetInteger (0, 0x7ffffff);
+              AppendBits (bits, field.value, 27);
+              break;
+            case Asn1PrimitivesTestHeader::SEQUENCE5:
+              field.value = random->GetInteger (0, 0x1f);
+              // extension bit, then the optional or default fields mask
+              AppendBits (bits, 0, 1);
+              AppendBits (bits, field.value, 5);
+              break;
+            }
+          fields.push_back (field);
+        }
+      while (bits.size () % 8 != 0)
+        {
+          bits += '0';
+        }
+
+      Asn1PrimitivesTestHeader source (fields);
+      Ptr<Packet> packet = Create<Packet> ();
+      packet->AddHeader (source);
+
+      NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), bits.size () / 8, "Wrong encoding size");
+      std::vector<uint8_t> buffer (packet->GetSize ());
+      packet->CopyData (buffer.data (), buffer.size ());
+      for (uint32_t i = 0; i < buffer.size (); i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ ((uint32_t) buffer[i], std::bitset<8> (bits.substr (8 * i, 8)).to_ulong (),
+                                 "Wrong octet " << i << " of header " << header);
+        }
+
+      for (std::vector<Asn1PrimitivesTestHeader::Field>::iterator it = fields.begin (); it != fields.end (); ++it)
+        {
+          it->value = 0;
+        }
+      Asn1PrimitivesTestHeader destination (fields);
+      packet->RemoveHeader (destination);
+      NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), 0, "Header not fully decoded");
+      for (uint32_t i = 0; i < numFields; i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (destination.m_fields[i].value, source.m_fields[i].value,
+                                 "Wrong value of field " << i << " of header " << header);
+        }
+    }
+}
+
 /**
  * \ingroup lte-test
  * \ingroup tests
@@ -1142,6 +1468,7 @@ Asn1EncodingSuite::Asn1EncodingSuite ()
   AddTestCase (new RrcConnectionReestablishmentCompleteTestCase (), TestCase::QUICK);
   AddTestCase (new RrcConnectionRejectTestCase (), TestCase::QUICK);
   AddTestCase (new MeasurementReportTestCase (), TestCase::QUICK);
+  AddTestCase (new Asn1PrimitivesTestCase (), TestCase::QUICK);
 }
 
 Asn1EncodingSuite asn1EncodingSuite;
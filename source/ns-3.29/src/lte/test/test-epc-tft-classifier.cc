@@ -24,6 +24,7 @@
 #include "ns3/log.h"
 #include "ns3/packet.h"
 #include "ns3/ipv4-header.h"
+#include "ns3/ipv6-header.h"
 #include "ns3/udp-header.h"
 #include "ns3/tcp-header.h"
 #include "ns3/udp-l4-protocol.h"
@@ -170,6 +171,126 @@ EpcTftClassifierTestCase::DoRun (void)
 
 
 
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test case to check that the classification cached for each flow
+ * follows the addition and deletion of TFTs, and that the ports of
+ * fragmented IPv4 packets and of IPv6 packets are taken into account.
+ */
+class EpcTftClassifierCacheTestCase : public TestCase
+{
+public:
+  EpcTftClassifierCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Create an IPv4 UDP packet, or a fragment of it
+   * \param sp the source port
+   * \param dp the destination port
+   * \param fragmentOffset the offset of the fragment in bytes
+   * \param lastFragment whether it is the last fragment
+   * \returns the packet
+   */
+  static Ptr<Packet> CreateIpv4Packet (uint16_t sp, uint16_t dp, uint16_t fragmentOffset, bool lastFragment);
+
+  /**
+   * Create an IPv6 UDP packet
+   * \param sp the source port
+   * \param dp the destination port
+   * \returns the packet
+   */
+  static Ptr<Packet> CreateIpv6Packet (uint16_t sp, uint16_t dp);
+};
+
+EpcTftClassifierCacheTestCase::EpcTftClassifierCacheTestCase ()
+  : TestCase ("Classification of flows across TFT updates, fragments and IPv6")
+{
+}
+
+Ptr<Packet>
+EpcTftClassifierCacheTestCase::CreateIpv4Packet (uint16_t sp, uint16_t dp, uint16_t fragmentOffset, bool lastFragment)
+{
+  Ptr<Packet> packet = Create<Packet> (100);
+  if (fragmentOffset == 0)
+    {
+      UdpHeader udpHeader;
+      udpHeader.SetSourcePort (sp);
+      udpHeader.SetDestinationPort (dp);
+      packet->AddHeader (udpHeader);
+    }
+  Ipv4Header ipHeader;
+  ipHeader.SetSource (Ipv4Address ("9.1.1.1"));
+  ipHeader.SetDestination (Ipv4Address ("8.1.1.1"));
+  ipHeader.SetProtocol (UdpL4Protocol::PROT_NUMBER);
+  ipHeader.SetPayloadSize (packet->GetSize ());
+  ipHeader.SetIdentification (7);
+  ipHeader.SetFragmentOffset (fragmentOffset);
+  if (lastFragment)
+    {
+      ipHeader.SetLastFragment ();
+    }
+  else
+    {
+      ipHeader.SetMoreFragments ();
+    }
+  packet->AddHeader (ipHeader);
+  return packet;
+}
+
+Ptr<Packet>
+EpcTftClassifierCacheTestCase::CreateIpv6Packet (uint16_t sp, uint16_t dp)
+{
+  Ptr<Packet> packet = Create<Packet> (100);
+  UdpHeader udpHeader;
+  udpHeader.SetSourcePort (sp);
+  udpHeader.SetDestinationPort (dp);
+  packet->AddHeader (udpHeader);
+  Ipv6Header ipHeader;
+  ipHeader.SetSourceAddress (Ipv6Address ("2001:1::1"));
+  ipHeader.SetDestinationAddress (Ipv6Address ("2001:2::1"));
+  ipHeader.SetNextHeader (UdpL4Protocol::PROT_NUMBER);
+  ipHeader.SetPayloadLength (packet->GetSize ());
+  packet->AddHeader (ipHeader);
+  return packet;
+}
+
+void
+EpcTftClassifierCacheTestCase::DoRun (void)
+{
+  Ptr<EpcTftClassifier> c = Create<EpcTftClassifier> ();
+  c->Add (EpcTft::Default (), 1);
+  Ptr<EpcTft> tft = Create<EpcTft> ();
+  EpcTft::PacketFilter pf;
+  pf.localPortStart = 3456;
+  pf.localPortEnd = 3489;
+  tft->Add (pf);
+  c->Add (tft, 2);
+
+  Ptr<Packet> packet = CreateIpv4Packet (9, 3460, 0, true);
+  uint32_t size = packet->GetSize ();
+  NS_TEST_ASSERT_MSG_EQ (c->Classify (packet, EpcTft::DOWNLINK), 2, "bad classification of a new flow");
+  NS_TEST_ASSERT_MSG_EQ (c->Classify (packet, EpcTft::DOWNLINK), 2, "bad classification of a cached flow");
+  NS_TEST_ASSERT_MSG_EQ (c->Classify (packet, EpcTft::UPLINK), 1, "the direction is not part of the flow");
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), size, "the classified packet was modified");
+
+  c->Delete (2);
+  NS_TEST_ASSERT_MSG_EQ (c->Classify (packet, EpcTft::DOWNLINK), 1, "flow not reclassified after a TFT deletion");
+  c->Add (tft, 3);
+  NS_TEST_ASSERT_MSG_EQ (c->Classify (packet, EpcTft::DOWNLINK), 3, "flow not reclassified after a TFT addition");
+
+  // only the first fragment carries the ports
+  NS_TEST_ASSERT_MSG_EQ (c->Classify (CreateIpv4Packet (9, 3470, 0, false), EpcTft::DOWNLINK), 3, "bad classification of the first fragment");
+  NS_TEST_ASSERT_MSG_EQ (c->Classify (CreateIpv4Packet (0, 0, 1000, true), EpcTft::DOWNLINK), 3, "bad classification of the last fragment");
+  NS_TEST_ASSERT_MSG_EQ (c->Classify (CreateIpv4Packet (0, 0, 1000, true), EpcTft::DOWNLINK), 1, "ports of a completed packet still in use");
+
+  NS_TEST_ASSERT_MSG_EQ (c->Classify (CreateIpv6Packet (9, 3460), EpcTft::DOWNLINK), 3, "bad classification of an IPv6 packet");
+  NS_TEST_ASSERT_MSG_EQ (c->Classify (CreateIpv6Packet (9, 5000), EpcTft::DOWNLINK), 1, "bad classification of an IPv6 packet");
+}
+
 /**
  * \ingroup lte-test
  * \ingroup tests
@@ -368,4 +489,11 @@ EpcTftClassifierTestSuite::EpcTftClassifierTestSuite ()
   AddTestCase (new EpcTftClassifierTestCase (c4, EpcTft::UPLINK,   Ipv4Address ("9.1.1.1"), Ipv4Address ("8.1.1.1"),     9,     5897,     0,    2), TestCase::QUICK);
   AddTestCase (new EpcTftClassifierTestCase (c4, EpcTft::DOWNLINK, Ipv4Address ("9.1.1.1"), Ipv4Address ("8.1.1.1"),  5897,       10,     0,    2), TestCase::QUICK);
 
+
+  ///////////////////////////////////////////
+  // check the classification cache
+  ///////////////////////////////////////////
+
+  AddTestCase (new EpcTftClassifierCacheTestCase (), TestCase::QUICK);
+
 }
@@ -226,7 +226,7 @@ MobilityHelper::CourseChanged (Ptr<OutputStreamWrapper> stream, Ptr<const Mobili
   os->setf (std::ios::fixed,std::ios::floatfield);
   *os << " pos=" << pos.x << ":" << pos.y << ":" << pos.z
       << " vel=" << vel.x << ":" << vel.y << ":" << vel.z
-      << std::endl;
+      << "\n";
   os->flags (saved_flags);
   os->precision (saved_precision);
 }
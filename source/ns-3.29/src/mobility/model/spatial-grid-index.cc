@@ -0,0 +1,177 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "spatial-grid-index.h"
+#include "constant-acceleration-mobility-model.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SpatialGridIndex");
+
+SpatialGridIndex::SpatialGridIndex (double cellSize)
+  : m_cellSize (cellSize)
+{
+  NS_LOG_FUNCTION (this << cellSize);
+  NS_ABORT_MSG_IF (cellSize <= 0, "SpatialGridIndex: the cell size must be strictly positive");
+}
+
+SpatialGridIndex::~SpatialGridIndex ()
+{
+  NS_LOG_FUNCTION (this);
+  for (std::map<const MobilityModel *, std::vector<uint32_t> >::const_iterator i = m_byModel.begin ();
+       i != m_byModel.end (); ++i)
+    {
+      Ptr<MobilityModel> mobility = m_items[i->second.front ()].mobility;
+      mobility->TraceDisconnectWithoutContext ("CourseChange",
+                                               MakeCallback (&SpatialGridIndex::CourseChanged, this));
+    }
+}
+
+double
+SpatialGridIndex::GetCellSize (void) const
+{
+  return m_cellSize;
+}
+
+uint32_t
+SpatialGridIndex::GetNItems (void) const
+{
+  return m_items.size ();
+}
+
+int64_t
+SpatialGridIndex::GetCellIndex (double x) const
+{
+  return static_cast<int64_t> (std::floor (x / m_cellSize));
+}
+
+uint32_t
+SpatialGridIndex::Add (Ptr<MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  NS_ASSERT (mobility != 0);
+  uint32_t id = m_items.size ();
+  Item item;
+  item.mobility = mobility;
+  m_items.push_back (item);
+  std::vector<uint32_t> &ids = m_byModel[PeekPointer (mobility)];
+  if (ids.empty ())
+    {
+      // several items (e.g., the devices of a node) can share a model
+      mobility->TraceConnectWithoutContext ("CourseChange",
+                                            MakeCallback (&SpatialGridIndex::CourseChanged, this));
+    }
+  ids.push_back (id);
+  Insert (id);
+  return id;
+}
+
+void
+SpatialGridIndex::Insert (uint32_t id)
+{
+  Item &item = m_items[id];
+  Vector velocity = item.mobility->GetVelocity ();
+  // the velocity of a ConstantAccelerationMobilityModel changes without
+  // course change notifications
+  item.moving = velocity.x != 0 || velocity.y != 0 || velocity.z != 0
+    || DynamicCast<ConstantAccelerationMobilityModel> (item.mobility) != 0;
+  if (item.moving)
+    {
+      m_moving.push_back (id);
+    }
+  else
+    {
+      item.position = item.mobility->GetPosition ();
+      item.cell = Cell (GetCellIndex (item.position.x), GetCellIndex (item.position.y));
+      m_cells[item.cell].push_back (id);
+    }
+}
+
+void
+SpatialGridIndex::Remove (uint32_t id)
+{
+  Item &item = m_items[id];
+  if (item.moving)
+    {
+      m_moving.erase (std::find (m_moving.begin (), m_moving.end (), id));
+    }
+  else
+    {
+      std::map<Cell, std::vector<uint32_t> >::iterator cell = m_cells.find (item.cell);
+      NS_ASSERT (cell != m_cells.end ());
+      cell->second.erase (std::find (cell->second.begin (), cell->second.end (), id));
+      if (cell->second.empty ())
+        {
+          m_cells.erase (cell);
+        }
+    }
+}
+
+void
+SpatialGridIndex::CourseChanged (Ptr<const MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  std::map<const MobilityModel *, std::vector<uint32_t> >::const_iterator i = m_byModel.find (PeekPointer (mobility));
+  NS_ASSERT (i != m_byModel.end ());
+  for (std::vector<uint32_t>::const_iterator id = i->second.begin (); id != i->second.end (); ++id)
+    {
+      Remove (*id);
+      Insert (*id);
+    }
+}
+
+void
+SpatialGridIndex::GetItemsInRange (const Vector &position, double range, std::vector<uint32_t> &items) const
+{
+  NS_LOG_FUNCTION (this << position << range);
+  items.clear ();
+  int64_t xMin = GetCellIndex (position.x - range);
+  int64_t xMax = GetCellIndex (position.x + range);
+  int64_t yMin = GetCellIndex (position.y - range);
+  int64_t yMax = GetCellIndex (position.y + range);
+  for (int64_t x = xMin; x <= xMax; ++x)
+    {
+      for (int64_t y = yMin; y <= yMax; ++y)
+        {
+          std::map<Cell, std::vector<uint32_t> >::const_iterator cell = m_cells.find (Cell (x, y));
+          if (cell == m_cells.end ())
+            {
+              continue;
+            }
+          for (std::vector<uint32_t>::const_iterator id = cell->second.begin (); id != cell->second.end (); ++id)
+            {
+              if (CalculateDistance (position, m_items[*id].position) <= range)
+                {
+                  items.push_back (*id);
+                }
+            }
+        }
+    }
+  for (std::vector<uint32_t>::const_iterator id = m_moving.begin (); id != m_moving.end (); ++id)
+    {
+      if (CalculateDistance (position, m_items[*id].mobility->GetPosition ()) <= range)
+        {
+          items.push_back (*id);
+        }
+    }
+  std::sort (items.begin (), items.end ());
+}
+
+} // namespace ns3
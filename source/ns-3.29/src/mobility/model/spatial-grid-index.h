@@ -0,0 +1,127 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef SPATIAL_GRID_INDEX_H
+#define SPATIAL_GRID_INDEX_H
+
+#include <map>
+#include <vector>
+#include "ns3/ptr.h"
+#include "ns3/vector.h"
+#include "ns3/simple-ref-count.h"
+#include "mobility-model.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief Index of the positions of a set of mobility models on a grid.
+ *
+ * The items (typically the receivers of a channel) are numbered in the
+ * order they are added.  Items whose mobility model is not moving are
+ * stored in square cells of the x-y plane; items which are moving are
+ * kept apart and their position is read when needed.  The index follows
+ * the "CourseChange" trace source of the mobility models, so that the
+ * items move between the two sets as they stop and start moving.  This
+ * relies on the mobility models notifying a course change whenever
+ * their velocity or position changes other than by the velocity; the
+ * mobility models of this module do so.
+ *
+ * GetItemsInRange then only looks at the static items of the cells
+ * around a position, and at the moving items.  Choosing the range of
+ * the queries as cell size keeps the number of cells looked at to
+ * nine.
+ */
+class SpatialGridIndex : public SimpleRefCount<SpatialGridIndex>
+{
+public:
+  /**
+   * \param cellSize the side of the cells, in meters
+   */
+  SpatialGridIndex (double cellSize);
+  ~SpatialGridIndex ();
+
+  /**
+   * \returns the side of the cells, in meters
+   */
+  double GetCellSize (void) const;
+
+  /**
+   * \param mobility the mobility model of the new item
+   * \returns the number of the item
+   */
+  uint32_t Add (Ptr<MobilityModel> mobility);
+
+  /**
+   * \returns the number of items in the index
+   */
+  uint32_t GetNItems (void) const;
+
+  /**
+   * \brief Find the items within a distance of a position.
+   *
+   * \param position the position
+   * \param range the distance, in meters
+   * \param items receives the numbers of the items at most range
+   *        meters away from position, in increasing order
+   */
+  void GetItemsInRange (const Vector &position, double range, std::vector<uint32_t> &items) const;
+
+private:
+  /// A cell of the grid
+  typedef std::pair<int64_t, int64_t> Cell;
+
+  /// An item of the index
+  struct Item
+  {
+    Ptr<MobilityModel> mobility; //!< the mobility model
+    Vector position;             //!< the position, if not moving
+    bool moving;                 //!< true if the item is moving
+    Cell cell;                   //!< the cell, if not moving
+  };
+
+  /**
+   * \param x a coordinate
+   * \returns the index of the cell containing x
+   */
+  int64_t GetCellIndex (double x) const;
+
+  /**
+   * \param mobility the model whose course changed
+   */
+  void CourseChanged (Ptr<const MobilityModel> mobility);
+
+  /**
+   * \brief Insert an item in the static cells or in the moving items.
+   * \param id the number of the item
+   */
+  void Insert (uint32_t id);
+
+  /**
+   * \brief Remove an item from the static cells or from the moving items.
+   * \param id the number of the item
+   */
+  void Remove (uint32_t id);
+
+  double m_cellSize;                                                  //!< the side of the cells
+  std::vector<Item> m_items;                                          //!< the items, by number
+  std::map<Cell, std::vector<uint32_t> > m_cells;                     //!< the static items, by cell
+  std::vector<uint32_t> m_moving;                                     //!< the moving items
+  std::map<const MobilityModel *, std::vector<uint32_t> > m_byModel;  //!< the items, by mobility model
+};
+
+} // namespace ns3
+
+#endif /* SPATIAL_GRID_INDEX_H */
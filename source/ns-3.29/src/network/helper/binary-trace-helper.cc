@@ -0,0 +1,210 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/pointer.h"
+#include "binary-trace-helper.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BinaryTraceHelper");
+
+/**
+ * \brief Trace sinks bound to one device of one node.
+ *
+ * Binding the node id and device index when the device is connected
+ * avoids recovering them from a context string on each event.
+ */
+class BinaryTraceDeviceSink : public SimpleRefCount<BinaryTraceDeviceSink>
+{
+public:
+  /**
+   * \param file the binary trace file
+   * \param node the node id
+   * \param device the device index
+   */
+  BinaryTraceDeviceSink (Ptr<BinaryTraceFile> file, uint32_t node, uint32_t device)
+    : m_file (file),
+      m_node (node),
+      m_device (device)
+  {
+  }
+  /**
+   * \param p the enqueued packet
+   */
+  void Enqueue (Ptr<const Packet> p)
+  {
+    m_file->Write (BinaryTraceRecord::ENQUEUE, m_node, m_device, p);
+  }
+  /**
+   * \param p the dequeued packet
+   */
+  void Dequeue (Ptr<const Packet> p)
+  {
+    m_file->Write (BinaryTraceRecord::DEQUEUE, m_node, m_device, p);
+  }
+  /**
+   * \param p the dropped packet
+   */
+  void Drop (Ptr<const Packet> p)
+  {
+    m_file->Write (BinaryTraceRecord::DROP, m_node, m_device, p);
+  }
+  /**
+   * \param p the received packet
+   */
+  void Receive (Ptr<const Packet> p)
+  {
+    m_file->Write (BinaryTraceRecord::RECEIVE, m_node, m_device, p);
+  }
+private:
+  Ptr<BinaryTraceFile> m_file; //!< the binary trace file
+  uint32_t m_node;             //!< the node id
+  uint32_t m_device;           //!< the device index
+};
+
+BinaryTraceHelper::BinaryTraceHelper ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+}
+
+BinaryTraceHelper::~BinaryTraceHelper ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+}
+
+Ptr<BinaryTraceFile>
+BinaryTraceHelper::CreateFile (std::string filename)
+{
+  NS_LOG_FUNCTION (filename);
+  //
+  // As with the ascii and pcap helpers, the file object is kept alive by
+  // the callbacks that reference it and is flushed and closed when the
+  // last of them goes away.
+  //
+  return Create<BinaryTraceFile> (filename);
+}
+
+void
+BinaryTraceHelper::EnableBinaryTrace (Ptr<BinaryTraceFile> file, Ptr<NetDevice> nd)
+{
+  NS_LOG_FUNCTION (file << nd);
+  Ptr<BinaryTraceDeviceSink> sink =
+    Create<BinaryTraceDeviceSink> (file, nd->GetNode ()->GetId (), nd->GetIfIndex ());
+
+  PointerValue queue;
+  if (nd->GetAttributeFailSafe ("TxQueue", queue) && queue.GetObject () != 0)
+    {
+      Ptr<Object> q = queue.GetObject ();
+      q->TraceConnectWithoutContext ("Enqueue", MakeCallback (&BinaryTraceDeviceSink::Enqueue, sink));
+      q->TraceConnectWithoutContext ("Dequeue", MakeCallback (&BinaryTraceDeviceSink::Dequeue, sink));
+      q->TraceConnectWithoutContext ("Drop", MakeCallback (&BinaryTraceDeviceSink::Drop, sink));
+    }
+
+  nd->TraceConnectWithoutContext ("MacRx", MakeCallback (&BinaryTraceDeviceSink::Receive, sink));
+  nd->TraceConnectWithoutContext ("MacTxDrop", MakeCallback (&BinaryTraceDeviceSink::Drop, sink));
+  nd->TraceConnectWithoutContext ("PhyTxDrop", MakeCallback (&BinaryTraceDeviceSink::Drop, sink));
+  nd->TraceConnectWithoutContext ("PhyRxDrop", MakeCallback (&BinaryTraceDeviceSink::Drop, sink));
+}
+
+void
+BinaryTraceHelper::EnableBinaryTrace (Ptr<BinaryTraceFile> file, NetDeviceContainer d)
+{
+  NS_LOG_FUNCTION (file);
+  for (NetDeviceContainer::Iterator i = d.Begin (); i != d.End (); ++i)
+    {
+      EnableBinaryTrace (file, *i);
+    }
+}
+
+void
+BinaryTraceHelper::EnableBinaryTrace (Ptr<BinaryTraceFile> file, NodeContainer n)
+{
+  NS_LOG_FUNCTION (file);
+  for (NodeContainer::Iterator i = n.Begin (); i != n.End (); ++i)
+    {
+      Ptr<Node> node = *i;
+      for (uint32_t j = 0; j < node->GetNDevices (); ++j)
+        {
+          EnableBinaryTrace (file, node->GetDevice (j));
+        }
+    }
+}
+
+void
+BinaryTraceHelper::EnableBinaryTraceAll (Ptr<BinaryTraceFile> file)
+{
+  NS_LOG_FUNCTION (file);
+  EnableBinaryTrace (file, NodeContainer::GetGlobal ());
+}
+
+void
+BinaryTraceHelper::ParseContext (std::string const &context, uint32_t &node, uint32_t &device)
+{
+  static const char nodeList[] = "/NodeList/";
+  static const char deviceList[] = "/DeviceList/";
+  node = 0xffffffff;
+  device = 0xffffffff;
+  const char *s = context.c_str ();
+  if (std::strncmp (s, nodeList, sizeof (nodeList) - 1) != 0)
+    {
+      return;
+    }
+  char *end;
+  node = std::strtoul (s + sizeof (nodeList) - 1, &end, 10);
+  if (std::strncmp (end, deviceList, sizeof (deviceList) - 1) != 0)
+    {
+      return;
+    }
+  device = std::strtoul (end + sizeof (deviceList) - 1, &end, 10);
+}
+
+void
+BinaryTraceHelper::EnqueueSinkWithContext (Ptr<BinaryTraceFile> file, std::string context, Ptr<const Packet> p)
+{
+  uint32_t node, device;
+  ParseContext (context, node, device);
+  file->Write (BinaryTraceRecord::ENQUEUE, node, device, p);
+}
+
+void
+BinaryTraceHelper::DequeueSinkWithContext (Ptr<BinaryTraceFile> file, std::string context, Ptr<const Packet> p)
+{
+  uint32_t node, device;
+  ParseContext (context, node, device);
+  file->Write (BinaryTraceRecord::DEQUEUE, node, device, p);
+}
+
+void
+BinaryTraceHelper::DropSinkWithContext (Ptr<BinaryTraceFile> file, std::string context, Ptr<const Packet> p)
+{
+  uint32_t node, device;
+  ParseContext (context, node, device);
+  file->Write (BinaryTraceRecord::DROP, node, device, p);
+}
+
+void
+BinaryTraceHelper::ReceiveSinkWithContext (Ptr<BinaryTraceFile> file, std::string context, Ptr<const Packet> p)
+{
+  uint32_t node, device;
+  ParseContext (context, node, device);
+  file->Write (BinaryTraceRecord::RECEIVE, node, device, p);
+}
+
+} // namespace ns3
@@ -0,0 +1,130 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_TRACE_HELPER_H
+#define BINARY_TRACE_HELPER_H
+
+#include <string>
+#include "ns3/ptr.h"
+#include "ns3/packet.h"
+#include "ns3/net-device.h"
+#include "ns3/net-device-container.h"
+#include "ns3/node-container.h"
+#include "ns3/binary-trace-file.h"
+
+namespace ns3 {
+
+/**
+ * \brief Manage binary event traces of net devices.
+ *
+ * This is the binary counterpart of AsciiTraceHelper: the sinks record
+ * a BinaryTraceRecord per enqueue, dequeue, drop or receive event
+ * instead of formatting text.  Use the binary-trace-convert program to
+ * turn the resulting file into ascii, CSV or columnar files.
+ *
+ * EnableBinaryTrace connects a device to the sources most devices share:
+ * the "Enqueue", "Dequeue" and "Drop" sources of the queue held in the
+ * "TxQueue" attribute, and the "MacRx", "MacTxDrop", "PhyTxDrop" and
+ * "PhyRxDrop" sources of the device itself.  Sources a device does not
+ * have are skipped.  Other sources can be connected with Config::Connect
+ * to the *SinkWithContext methods, which take the node and device from
+ * the "/NodeList/n/DeviceList/d" prefix of the context.
+ */
+class BinaryTraceHelper
+{
+public:
+  BinaryTraceHelper ();
+  ~BinaryTraceHelper ();
+
+  /**
+   * \brief Create a binary trace file.
+   * \param filename the name of the file
+   * \returns the file
+   */
+  Ptr<BinaryTraceFile> CreateFile (std::string filename);
+
+  /**
+   * \brief Trace the events of a device.
+   * \param file the binary trace file
+   * \param nd the device
+   */
+  void EnableBinaryTrace (Ptr<BinaryTraceFile> file, Ptr<NetDevice> nd);
+
+  /**
+   * \brief Trace the events of a set of devices.
+   * \param file the binary trace file
+   * \param d the devices
+   */
+  void EnableBinaryTrace (Ptr<BinaryTraceFile> file, NetDeviceContainer d);
+
+  /**
+   * \brief Trace the events of all the devices of a set of nodes.
+   * \param file the binary trace file
+   * \param n the nodes
+   */
+  void EnableBinaryTrace (Ptr<BinaryTraceFile> file, NodeContainer n);
+
+  /**
+   * \brief Trace the events of all the devices of all nodes.
+   * \param file the binary trace file
+   */
+  void EnableBinaryTraceAll (Ptr<BinaryTraceFile> file);
+
+  /**
+   * \brief Enqueue sink for Config::Connect.
+   * \param file the binary trace file
+   * \param context the context of the trace source
+   * \param p the packet
+   */
+  static void EnqueueSinkWithContext (Ptr<BinaryTraceFile> file, std::string context, Ptr<const Packet> p);
+
+  /**
+   * \brief Dequeue sink for Config::Connect.
+   * \param file the binary trace file
+   * \param context the context of the trace source
+   * \param p the packet
+   */
+  static void DequeueSinkWithContext (Ptr<BinaryTraceFile> file, std::string context, Ptr<const Packet> p);
+
+  /**
+   * \brief Drop sink for Config::Connect.
+   * \param file the binary trace file
+   * \param context the context of the trace source
+   * \param p the packet
+   */
+  static void DropSinkWithContext (Ptr<BinaryTraceFile> file, std::string context, Ptr<const Packet> p);
+
+  /**
+   * \brief Receive sink for Config::Connect.
+   * \param file the binary trace file
+   * \param context the context of the trace source
+   * \param p the packet
+   */
+  static void ReceiveSinkWithContext (Ptr<BinaryTraceFile> file, std::string context, Ptr<const Packet> p);
+
+  /**
+   * \brief Extract the node id and device index from a trace context.
+   *
+   * \param context a context starting with "/NodeList/n/DeviceList/d"
+   * \param node receives n, or 0xffffffff if absent
+   * \param device receives d, or 0xffffffff if absent
+   */
+  static void ParseContext (std::string const &context, uint32_t &node, uint32_t &device);
+};
+
+} // namespace ns3
+
+#endif /* BINARY_TRACE_HELPER_H */
@@ -28,6 +28,8 @@
 #include "ns3/names.h"
 #include "ns3/net-device.h"
 #include "ns3/pcap-file-wrapper.h"
+#include "ns3/global-value.h"
+#include "ns3/string.h"
 
 #include "trace-helper.h"
 
@@ -35,6 +37,29 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("TraceHelper");
 
+/**
+ * \brief A global switch to compress the trace files named by the helpers.
+ */
+static GlobalValue g_traceCompression = GlobalValue ("TraceCompression",
+                                                     "Extension appended to the names of the pcap and ascii trace files "
+                                                     "generated by the trace helpers to select a compressed format: "
+                                                     "\"\" (none), \"gz\", \"zst\" or \"lz4\"",
+                                                     StringValue (""),
+                                                     MakeStringChecker ());
+
+/**
+ * \returns the suffix selected by the TraceCompression global value,
+ * including the leading dot, or an empty string.
+ */
+static std::string
+GetCompressionSuffix (void)
+{
+  StringValue val;
+  g_traceCompression.GetValue (val);
+  std::string extension = val.Get ();
+  return extension.empty () ? extension : "." + extension;
+}
+
 PcapHelper::PcapHelper ()
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -116,7 +141,7 @@ PcapHelper::GetFilenameFromDevice (std::string prefix, Ptr<NetDevice> device, bo
       oss << device->GetIfIndex ();
     }
 
-  oss << ".pcap";
+  oss << ".pcap" << GetCompressionSuffix ();
 
   return oss.str ();
 }
@@ -154,7 +179,7 @@ PcapHelper::GetFilenameFromInterfacePair (std::string prefix, Ptr<Object> object
       oss << "n" << node->GetId ();
     }
 
-  oss << "-i" << interface << ".pcap";
+  oss << "-i" << interface << ".pcap" << GetCompressionSuffix ();
 
   return oss.str ();
 }
@@ -248,7 +273,7 @@ AsciiTraceHelper::GetFilenameFromDevice (std::string prefix, Ptr<NetDevice> devi
       oss << device->GetIfIndex ();
     }
 
-  oss << ".tr";
+  oss << ".tr" << GetCompressionSuffix ();
 
   return oss.str ();
 }
@@ -290,7 +315,7 @@ AsciiTraceHelper::GetFilenameFromInterfacePair (
       oss << "n" << node->GetId ();
     }
 
-  oss << "-i" << interface << ".tr";
+  oss << "-i" << interface << ".tr" << GetCompressionSuffix ();
 
   return oss.str ();
 }
@@ -310,14 +335,14 @@ void
 AsciiTraceHelper::DefaultEnqueueSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
-  *stream->GetStream () << "+ " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
+  *stream->GetStream () << "+ " << Simulator::Now ().GetSeconds () << " " << *p << "\n";
 }
 
 void
 AsciiTraceHelper::DefaultEnqueueSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
-  *stream->GetStream () << "+ " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
+  *stream->GetStream () << "+ " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << "\n";
 }
 
 //
@@ -336,14 +361,14 @@ void
 AsciiTraceHelper::DefaultDropSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
-  *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
+  *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << *p << "\n";
 }
 
 void
 AsciiTraceHelper::DefaultDropSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
-  *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
+  *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << "\n";
 }
 
 //
@@ -363,14 +388,14 @@ void
 AsciiTraceHelper::DefaultDequeueSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
-  *stream->GetStream () << "- " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
+  *stream->GetStream () << "- " << Simulator::Now ().GetSeconds () << " " << *p << "\n";
 }
 
 void
 AsciiTraceHelper::DefaultDequeueSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
-  *stream->GetStream () << "- " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
+  *stream->GetStream () << "- " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << "\n";
 }
 
 //
@@ -387,14 +412,14 @@ void
 AsciiTraceHelper::DefaultReceiveSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
-  *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
+  *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << *p << "\n";
 }
 
 void
 AsciiTraceHelper::DefaultReceiveSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
-  *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
+  *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << "\n";
 }
 
 void 
@@ -77,7 +77,8 @@ public:
    * @param prefix prefix string
    * @param device NetDevice
    * @param useObjectNames use node and device names instead of indexes
-   * @returns file name
+   * @returns file name, with the extension selected by the
+   * "TraceCompression" global value appended
    */
   std::string GetFilenameFromDevice (std::string prefix, Ptr<NetDevice> device, bool useObjectNames = true);
 
@@ -89,7 +90,8 @@ public:
    * @param object interface (such as Ipv4Interface or Ipv6Interface)
    * @param interface interface id
    * @param useObjectNames use node and device names instead of indexes
-   * @returns file name
+   * @returns file name, with the extension selected by the
+   * "TraceCompression" global value appended
    */
   std::string GetFilenameFromInterfacePair (std::string prefix, Ptr<Object> object, 
                                             uint32_t interface, bool useObjectNames = true);
@@ -178,7 +180,8 @@ public:
    * @param prefix prefix string
    * @param device NetDevice
    * @param useObjectNames use node and device names instead of indexes
-   * @returns file name
+   * @returns file name, with the extension selected by the
+   * "TraceCompression" global value appended
    */
   std::string GetFilenameFromDevice (std::string prefix, Ptr<NetDevice> device, bool useObjectNames = true);
 
@@ -190,7 +193,8 @@ public:
    * @param object interface (such as Ipv4Interface or Ipv6Interface)
    * @param interface interface id
    * @param useObjectNames use node and device names instead of indexes
-   * @returns file name
+   * @returns file name, with the extension selected by the
+   * "TraceCompression" global value appended
    */
   std::string GetFilenameFromInterfacePair (std::string prefix, Ptr<Object> object, 
                                             uint32_t interface, bool useObjectNames = true);
@@ -20,6 +20,8 @@
 #include "buffer.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
+#include "ns3/ip-checksum.h"
+#include <algorithm>
 
 #define LOG_INTERNAL_STATE(y)                                                                    \
   NS_LOG_LOGIC (y << "start="<<m_start<<", end="<<m_end<<", zero start="<<m_zeroAreaStart<<              \
@@ -1140,14 +1142,34 @@ uint16_t
 Buffer::Iterator::CalculateIpChecksum (uint16_t size, uint32_t initialChecksum)
 {
   NS_LOG_FUNCTION (this << size << initialChecksum);
-  /* see RFC 1071 to understand this code. */
-  uint32_t sum = initialChecksum;
-
-  for (int j = 0; j < size/2; j++)
-    sum += ReadU16 ();
-
-  if (size & 1)
-    sum += ReadU8 ();
+  NS_ASSERT_MSG (m_current >= m_dataStart &&
+                 m_current + size <= m_dataEnd,
+                 GetReadErrorMessage ());
+  /* see RFC 1071 to understand this code. The data before and after
+   * the zero area are summed separately. The zero area adds nothing
+   * to the sum, but the bytes after it are in the other half of their
+   * 16-bit words when the data before them has an odd size.
+   */
+  uint64_t sum = initialChecksum;
+  uint32_t start = m_current;
+  uint32_t end = m_current + size;
+
+  if (start < m_zeroStart)
+    {
+      uint32_t stop = std::min (end, m_zeroStart);
+      sum += IpChecksumAdd (&m_data[start], stop - start);
+    }
+  if (end > m_zeroEnd)
+    {
+      uint32_t from = std::max (start, m_zeroEnd);
+      uint16_t part = IpChecksumAdd (&m_data[from - (m_zeroEnd - m_zeroStart)], end - from);
+      if ((from - start) & 1)
+        {
+          part = (part >> 8) | (part << 8);
+        }
+      sum += part;
+    }
+  m_current = end;
 
   while (sum >> 16)
     sum = (sum & 0xffff) + (sum >> 16);
@@ -28,6 +28,17 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("ChannelList");
 
+class ChannelListPriv;
+
+/**
+ * \brief The ChannelListPriv singleton, as a raw pointer.
+ *
+ * The lookups of the public API go through this pointer rather than
+ * through ChannelListPriv::Get to avoid the reference counting of the Ptr
+ * copy.
+ */
+static ChannelListPriv *g_channelList = 0;
+
 /**
  * \ingroup network
  *
@@ -70,6 +81,12 @@ public:
    */
   Ptr<Channel> GetChannel (uint32_t n);
 
+  /**
+   * \param n index of requested channel.
+   * \returns the Channel associated to index n, without taking a reference.
+   */
+  Channel *PeekChannel (uint32_t n) const;
+
   /**
    * \returns the number of channels currently in the list.
    */
@@ -81,6 +98,12 @@ public:
    */
   static Ptr<ChannelListPriv> Get (void);
 
+  /**
+   * \brief Get the channel list object without taking a reference
+   * \returns the channel list
+   */
+  static ChannelListPriv *Peek (void);
+
 private:
   /**
    * \brief Get the channel list object
@@ -124,6 +147,16 @@ ChannelListPriv::Get (void)
   return *DoGet ();
 }
 
+ChannelListPriv *
+ChannelListPriv::Peek (void)
+{
+  if (g_channelList == 0)
+    {
+      DoGet ();
+    }
+  return g_channelList;
+}
+
 Ptr<ChannelListPriv> *
 ChannelListPriv::DoGet (void)
 {
@@ -132,6 +165,7 @@ ChannelListPriv::DoGet (void)
   if (ptr == 0)
     {
       ptr = CreateObject<ChannelListPriv> ();
+      g_channelList = PeekPointer (ptr);
       Config::RegisterRootNamespaceObject (ptr);
       Simulator::ScheduleDestroy (&ChannelListPriv::Delete);
     }
@@ -143,6 +177,7 @@ ChannelListPriv::Delete (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
   Config::UnregisterRootNamespaceObject (Get ());
+  g_channelList = 0;
   (*DoGet ()) = 0;
 }
 
@@ -210,6 +245,14 @@ ChannelListPriv::GetChannel (uint32_t n)
   return m_channels[n];
 }
 
+Channel *
+ChannelListPriv::PeekChannel (uint32_t n) const
+{
+  NS_ASSERT_MSG (n < m_channels.size (), "Channel index " << n <<
+                 " is out of range (only have " << m_channels.size () << " channels).");
+  return PeekPointer (m_channels[n]);
+}
+
 uint32_t
 ChannelList::Add (Ptr<Channel> channel)
 {
@@ -221,28 +264,49 @@ ChannelList::Iterator
 ChannelList::Begin (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  return ChannelListPriv::Get ()->Begin ();
+  return ChannelListPriv::Peek ()->Begin ();
 }
 
 ChannelList::Iterator 
 ChannelList::End (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  return ChannelListPriv::Get ()->End ();
+  return ChannelListPriv::Peek ()->End ();
+}
+ChannelList::PeekIterator
+ChannelList::PeekBegin (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  return PeekIterator (ChannelListPriv::Peek ()->Begin ());
+}
+ChannelList::PeekIterator
+ChannelList::PeekEnd (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  return PeekIterator (ChannelListPriv::Peek ()->End ());
 }
 
 Ptr<Channel>
 ChannelList::GetChannel (uint32_t n)
 {
   NS_LOG_FUNCTION (n);
-  return ChannelListPriv::Get ()->GetChannel (n);
+  return ChannelListPriv::Peek ()->GetChannel (n);
+}
+
+Channel *
+ChannelList::PeekChannel (uint32_t n)
+{
+  // unlike Peek, do not create the list: if there is none, there is no
+  // channel to return anyway
+  NS_ASSERT_MSG (g_channelList != 0, "Channel index " << n << " is out of range (no channels).");
+  return g_channelList->PeekChannel (n);
 }
 
 uint32_t
 ChannelList::GetNChannels (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  return ChannelListPriv::Get ()->GetNChannels ();
+  return ChannelListPriv::Peek ()->GetNChannels ();
 }
 
 } // namespace ns3
@@ -41,6 +41,49 @@ public:
   /// Channel container iterator
   typedef std::vector< Ptr<Channel> >::const_iterator Iterator;
 
+  /**
+   * \brief An iterator over the channels of the list which yields raw
+   * pointers rather than Ptr copies.
+   *
+   * Iterating with Begin and End usually copies each Ptr<Channel>, which
+   * increments and decrements the reference count of every channel.
+   * This iterator goes through the same channels without touching their
+   * reference counts; see PeekChannel for the validity of the pointers.
+   * Like Iterator, it is invalidated when a channel is added.
+   */
+  class PeekIterator
+  {
+  public:
+    /**
+     * \param i the position in the list
+     */
+    explicit PeekIterator (Iterator i);
+    /**
+     * \returns the channel at the current position, without taking a reference
+     */
+    Channel *operator* (void) const;
+    /**
+     * \returns this iterator, moved to the next channel
+     */
+    PeekIterator &operator++ (void);
+    /**
+     * \returns a copy of this iterator, made before it moved to the next channel
+     */
+    PeekIterator operator++ (int);
+    /**
+     * \param o another iterator
+     * \returns true if both iterators are at the same position
+     */
+    bool operator== (PeekIterator const &o) const;
+    /**
+     * \param o another iterator
+     * \returns true if the iterators are at different positions
+     */
+    bool operator!= (PeekIterator const &o) const;
+  private:
+    Iterator m_i; //!< the position in the list
+  };
+
   /**
    * \param channel channel to add
    * \returns index of channel in list.
@@ -59,17 +102,81 @@ public:
    *          list.
    */
   static Iterator End (void);
+  /**
+   * \returns an iterator yielding raw pointers, located at the
+   *          beginning of this list.
+   */
+  static PeekIterator PeekBegin (void);
+  /**
+   * \returns an iterator yielding raw pointers, located at the end
+   *          of this list.
+   */
+  static PeekIterator PeekEnd (void);
   /**
    * \param n index of requested channel.
    * \returns the Channel associated to index n.
    */
   static Ptr<Channel> GetChannel (uint32_t n);
+  /**
+   * \param n index of requested channel.
+   * \returns the Channel associated to index n, without taking a reference.
+   *
+   * Unlike GetChannel, this method does not copy a Ptr, which saves the
+   * increment and decrement of the reference count of the channel on
+   * lookups made per packet or per event. The pointer is only valid as
+   * long as the channel is in the list, i.e., until Simulator::Destroy.
+   *
+   * \note This does not make the channel thread safe: the reference
+   * counts of ns-3 objects are not atomic, so any Ptr copy made through
+   * the returned pointer (e.g., by GetDevice or GetObject) must still
+   * happen in the simulation thread.
+   */
+  static Channel *PeekChannel (uint32_t n);
   /**
    * \returns the number of channels currently in the list.
    */
   static uint32_t GetNChannels (void);
 };
 
+inline
+ChannelList::PeekIterator::PeekIterator (Iterator i)
+  : m_i (i)
+{
+}
+
+inline Channel *
+ChannelList::PeekIterator::operator* (void) const
+{
+  return PeekPointer (*m_i);
+}
+
+inline ChannelList::PeekIterator &
+ChannelList::PeekIterator::operator++ (void)
+{
+  ++m_i;
+  return *this;
+}
+
+inline ChannelList::PeekIterator
+ChannelList::PeekIterator::operator++ (int)
+{
+  PeekIterator tmp = *this;
+  ++m_i;
+  return tmp;
+}
+
+inline bool
+ChannelList::PeekIterator::operator== (PeekIterator const &o) const
+{
+  return m_i == o.m_i;
+}
+
+inline bool
+ChannelList::PeekIterator::operator!= (PeekIterator const &o) const
+{
+  return m_i != o.m_i;
+}
+
 } // namespace ns3
 
 #endif /* CHANNEL_LIST_H */
@@ -31,6 +31,17 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("NodeList");
 
+class NodeListPriv;
+
+/**
+ * \brief The NodeListPriv singleton, as a raw pointer.
+ *
+ * The lookups of the public API go through this pointer rather than
+ * through NodeListPriv::Get to avoid the reference counting of the Ptr
+ * copy.
+ */
+static NodeListPriv *g_nodeList = 0;
+
 /**
  * \ingroup network
  * \brief private implementation detail of the NodeList API.
@@ -73,6 +84,12 @@ public:
    */
   Ptr<Node> GetNode (uint32_t n);
 
+  /**
+   * \param n index of requested node.
+   * \returns the Node associated to index n, without taking a reference.
+   */
+  Node *PeekNode (uint32_t n) const;
+
   /**
    * \returns the number of nodes currently in the list.
    */
@@ -84,6 +101,12 @@ public:
    */
   static Ptr<NodeListPriv> Get (void);
 
+  /**
+   * \brief Get the node list object without taking a reference
+   * \returns the node list
+   */
+  static NodeListPriv *Peek (void);
+
 private:
   /**
    * \brief Get the node list object
@@ -126,6 +149,16 @@ NodeListPriv::Get (void)
   NS_LOG_FUNCTION_NOARGS ();
   return *DoGet ();
 }
+
+NodeListPriv *
+NodeListPriv::Peek (void)
+{
+  if (g_nodeList == 0)
+    {
+      DoGet ();
+    }
+  return g_nodeList;
+}
 Ptr<NodeListPriv> *
 NodeListPriv::DoGet (void)
 {
@@ -134,6 +167,7 @@ NodeListPriv::DoGet (void)
   if (ptr == 0)
     {
       ptr = CreateObject<NodeListPriv> ();
+      g_nodeList = PeekPointer (ptr);
       Config::RegisterRootNamespaceObject (ptr);
       Simulator::ScheduleDestroy (&NodeListPriv::Delete);
     }
@@ -144,6 +178,7 @@ NodeListPriv::Delete (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
   Config::UnregisterRootNamespaceObject (Get ());
+  g_nodeList = 0;
   (*DoGet ()) = 0;
 }
 
@@ -210,6 +245,14 @@ NodeListPriv::GetNode (uint32_t n)
   return m_nodes[n];
 }
 
+Node *
+NodeListPriv::PeekNode (uint32_t n) const
+{
+  NS_ASSERT_MSG (n < m_nodes.size (), "Node index " << n <<
+                 " is out of range (only have " << m_nodes.size () << " nodes).");
+  return PeekPointer (m_nodes[n]);
+}
+
 }
 
 /**
@@ -229,25 +272,45 @@ NodeList::Iterator
 NodeList::Begin (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  return NodeListPriv::Get ()->Begin ();
+  return NodeListPriv::Peek ()->Begin ();
 }
 NodeList::Iterator 
 NodeList::End (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  return NodeListPriv::Get ()->End ();
+  return NodeListPriv::Peek ()->End ();
+}
+NodeList::PeekIterator
+NodeList::PeekBegin (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  return PeekIterator (NodeListPriv::Peek ()->Begin ());
+}
+NodeList::PeekIterator
+NodeList::PeekEnd (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  return PeekIterator (NodeListPriv::Peek ()->End ());
 }
 Ptr<Node>
 NodeList::GetNode (uint32_t n)
 {
   NS_LOG_FUNCTION (n);
-  return NodeListPriv::Get ()->GetNode (n);
+  return NodeListPriv::Peek ()->GetNode (n);
+}
+Node *
+NodeList::PeekNode (uint32_t n)
+{
+  // unlike Peek, do not create the list: if there is none, there is no
+  // node to return anyway
+  NS_ASSERT_MSG (g_nodeList != 0, "Node index " << n << " is out of range (no nodes).");
+  return g_nodeList->PeekNode (n);
 }
 uint32_t
 NodeList::GetNNodes (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  return NodeListPriv::Get ()->GetNNodes ();
+  return NodeListPriv::Peek ()->GetNNodes ();
 }
 
 } // namespace ns3
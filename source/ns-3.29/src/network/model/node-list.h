@@ -43,6 +43,49 @@ public:
   /// Node container iterator
   typedef std::vector< Ptr<Node> >::const_iterator Iterator;
 
+  /**
+   * \brief An iterator over the nodes of the list which yields raw
+   * pointers rather than Ptr copies.
+   *
+   * Iterating with Begin and End usually copies each Ptr<Node>, which
+   * increments and decrements the reference count of every node.
+   * This iterator goes through the same nodes without touching their
+   * reference counts; see PeekNode for the validity of the pointers.
+   * Like Iterator, it is invalidated when a node is added.
+   */
+  class PeekIterator
+  {
+  public:
+    /**
+     * \param i the position in the list
+     */
+    explicit PeekIterator (Iterator i);
+    /**
+     * \returns the node at the current position, without taking a reference
+     */
+    Node *operator* (void) const;
+    /**
+     * \returns this iterator, moved to the next node
+     */
+    PeekIterator &operator++ (void);
+    /**
+     * \returns a copy of this iterator, made before it moved to the next node
+     */
+    PeekIterator operator++ (int);
+    /**
+     * \param o another iterator
+     * \returns true if both iterators are at the same position
+     */
+    bool operator== (PeekIterator const &o) const;
+    /**
+     * \param o another iterator
+     * \returns true if the iterators are at different positions
+     */
+    bool operator!= (PeekIterator const &o) const;
+  private:
+    Iterator m_i; //!< the position in the list
+  };
+
   /**
    * \param node node to add
    * \returns index of node in list.
@@ -61,17 +104,81 @@ public:
    *          list.
    */
   static Iterator End (void);
+  /**
+   * \returns an iterator yielding raw pointers, located at the
+   *          beginning of this list.
+   */
+  static PeekIterator PeekBegin (void);
+  /**
+   * \returns an iterator yielding raw pointers, located at the end
+   *          of this list.
+   */
+  static PeekIterator PeekEnd (void);
   /**
    * \param n index of requested node.
    * \returns the Node associated to index n.
    */
   static Ptr<Node> GetNode (uint32_t n);
+  /**
+   * \param n index of requested node.
+   * \returns the Node associated to index n, without taking a reference.
+   *
+   * Unlike GetNode, this method does not copy a Ptr, which saves the
+   * increment and decrement of the reference count of the node on
+   * lookups made per packet or per event. The pointer is only valid as
+   * long as the node is in the list, i.e., until Simulator::Destroy.
+   *
+   * \note This does not make the node thread safe: the reference
+   * counts of ns-3 objects are not atomic, so any Ptr copy made through
+   * the returned pointer (e.g., by GetDevice or GetObject) must still
+   * happen in the simulation thread.
+   */
+  static Node *PeekNode (uint32_t n);
   /**
    * \returns the number of nodes currently in the list.
    */
   static uint32_t GetNNodes (void);
 };
 
+inline
+NodeList::PeekIterator::PeekIterator (Iterator i)
+  : m_i (i)
+{
+}
+
+inline Node *
+NodeList::PeekIterator::operator* (void) const
+{
+  return PeekPointer (*m_i);
+}
+
+inline NodeList::PeekIterator &
+NodeList::PeekIterator::operator++ (void)
+{
+  ++m_i;
+  return *this;
+}
+
+inline NodeList::PeekIterator
+NodeList::PeekIterator::operator++ (int)
+{
+  PeekIterator tmp = *this;
+  ++m_i;
+  return tmp;
+}
+
+inline bool
+NodeList::PeekIterator::operator== (PeekIterator const &o) const
+{
+  return m_i == o.m_i;
+}
+
+inline bool
+NodeList::PeekIterator::operator!= (PeekIterator const &o) const
+{
+  return m_i != o.m_i;
+}
+
 } // namespace ns3
 
 
@@ -0,0 +1,238 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdio>
+#include <vector>
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/binary-trace-file.h"
+#include "ns3/binary-trace-helper.h"
+#include "ns3/compressed-output-stream.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("BinaryTraceTestSuite");
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that records written by BinaryTraceFile are read back
+ * unchanged, across several flushes of the record buffer, plain or
+ * compressed.
+ */
+class BinaryTraceRoundTripTestCase : public TestCase
+{
+public:
+  /**
+   * \param extension the extension of the file, selecting its compression
+   */
+  BinaryTraceRoundTripTestCase (std::string const &extension);
+private:
+  virtual void DoRun (void);
+  /**
+   * \param i index of the event
+   */
+  void WriteEvent (uint32_t i);
+
+  Ptr<BinaryTraceFile> m_file; //!< the file being written
+  std::string m_extension;     //!< the extension of the file
+};
+
+BinaryTraceRoundTripTestCase::BinaryTraceRoundTripTestCase (std::string const &extension)
+  : TestCase ("Check that binary trace records round-trip through " + extension + " files"),
+    m_extension (extension)
+{
+}
+
+void
+BinaryTraceRoundTripTestCase::WriteEvent (uint32_t i)
+{
+  Ptr<Packet> p = Create<Packet> (100 + i);
+  m_file->Write (static_cast<BinaryTraceRecord::Type> (i % 4), i % 5, i % 3, p);
+}
+
+void
+BinaryTraceRoundTripTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("binary-trace" + m_extension);
+  // enough records for the decompressed data to span several chunks
+  const uint32_t n = 5000;
+  // a small buffer to exercise several flushes
+  m_file = Create<BinaryTraceFile> (filename, 16);
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      Simulator::Schedule (MicroSeconds (i), &BinaryTraceRoundTripTestCase::WriteEvent, this, i);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_ASSERT_MSG_EQ (m_file->GetNRecords (), n, "Wrong number of records written");
+  m_file = 0;
+
+  BinaryTraceReader reader;
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (filename), true, "Unable to open " << filename);
+  BinaryTraceRecord r;
+  uint32_t i = 0;
+  while (reader.Read (r))
+    {
+      NS_TEST_ASSERT_MSG_EQ (r.time, MicroSeconds (i).GetNanoSeconds (), "Wrong time for record " << i);
+      NS_TEST_ASSERT_MSG_EQ (static_cast<uint32_t> (r.type), i % 4, "Wrong type for record " << i);
+      NS_TEST_ASSERT_MSG_EQ (r.node, i % 5, "Wrong node for record " << i);
+      NS_TEST_ASSERT_MSG_EQ (r.device, i % 3, "Wrong device for record " << i);
+      NS_TEST_ASSERT_MSG_EQ (r.size, 100 + i, "Wrong size for record " << i);
+      ++i;
+    }
+  NS_TEST_ASSERT_MSG_EQ (i, n, "Wrong number of records read");
+  reader.Close ();
+  std::remove (filename.c_str ());
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check the extraction of node and device from trace contexts.
+ */
+class BinaryTraceContextTestCase : public TestCase
+{
+public:
+  BinaryTraceContextTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+BinaryTraceContextTestCase::BinaryTraceContextTestCase ()
+  : TestCase ("Check the parsing of trace contexts")
+{
+}
+
+void
+BinaryTraceContextTestCase::DoRun (void)
+{
+  uint32_t node, device;
+  BinaryTraceHelper::ParseContext ("/NodeList/12/DeviceList/3/$ns3::PointToPointNetDevice/TxQueue/Enqueue", node, device);
+  NS_TEST_ASSERT_MSG_EQ (node, 12, "Wrong node");
+  NS_TEST_ASSERT_MSG_EQ (device, 3, "Wrong device");
+  BinaryTraceHelper::ParseContext ("/NodeList/7/$ns3::Ipv4L3Protocol/Tx", node, device);
+  NS_TEST_ASSERT_MSG_EQ (node, 7, "Wrong node");
+  NS_TEST_ASSERT_MSG_EQ (device, 0xffffffff, "Device found in a context without one");
+  BinaryTraceHelper::ParseContext ("", node, device);
+  NS_TEST_ASSERT_MSG_EQ (node, 0xffffffff, "Node found in an empty context");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that BinaryTraceHelper records the queue events of a device.
+ */
+class BinaryTraceHelperTestCase : public TestCase
+{
+public:
+  BinaryTraceHelperTestCase ();
+private:
+  virtual void DoRun (void);
+  /**
+   * \param device the device sending the packet
+   * \param to the destination address
+   */
+  void Send (Ptr<NetDevice> device, Address to);
+};
+
+BinaryTraceHelperTestCase::BinaryTraceHelperTestCase ()
+  : TestCase ("Check that BinaryTraceHelper traces device queues")
+{
+}
+
+void
+BinaryTraceHelperTestCase::Send (Ptr<NetDevice> device, Address to)
+{
+  device->Send (Create<Packet> (500), to, 0x800);
+}
+
+void
+BinaryTraceHelperTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("binary-trace-helper.btr");
+  NodeContainer nodes;
+  nodes.Create (2);
+  SimpleNetDeviceHelper simple;
+  NetDeviceContainer devices = simple.Install (nodes);
+
+  BinaryTraceHelper helper;
+  Ptr<BinaryTraceFile> file = helper.CreateFile (filename);
+  helper.EnableBinaryTrace (file, devices);
+  Simulator::Schedule (Seconds (1), &BinaryTraceHelperTestCase::Send, this,
+                       devices.Get (0), devices.Get (1)->GetAddress ());
+  Simulator::Run ();
+  file->Flush ();
+
+  BinaryTraceReader reader;
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (filename), true, "Unable to open " << filename);
+  std::vector<BinaryTraceRecord> records;
+  BinaryTraceRecord r;
+  while (reader.Read (r))
+    {
+      records.push_back (r);
+    }
+  NS_TEST_ASSERT_MSG_EQ (records.size (), 2, "Expected an enqueue and a dequeue");
+  NS_TEST_ASSERT_MSG_EQ (static_cast<uint32_t> (records[0].type), BinaryTraceRecord::ENQUEUE, "First event is not an enqueue");
+  NS_TEST_ASSERT_MSG_EQ (static_cast<uint32_t> (records[1].type), BinaryTraceRecord::DEQUEUE, "Second event is not a dequeue");
+  NS_TEST_ASSERT_MSG_EQ (records[0].node, nodes.Get (0)->GetId (), "Wrong node");
+  NS_TEST_ASSERT_MSG_EQ (records[0].device, devices.Get (0)->GetIfIndex (), "Wrong device");
+  NS_TEST_ASSERT_MSG_EQ (records[0].size, 500, "Wrong size");
+  NS_TEST_ASSERT_MSG_EQ (records[0].time, Seconds (1).GetNanoSeconds (), "Wrong time");
+  reader.Close ();
+  Simulator::Destroy ();
+  std::remove (filename.c_str ());
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Binary trace TestSuite
+ */
+class BinaryTraceTestSuite : public TestSuite
+{
+public:
+  BinaryTraceTestSuite ();
+};
+
+BinaryTraceTestSuite::BinaryTraceTestSuite ()
+  : TestSuite ("binary-trace", UNIT)
+{
+  AddTestCase (new BinaryTraceRoundTripTestCase (".btr"), TestCase::QUICK);
+  // the compressed formats available in this build
+  const char *compressed[] = { ".btr.gz", ".btr.zst", ".btr.lz4" };
+  for (uint32_t i = 0; i < sizeof (compressed) / sizeof (compressed[0]); ++i)
+    {
+      if (CompressionCodec::CreateForFile (compressed[i]) != 0)
+        {
+          AddTestCase (new BinaryTraceRoundTripTestCase (compressed[i]), TestCase::QUICK);
+        }
+    }
+  AddTestCase (new BinaryTraceContextTestCase, TestCase::QUICK);
+  AddTestCase (new BinaryTraceHelperTestCase, TestCase::QUICK);
+}
+
+static BinaryTraceTestSuite g_binaryTraceTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,270 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/compressed-output-stream.h"
+#include "ns3/output-stream-wrapper.h"
+#include "ns3/pcap-file.h"
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif /* HAVE_ZLIB */
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("CompressedOutputStreamTestSuite");
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check the selection of compression codecs from file names.
+ */
+class CompressedFilenameTestCase : public TestCase
+{
+public:
+  CompressedFilenameTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+CompressedFilenameTestCase::CompressedFilenameTestCase ()
+  : TestCase ("Check that compressed formats are selected by file extension")
+{
+}
+
+void
+CompressedFilenameTestCase::DoRun (void)
+{
+  NS_TEST_ASSERT_MSG_EQ (CompressionCodec::IsCompressedFilename ("trace.pcap.gz"), true, "gzip extension not detected");
+  NS_TEST_ASSERT_MSG_EQ (CompressionCodec::IsCompressedFilename ("trace.tr.zst"), true, "zstd extension not detected");
+  NS_TEST_ASSERT_MSG_EQ (CompressionCodec::IsCompressedFilename ("trace.tr.lz4"), true, "lz4 extension not detected");
+  NS_TEST_ASSERT_MSG_EQ (CompressionCodec::IsCompressedFilename ("trace.pcap"), false, "plain pcap detected as compressed");
+  NS_TEST_ASSERT_MSG_EQ (CompressionCodec::IsCompressedFilename (".gz"), false, "bare extension detected as compressed");
+  NS_TEST_ASSERT_MSG_EQ (CompressionCodec::CreateForFile ("trace.tr"), 0, "codec created for an uncompressed file");
+#ifdef HAVE_ZLIB
+  NS_TEST_ASSERT_MSG_NE (CompressionCodec::CreateForFile ("trace.tr.gz"), 0, "no codec for a gzip file");
+#endif /* HAVE_ZLIB */
+}
+
+#ifdef HAVE_ZLIB
+/**
+ * \param filename a gzip file
+ * \returns the uncompressed content of the file
+ */
+static std::string
+Gunzip (std::string const &filename)
+{
+  std::string content;
+  gzFile f = gzopen (filename.c_str (), "rb");
+  if (f == 0)
+    {
+      return content;
+    }
+  char chunk[4096];
+  int n;
+  while ((n = gzread (f, chunk, sizeof (chunk))) > 0)
+    {
+      content.append (chunk, n);
+    }
+  gzclose (f);
+  return content;
+}
+
+/**
+ * \param filename a file
+ * \returns the content of the file
+ */
+static std::string
+ReadFile (std::string const &filename)
+{
+  std::ifstream f (filename.c_str (), std::ios::in | std::ios::binary);
+  std::ostringstream oss;
+  oss << f.rdbuf ();
+  return oss.str ();
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that an ascii trace written through OutputStreamWrapper to
+ * a ".gz" file decompresses to the text that was written.
+ */
+class CompressedAsciiTestCase : public TestCase
+{
+public:
+  CompressedAsciiTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+CompressedAsciiTestCase::CompressedAsciiTestCase ()
+  : TestCase ("Check that a compressed ascii trace round-trips")
+{
+}
+
+void
+CompressedAsciiTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("compressed-ascii.tr.gz");
+  std::ostringstream expected;
+  {
+    Ptr<OutputStreamWrapper> stream = Create<OutputStreamWrapper> (filename, std::ios::out);
+    // enough lines to span several compression blocks
+    for (uint32_t i = 0; i < 50000; ++i)
+      {
+        *stream->GetStream () << "+ " << i * 0.001 << " /NodeList/" << i % 7 << "/DeviceList/0 ns3::Packet " << i << std::endl;
+        expected << "+ " << i * 0.001 << " /NodeList/" << i % 7 << "/DeviceList/0 ns3::Packet " << i << std::endl;
+      }
+  }
+  std::string content = Gunzip (filename);
+  NS_TEST_ASSERT_MSG_EQ (content.size (), expected.str ().size (), "Decompressed trace has the wrong size");
+  NS_TEST_ASSERT_MSG_EQ ((content == expected.str ()), true, "Decompressed trace differs");
+  std::remove (filename.c_str ());
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that flushing a compressed ascii trace writes all the lines
+ * so far to the file, while the trace is still open.
+ */
+class CompressedFlushTestCase : public TestCase
+{
+public:
+  CompressedFlushTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+CompressedFlushTestCase::CompressedFlushTestCase ()
+  : TestCase ("Check that flushing a compressed ascii trace writes it")
+{
+}
+
+void
+CompressedFlushTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("compressed-flush.tr.gz");
+  std::ostringstream expected;
+  Ptr<OutputStreamWrapper> stream = Create<OutputStreamWrapper> (filename, std::ios::out);
+  for (uint32_t flush = 0; flush < 3; ++flush)
+    {
+      // less than a block, then more than a block, between the flushes
+      uint32_t nLines = (flush == 1) ? 20000 : 10;
+      for (uint32_t i = 0; i < nLines; ++i)
+        {
+          *stream->GetStream () << "r " << i * 0.001 << " /NodeList/" << i % 7 << " " << flush << "\n";
+          expected << "r " << i * 0.001 << " /NodeList/" << i % 7 << " " << flush << "\n";
+        }
+      stream->GetStream ()->flush ();
+      NS_TEST_ASSERT_MSG_EQ (stream->GetStream ()->good (), true, "Flush " << flush << " failed");
+      std::string content = Gunzip (filename);
+      NS_TEST_ASSERT_MSG_EQ (content.size (), expected.str ().size (), "Flush " << flush << " did not write the trace");
+      NS_TEST_ASSERT_MSG_EQ ((content == expected.str ()), true, "Flushed trace differs after flush " << flush);
+    }
+  stream = 0;
+  NS_TEST_ASSERT_MSG_EQ ((Gunzip (filename) == expected.str ()), true, "Closed trace differs");
+  std::remove (filename.c_str ());
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that a ".pcap.gz" file decompresses to the same bytes as
+ * the equivalent uncompressed pcap file.
+ */
+class CompressedPcapTestCase : public TestCase
+{
+public:
+  CompressedPcapTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+CompressedPcapTestCase::CompressedPcapTestCase ()
+  : TestCase ("Check that a compressed pcap file matches the uncompressed one")
+{
+}
+
+void
+CompressedPcapTestCase::DoRun (void)
+{
+  std::string plain = CreateTempDirFilename ("compressed-pcap.pcap");
+  std::string compressed = plain + ".gz";
+  uint8_t data[1500];
+  for (uint32_t i = 0; i < sizeof (data); ++i)
+    {
+      data[i] = i & 0xff;
+    }
+
+  PcapFile f1;
+  PcapFile f2;
+  f1.Open (plain, std::ios::out);
+  f2.Open (compressed, std::ios::out);
+  NS_TEST_ASSERT_MSG_EQ (f2.Fail (), false, "Open (" << compressed << ") failed");
+  f1.Init (1, 1000);
+  f2.Init (1, 1000);
+  for (uint32_t i = 0; i < 1000; ++i)
+    {
+      f1.Write (i, i * 10, data, 64 + i);
+      f2.Write (i, i * 10, data, 64 + i);
+      NS_TEST_ASSERT_MSG_EQ (f2.Fail (), false, "Write to compressed file failed");
+    }
+  f1.Close ();
+  f2.Close ();
+
+  std::string expected = ReadFile (plain);
+  std::string content = Gunzip (compressed);
+  NS_TEST_ASSERT_MSG_EQ (content.size (), expected.size (), "Decompressed pcap has the wrong size");
+  NS_TEST_ASSERT_MSG_EQ ((content == expected), true, "Decompressed pcap differs");
+  std::remove (plain.c_str ());
+  std::remove (compressed.c_str ());
+}
+#endif /* HAVE_ZLIB */
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Compressed trace output TestSuite
+ */
+class CompressedOutputStreamTestSuite : public TestSuite
+{
+public:
+  CompressedOutputStreamTestSuite ();
+};
+
+CompressedOutputStreamTestSuite::CompressedOutputStreamTestSuite ()
+  : TestSuite ("compressed-output-stream", UNIT)
+{
+  AddTestCase (new CompressedFilenameTestCase, TestCase::QUICK);
+#ifdef HAVE_ZLIB
+  AddTestCase (new CompressedAsciiTestCase, TestCase::QUICK);
+  AddTestCase (new CompressedFlushTestCase, TestCase::QUICK);
+  AddTestCase (new CompressedPcapTestCase, TestCase::QUICK);
+#endif /* HAVE_ZLIB */
+}
+
+static CompressedOutputStreamTestSuite g_compressedOutputStreamTestSuite; //!< Static variable for test initialization
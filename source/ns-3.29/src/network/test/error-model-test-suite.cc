@@ -39,6 +39,10 @@
 #include "ns3/double.h"
 #include "ns3/string.h"
 #include "ns3/rng-seed-manager.h"
+#include "ns3/enum.h"
+#include <cmath>
+#include <map>
+#include <vector>
 
 using namespace ns3;
 
@@ -262,6 +266,145 @@ BurstErrorModelSimple::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_drops, 260 , "Wrong number of drops.");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * GilbertElliottErrorModel unit tests: the long-run loss rate and the
+ * mean length of the loss bursts follow from the transition
+ * probabilities.
+ */
+class GilbertElliottErrorModelSimple : public TestCase
+{
+public:
+  GilbertElliottErrorModelSimple ();
+
+private:
+  virtual void DoRun (void);
+};
+
+GilbertElliottErrorModelSimple::GilbertElliottErrorModelSimple ()
+  : TestCase ("GilbertElliottErrorModel loss rate and burst length")
+{
+}
+
+void
+GilbertElliottErrorModelSimple::DoRun (void)
+{
+  RngSeedManager::SetSeed (3);
+  RngSeedManager::SetRun (4);
+
+  Ptr<GilbertElliottErrorModel> em = CreateObject<GilbertElliottErrorModel> ();
+  em->SetAttribute ("GoodToBad", DoubleValue (0.01));
+  em->SetAttribute ("BadToGood", DoubleValue (0.1));
+  em->AssignStreams (10);
+
+  Ptr<Packet> p = Create<Packet> (1000);
+  uint32_t n = 200000;
+  uint32_t drops = 0;
+  uint32_t bursts = 0;
+  bool previous = false;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      bool corrupt = em->IsCorrupt (p);
+      NS_TEST_ASSERT_MSG_EQ (corrupt, em->IsBadState (), "Only the bad state loses packets");
+      if (corrupt)
+        {
+          drops++;
+          if (!previous)
+            {
+              bursts++;
+            }
+        }
+      previous = corrupt;
+    }
+  // stationary probability of the bad state: 0.01 / (0.01 + 0.1)
+  NS_TEST_ASSERT_MSG_EQ_TOL (static_cast<double> (drops) / n, 0.01 / 0.11, 0.01, "Wrong loss rate");
+  NS_TEST_ASSERT_MSG_EQ_TOL (static_cast<double> (drops) / bursts, 10, 1, "Wrong mean burst length");
+
+  em->Reset ();
+  NS_TEST_ASSERT_MSG_EQ (em->IsBadState (), false, "Reset did not go back to the good state");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * LinkErrorModel unit tests, through a SimpleChannel.
+ */
+class LinkErrorModelSimple : public TestCase
+{
+public:
+  LinkErrorModelSimple ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Receive form a NetDevice
+   * \param nd The NetDevice.
+   * \param p The received packet.
+   * \param protocol The protocol received.
+   * \param addr The sender address.
+   * \return True on success.
+   */
+  bool Receive (Ptr<NetDevice> nd, Ptr<const Packet> p, uint16_t protocol, const Address& addr);
+
+  std::map<Ptr<NetDevice>, uint32_t> m_count; //!< The received packets counters.
+};
+
+LinkErrorModelSimple::LinkErrorModelSimple ()
+  : TestCase ("LinkErrorModel on a SimpleChannel")
+{
+}
+
+bool
+LinkErrorModelSimple::Receive (Ptr<NetDevice> nd, Ptr<const Packet> p, uint16_t protocol, const Address& addr)
+{
+  m_count[nd]++;
+  return true;
+}
+
+void
+LinkErrorModelSimple::DoRun (void)
+{
+  Ptr<LinkErrorModel> em = CreateObject<LinkErrorModel> ();
+  em->SetAttribute ("ErrorRate", DoubleValue (1e-3));
+  NS_TEST_ASSERT_MSG_EQ_TOL (em->GetPacketErrorRate (3, 4, 1000), 1 - std::pow (1 - 1e-3, 1000), 1e-12,
+                             "Wrong closed-form packet error rate");
+  em->SetAttribute ("ErrorUnit", EnumValue (RateErrorModel::ERROR_UNIT_PACKET));
+  em->SetAttribute ("ErrorRate", DoubleValue (0));
+  em->SetRate (0, 1, 1);
+  em->SetRate (0, 2, 0.5);
+  NS_TEST_ASSERT_MSG_EQ (em->GetRate (1, 0), 0, "Links are not symmetric");
+  em->AssignStreams (20);
+
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  channel->SetAttribute ("LinkErrorModel", PointerValue (em));
+  std::vector<Ptr<SimpleNetDevice> > devices;
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      Ptr<Node> node = CreateObject<Node> ();
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      node->AddDevice (device);
+      device->SetAddress (Mac48Address::Allocate ());
+      device->SetChannel (channel);
+      device->SetNode (node);
+      device->SetReceiveCallback (MakeCallback (&LinkErrorModelSimple::Receive, this));
+      devices.push_back (device);
+    }
+
+  Address broadcast = devices[0]->GetBroadcast ();
+  Simulator::Schedule (Seconds (0), &SendPacket, 1000, devices[0], broadcast);
+  Simulator::Schedule (Seconds (1), &SendPacket, 10, devices[1], broadcast);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_count[devices[1]], 0, "Packets received on a lossy link");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_count[devices[2]], 500, 60, "Wrong number of packets on a half-lossy link");
+  NS_TEST_ASSERT_MSG_EQ (m_count[devices[3]], 1010, "Packets lost on a perfect link");
+  NS_TEST_ASSERT_MSG_EQ (m_count[devices[0]], 10, "Packets lost on the reverse link");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -283,6 +426,8 @@ ErrorModelTestSuite::ErrorModelTestSuite ()
 {
   AddTestCase (new ErrorModelSimple, TestCase::QUICK);
   AddTestCase (new BurstErrorModelSimple, TestCase::QUICK);
+  AddTestCase (new GilbertElliottErrorModelSimple, TestCase::QUICK);
+  AddTestCase (new LinkErrorModelSimple, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
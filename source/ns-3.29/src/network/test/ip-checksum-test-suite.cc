@@ -0,0 +1,274 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/buffer.h"
+#include "ns3/ip-checksum.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Byte at a time checksum, as Buffer::Iterator used to compute it.
+ *
+ * \param i the start of the data
+ * \param size the size of the data
+ * \returns the checksum of the data
+ */
+static uint16_t
+ReferenceIpChecksum (Buffer::Iterator i, uint16_t size)
+{
+  uint32_t sum = 0;
+  for (int j = 0; j < size / 2; j++)
+    {
+      sum += i.ReadU16 ();
+    }
+  if (size & 1)
+    {
+      sum += i.ReadU8 ();
+    }
+  while (sum >> 16)
+    {
+      sum = (sum & 0xffff) + (sum >> 16);
+    }
+  return ~sum;
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Build a buffer made of some data, a zero area and some more data.
+ *
+ * \param before size of the data before the zero area
+ * \param zeroes size of the zero area
+ * \param after size of the data after the zero area
+ * \returns the buffer
+ */
+static Buffer
+MakeBuffer (uint32_t before, uint32_t zeroes, uint32_t after)
+{
+  Buffer b (zeroes);
+  b.AddAtStart (before);
+  Buffer::Iterator i = b.Begin ();
+  for (uint32_t j = 0; j < before; ++j)
+    {
+      i.WriteU8 (static_cast<uint8_t> (j * 7 + 0x35));
+    }
+  b.AddAtEnd (after);
+  i = b.End ();
+  i.Prev (after);
+  for (uint32_t j = 0; j < after; ++j)
+    {
+      i.WriteU8 (static_cast<uint8_t> (0xff - j * 13));
+    }
+  return b;
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check the checksum of Buffer::Iterator against the byte at a
+ * time computation, for data around zero areas of various parities.
+ */
+class IpChecksumBufferTestCase : public TestCase
+{
+public:
+  IpChecksumBufferTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+IpChecksumBufferTestCase::IpChecksumBufferTestCase ()
+  : TestCase ("Check Buffer::Iterator::CalculateIpChecksum")
+{
+}
+
+void
+IpChecksumBufferTestCase::DoRun (void)
+{
+  uint32_t sizes[] = { 0, 1, 2, 3, 7, 8, 9, 20, 31, 33, 64, 101 };
+  uint32_t nSizes = sizeof (sizes) / sizeof (sizes[0]);
+  for (uint32_t a = 0; a < nSizes; ++a)
+    {
+      for (uint32_t z = 0; z < nSizes; ++z)
+        {
+          for (uint32_t e = 0; e < nSizes; ++e)
+            {
+              Buffer b = MakeBuffer (sizes[a], sizes[z], sizes[e]);
+              for (uint32_t offset = 0; offset < 3 && offset <= b.GetSize (); ++offset)
+                {
+                  uint16_t size = b.GetSize () - offset;
+                  Buffer::Iterator i = b.Begin ();
+                  i.Next (offset);
+                  uint16_t expected = ReferenceIpChecksum (i, size);
+                  uint16_t got = i.CalculateIpChecksum (size);
+                  NS_TEST_ASSERT_MSG_EQ (got, expected, "Wrong checksum for layout " << sizes[a] << "/"
+                                         << sizes[z] << "/" << sizes[e] << " at offset " << offset);
+                  NS_TEST_ASSERT_MSG_EQ (i.GetRemainingSize (), 0, "Iterator not moved to the end");
+                }
+            }
+        }
+    }
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check the incremental update of a checksum against its full
+ * computation.
+ */
+class IpChecksumUpdateTestCase : public TestCase
+{
+public:
+  IpChecksumUpdateTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+IpChecksumUpdateTestCase::IpChecksumUpdateTestCase ()
+  : TestCase ("Check the incremental update of checksums")
+{
+}
+
+void
+IpChecksumUpdateTestCase::DoRun (void)
+{
+  // an IPv4 header without its checksum; the TTL is byte 8
+  uint8_t header[20] = { 0x45, 0x00, 0x00, 0x54, 0x1c, 0x46, 0x40, 0x00,
+                         0x40, 0x01, 0x00, 0x00, 0xc0, 0xa8, 0x00, 0x01,
+                         0xc0, 0xa8, 0x00, 0xc7 };
+  uint16_t checksum = ~IpChecksumAdd (header, sizeof (header));
+  while (header[8] > 0)
+    {
+      uint16_t oldWord = header[8] | (header[9] << 8);
+      header[8]--;
+      uint16_t newWord = header[8] | (header[9] << 8);
+      checksum = IpChecksumUpdate (checksum, oldWord, newWord);
+      uint16_t expected = ~IpChecksumAdd (header, sizeof (header));
+      NS_TEST_ASSERT_MSG_EQ (checksum, expected, "Wrong checksum for TTL " << static_cast<uint32_t> (header[8]));
+    }
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief IP checksum TestSuite
+ */
+class IpChecksumTestSuite : public TestSuite
+{
+public:
+  IpChecksumTestSuite ();
+};
+
+IpChecksumTestSuite::IpChecksumTestSuite ()
+  : TestSuite ("ip-checksum", UNIT)
+{
+  AddTestCase (new IpChecksumBufferTestCase, TestCase::QUICK);
+  AddTestCase (new IpChecksumUpdateTestCase, TestCase::QUICK);
+}
+
+static IpChecksumTestSuite g_ipChecksumTestSuite; //!< Static variable for test initialization
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Compare the time taken by the byte at a time and the word at
+ * a time checksums, on IPv4 header and full packet sizes.
+ */
+class IpChecksumBenchmarkTestCase : public TestCase
+{
+public:
+  IpChecksumBenchmarkTestCase ();
+private:
+  virtual void DoRun (void);
+  /**
+   * \param size the size of the data to checksum
+   * \param reps the number of checksums to compute
+   */
+  void Bench (uint16_t size, uint32_t reps);
+};
+
+IpChecksumBenchmarkTestCase::IpChecksumBenchmarkTestCase ()
+  : TestCase ("Benchmark Buffer::Iterator::CalculateIpChecksum")
+{
+}
+
+void
+IpChecksumBenchmarkTestCase::Bench (uint16_t size, uint32_t reps)
+{
+  Buffer b = MakeBuffer (size, 0, 0);
+  uint32_t acc = 0;
+
+  clock_t start = clock ();
+  for (uint32_t r = 0; r < reps; ++r)
+    {
+      acc += ReferenceIpChecksum (b.Begin (), size);
+    }
+  clock_t reference = clock () - start;
+
+  start = clock ();
+  for (uint32_t r = 0; r < reps; ++r)
+    {
+      acc -= b.Begin ().CalculateIpChecksum (size);
+    }
+  clock_t fast = clock () - start;
+
+  NS_TEST_ASSERT_MSG_EQ (acc, 0, "The checksums differ");
+  std::cout << "ip-checksum-perf: size " << size << ", reps " << reps
+            << ": byte at a time " << 1e3 * reference / CLOCKS_PER_SEC << " ms"
+            << ", word at a time " << 1e3 * fast / CLOCKS_PER_SEC << " ms"
+            << std::endl;
+}
+
+void
+IpChecksumBenchmarkTestCase::DoRun (void)
+{
+  Bench (20, 1000000);
+  Bench (60, 1000000);
+  Bench (1500, 100000);
+  Bench (9000, 20000);
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief IP checksum performance TestSuite
+ */
+class IpChecksumPerformanceTestSuite : public TestSuite
+{
+public:
+  IpChecksumPerformanceTestSuite ();
+};
+
+IpChecksumPerformanceTestSuite::IpChecksumPerformanceTestSuite ()
+  : TestSuite ("ip-checksum-perf", PERFORMANCE)
+{
+  AddTestCase (new IpChecksumBenchmarkTestCase, TestCase::QUICK);
+}
+
+static IpChecksumPerformanceTestSuite g_ipChecksumPerformanceTestSuite; //!< Static variable for test initialization
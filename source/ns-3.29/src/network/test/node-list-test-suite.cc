@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/channel-list.h"
+#include "ns3/simple-channel.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that NodeList::PeekNode and ChannelList::PeekChannel return
+ * the objects of GetNode and GetChannel, and that PeekBegin and PeekEnd
+ * go through the objects of Begin and End, without taking a reference.
+ */
+class NodeListPeekTestCase : public TestCase
+{
+public:
+  NodeListPeekTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+NodeListPeekTestCase::NodeListPeekTestCase ()
+  : TestCase ("Check the lookups and iterations of the nodes and channels without reference")
+{
+}
+
+void
+NodeListPeekTestCase::DoRun (void)
+{
+  std::vector<Ptr<Node> > nodes;
+  std::vector<Ptr<Channel> > channels;
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      nodes.push_back (CreateObject<Node> ());
+      channels.push_back (CreateObject<SimpleChannel> ());
+    }
+  NS_TEST_ASSERT_MSG_EQ (NodeList::GetNNodes (), nodes.size (), "Wrong number of nodes");
+  NS_TEST_ASSERT_MSG_EQ (ChannelList::GetNChannels (), channels.size (), "Wrong number of channels");
+
+  for (uint32_t i = 0; i < nodes.size (); i++)
+    {
+      uint32_t references = nodes[i]->GetReferenceCount ();
+      Node *node = NodeList::PeekNode (i);
+      NS_TEST_ASSERT_MSG_EQ (node, PeekPointer (nodes[i]), "Wrong node " << i);
+      NS_TEST_ASSERT_MSG_EQ (node->GetId (), i, "Wrong id of node " << i);
+      NS_TEST_ASSERT_MSG_EQ (node->GetReferenceCount (), references, "Reference taken on node " << i);
+      NS_TEST_ASSERT_MSG_EQ (node, PeekPointer (NodeList::GetNode (i)), "PeekNode and GetNode differ for node " << i);
+    }
+  for (uint32_t i = 0; i < channels.size (); i++)
+    {
+      uint32_t references = channels[i]->GetReferenceCount ();
+      Channel *channel = ChannelList::PeekChannel (i);
+      NS_TEST_ASSERT_MSG_EQ (channel, PeekPointer (channels[i]), "Wrong channel " << i);
+      NS_TEST_ASSERT_MSG_EQ (channel->GetId (), i, "Wrong id of channel " << i);
+      NS_TEST_ASSERT_MSG_EQ (channel->GetReferenceCount (), references, "Reference taken on channel " << i);
+      NS_TEST_ASSERT_MSG_EQ (channel, PeekPointer (ChannelList::GetChannel (i)), "PeekChannel and GetChannel differ for channel " << i);
+    }
+
+  uint32_t n = 0;
+  NodeList::Iterator node = NodeList::Begin ();
+  for (NodeList::PeekIterator i = NodeList::PeekBegin (); i != NodeList::PeekEnd (); ++i, ++node, ++n)
+    {
+      uint32_t references = nodes[n]->GetReferenceCount ();
+      NS_TEST_ASSERT_MSG_EQ ((node != NodeList::End ()), true, "Too many nodes iterated");
+      NS_TEST_ASSERT_MSG_EQ (*i, PeekPointer (*node), "Wrong node " << n);
+      NS_TEST_ASSERT_MSG_EQ ((*i)->GetReferenceCount (), references, "Reference taken on node " << n);
+    }
+  NS_TEST_ASSERT_MSG_EQ (n, nodes.size (), "Wrong number of nodes iterated");
+  n = 0;
+  ChannelList::Iterator channel = ChannelList::Begin ();
+  for (ChannelList::PeekIterator i = ChannelList::PeekBegin (); i != ChannelList::PeekEnd (); i++, ++channel, ++n)
+    {
+      uint32_t references = channels[n]->GetReferenceCount ();
+      NS_TEST_ASSERT_MSG_EQ ((channel != ChannelList::End ()), true, "Too many channels iterated");
+      NS_TEST_ASSERT_MSG_EQ (*i, PeekPointer (*channel), "Wrong channel " << n);
+      NS_TEST_ASSERT_MSG_EQ ((*i)->GetReferenceCount (), references, "Reference taken on channel " << n);
+    }
+  NS_TEST_ASSERT_MSG_EQ (n, channels.size (), "Wrong number of channels iterated");
+
+  nodes.clear ();
+  channels.clear ();
+  Simulator::Destroy ();
+  NS_TEST_ASSERT_MSG_EQ (NodeList::GetNNodes (), 0, "Nodes kept across Simulator::Destroy");
+  NS_TEST_ASSERT_MSG_EQ (ChannelList::GetNChannels (), 0, "Channels kept across Simulator::Destroy");
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief NodeList and ChannelList TestSuite
+ */
+class NodeListTestSuite : public TestSuite
+{
+public:
+  NodeListTestSuite ();
+};
+
+NodeListTestSuite::NodeListTestSuite ()
+  : TestSuite ("node-list", UNIT)
+{
+  AddTestCase (new NodeListPeekTestCase, TestCase::QUICK);
+}
+
+static NodeListTestSuite g_nodeListTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,193 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "binary-trace-file.h"
+#include "compressed-output-stream.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BinaryTraceFile");
+
+/// Magic string at the start of binary trace files, NUL included
+static const char BINARY_TRACE_MAGIC[8] = { 'n', 's', '3', 'b', 't', 'r', 'c', '\0' };
+
+BinaryTraceFile::BinaryTraceFile (std::string const &filename, uint32_t capacity)
+  : m_records (capacity),
+    m_count (0),
+    m_flushed (0)
+{
+  NS_LOG_FUNCTION (this << filename << capacity);
+  NS_ABORT_MSG_IF (capacity == 0, "BinaryTraceFile: capacity must be strictly positive");
+  NS_ASSERT (sizeof (BinaryTraceRecord) == 32);
+  m_stream = Create<OutputStreamWrapper> (filename, std::ios::out | std::ios::binary);
+  char header[HEADER_SIZE];
+  MakeHeader (header);
+  m_stream->GetStream ()->write (header, HEADER_SIZE);
+}
+
+BinaryTraceFile::~BinaryTraceFile ()
+{
+  NS_LOG_FUNCTION (this);
+  Flush ();
+}
+
+void
+BinaryTraceFile::Flush (void)
+{
+  NS_LOG_FUNCTION (this << m_count);
+  if (m_count == 0)
+    {
+      return;
+    }
+  std::ostream *os = m_stream->GetStream ();
+  os->write (reinterpret_cast<const char *> (&m_records[0]), m_count * sizeof (BinaryTraceRecord));
+  os->flush ();
+  m_flushed += m_count;
+  m_count = 0;
+}
+
+uint64_t
+BinaryTraceFile::GetNRecords (void) const
+{
+  return m_flushed + m_count;
+}
+
+void
+BinaryTraceFile::MakeHeader (char *header)
+{
+  uint32_t version = VERSION;
+  uint32_t recordSize = sizeof (BinaryTraceRecord);
+  std::memcpy (header, BINARY_TRACE_MAGIC, sizeof (BINARY_TRACE_MAGIC));
+  std::memcpy (header + 8, &version, sizeof (version));
+  std::memcpy (header + 12, &recordSize, sizeof (recordSize));
+}
+
+bool
+BinaryTraceFile::CheckHeader (const char *header)
+{
+  uint32_t version;
+  uint32_t recordSize;
+  std::memcpy (&version, header + 8, sizeof (version));
+  std::memcpy (&recordSize, header + 12, sizeof (recordSize));
+  // a file written with the other byte order shows a swapped version
+  return std::memcmp (header, BINARY_TRACE_MAGIC, sizeof (BINARY_TRACE_MAGIC)) == 0
+         && version == VERSION
+         && recordSize == sizeof (BinaryTraceRecord);
+}
+
+BinaryTraceReader::BinaryTraceReader ()
+  : m_offset (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+BinaryTraceReader::~BinaryTraceReader ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+bool
+BinaryTraceReader::Open (std::string const &filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  Close ();
+  if (CompressionCodec::IsCompressedFilename (filename))
+    {
+      // the decompressor matching the codec which wrote the file
+      m_codec = DecompressionCodec::CreateForFile (filename);
+      if (m_codec == 0)
+        {
+          NS_LOG_WARN ("No compression support compiled in for " << filename);
+          return false;
+        }
+      m_chunk.resize (CHUNK_SIZE);
+    }
+  m_file.open (filename.c_str (), std::ios::in | std::ios::binary);
+  if (!m_file.is_open ())
+    {
+      Close ();
+      return false;
+    }
+  char header[BinaryTraceFile::HEADER_SIZE];
+  if (!ReadBytes (header, sizeof (header)) || !BinaryTraceFile::CheckHeader (header))
+    {
+      NS_LOG_WARN ("Invalid binary trace header in " << filename);
+      Close ();
+      return false;
+    }
+  return true;
+}
+
+bool
+BinaryTraceReader::Read (BinaryTraceRecord &record)
+{
+  return ReadBytes (reinterpret_cast<char *> (&record), sizeof (record));
+}
+
+bool
+BinaryTraceReader::ReadBytes (char *buffer, uint32_t size)
+{
+  if (!m_file.is_open ())
+    {
+      return false;
+    }
+  if (m_codec == 0)
+    {
+      m_file.read (buffer, size);
+      return m_file.good ();
+    }
+  while (m_buffer.size () - m_offset < size)
+    {
+      m_file.read (&m_chunk[0], m_chunk.size ());
+      std::streamsize n = m_file.gcount ();
+      if (n == 0)
+        {
+          return false;
+        }
+      m_buffer.erase (0, m_offset);
+      m_offset = 0;
+      if (!m_codec->Decompress (&m_chunk[0], n, m_buffer))
+        {
+          NS_LOG_WARN ("Corrupted compressed binary trace");
+          m_file.close ();
+          return false;
+        }
+    }
+  std::memcpy (buffer, m_buffer.data () + m_offset, size);
+  m_offset += size;
+  return true;
+}
+
+void
+BinaryTraceReader::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_file.is_open ())
+    {
+      m_file.close ();
+    }
+  m_file.clear ();
+  m_codec = 0;
+  m_buffer.clear ();
+  m_offset = 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,203 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_TRACE_FILE_H
+#define BINARY_TRACE_FILE_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <stdint.h>
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "output-stream-wrapper.h"
+
+namespace ns3 {
+
+class DecompressionCodec;
+
+/**
+ * \brief One event of a binary trace.
+ *
+ * The layout is fixed (32 bytes, no implicit padding) and records are
+ * written in host byte order; the file header allows a reader to detect
+ * a byte order mismatch.
+ */
+struct BinaryTraceRecord
+{
+  /// Kind of event recorded
+  enum Type
+  {
+    ENQUEUE = 0,  //!< packet entered a device transmit queue
+    DEQUEUE = 1,  //!< packet left a device transmit queue
+    DROP = 2,     //!< packet dropped by a queue or a device
+    RECEIVE = 3   //!< packet received by a device
+  };
+
+  int64_t  time;        //!< simulation time, in nanoseconds
+  uint64_t uid;         //!< packet uid
+  uint32_t node;        //!< node id
+  uint32_t device;      //!< device index within the node
+  uint32_t size;        //!< packet size, in bytes
+  uint8_t  type;        //!< one of Type
+  uint8_t  reserved[3]; //!< padding, always zero
+};
+
+/**
+ * \brief A compact event log of packet events.
+ *
+ * Instead of formatting each event with Packet::Print and iostreams as
+ * the ascii traces do, a BinaryTraceFile stores a fixed size
+ * BinaryTraceRecord per event in an in-memory record buffer.  The buffer
+ * is written out with a single write when it is full, and the resulting
+ * file is converted to text or columnar formats off-line with the
+ * binary-trace-convert program.
+ *
+ * The file is written through an OutputStreamWrapper, so a file name
+ * ending in ".gz", ".zst" or ".lz4" also compresses the log.
+ *
+ * The file starts with a 16 bytes header: the 8 bytes magic "ns3btrc",
+ * the format version and the record size, both as uint32_t.
+ */
+class BinaryTraceFile : public SimpleRefCount<BinaryTraceFile>
+{
+public:
+  /// Default number of records buffered before a write
+  static const uint32_t DEFAULT_CAPACITY = 8192;
+  /// Version of the file format
+  static const uint32_t VERSION = 1;
+
+  /**
+   * \param filename the name of the file to write
+   * \param capacity the number of records buffered before a write
+   */
+  BinaryTraceFile (std::string const &filename, uint32_t capacity = DEFAULT_CAPACITY);
+  ~BinaryTraceFile ();
+
+  /**
+   * \brief Record an event for a packet at the current simulation time.
+   *
+   * \param type the kind of event
+   * \param node the node id
+   * \param device the device index
+   * \param p the packet
+   */
+  void Write (BinaryTraceRecord::Type type, uint32_t node, uint32_t device, Ptr<const Packet> p);
+
+  /**
+   * \brief Write the buffered records to the file.
+   */
+  void Flush (void);
+
+  /**
+   * \returns the number of records written so far, including buffered ones
+   */
+  uint64_t GetNRecords (void) const;
+
+  /**
+   * \brief Check a file header.
+   * \param header the 16 first bytes of a file
+   * \returns true if the header is a valid binary trace header
+   */
+  static bool CheckHeader (const char *header);
+
+  /**
+   * \brief Fill in a file header.
+   * \param header 16 bytes receiving the header
+   */
+  static void MakeHeader (char *header);
+
+  /// Size of the file header, in bytes
+  static const uint32_t HEADER_SIZE = 16;
+
+private:
+  Ptr<OutputStreamWrapper> m_stream;        //!< the output file
+  std::vector<BinaryTraceRecord> m_records; //!< buffered records
+  uint32_t m_count;                         //!< number of buffered records
+  uint64_t m_flushed;                       //!< number of records already written
+};
+
+inline void
+BinaryTraceFile::Write (BinaryTraceRecord::Type type, uint32_t node, uint32_t device, Ptr<const Packet> p)
+{
+  BinaryTraceRecord &record = m_records[m_count];
+  record.time = Simulator::Now ().GetNanoSeconds ();
+  record.uid = p->GetUid ();
+  record.node = node;
+  record.device = device;
+  record.size = p->GetSize ();
+  record.type = type;
+  if (++m_count == m_records.size ())
+    {
+      Flush ();
+    }
+}
+
+/**
+ * \brief Sequential reader of the files written by BinaryTraceFile.
+ *
+ * Files with a ".gz", ".zst" or ".lz4" extension are decompressed with
+ * the DecompressionCodec of that extension, so every compressed format
+ * BinaryTraceFile can write in this build can be read back.
+ */
+class BinaryTraceReader
+{
+public:
+  BinaryTraceReader ();
+  ~BinaryTraceReader ();
+
+  /**
+   * \brief Open a file and check its header.
+   * \param filename the name of the file to read
+   * \returns true on success
+   */
+  bool Open (std::string const &filename);
+
+  /**
+   * \brief Read the next record.
+   * \param record receives the record
+   * \returns false at the end of the file or on error
+   */
+  bool Read (BinaryTraceRecord &record);
+
+  /**
+   * \brief Close the file.
+   */
+  void Close (void);
+
+private:
+  /**
+   * \param buffer receives the data
+   * \param size the number of bytes to read
+   * \returns true if size bytes were read
+   */
+  bool ReadBytes (char *buffer, uint32_t size);
+
+  /// Number of compressed bytes read from the file at once
+  static const uint32_t CHUNK_SIZE = 64 * 1024;
+
+  std::ifstream m_file;              //!< the file
+  Ptr<DecompressionCodec> m_codec;   //!< the decompressor, if the file is compressed
+  std::vector<char> m_chunk;         //!< compressed bytes read from the file
+  std::string m_buffer;              //!< decompressed bytes not yet read
+  std::string::size_type m_offset;   //!< offset of the next byte to read in m_buffer
+};
+
+} // namespace ns3
+
+#endif /* BINARY_TRACE_FILE_H */
@@ -0,0 +1,685 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "compressed-output-stream.h"
+
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#endif /* HAVE_PTHREAD_H */
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif /* HAVE_ZLIB */
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif /* HAVE_ZSTD */
+#ifdef HAVE_LZ4
+#include <lz4frame.h>
+#endif /* HAVE_LZ4 */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CompressedOutputStream");
+
+/**
+ * \param filename a file name
+ * \param suffix an extension, including the dot
+ * \returns true if filename ends with suffix
+ */
+static bool
+HasSuffix (std::string const &filename, std::string const &suffix)
+{
+  return filename.size () > suffix.size ()
+         && filename.compare (filename.size () - suffix.size (), suffix.size (), suffix) == 0;
+}
+
+#ifdef HAVE_ZLIB
+/**
+ * \brief gzip codec, built on zlib's deflate.
+ */
+class GzipCompressionCodec : public CompressionCodec
+{
+public:
+  GzipCompressionCodec ()
+  {
+    std::memset (&m_stream, 0, sizeof (m_stream));
+    // 15 window bits, plus 16 to get a gzip rather than a zlib wrapper
+    int ret = deflateInit2 (&m_stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                            15 + 16, 8, Z_DEFAULT_STRATEGY);
+    NS_ABORT_MSG_IF (ret != Z_OK, "GzipCompressionCodec: deflateInit2 failed (" << ret << ")");
+  }
+  virtual ~GzipCompressionCodec ()
+  {
+    deflateEnd (&m_stream);
+  }
+  virtual void Compress (const char *data, uint32_t size, std::string &out)
+  {
+    Deflate (data, size, Z_NO_FLUSH, out);
+  }
+  virtual void Flush (std::string &out)
+  {
+    Deflate (0, 0, Z_SYNC_FLUSH, out);
+  }
+  virtual void Finish (std::string &out)
+  {
+    Deflate (0, 0, Z_FINISH, out);
+  }
+private:
+  /**
+   * \param data the raw data
+   * \param size the number of bytes in data
+   * \param flush the zlib flush mode
+   * \param out string to which the compressed bytes are appended
+   */
+  void Deflate (const char *data, uint32_t size, int flush, std::string &out)
+  {
+    char chunk[64 * 1024];
+    m_stream.next_in = (Bytef *)data;
+    m_stream.avail_in = size;
+    do
+      {
+        m_stream.next_out = (Bytef *)chunk;
+        m_stream.avail_out = sizeof (chunk);
+        int ret = deflate (&m_stream, flush);
+        NS_ABORT_MSG_IF (ret == Z_STREAM_ERROR, "GzipCompressionCodec: deflate failed");
+        out.append (chunk, sizeof (chunk) - m_stream.avail_out);
+      }
+    while (m_stream.avail_out == 0);
+  }
+
+  z_stream m_stream; //!< the deflate state
+};
+
+/**
+ * \brief gzip decompressor, built on zlib's inflate.
+ */
+class GzipDecompressionCodec : public DecompressionCodec
+{
+public:
+  GzipDecompressionCodec ()
+  {
+    std::memset (&m_stream, 0, sizeof (m_stream));
+    // 15 window bits, plus 16 to only accept a gzip wrapper
+    int ret = inflateInit2 (&m_stream, 15 + 16);
+    NS_ABORT_MSG_IF (ret != Z_OK, "GzipDecompressionCodec: inflateInit2 failed (" << ret << ")");
+  }
+  virtual ~GzipDecompressionCodec ()
+  {
+    inflateEnd (&m_stream);
+  }
+  virtual bool Decompress (const char *data, uint32_t size, std::string &out)
+  {
+    char chunk[64 * 1024];
+    m_stream.next_in = (Bytef *)data;
+    m_stream.avail_in = size;
+    do
+      {
+        m_stream.next_out = (Bytef *)chunk;
+        m_stream.avail_out = sizeof (chunk);
+        int ret = inflate (&m_stream, Z_NO_FLUSH);
+        if (ret == Z_BUF_ERROR)
+          {
+            // no progress without more input
+            break;
+          }
+        if (ret != Z_OK && ret != Z_STREAM_END)
+          {
+            return false;
+          }
+        out.append (chunk, sizeof (chunk) - m_stream.avail_out);
+        if (ret == Z_STREAM_END)
+          {
+            // a file written in append mode holds several gzip members
+            inflateReset (&m_stream);
+          }
+      }
+    while (m_stream.avail_in > 0 || m_stream.avail_out == 0);
+    return true;
+  }
+private:
+  z_stream m_stream; //!< the inflate state
+};
+#endif /* HAVE_ZLIB */
+
+#ifdef HAVE_ZSTD
+/**
+ * \brief Zstandard codec, built on the libzstd streaming API.
+ */
+class ZstdCompressionCodec : public CompressionCodec
+{
+public:
+  ZstdCompressionCodec ()
+    : m_chunk (ZSTD_CStreamOutSize ())
+  {
+    m_stream = ZSTD_createCStream ();
+    NS_ABORT_MSG_IF (m_stream == 0, "ZstdCompressionCodec: ZSTD_createCStream failed");
+    size_t ret = ZSTD_initCStream (m_stream, 3);
+    NS_ABORT_MSG_IF (ZSTD_isError (ret), "ZstdCompressionCodec: " << ZSTD_getErrorName (ret));
+  }
+  virtual ~ZstdCompressionCodec ()
+  {
+    ZSTD_freeCStream (m_stream);
+  }
+  virtual void Compress (const char *data, uint32_t size, std::string &out)
+  {
+    ZSTD_inBuffer in = { data, size, 0 };
+    while (in.pos < in.size)
+      {
+        ZSTD_outBuffer chunk = { &m_chunk[0], m_chunk.size (), 0 };
+        size_t ret = ZSTD_compressStream (m_stream, &chunk, &in);
+        NS_ABORT_MSG_IF (ZSTD_isError (ret), "ZstdCompressionCodec: " << ZSTD_getErrorName (ret));
+        out.append (&m_chunk[0], chunk.pos);
+      }
+  }
+  virtual void Flush (std::string &out)
+  {
+    size_t remaining;
+    do
+      {
+        ZSTD_outBuffer chunk = { &m_chunk[0], m_chunk.size (), 0 };
+        remaining = ZSTD_flushStream (m_stream, &chunk);
+        NS_ABORT_MSG_IF (ZSTD_isError (remaining), "ZstdCompressionCodec: " << ZSTD_getErrorName (remaining));
+        out.append (&m_chunk[0], chunk.pos);
+      }
+    while (remaining != 0);
+  }
+  virtual void Finish (std::string &out)
+  {
+    size_t remaining;
+    do
+      {
+        ZSTD_outBuffer chunk = { &m_chunk[0], m_chunk.size (), 0 };
+        remaining = ZSTD_endStream (m_stream, &chunk);
+        NS_ABORT_MSG_IF (ZSTD_isError (remaining), "ZstdCompressionCodec: " << ZSTD_getErrorName (remaining));
+        out.append (&m_chunk[0], chunk.pos);
+      }
+    while (remaining != 0);
+  }
+private:
+  ZSTD_CStream *m_stream;    //!< the compression state
+  std::vector<char> m_chunk; //!< output scratch buffer
+};
+
+/**
+ * \brief Zstandard decompressor, built on the libzstd streaming API.
+ */
+class ZstdDecompressionCodec : public DecompressionCodec
+{
+public:
+  ZstdDecompressionCodec ()
+    : m_chunk (ZSTD_DStreamOutSize ())
+  {
+    m_stream = ZSTD_createDStream ();
+    NS_ABORT_MSG_IF (m_stream == 0, "ZstdDecompressionCodec: ZSTD_createDStream failed");
+    size_t ret = ZSTD_initDStream (m_stream);
+    NS_ABORT_MSG_IF (ZSTD_isError (ret), "ZstdDecompressionCodec: " << ZSTD_getErrorName (ret));
+  }
+  virtual ~ZstdDecompressionCodec ()
+  {
+    ZSTD_freeDStream (m_stream);
+  }
+  virtual bool Decompress (const char *data, uint32_t size, std::string &out)
+  {
+    ZSTD_inBuffer in = { data, size, 0 };
+    bool full;
+    do
+      {
+        ZSTD_outBuffer chunk = { &m_chunk[0], m_chunk.size (), 0 };
+        size_t ret = ZSTD_decompressStream (m_stream, &chunk, &in);
+        if (ZSTD_isError (ret))
+          {
+            return false;
+          }
+        out.append (&m_chunk[0], chunk.pos);
+        full = chunk.pos == chunk.size;
+      }
+    while (in.pos < in.size || full);
+    return true;
+  }
+private:
+  ZSTD_DStream *m_stream;    //!< the decompression state
+  std::vector<char> m_chunk; //!< output scratch buffer
+};
+#endif /* HAVE_ZSTD */
+
+#ifdef HAVE_LZ4
+/**
+ * \brief LZ4 codec, writing the LZ4 frame format.
+ */
+class Lz4CompressionCodec : public CompressionCodec
+{
+public:
+  Lz4CompressionCodec ()
+    : m_started (false)
+  {
+    LZ4F_errorCode_t ret = LZ4F_createCompressionContext (&m_context, LZ4F_VERSION);
+    NS_ABORT_MSG_IF (LZ4F_isError (ret), "Lz4CompressionCodec: " << LZ4F_getErrorName (ret));
+  }
+  virtual ~Lz4CompressionCodec ()
+  {
+    LZ4F_freeCompressionContext (m_context);
+  }
+  virtual void Compress (const char *data, uint32_t size, std::string &out)
+  {
+    Begin (out);
+    m_chunk.resize (LZ4F_compressBound (size, 0));
+    size_t ret = LZ4F_compressUpdate (m_context, &m_chunk[0], m_chunk.size (), data, size, 0);
+    NS_ABORT_MSG_IF (LZ4F_isError (ret), "Lz4CompressionCodec: " << LZ4F_getErrorName (ret));
+    out.append (&m_chunk[0], ret);
+  }
+  virtual void Flush (std::string &out)
+  {
+    Begin (out);
+    m_chunk.resize (LZ4F_compressBound (0, 0));
+    size_t ret = LZ4F_flush (m_context, &m_chunk[0], m_chunk.size (), 0);
+    NS_ABORT_MSG_IF (LZ4F_isError (ret), "Lz4CompressionCodec: " << LZ4F_getErrorName (ret));
+    out.append (&m_chunk[0], ret);
+  }
+  virtual void Finish (std::string &out)
+  {
+    Begin (out);
+    m_chunk.resize (LZ4F_compressBound (0, 0));
+    size_t ret = LZ4F_compressEnd (m_context, &m_chunk[0], m_chunk.size (), 0);
+    NS_ABORT_MSG_IF (LZ4F_isError (ret), "Lz4CompressionCodec: " << LZ4F_getErrorName (ret));
+    out.append (&m_chunk[0], ret);
+  }
+private:
+  /**
+   * \brief Write the frame header, once.
+   * \param out string to which the header is appended
+   */
+  void Begin (std::string &out)
+  {
+    if (m_started)
+      {
+        return;
+      }
+    char header[64];
+    size_t ret = LZ4F_compressBegin (m_context, header, sizeof (header), 0);
+    NS_ABORT_MSG_IF (LZ4F_isError (ret), "Lz4CompressionCodec: " << LZ4F_getErrorName (ret));
+    out.append (header, ret);
+    m_started = true;
+  }
+
+  LZ4F_compressionContext_t m_context; //!< the compression state
+  std::vector<char> m_chunk;           //!< output scratch buffer
+  bool m_started;                      //!< true once the frame header is written
+};
+
+/**
+ * \brief LZ4 decompressor, reading the LZ4 frame format.
+ */
+class Lz4DecompressionCodec : public DecompressionCodec
+{
+public:
+  Lz4DecompressionCodec ()
+  {
+    LZ4F_errorCode_t ret = LZ4F_createDecompressionContext (&m_context, LZ4F_VERSION);
+    NS_ABORT_MSG_IF (LZ4F_isError (ret), "Lz4DecompressionCodec: " << LZ4F_getErrorName (ret));
+  }
+  virtual ~Lz4DecompressionCodec ()
+  {
+    LZ4F_freeDecompressionContext (m_context);
+  }
+  virtual bool Decompress (const char *data, uint32_t size, std::string &out)
+  {
+    char chunk[64 * 1024];
+    size_t outSize;
+    do
+      {
+        outSize = sizeof (chunk);
+        size_t inSize = size;
+        size_t ret = LZ4F_decompress (m_context, chunk, &outSize, data, &inSize, 0);
+        if (LZ4F_isError (ret))
+          {
+            return false;
+          }
+        out.append (chunk, outSize);
+        data += inSize;
+        size -= inSize;
+        if (inSize == 0 && outSize == 0)
+          {
+            // no progress without more input
+            break;
+          }
+      }
+    while (size > 0 || outSize == sizeof (chunk));
+    return true;
+  }
+private:
+  LZ4F_decompressionContext_t m_context; //!< the decompression state
+};
+#endif /* HAVE_LZ4 */
+
+CompressionCodec::~CompressionCodec ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+bool
+CompressionCodec::IsCompressedFilename (std::string const &filename)
+{
+  NS_LOG_FUNCTION (filename);
+  return HasSuffix (filename, ".gz")
+         || HasSuffix (filename, ".zst")
+         || HasSuffix (filename, ".lz4");
+}
+
+Ptr<CompressionCodec>
+CompressionCodec::CreateForFile (std::string const &filename)
+{
+  NS_LOG_FUNCTION (filename);
+#ifdef HAVE_ZLIB
+  if (HasSuffix (filename, ".gz"))
+    {
+      return Create<GzipCompressionCodec> ();
+    }
+#endif /* HAVE_ZLIB */
+#ifdef HAVE_ZSTD
+  if (HasSuffix (filename, ".zst"))
+    {
+      return Create<ZstdCompressionCodec> ();
+    }
+#endif /* HAVE_ZSTD */
+#ifdef HAVE_LZ4
+  if (HasSuffix (filename, ".lz4"))
+    {
+      return Create<Lz4CompressionCodec> ();
+    }
+#endif /* HAVE_LZ4 */
+  return 0;
+}
+
+DecompressionCodec::~DecompressionCodec ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+Ptr<DecompressionCodec>
+DecompressionCodec::CreateForFile (std::string const &filename)
+{
+  NS_LOG_FUNCTION (filename);
+#ifdef HAVE_ZLIB
+  if (HasSuffix (filename, ".gz"))
+    {
+      return Create<GzipDecompressionCodec> ();
+    }
+#endif /* HAVE_ZLIB */
+#ifdef HAVE_ZSTD
+  if (HasSuffix (filename, ".zst"))
+    {
+      return Create<ZstdDecompressionCodec> ();
+    }
+#endif /* HAVE_ZSTD */
+#ifdef HAVE_LZ4
+  if (HasSuffix (filename, ".lz4"))
+    {
+      return Create<Lz4DecompressionCodec> ();
+    }
+#endif /* HAVE_LZ4 */
+  return 0;
+}
+
+CompressedStreamBuf::CompressedStreamBuf (std::string const &filename,
+                                          std::ios::openmode mode,
+                                          Ptr<CompressionCodec> codec)
+  : m_codec (codec),
+    m_block (BLOCK_SIZE),
+    m_closed (false)
+{
+  NS_LOG_FUNCTION (this << filename << mode << codec);
+  NS_ASSERT (codec != 0);
+  m_file.open (filename.c_str (), mode | std::ios::out | std::ios::binary);
+  setp (&m_block[0], &m_block[0] + m_block.size ());
+#ifdef HAVE_PTHREAD_H
+  m_submitted = 0;
+  m_done = 0;
+  m_stop = false;
+  if (m_file.is_open ())
+    {
+      m_thread = Create<SystemThread> (MakeCallback (&CompressedStreamBuf::Run, this));
+      m_thread->Start ();
+    }
+#endif /* HAVE_PTHREAD_H */
+}
+
+CompressedStreamBuf::~CompressedStreamBuf ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+bool
+CompressedStreamBuf::IsOpen (void) const
+{
+  return m_file.is_open ();
+}
+
+void
+CompressedStreamBuf::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_closed)
+    {
+      return;
+    }
+  m_closed = true;
+  if (!m_file.is_open ())
+    {
+      return;
+    }
+  SubmitBlock (false);
+#ifdef HAVE_PTHREAD_H
+  {
+    CriticalSection cs (m_mutex);
+    m_stop = true;
+  }
+  m_dataReady.SetCondition (true);
+  m_dataReady.Signal ();
+  m_thread->Join ();
+  m_thread = 0;
+#endif /* HAVE_PTHREAD_H */
+  m_compressed.clear ();
+  m_codec->Finish (m_compressed);
+  m_file.write (m_compressed.data (), m_compressed.size ());
+  m_file.close ();
+  setp (0, 0);
+}
+
+CompressedStreamBuf::int_type
+CompressedStreamBuf::overflow (int_type c)
+{
+  if (m_closed || !m_file.is_open ())
+    {
+      return traits_type::eof ();
+    }
+  SubmitBlock (false);
+  if (!traits_type::eq_int_type (c, traits_type::eof ()))
+    {
+      *pptr () = traits_type::to_char_type (c);
+      pbump (1);
+    }
+  return traits_type::not_eof (c);
+}
+
+int
+CompressedStreamBuf::sync (void)
+{
+  if (m_closed)
+    {
+      return 0;
+    }
+  if (!m_file.is_open ())
+    {
+      return -1;
+    }
+  SubmitBlock (true);
+  return m_file.good () ? 0 : -1;
+}
+
+void
+CompressedStreamBuf::SubmitBlock (bool flush)
+{
+  uint32_t size = pptr () - pbase ();
+  if (size == 0 && !flush)
+    {
+      return;
+    }
+  m_block.resize (size);
+#ifdef HAVE_PTHREAD_H
+  // the conditions are reset before the state they announce is
+  // checked, so that a change made after the check ends the wait at once
+  uint64_t submitted;
+  while (true)
+    {
+      m_written.SetCondition (false);
+      {
+        CriticalSection cs (m_mutex);
+        if (m_pending.size () < MAX_PENDING_BLOCKS)
+          {
+            m_pending.push_back (PendingBlock ());
+            m_pending.back ().data.swap (m_block);
+            m_pending.back ().flush = flush;
+            submitted = ++m_submitted;
+            break;
+          }
+      }
+      m_written.TimedWait (WAIT_TIMEOUT);
+    }
+  m_dataReady.SetCondition (true);
+  m_dataReady.Signal ();
+  if (flush)
+    {
+      while (true)
+        {
+          m_written.SetCondition (false);
+          {
+            CriticalSection cs (m_mutex);
+            if (m_done >= submitted)
+              {
+                break;
+              }
+          }
+          m_written.TimedWait (WAIT_TIMEOUT);
+        }
+    }
+#else
+  Compress (m_block, flush);
+#endif /* HAVE_PTHREAD_H */
+  m_block.resize (BLOCK_SIZE);
+  setp (&m_block[0], &m_block[0] + m_block.size ());
+}
+
+void
+CompressedStreamBuf::Compress (std::vector<char> const &block, bool flush)
+{
+  m_compressed.clear ();
+  if (!block.empty ())
+    {
+      m_codec->Compress (&block[0], block.size (), m_compressed);
+    }
+  if (flush)
+    {
+      m_codec->Flush (m_compressed);
+    }
+  m_file.write (m_compressed.data (), m_compressed.size ());
+  if (flush)
+    {
+      m_file.flush ();
+    }
+}
+
+#ifdef HAVE_PTHREAD_H
+void
+CompressedStreamBuf::Run (void)
+{
+  PendingBlock block;
+  while (true)
+    {
+      bool found = false;
+      bool stop = false;
+      m_dataReady.SetCondition (false);
+      {
+        CriticalSection cs (m_mutex);
+        if (!m_pending.empty ())
+          {
+            block.data.swap (m_pending.front ().data);
+            block.flush = m_pending.front ().flush;
+            m_pending.pop_front ();
+            found = true;
+          }
+        stop = m_stop;
+      }
+      if (found)
+        {
+          Compress (block.data, block.flush);
+          {
+            CriticalSection cs (m_mutex);
+            m_done++;
+          }
+          m_written.SetCondition (true);
+          m_written.Broadcast ();
+        }
+      else if (stop)
+        {
+          // every block has been written
+          break;
+        }
+      else
+        {
+          m_dataReady.TimedWait (WAIT_TIMEOUT);
+        }
+    }
+}
+#endif /* HAVE_PTHREAD_H */
+
+CompressedOutputStream::CompressedOutputStream (std::string const &filename,
+                                                std::ios::openmode mode,
+                                                Ptr<CompressionCodec> codec)
+  : std::ostream (0),
+    m_buf (filename, mode, codec)
+{
+  NS_LOG_FUNCTION (this << filename << mode << codec);
+  rdbuf (&m_buf);
+  if (!m_buf.IsOpen ())
+    {
+      setstate (std::ios::failbit);
+    }
+}
+
+CompressedOutputStream::~CompressedOutputStream ()
+{
+  NS_LOG_FUNCTION (this);
+  m_buf.Close ();
+}
+
+bool
+CompressedOutputStream::IsOpen (void) const
+{
+  return m_buf.IsOpen ();
+}
+
+void
+CompressedOutputStream::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_buf.Close ();
+}
+
+} // namespace ns3
@@ -0,0 +1,248 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef COMPRESSED_OUTPUT_STREAM_H
+#define COMPRESSED_OUTPUT_STREAM_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <fstream>
+#include <ostream>
+#include <streambuf>
+#include <stdint.h>
+#include "ns3/core-config.h"
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-mutex.h"
+#include "ns3/system-condition.h"
+#endif /* HAVE_PTHREAD_H */
+
+namespace ns3 {
+
+class SystemThread;
+
+/**
+ * \brief Interface of a streaming compressor used for trace files.
+ *
+ * A codec consumes raw blocks of trace data and appends the compressed
+ * representation to an output string.  Codecs are selected from the
+ * file name extension by CreateForFile; which codecs are available
+ * depends on the libraries found when ns-3 was configured (zlib for
+ * ".gz", libzstd for ".zst" and liblz4 for ".lz4").
+ */
+class CompressionCodec : public SimpleRefCount<CompressionCodec>
+{
+public:
+  virtual ~CompressionCodec ();
+
+  /**
+   * \brief Compress a block of data
+   * \param data the raw data
+   * \param size the number of bytes in data
+   * \param out string to which the compressed bytes are appended
+   */
+  virtual void Compress (const char *data, uint32_t size, std::string &out) = 0;
+
+  /**
+   * \brief Output everything compressed so far, so that the stream
+   * written until now can be decompressed without its end
+   * \param out string to which the compressed bytes are appended
+   */
+  virtual void Flush (std::string &out) = 0;
+
+  /**
+   * \brief Terminate the compressed stream
+   * \param out string to which the trailing bytes are appended
+   */
+  virtual void Finish (std::string &out) = 0;
+
+  /**
+   * \param filename the name of the file to be written
+   * \returns true if the extension of filename selects a compressed format
+   */
+  static bool IsCompressedFilename (std::string const &filename);
+
+  /**
+   * \param filename the name of the file to be written
+   * \returns a codec for the extension of filename, or 0 if the extension
+   * is not a compressed format or support for it was not compiled in.
+   */
+  static Ptr<CompressionCodec> CreateForFile (std::string const &filename);
+};
+
+/**
+ * \brief Interface of a streaming decompressor, reading back the files
+ * written through a CompressionCodec.
+ *
+ * Decompressors are selected from the file name extension by
+ * CreateForFile, among the same formats as the compressors.
+ */
+class DecompressionCodec : public SimpleRefCount<DecompressionCodec>
+{
+public:
+  virtual ~DecompressionCodec ();
+
+  /**
+   * \brief Decompress the next bytes of a compressed file
+   * \param data the compressed data
+   * \param size the number of bytes in data
+   * \param out string to which the decompressed bytes are appended
+   * \returns false if data is not valid compressed data
+   */
+  virtual bool Decompress (const char *data, uint32_t size, std::string &out) = 0;
+
+  /**
+   * \param filename the name of the file to be read
+   * \returns a decompressor for the extension of filename, or 0 if the
+   * extension is not a compressed format or support for it was not
+   * compiled in.
+   */
+  static Ptr<DecompressionCodec> CreateForFile (std::string const &filename);
+};
+
+/**
+ * \brief A std::streambuf which compresses its content into a file.
+ *
+ * Data written to the buffer is accumulated in fixed size blocks.  Full
+ * blocks are handed to a worker thread (when threading is available)
+ * which compresses them and writes the result to the file, so that the
+ * simulation only pays for a memcpy per trace line.  The number of
+ * blocks waiting for the worker is bounded; if the worker falls behind
+ * the writer blocks until a slot is free.
+ *
+ * sync (), i.e., std::ostream::flush () and std::endl, hands the block
+ * being filled to the worker, flushes the codec and waits until the
+ * file has been written, so that a flushed trace can be decompressed up
+ * to its last line, e.g., after NS_FATAL_ERROR.  This costs a round
+ * trip to the worker and some compression ratio per flush, which is why
+ * the ascii trace sinks of the helpers end their lines with "\n" rather
+ * than std::endl.
+ */
+class CompressedStreamBuf : public std::streambuf
+{
+public:
+  /**
+   * \param filename the name of the file to write
+   * \param mode the std::ios::openmode used to open the file
+   * \param codec the compressor to use
+   */
+  CompressedStreamBuf (std::string const &filename, std::ios::openmode mode,
+                       Ptr<CompressionCodec> codec);
+  virtual ~CompressedStreamBuf ();
+
+  /**
+   * \returns true if the underlying file was successfully opened
+   */
+  bool IsOpen (void) const;
+
+  /**
+   * \brief Compress any pending data, terminate the stream and close the file.
+   */
+  void Close (void);
+
+protected:
+  virtual int_type overflow (int_type c);
+  virtual int sync (void);
+
+private:
+  /// Size of the blocks handed to the codec
+  static const uint32_t BLOCK_SIZE = 256 * 1024;
+  /// Maximum number of blocks waiting to be compressed
+  static const uint32_t MAX_PENDING_BLOCKS = 8;
+  /// Bound on each wait for the worker or the writer, in ns
+  static const uint64_t WAIT_TIMEOUT = 100000000;
+
+  /**
+   * \brief Hand the current block to the worker and start a new one.
+   * \param flush whether to flush the codec after the block, and wait
+   * until the file has been written
+   */
+  void SubmitBlock (bool flush);
+  /**
+   * \brief Compress a block and write it to the file.
+   * \param block the block to compress
+   * \param flush whether to flush the codec and the file after the block
+   */
+  void Compress (std::vector<char> const &block, bool flush);
+
+  std::ofstream m_file;                 //!< the compressed file
+  Ptr<CompressionCodec> m_codec;        //!< the compressor
+  std::vector<char> m_block;            //!< the block being filled
+  std::string m_compressed;             //!< scratch output of the codec
+  bool m_closed;                        //!< true once Close has run
+
+#ifdef HAVE_PTHREAD_H
+  /**
+   * \brief Worker thread entry point.
+   */
+  void Run (void);
+
+  /// A block waiting for the worker
+  struct PendingBlock
+  {
+    std::vector<char> data; //!< the raw data, possibly empty
+    bool flush;             //!< whether sync () asked for this block
+  };
+
+  Ptr<SystemThread> m_thread;           //!< the compression worker
+  SystemMutex m_mutex;                  //!< protects the fields below
+  SystemCondition m_dataReady;          //!< set when a block is queued or the worker must stop
+  SystemCondition m_written;            //!< set when a block has been written
+  std::deque<PendingBlock> m_pending;   //!< blocks waiting for the worker
+  uint64_t m_submitted;                 //!< number of blocks queued so far
+  uint64_t m_done;                      //!< number of blocks written so far
+  bool m_stop;                          //!< asks the worker to exit once drained
+#endif /* HAVE_PTHREAD_H */
+};
+
+/**
+ * \brief An std::ostream writing into a CompressedStreamBuf.
+ *
+ * This is the stream created by OutputStreamWrapper when it is given a
+ * file name with a compressed extension, e.g., "trace.tr.gz".
+ */
+class CompressedOutputStream : public std::ostream
+{
+public:
+  /**
+   * \param filename the name of the file to write
+   * \param mode the std::ios::openmode used to open the file
+   * \param codec the compressor to use
+   */
+  CompressedOutputStream (std::string const &filename, std::ios::openmode mode,
+                          Ptr<CompressionCodec> codec);
+  virtual ~CompressedOutputStream ();
+
+  /**
+   * \returns true if the underlying file was successfully opened
+   */
+  bool IsOpen (void) const;
+
+  /**
+   * \brief Flush everything to the file and close it.
+   */
+  void Close (void);
+
+private:
+  CompressedStreamBuf m_buf; //!< the compressing stream buffer
+};
+
+} // namespace ns3
+
+#endif /* COMPRESSED_OUTPUT_STREAM_H */
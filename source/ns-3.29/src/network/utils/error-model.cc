@@ -60,12 +60,14 @@
  *         James P.G. Sterbenz <jpgs@ittc.ku.edu>, director 
  */
 
+#include <algorithm>
 #include <cmath>
 
 #include "error-model.h"
 
 #include "ns3/packet.h"
 #include "ns3/assert.h"
+#include "ns3/abort.h"
 #include "ns3/log.h"
 #include "ns3/boolean.h"
 #include "ns3/enum.h"
@@ -77,6 +79,32 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("ErrorModel");
 
+/**
+ * \param logSuccess log of the probability that one unit is not errored
+ * \param unit the error unit
+ * \param size size of the packet in bytes
+ * \returns the probability that the packet is errored, assuming
+ *          independent errors
+ */
+static double
+PacketErrorRate (double logSuccess, enum RateErrorModel::ErrorUnit unit, uint32_t size)
+{
+  switch (unit)
+    {
+    case RateErrorModel::ERROR_UNIT_PACKET:
+      return -std::expm1 (logSuccess);
+    case RateErrorModel::ERROR_UNIT_BYTE:
+      return -std::expm1 (logSuccess * size);
+    case RateErrorModel::ERROR_UNIT_BIT:
+      return -std::expm1 (logSuccess * 8 * size);
+    default:
+      NS_ASSERT_MSG (false, "unit not supported yet");
+      break;
+    }
+  return 0;
+}
+
+
 NS_OBJECT_ENSURE_REGISTERED (ErrorModel);
 
 TypeId ErrorModel::GetTypeId (void)
@@ -411,6 +439,115 @@ BurstErrorModel::DoReset (void)
 }
 
 
+//
+// GilbertElliottErrorModel
+//
+
+NS_OBJECT_ENSURE_REGISTERED (GilbertElliottErrorModel);
+
+TypeId GilbertElliottErrorModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::GilbertElliottErrorModel")
+    .SetParent<ErrorModel> ()
+    .SetGroupName("Network")
+    .AddConstructor<GilbertElliottErrorModel> ()
+    .AddAttribute ("ErrorUnit", "The error unit",
+                   EnumValue (RateErrorModel::ERROR_UNIT_PACKET),
+                   MakeEnumAccessor (&GilbertElliottErrorModel::m_unit),
+                   MakeEnumChecker (RateErrorModel::ERROR_UNIT_BIT, "ERROR_UNIT_BIT",
+                                    RateErrorModel::ERROR_UNIT_BYTE, "ERROR_UNIT_BYTE",
+                                    RateErrorModel::ERROR_UNIT_PACKET, "ERROR_UNIT_PACKET"))
+    .AddAttribute ("GoodToBad", "The probability to move from the good to the bad state, per packet.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&GilbertElliottErrorModel::m_goodToBad),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddAttribute ("BadToGood", "The probability to move from the bad to the good state, per packet.",
+                   DoubleValue (1.0),
+                   MakeDoubleAccessor (&GilbertElliottErrorModel::m_badToGood),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddAttribute ("GoodErrorRate", "The error rate in the good state.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&GilbertElliottErrorModel::m_goodRate),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddAttribute ("BadErrorRate", "The error rate in the bad state.",
+                   DoubleValue (1.0),
+                   MakeDoubleAccessor (&GilbertElliottErrorModel::m_badRate),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddAttribute ("RanVar", "The decision variable attached to this error model.",
+                   StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=1.0]"),
+                   MakePointerAccessor (&GilbertElliottErrorModel::m_ranvar),
+                   MakePointerChecker<RandomVariableStream> ())
+  ;
+  return tid;
+}
+
+GilbertElliottErrorModel::GilbertElliottErrorModel ()
+  : m_bad (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+GilbertElliottErrorModel::~GilbertElliottErrorModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+bool
+GilbertElliottErrorModel::IsBadState (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_bad;
+}
+
+void
+GilbertElliottErrorModel::SetRandomVariable (Ptr<RandomVariableStream> ranvar)
+{
+  NS_LOG_FUNCTION (this << ranvar);
+  m_ranvar = ranvar;
+}
+
+int64_t
+GilbertElliottErrorModel::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_ranvar->SetStream (stream);
+  return 1;
+}
+
+bool
+GilbertElliottErrorModel::DoCorrupt (Ptr<Packet> p)
+{
+  NS_LOG_FUNCTION (this << p);
+  if (!IsEnabled ())
+    {
+      return false;
+    }
+  if (m_ranvar->GetValue () < (m_bad ? m_badToGood : m_goodToBad))
+    {
+      m_bad = !m_bad;
+      NS_LOG_DEBUG ("moved to the " << (m_bad ? "bad" : "good") << " state");
+    }
+  double rate = m_bad ? m_badRate : m_goodRate;
+  if (rate <= 0)
+    {
+      return false;
+    }
+  if (rate >= 1)
+    {
+      return true;
+    }
+  double per = PacketErrorRate (std::log1p (-rate), m_unit, p->GetSize ());
+  return (m_ranvar->GetValue () < per);
+}
+
+void
+GilbertElliottErrorModel::DoReset (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_bad = false;
+}
+
+
 //
 // ListErrorModel
 //
@@ -596,5 +733,158 @@ BinaryErrorModel::DoReset (void)
 
 
 
+//
+// LinkErrorModel
+//
+
+NS_OBJECT_ENSURE_REGISTERED (LinkErrorModel);
+
+TypeId LinkErrorModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LinkErrorModel")
+    .SetParent<Object> ()
+    .SetGroupName("Network")
+    .AddConstructor<LinkErrorModel> ()
+    .AddAttribute ("ErrorUnit", "The error unit",
+                   EnumValue (RateErrorModel::ERROR_UNIT_BYTE),
+                   MakeEnumAccessor (&LinkErrorModel::m_unit),
+                   MakeEnumChecker (RateErrorModel::ERROR_UNIT_BIT, "ERROR_UNIT_BIT",
+                                    RateErrorModel::ERROR_UNIT_BYTE, "ERROR_UNIT_BYTE",
+                                    RateErrorModel::ERROR_UNIT_PACKET, "ERROR_UNIT_PACKET"))
+    .AddAttribute ("ErrorRate", "The error rate of the links without a rate of their own.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&LinkErrorModel::SetDefaultRate,
+                                       &LinkErrorModel::GetDefaultRate),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddAttribute ("RanVar", "The decision variable attached to this error model.",
+                   StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=1.0]"),
+                   MakePointerAccessor (&LinkErrorModel::m_ranvar),
+                   MakePointerChecker<RandomVariableStream> ())
+    .AddTraceSource ("Corrupt",
+                     "A packet has been corrupted on a link.",
+                     MakeTraceSourceAccessor (&LinkErrorModel::m_corruptTrace),
+                     "ns3::LinkErrorModel::CorruptTracedCallback")
+  ;
+  return tid;
+}
+
+LinkErrorModel::LinkErrorModel ()
+  : m_nDevices (0)
+{
+  NS_LOG_FUNCTION (this);
+  m_default.rate = 0;
+  m_default.logSuccess = 0;
+}
+
+LinkErrorModel::~LinkErrorModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+LinkErrorModel::SetDefaultRate (double rate)
+{
+  NS_LOG_FUNCTION (this << rate);
+  m_default.rate = rate;
+  m_default.logSuccess = std::log1p (-rate);
+}
+
+double
+LinkErrorModel::GetDefaultRate (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_default.rate;
+}
+
+void
+LinkErrorModel::SetRate (uint32_t from, uint32_t to, double rate)
+{
+  NS_LOG_FUNCTION (this << from << to << rate);
+  NS_ABORT_MSG_IF (rate < 0 || rate > 1, "LinkErrorModel::SetRate(): rate must be in [0, 1]");
+  uint32_t n = std::max (from, to) + 1;
+  if (n > m_nDevices)
+    {
+      Link unset;
+      unset.rate = -1;
+      unset.logSuccess = 0;
+      std::vector<Link> links (n * n, unset);
+      for (uint32_t i = 0; i < m_nDevices; ++i)
+        {
+          std::copy (m_links.begin () + i * m_nDevices, m_links.begin () + (i + 1) * m_nDevices,
+                     links.begin () + i * n);
+        }
+      m_links.swap (links);
+      m_nDevices = n;
+    }
+  Link &link = m_links[from * m_nDevices + to];
+  link.rate = rate;
+  link.logSuccess = std::log1p (-rate);
+}
+
+double
+LinkErrorModel::GetRate (uint32_t from, uint32_t to) const
+{
+  NS_LOG_FUNCTION (this << from << to);
+  return Lookup (from, to).rate;
+}
+
+const LinkErrorModel::Link &
+LinkErrorModel::Lookup (uint32_t from, uint32_t to) const
+{
+  if (from < m_nDevices && to < m_nDevices)
+    {
+      const Link &link = m_links[from * m_nDevices + to];
+      if (link.rate >= 0)
+        {
+          return link;
+        }
+    }
+  return m_default;
+}
+
+double
+LinkErrorModel::GetPacketErrorRate (uint32_t from, uint32_t to, uint32_t size) const
+{
+  NS_LOG_FUNCTION (this << from << to << size);
+  const Link &link = Lookup (from, to);
+  if (link.rate <= 0)
+    {
+      return 0;
+    }
+  if (link.rate >= 1)
+    {
+      return 1;
+    }
+  return PacketErrorRate (link.logSuccess, m_unit, size);
+}
+
+bool
+LinkErrorModel::IsCorrupt (Ptr<const Packet> p, uint32_t from, uint32_t to)
+{
+  NS_LOG_FUNCTION (this << p << from << to);
+  double per = GetPacketErrorRate (from, to, p->GetSize ());
+  if (per <= 0 || m_ranvar->GetValue () >= per)
+    {
+      return false;
+    }
+  m_corruptTrace (p, from, to);
+  return true;
+}
+
+void
+LinkErrorModel::SetRandomVariable (Ptr<RandomVariableStream> ranvar)
+{
+  NS_LOG_FUNCTION (this << ranvar);
+  m_ranvar = ranvar;
+}
+
+int64_t
+LinkErrorModel::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_ranvar->SetStream (stream);
+  return 1;
+}
+
 } // namespace ns3
 
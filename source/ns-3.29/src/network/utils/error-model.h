@@ -64,8 +64,10 @@
 #define ERROR_MODEL_H
 
 #include <list>
+#include <vector>
 #include "ns3/object.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/traced-callback.h"
 
 namespace ns3 {
 
@@ -354,6 +356,69 @@ private:
 };
 
 
+/**
+ * \brief Determine which packets are errored with a two-state
+ * Gilbert-Elliott channel.
+ *
+ * The channel is either in the good or in the bad state.  For each
+ * packet, the model first moves from the good to the bad state with
+ * probability GoodToBad, or from the bad to the good state with
+ * probability BadToGood, and then corrupts the packet with the error
+ * rate of the new state.  As with RateErrorModel, the rates apply to
+ * packets, bytes or bits; with byte or bit units the packet error rate
+ * is computed in closed form from the size of the packet, assuming
+ * independent errors.  The mean length of a bad period is
+ * 1/BadToGood packets.
+ *
+ * Reset() on this model puts it back in the good state
+ *
+ * IsCorrupt() will not modify the packet data buffer
+ */
+class GilbertElliottErrorModel : public ErrorModel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  GilbertElliottErrorModel ();
+  virtual ~GilbertElliottErrorModel ();
+
+  /**
+   * \returns true if the channel is in the bad state
+   */
+  bool IsBadState (void) const;
+
+  /**
+   * \param ranvar A random variable distribution to generate random variates
+   */
+  void SetRandomVariable (Ptr<RandomVariableStream> ranvar);
+
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.  Return the number of streams (possibly zero) that
+   * have been assigned.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+
+private:
+  virtual bool DoCorrupt (Ptr<Packet> p);
+  virtual void DoReset (void);
+
+  enum RateErrorModel::ErrorUnit m_unit; //!< Error rate unit
+  double m_goodToBad;                    //!< transition probability from the good state
+  double m_badToGood;                    //!< transition probability from the bad state
+  double m_goodRate;                     //!< error rate in the good state
+  double m_badRate;                      //!< error rate in the bad state
+  bool m_bad;                            //!< true in the bad state
+  Ptr<RandomVariableStream> m_ranvar;    //!< rng stream
+};
+
 /**
  * \brief Provide a list of Packet uids to corrupt
  *
@@ -482,5 +547,122 @@ private:
 
 };
 
+
+/**
+ * \brief Table of error rates between the devices of a channel.
+ *
+ * Channels holding a LinkErrorModel (the "LinkErrorModel" attribute of
+ * SimpleChannel, PointToPointChannel and CsmaChannel) consult it for
+ * each receiver of a packet, and do not deliver the packets it
+ * flags as corrupted; the receiving device reports them on its
+ * PhyRxDrop trace instead, when they would have arrived.  Links are identified by the indices of the
+ * transmitting and receiving devices in the channel, i.e., the
+ * indices of Channel::GetDevice.  Links without an error rate of their
+ * own use the "ErrorRate" attribute.
+ *
+ * Rates apply to packets, bytes or bits, as with RateErrorModel.  The
+ * log of the success probability of each link is stored in the table,
+ * so that the packet error rate for a given size costs one exp() and
+ * the decision costs one random draw; no draw is made on links with a
+ * zero error rate.
+ */
+class LinkErrorModel : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  LinkErrorModel ();
+  virtual ~LinkErrorModel ();
+
+  /**
+   * \param rate the error rate of the links without a rate of their own
+   */
+  void SetDefaultRate (double rate);
+  /**
+   * \returns the error rate of the links without a rate of their own
+   */
+  double GetDefaultRate (void) const;
+
+  /**
+   * \param from index in the channel of the transmitting device
+   * \param to index in the channel of the receiving device
+   * \param rate the error rate of the link
+   */
+  void SetRate (uint32_t from, uint32_t to, double rate);
+  /**
+   * \param from index in the channel of the transmitting device
+   * \param to index in the channel of the receiving device
+   * \returns the error rate of the link
+   */
+  double GetRate (uint32_t from, uint32_t to) const;
+
+  /**
+   * \param from index in the channel of the transmitting device
+   * \param to index in the channel of the receiving device
+   * \param size the size of the packet, in bytes
+   * \returns the probability that a packet of this size is corrupted
+   */
+  double GetPacketErrorRate (uint32_t from, uint32_t to, uint32_t size) const;
+
+  /**
+   * \param p the packet
+   * \param from index in the channel of the transmitting device
+   * \param to index in the channel of the receiving device
+   * \returns true if the packet is corrupted on this link
+   */
+  bool IsCorrupt (Ptr<const Packet> p, uint32_t from, uint32_t to);
+
+  /**
+   * \param ranvar A random variable distribution to generate random variates
+   */
+  void SetRandomVariable (Ptr<RandomVariableStream> ranvar);
+
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.  Return the number of streams (possibly zero) that
+   * have been assigned.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+
+  /**
+   * TracedCallback signature for packets corrupted on a link.
+   *
+   * \param [in] packet The packet.
+   * \param [in] from Index of the transmitting device.
+   * \param [in] to Index of the receiving device.
+   */
+  typedef void (* CorruptTracedCallback)
+    (Ptr<const Packet> packet, uint32_t from, uint32_t to);
+
+private:
+  /// Error rate of a link
+  struct Link
+  {
+    double rate;       //!< the error rate, negative if unset
+    double logSuccess; //!< log (1 - rate)
+  };
+
+  /**
+   * \param from index of the transmitting device
+   * \param to index of the receiving device
+   * \returns the link, or the default link
+   */
+  const Link &Lookup (uint32_t from, uint32_t to) const;
+
+  enum RateErrorModel::ErrorUnit m_unit; //!< Error rate unit
+  Link m_default;                        //!< the link used when no rate is set
+  std::vector<Link> m_links;             //!< m_nDevices x m_nDevices links, by transmitter
+  uint32_t m_nDevices;                   //!< the dimension of the table
+  Ptr<RandomVariableStream> m_ranvar;    //!< rng stream
+  TracedCallback<Ptr<const Packet>, uint32_t, uint32_t> m_corruptTrace; //!< corrupted packets
+};
+
 } // namespace ns3
 #endif
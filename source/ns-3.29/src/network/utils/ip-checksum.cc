@@ -0,0 +1,110 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include "ip-checksum.h"
+
+namespace ns3 {
+
+/**
+ * \param sum a ones' complement sum on 64 bits
+ * \returns the same sum on 16 bits
+ */
+static inline uint16_t
+Fold (uint64_t sum)
+{
+  sum = (sum & 0xffffffff) + (sum >> 32);
+  sum = (sum & 0xffffffff) + (sum >> 32);
+  sum = (sum & 0xffff) + (sum >> 16);
+  sum = (sum & 0xffff) + (sum >> 16);
+  sum = (sum & 0xffff) + (sum >> 16);
+  return static_cast<uint16_t> (sum);
+}
+
+/**
+ * \param sum the running sum
+ * \param data the 8 bytes to add
+ * \returns sum + data, with the carry wrapped around
+ */
+static inline uint64_t
+Add64 (uint64_t sum, const uint8_t *data)
+{
+  uint64_t v;
+  std::memcpy (&v, data, sizeof (v));
+  sum += v;
+  return sum + (sum < v);
+}
+
+uint16_t
+IpChecksumAdd (const uint8_t *data, uint32_t length)
+{
+  // RFC 1071: the ones' complement sum can be computed on words wider
+  // than 16 bits and folded at the end.  Four accumulators keep the
+  // carry chains independent.
+  uint64_t s0 = 0;
+  uint64_t s1 = 0;
+  uint64_t s2 = 0;
+  uint64_t s3 = 0;
+  while (length >= 32)
+    {
+      s0 = Add64 (s0, data);
+      s1 = Add64 (s1, data + 8);
+      s2 = Add64 (s2, data + 16);
+      s3 = Add64 (s3, data + 24);
+      data += 32;
+      length -= 32;
+    }
+  while (length >= 8)
+    {
+      s0 = Add64 (s0, data);
+      data += 8;
+      length -= 8;
+    }
+  uint64_t sum = Fold (s0) + Fold (s1) + Fold (s2) + Fold (s3);
+
+  // The words loaded above are in host order: swap the result on
+  // big-endian hosts before adding the tail, which is summed in the
+  // order of Buffer::Iterator::ReadU16.
+  const uint16_t one = 1;
+  if (*reinterpret_cast<const uint8_t *> (&one) == 0)
+    {
+      uint16_t folded = Fold (sum);
+      sum = static_cast<uint16_t> ((folded >> 8) | (folded << 8));
+    }
+  while (length >= 2)
+    {
+      sum += data[0] | (data[1] << 8);
+      data += 2;
+      length -= 2;
+    }
+  if (length == 1)
+    {
+      sum += data[0];
+    }
+  return Fold (sum);
+}
+
+uint16_t
+IpChecksumUpdate (uint16_t checksum, uint16_t oldWord, uint16_t newWord)
+{
+  // HC' = ~(~HC + ~m + m')
+  uint32_t sum = static_cast<uint16_t> (~checksum);
+  sum += static_cast<uint16_t> (~oldWord);
+  sum += newWord;
+  return ~Fold (sum);
+}
+
+} // namespace ns3
@@ -0,0 +1,53 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef IP_CHECKSUM_H
+#define IP_CHECKSUM_H
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ *
+ * Calculates the 16-bit ones' complement sum of a buffer (RFC 1071).
+ *
+ * The 16-bit words are read with their first byte in the low-order
+ * half, as Buffer::Iterator::ReadU16 reads them, and a trailing odd
+ * byte is padded with zero.  The data is summed eight bytes at a time.
+ *
+ * \param data buffer to sum
+ * \param length the length of the buffer (bytes)
+ * \returns the folded sum (not its complement).
+ */
+uint16_t IpChecksumAdd (const uint8_t *data, uint32_t length);
+
+/**
+ * \ingroup network
+ *
+ * Updates a checksum after a change of one 16-bit word of the data
+ * it covers (RFC 1624, eqn. 3), e.g., the TTL and protocol word of
+ * an IPv4 header after a TTL decrement.
+ *
+ * \param checksum the checksum of the data before the change
+ * \param oldWord the word before the change
+ * \param newWord the word after the change
+ * \returns the checksum of the data after the change.
+ */
+uint16_t IpChecksumUpdate (uint16_t checksum, uint16_t oldWord, uint16_t newWord);
+
+} // namespace ns3
+
+#endif /* IP_CHECKSUM_H */
@@ -17,6 +17,7 @@
  */
 
 #include "output-stream-wrapper.h"
+#include "compressed-output-stream.h"
 #include "ns3/log.h"
 #include "ns3/fatal-impl.h"
 #include "ns3/abort.h"
@@ -30,6 +31,18 @@ OutputStreamWrapper::OutputStreamWrapper (std::string filename, std::ios::openmo
   : m_destroyable (true)
 {
   NS_LOG_FUNCTION (this << filename << filemode);
+  if (CompressionCodec::IsCompressedFilename (filename))
+    {
+      Ptr<CompressionCodec> codec = CompressionCodec::CreateForFile (filename);
+      NS_ABORT_MSG_IF (codec == 0, "AsciiTraceHelper::CreateFileStream():  " <<
+                       "No compression support compiled in for " << filename);
+      CompressedOutputStream* os = new CompressedOutputStream (filename, filemode, codec);
+      m_ostream = os;
+      FatalImpl::RegisterStream (m_ostream);
+      NS_ABORT_MSG_UNLESS (os->IsOpen (), "AsciiTraceHelper::CreateFileStream():  " <<
+                           "Unable to Open " << filename << " for mode " << filemode);
+      return;
+    }
   std::ofstream* os = new std::ofstream ();
   os->open (filename.c_str (), filemode);
   m_ostream = os;
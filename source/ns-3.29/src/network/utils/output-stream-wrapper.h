@@ -72,6 +72,10 @@ class OutputStreamWrapper : public SimpleRefCount<OutputStreamWrapper>
 public:
   /**
    * Constructor
+   *
+   * If filename ends with ".gz", ".zst" or ".lz4" the wrapped stream is a
+   * CompressedOutputStream which compresses the trace on a worker thread.
+   *
    * \param filename file name
    * \param filemode std::ios::openmode flags
    */
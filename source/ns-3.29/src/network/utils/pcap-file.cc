@@ -21,12 +21,14 @@
 #include <iostream>
 #include <cstring>
 #include "ns3/assert.h"
+#include "ns3/abort.h"
 #include "ns3/packet.h"
 #include "ns3/fatal-error.h"
 #include "ns3/fatal-impl.h"
 #include "ns3/header.h"
 #include "ns3/buffer.h"
 #include "pcap-file.h"
+#include "compressed-output-stream.h"
 #include "ns3/log.h"
 #include "ns3/build-profile.h"
 //
@@ -49,6 +51,8 @@ const uint16_t VERSION_MINOR = 4;             /**< Minor version of supported pc
 
 PcapFile::PcapFile ()
   : m_file (),
+    m_out (&m_file),
+    m_compressed (0),
     m_swapMode (false),
     m_nanosecMode (false)
 {
@@ -68,7 +72,7 @@ bool
 PcapFile::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
-  return m_file.fail ();
+  return m_file.fail () || (m_compressed != 0 && m_compressed->fail ());
 }
 bool 
 PcapFile::Eof (void) const
@@ -81,6 +85,10 @@ PcapFile::Clear (void)
 {
   NS_LOG_FUNCTION (this);
   m_file.clear ();
+  if (m_compressed != 0)
+    {
+      m_compressed->clear ();
+    }
 }
 
 
@@ -89,6 +97,13 @@ PcapFile::Close (void)
 {
   NS_LOG_FUNCTION (this);
   m_file.close ();
+  if (m_compressed != 0)
+    {
+      FatalImpl::UnregisterStream (m_compressed);
+      delete m_compressed;
+      m_compressed = 0;
+      m_out = &m_file;
+    }
 }
 
 uint32_t
@@ -204,9 +219,13 @@ PcapFile::WriteFileHeader (void)
   NS_LOG_FUNCTION (this);
   //
   // If we're initializing the file, we need to write the pcap file header
-  // at the start of the file.
+  // at the start of the file.  A compressed stream cannot seek, but it
+  // is always freshly created and so already at the start.
   //
-  m_file.seekp (0, std::ios::beg);
+  if (m_compressed == 0)
+    {
+      m_file.seekp (0, std::ios::beg);
+    }
  
   //
   // We have the ability to write out the pcap file header in a foreign endian
@@ -234,13 +253,13 @@ PcapFile::WriteFileHeader (void)
   // Watch out for memory alignment differences between machines, so write
   // them all individually.
   //
-  m_file.write ((const char *)&headerOut->m_magicNumber, sizeof(headerOut->m_magicNumber));
-  m_file.write ((const char *)&headerOut->m_versionMajor, sizeof(headerOut->m_versionMajor));
-  m_file.write ((const char *)&headerOut->m_versionMinor, sizeof(headerOut->m_versionMinor));
-  m_file.write ((const char *)&headerOut->m_zone, sizeof(headerOut->m_zone));
-  m_file.write ((const char *)&headerOut->m_sigFigs, sizeof(headerOut->m_sigFigs));
-  m_file.write ((const char *)&headerOut->m_snapLen, sizeof(headerOut->m_snapLen));
-  m_file.write ((const char *)&headerOut->m_type, sizeof(headerOut->m_type));
+  m_out->write ((const char *)&headerOut->m_magicNumber, sizeof(headerOut->m_magicNumber));
+  m_out->write ((const char *)&headerOut->m_versionMajor, sizeof(headerOut->m_versionMajor));
+  m_out->write ((const char *)&headerOut->m_versionMinor, sizeof(headerOut->m_versionMinor));
+  m_out->write ((const char *)&headerOut->m_zone, sizeof(headerOut->m_zone));
+  m_out->write ((const char *)&headerOut->m_sigFigs, sizeof(headerOut->m_sigFigs));
+  m_out->write ((const char *)&headerOut->m_snapLen, sizeof(headerOut->m_snapLen));
+  m_out->write ((const char *)&headerOut->m_type, sizeof(headerOut->m_type));
 }
 
 void
@@ -333,6 +352,16 @@ PcapFile::Open (std::string const &filename, std::ios::openmode mode)
   mode |= std::ios::binary;
 
   m_filename=filename;
+  if (CompressionCodec::IsCompressedFilename (filename))
+    {
+      NS_ABORT_MSG_IF (mode & std::ios::in, "PcapFile::Open(): compressed file " << filename << " can only be written");
+      Ptr<CompressionCodec> codec = CompressionCodec::CreateForFile (filename);
+      NS_ABORT_MSG_IF (codec == 0, "PcapFile::Open(): no compression support compiled in for " << filename);
+      m_compressed = new CompressedOutputStream (filename, mode, codec);
+      FatalImpl::RegisterStream (m_compressed);
+      m_out = m_compressed;
+      return;
+    }
   m_file.open (filename.c_str (), mode);
   if (mode & std::ios::in)
     {
@@ -403,7 +432,7 @@ uint32_t
 PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << totalLen);
-  NS_ASSERT (m_file.good ());
+  NS_ASSERT (m_out->good ());
 
   uint32_t inclLen = totalLen > m_fileHeader.m_snapLen ? m_fileHeader.m_snapLen : totalLen;
 
@@ -422,11 +451,11 @@ PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
   // Watch out for memory alignment differences between machines, so write
   // them all individually.
   //
-  m_file.write ((const char *)&header.m_tsSec, sizeof(header.m_tsSec));
-  m_file.write ((const char *)&header.m_tsUsec, sizeof(header.m_tsUsec));
-  m_file.write ((const char *)&header.m_inclLen, sizeof(header.m_inclLen));
-  m_file.write ((const char *)&header.m_origLen, sizeof(header.m_origLen));
-  NS_BUILD_DEBUG(m_file.flush());
+  m_out->write ((const char *)&header.m_tsSec, sizeof(header.m_tsSec));
+  m_out->write ((const char *)&header.m_tsUsec, sizeof(header.m_tsUsec));
+  m_out->write ((const char *)&header.m_inclLen, sizeof(header.m_inclLen));
+  m_out->write ((const char *)&header.m_origLen, sizeof(header.m_origLen));
+  NS_BUILD_DEBUG(m_out->flush());
   return inclLen;
 }
 
@@ -435,8 +464,8 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, uint8_t const * const data, ui
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << &data << totalLen);
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, totalLen);
-  m_file.write ((const char *)data, inclLen);
-  NS_BUILD_DEBUG(m_file.flush());
+  m_out->write ((const char *)data, inclLen);
+  NS_BUILD_DEBUG(m_out->flush());
 }
 
 void 
@@ -444,8 +473,8 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << p);
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, p->GetSize ());
-  p->CopyData (&m_file, inclLen);
-  NS_BUILD_DEBUG(m_file.flush());
+  p->CopyData (m_out, inclLen);
+  NS_BUILD_DEBUG(m_out->flush());
 }
 
 void 
@@ -460,9 +489,9 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, const Header &header, Ptr<cons
   headerBuffer.AddAtStart (headerSize);
   header.Serialize (headerBuffer.Begin ());
   uint32_t toCopy = std::min (headerSize, inclLen);
-  headerBuffer.CopyData (&m_file, toCopy);
+  headerBuffer.CopyData (m_out, toCopy);
   inclLen -= toCopy;
-  p->CopyData (&m_file, inclLen);
+  p->CopyData (m_out, inclLen);
 }
 
 void
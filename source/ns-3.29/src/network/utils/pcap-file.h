@@ -30,6 +30,7 @@ namespace ns3 {
 
 class Packet;
 class Header;
+class CompressedOutputStream;
 
 
 /**
@@ -74,6 +75,10 @@ public:
    * selected as a binary file (fstream::binary is automatically ored with the mode
    * field).
    *
+   * If the file name ends with ".gz", ".zst" or ".lz4" the file is written
+   * through a CompressedOutputStream.  Compressed files can only be opened
+   * for writing.
+   *
    * \param filename String containing the name of the file.
    *
    * \param mode the access mode for the file.
@@ -368,6 +373,8 @@ private:
 
   std::string    m_filename;    //!< file name
   std::fstream   m_file;        //!< file stream
+  std::ostream  *m_out;         //!< stream written to, either m_file or m_compressed
+  CompressedOutputStream *m_compressed; //!< compressed output stream, if any
   PcapFileHeader m_fileHeader;  //!< file header
   bool m_swapMode;              //!< swap mode
   bool m_nanosecMode;           //!< nanosecond timestamp mode
@@ -24,6 +24,7 @@
 #include "ns3/packet.h"
 #include "ns3/node.h"
 #include "ns3/log.h"
+#include "ns3/pointer.h"
 
 namespace ns3 {
 
@@ -42,6 +43,11 @@ SimpleChannel::GetTypeId (void)
                    TimeValue (Seconds (0)),
                    MakeTimeAccessor (&SimpleChannel::m_delay),
                    MakeTimeChecker ())
+    .AddAttribute ("LinkErrorModel",
+                   "The LinkErrorModel deciding which receivers lose the packets sent.",
+                   PointerValue (),
+                   MakePointerAccessor (&SimpleChannel::m_linkErrorModel),
+                   MakePointerChecker<LinkErrorModel> ())
   ;
   return tid;
 }
@@ -57,6 +63,11 @@ SimpleChannel::Send (Ptr<Packet> p, uint16_t protocol,
                      Ptr<SimpleNetDevice> sender)
 {
   NS_LOG_FUNCTION (this << p << protocol << to << from << sender);
+  uint32_t senderIndex = 0;
+  if (m_linkErrorModel != 0)
+    {
+      senderIndex = std::find (m_devices.begin (), m_devices.end (), sender) - m_devices.begin ();
+    }
   for (std::vector<Ptr<SimpleNetDevice> >::const_iterator i = m_devices.begin (); i != m_devices.end (); ++i)
     {
       Ptr<SimpleNetDevice> tmp = *i;
@@ -72,6 +83,12 @@ SimpleChannel::Send (Ptr<Packet> p, uint16_t protocol,
               continue;
             }
         }
+      if (m_linkErrorModel != 0
+          && m_linkErrorModel->IsCorrupt (p, senderIndex, i - m_devices.begin ()))
+        {
+          NS_LOG_LOGIC ("Packet lost on the link to " << tmp);
+          continue;
+        }
       Simulator::ScheduleWithContext (tmp->GetNode ()->GetId (), m_delay,
                                       &SimpleNetDevice::Receive, tmp, p->Copy (), protocol, to, from);
     }
@@ -23,6 +23,7 @@
 #include "ns3/channel.h"
 #include "ns3/nstime.h"
 #include "mac48-address.h"
+#include "error-model.h"
 #include <vector>
 #include <map>
 
@@ -101,6 +102,7 @@ private:
   Time m_delay; //!< The assigned speed-of-light delay of the channel
   std::vector<Ptr<SimpleNetDevice> > m_devices; //!< devices connected by the channel
   std::map<Ptr<SimpleNetDevice>, std::vector<Ptr<SimpleNetDevice> > > m_blackListedDevices; //!< devices blocked on a device
+  Ptr<LinkErrorModel> m_linkErrorModel; //!< losses between the devices, if any
 };
 
 } // namespace ns3
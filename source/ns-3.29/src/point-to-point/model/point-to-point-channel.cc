@@ -22,6 +22,7 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
+#include "ns3/pointer.h"
 
 namespace ns3 {
 
@@ -46,6 +47,12 @@ PointToPointChannel::GetTypeId (void)
                      "interface.",
                      MakeTraceSourceAccessor (&PointToPointChannel::m_txrxPointToPoint),
                      "ns3::PointToPointChannel::TxRxAnimationCallback")
+    .AddAttribute ("LinkErrorModel",
+                   "The LinkErrorModel deciding which packets are lost on each "
+                   "direction of the channel; direction i goes from device i.",
+                   PointerValue (),
+                   MakePointerAccessor (&PointToPointChannel::m_linkErrorModel),
+                   MakePointerChecker<LinkErrorModel> ())
   ;
   return tid;
 }
@@ -97,6 +104,16 @@ PointToPointChannel::TransmitStart (
 
   uint32_t wire = src == m_link[0].m_src ? 0 : 1;
 
+  if (m_linkErrorModel != 0 && m_linkErrorModel->IsCorrupt (p, wire, 1 - wire))
+    {
+      // the packet never reaches the receiver, which only reports the drop
+      NS_LOG_LOGIC ("Packet lost on wire " << wire);
+      Simulator::ScheduleWithContext (m_link[wire].m_dst->GetNode ()->GetId (),
+                                      txTime + m_delay, &PointToPointNetDevice::ReceiveDropped,
+                                      m_link[wire].m_dst, p);
+      return true;
+    }
+
   Simulator::ScheduleWithContext (m_link[wire].m_dst->GetNode ()->GetId (),
                                   txTime + m_delay, &PointToPointNetDevice::Receive,
                                   m_link[wire].m_dst, p->Copy ());
@@ -25,6 +25,7 @@
 #include "ns3/nstime.h"
 #include "ns3/data-rate.h"
 #include "ns3/traced-callback.h"
+#include "ns3/error-model.h"
 
 namespace ns3 {
 
@@ -151,13 +152,15 @@ private:
 
   Time          m_delay;    //!< Propagation delay
   std::size_t        m_nDevices; //!< Devices of this channel
+  Ptr<LinkErrorModel> m_linkErrorModel; //!< losses on the wires, if any
 
   /**
    * The trace source for the packet transmission animation events that the 
    * device can fire.
    * Arguments to the callback are the packet, transmitting
    * net device, receiving net device, transmission time and 
-   * packet receipt time.
+   * packet receipt time.  It does not fire for the packets lost
+   * by the LinkErrorModel, which never reach the receiver.
    *
    * \see class CallBackTraceSource
    * \deprecated The non-const \c Ptr<NetDevice> argument is deprecated
@@ -414,6 +414,13 @@ PointToPointNetDevice::Receive (Ptr<Packet> packet)
     }
 }
 
+void
+PointToPointNetDevice::ReceiveDropped (Ptr<const Packet> packet)
+{
+  NS_LOG_FUNCTION (this << packet);
+  m_phyRxDropTrace (packet);
+}
+
 Ptr<Queue<Packet> >
 PointToPointNetDevice::GetQueue (void) const
 { 
@@ -150,6 +150,17 @@ public:
    */
   void Receive (Ptr<Packet> p);
 
+  /**
+   * Report a packet lost by the LinkErrorModel of the connected channel.
+   *
+   * The channel calls it when the last bit of the packet would have
+   * arrived.  The packet is not received, and the PhyRxDrop trace fires
+   * as for a packet dropped by the receive error model.
+   *
+   * \param p Ptr to the lost packet.
+   */
+  void ReceiveDropped (Ptr<const Packet> p);
+
   // The remaining methods are documented in ns3::NetDevice*
 
   virtual void SetIfIndex (const uint32_t index);
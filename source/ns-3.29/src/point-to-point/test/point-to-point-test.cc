@@ -24,6 +24,10 @@
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/point-to-point-channel.h"
 #include "ns3/net-device-queue-interface.h"
+#include "ns3/error-model.h"
+#include "ns3/pointer.h"
+#include "ns3/enum.h"
+#include "ns3/double.h"
 
 using namespace ns3;
 
@@ -101,6 +105,155 @@ PointToPointTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \brief Test class for the LinkErrorModel of a PointToPointChannel
+ *
+ * The packets lost on a wire must fire the PhyRxDrop trace of the
+ * receiver when they would have arrived, and neither reach it nor
+ * fire the TxRxPointToPoint trace of the channel.
+ */
+class PointToPointLinkErrorTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointLinkErrorTest ();
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \brief Send packets to the device specified
+   *
+   * \param device NetDevice to send to
+   * \param n number of packets to send
+   */
+  void SendPackets (Ptr<PointToPointNetDevice> device, uint32_t n);
+  /**
+   * \brief Count a packet received by a device
+   *
+   * \param context the name of the device
+   * \param p the packet
+   */
+  void Received (std::string context, Ptr<const Packet> p);
+  /**
+   * \brief Count a packet dropped by a device
+   *
+   * \param context the name of the device
+   * \param p the packet
+   */
+  void Dropped (std::string context, Ptr<const Packet> p);
+  /**
+   * \brief Count a packet reported by the animation trace of the channel
+   *
+   * \param p the packet
+   * \param tx the transmitting device
+   * \param rx the receiving device
+   * \param txTime the transmission time
+   * \param rxTime the receive time
+   */
+  void TxRx (Ptr<const Packet> p, Ptr<NetDevice> tx, Ptr<NetDevice> rx, Time txTime, Time rxTime);
+
+  uint32_t m_received[2]; //!< packets received, by device
+  uint32_t m_dropped[2];  //!< packets dropped, by device
+  Time m_firstDrop;       //!< time of the first drop
+  uint32_t m_txrx;        //!< packets reported by the animation trace
+};
+
+PointToPointLinkErrorTest::PointToPointLinkErrorTest ()
+  : TestCase ("PointToPoint LinkErrorModel")
+{
+}
+
+void
+PointToPointLinkErrorTest::SendPackets (Ptr<PointToPointNetDevice> device, uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++)
+    {
+      device->Send (Create<Packet> (100), device->GetBroadcast (), 0x800);
+    }
+}
+
+void
+PointToPointLinkErrorTest::Received (std::string context, Ptr<const Packet> p)
+{
+  m_received[context == "b"]++;
+}
+
+void
+PointToPointLinkErrorTest::Dropped (std::string context, Ptr<const Packet> p)
+{
+  if (m_dropped[0] + m_dropped[1] == 0)
+    {
+      m_firstDrop = Simulator::Now ();
+    }
+  m_dropped[context == "b"]++;
+}
+
+void
+PointToPointLinkErrorTest::TxRx (Ptr<const Packet> p, Ptr<NetDevice> tx, Ptr<NetDevice> rx, Time txTime, Time rxTime)
+{
+  m_txrx++;
+}
+
+void
+PointToPointLinkErrorTest::DoRun (void)
+{
+  m_received[0] = m_received[1] = 0;
+  m_dropped[0] = m_dropped[1] = 0;
+  m_txrx = 0;
+
+  Ptr<LinkErrorModel> em = CreateObject<LinkErrorModel> ();
+  em->SetAttribute ("ErrorUnit", EnumValue (RateErrorModel::ERROR_UNIT_PACKET));
+  em->SetAttribute ("ErrorRate", DoubleValue (0));
+  em->SetRate (0, 1, 1);
+
+  Ptr<Node> a = CreateObject<Node> ();
+  Ptr<Node> b = CreateObject<Node> ();
+  Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel> ();
+  channel->SetAttribute ("Delay", TimeValue (MilliSeconds (2)));
+  channel->SetAttribute ("LinkErrorModel", PointerValue (em));
+
+  devA->Attach (channel);
+  devA->SetAddress (Mac48Address::Allocate ());
+  devA->SetQueue (CreateObject<DropTailQueue<Packet> > ());
+  devB->Attach (channel);
+  devB->SetAddress (Mac48Address::Allocate ());
+  devB->SetQueue (CreateObject<DropTailQueue<Packet> > ());
+
+  a->AddDevice (devA);
+  b->AddDevice (devB);
+
+  devA->TraceConnect ("MacRx", "a", MakeCallback (&PointToPointLinkErrorTest::Received, this));
+  devB->TraceConnect ("MacRx", "b", MakeCallback (&PointToPointLinkErrorTest::Received, this));
+  devA->TraceConnect ("PhyRxDrop", "a", MakeCallback (&PointToPointLinkErrorTest::Dropped, this));
+  devB->TraceConnect ("PhyRxDrop", "b", MakeCallback (&PointToPointLinkErrorTest::Dropped, this));
+  channel->TraceConnectWithoutContext ("TxRxPointToPoint", MakeCallback (&PointToPointLinkErrorTest::TxRx, this));
+
+  // the device of a is the first of the channel, so a -> b is the lossy wire
+  Simulator::Schedule (Seconds (1.0), &PointToPointLinkErrorTest::SendPackets, this, devA, 10);
+  Simulator::Schedule (Seconds (2.0), &PointToPointLinkErrorTest::SendPackets, this, devB, 5);
+
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_received[1], 0, "Packets received on a lossy wire");
+  NS_TEST_ASSERT_MSG_EQ (m_dropped[1], 10, "Lost packets not reported by the receiver");
+  NS_TEST_ASSERT_MSG_EQ (m_received[0], 5, "Packets lost on a perfect wire");
+  NS_TEST_ASSERT_MSG_EQ (m_dropped[0], 0, "Packets dropped on a perfect wire");
+  NS_TEST_ASSERT_MSG_EQ (m_txrx, 5, "Lost packets reported by the animation trace");
+  // 100 bytes and the 2 byte PPP header at the default 32768 b/s, and the delay
+  Time arrival = Seconds (1.0) + Seconds (102 * 8 / 32768.0) + MilliSeconds (2);
+  NS_TEST_ASSERT_MSG_EQ (m_firstDrop, arrival, "Lost packet not reported at its arrival time");
+
+  Simulator::Destroy ();
+}
+
 /**
  * \brief TestSuite for PointToPoint module
  */
@@ -117,6 +270,7 @@ PointToPointTestSuite::PointToPointTestSuite ()
   : TestSuite ("devices-point-to-point", UNIT)
 {
   AddTestCase (new PointToPointTest, TestCase::QUICK);
+  AddTestCase (new PointToPointLinkErrorTest, TestCase::QUICK);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite; //!< The testsuite
@@ -82,6 +82,7 @@ RxSpectrumModelInfo::RxSpectrumModelInfo (Ptr<const SpectrumModel> rxSpectrumMod
 
 
 MultiModelSpectrumChannel::MultiModelSpectrumChannel ()
+  : m_maxRange (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -92,6 +93,7 @@ MultiModelSpectrumChannel::DoDispose ()
   NS_LOG_FUNCTION (this);
   m_txSpectrumModelInfoMap.clear ();
   m_rxSpectrumModelInfoMap.clear ();
+  m_receivers.clear ();
   SpectrumChannel::DoDispose ();
 }
 
@@ -102,7 +104,12 @@ MultiModelSpectrumChannel::GetTypeId (void)
     .SetParent<SpectrumChannel> ()
     .SetGroupName ("Spectrum")
     .AddConstructor<MultiModelSpectrumChannel> ()
-
+    .AddAttribute ("MaxRange",
+                   "The distance (m) beyond which the receivers are skipped without "
+                   "computing their path loss; 0 disables the limit.",
+                   DoubleValue (0),
+                   MakeDoubleAccessor (&MultiModelSpectrumChannel::m_maxRange),
+                   MakeDoubleChecker<double> (0))
   ;
   return tid;
 }
@@ -132,6 +139,7 @@ MultiModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
       if (phyIt !=  rxInfoIterator->second.m_rxPhySet.end ())
         {
           rxInfoIterator->second.m_rxPhySet.erase (phyIt);
+          rxInfoIterator->second.m_spatialIndex = 0;
           --m_numDevices;
           break; // there should be at most one entry
         }       
@@ -174,6 +182,7 @@ MultiModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
       // spectrum model is already known, just add the device to the corresponding list
       std::pair<std::set<Ptr<SpectrumPhy> >::iterator, bool> ret2 = rxInfoIterator->second.m_rxPhySet.insert (phy);
       NS_ASSERT (ret2.second);
+      rxInfoIterator->second.m_spatialIndex = 0;
     }
 
 }
@@ -245,112 +254,213 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
   NS_LOG_LOGIC ("converter map size: " << txInfoIteratorerator->second.m_spectrumConverterMap.size ());
   NS_LOG_LOGIC ("converter map first element: " << txInfoIteratorerator->second.m_spectrumConverterMap.begin ()->first);
 
-  for (RxSpectrumModelInfoMap_t::const_iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
+  for (RxSpectrumModelInfoMap_t::iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
        rxInfoIterator != m_rxSpectrumModelInfoMap.end ();
        ++rxInfoIterator)
     {
       SpectrumModelUid_t rxSpectrumModelUid = rxInfoIterator->second.m_rxSpectrumModel->GetUid ();
       NS_LOG_LOGIC (" rxSpectrumModelUids " << rxSpectrumModelUid);
 
-      Ptr <SpectrumValue> convertedTxPowerSpectrum;
-      if (txSpectrumModelUid == rxSpectrumModelUid)
+      const SpectrumConverter *converter = 0;
+      if (txSpectrumModelUid != rxSpectrumModelUid)
         {
-          NS_LOG_LOGIC ("no spectrum conversion needed");
-          convertedTxPowerSpectrum = txParams->psd;
-        }
-      else
-        {
-          NS_LOG_LOGIC (" converting txPowerSpectrum SpectrumModelUids" << txSpectrumModelUid << " --> " << rxSpectrumModelUid);
           SpectrumConverterMap_t::const_iterator rxConverterIterator = txInfoIteratorerator->second.m_spectrumConverterMap.find (rxSpectrumModelUid);
           if (rxConverterIterator == txInfoIteratorerator->second.m_spectrumConverterMap.end ())
             {
               // No converter means TX SpectrumModel is orthogonal to RX SpectrumModel
               continue;
             }
-          convertedTxPowerSpectrum = rxConverterIterator->second.Convert (txParams->psd);
+          converter = &rxConverterIterator->second;
+        }
+      // the PSD is converted once for all the receivers of the model, and
+      // only if one of them is in range
+      Ptr <SpectrumValue> convertedTxPowerSpectrum;
+
+      if (GetReceivers (rxInfoIterator->second, txMobility, m_receivers))
+        {
+          for (std::vector<Ptr<SpectrumPhy> >::const_iterator rxPhyIterator = m_receivers.begin ();
+               rxPhyIterator != m_receivers.end ();
+               ++rxPhyIterator)
+            {
+              StartTxToReceiver (txParams, txMobility, *rxPhyIterator, rxSpectrumModelUid,
+                                 converter, convertedTxPowerSpectrum);
+            }
+        }
+      else
+        {
+          // no range pruning: go through the phys without copying their Ptrs
+          for (std::set<Ptr<SpectrumPhy> >::const_iterator rxPhyIterator = rxInfoIterator->second.m_rxPhySet.begin ();
+               rxPhyIterator != rxInfoIterator->second.m_rxPhySet.end ();
+               ++rxPhyIterator)
+            {
+              StartTxToReceiver (txParams, txMobility, *rxPhyIterator, rxSpectrumModelUid,
+                                 converter, convertedTxPowerSpectrum);
+            }
         }
+    }
+  m_receivers.clear ();
+}
 
+void
+MultiModelSpectrumChannel::StartTxToReceiver (Ptr<SpectrumSignalParameters> const &txParams,
+                                              Ptr<MobilityModel> const &txMobility,
+                                              Ptr<SpectrumPhy> const &rxPhy,
+                                              SpectrumModelUid_t rxSpectrumModelUid,
+                                              const SpectrumConverter *converter,
+                                              Ptr<SpectrumValue> &convertedTxPowerSpectrum)
+{
+  NS_ASSERT_MSG (rxPhy->GetRxSpectrumModel ()->GetUid () == rxSpectrumModelUid,
+                 "SpectrumModel change was not notified to MultiModelSpectrumChannel (i.e., AddRx should be called again after model is changed)");
 
-      for (std::set<Ptr<SpectrumPhy> >::const_iterator rxPhyIterator = rxInfoIterator->second.m_rxPhySet.begin ();
-           rxPhyIterator != rxInfoIterator->second.m_rxPhySet.end ();
-           ++rxPhyIterator)
+  if (rxPhy != txParams->txPhy)
+    {
+      Time delay = MicroSeconds (0);
+      double pathGainLinear = 1;
+
+      Ptr<MobilityModel> receiverMobility = rxPhy->GetMobility ();
+
+      if (txMobility && receiverMobility)
         {
-          NS_ASSERT_MSG ((*rxPhyIterator)->GetRxSpectrumModel ()->GetUid () == rxSpectrumModelUid,
-                         "SpectrumModel change was not notified to MultiModelSpectrumChannel (i.e., AddRx should be called again after model is changed)");
+          double pathLossDb = 0;
+          if (txParams->txAntenna != 0)
+            {
+              Angles txAngles (receiverMobility->GetPosition (), txMobility->GetPosition ());
+              double txAntennaGain = txParams->txAntenna->GetGainDb (txAngles);
+              NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
+              pathLossDb -= txAntennaGain;
+            }
+          Ptr<AntennaModel> rxAntenna = rxPhy->GetRxAntenna ();
+          if (rxAntenna != 0)
+            {
+              Angles rxAngles (txMobility->GetPosition (), receiverMobility->GetPosition ());
+              double rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
+              NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
+              pathLossDb -= rxAntennaGain;
+            }
+          if (m_propagationLoss)
+            {
+              double propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, receiverMobility);
+              NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
+              pathLossDb -= propagationGainDb;
+            }                    
+          NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");    
+          m_pathLossTrace (txParams->txPhy, rxPhy, pathLossDb);
+          if ( pathLossDb > m_maxLossDb)
+            {
+              // beyond range
+              return;
+            }
+          pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+        }
 
-          if ((*rxPhyIterator) != txParams->txPhy)
+      // the signal parameters are only copied for the receivers in
+      // range, and Copy () copies the PSD they hold: when a conversion
+      // is needed, they temporarily hold the converted PSD so that it
+      // is the only one copied
+      NS_LOG_LOGIC (" copying signal parameters " << txParams);
+      Ptr<SpectrumSignalParameters> rxParams;
+      if (converter != 0)
+        {
+          if (convertedTxPowerSpectrum == 0)
             {
-              NS_LOG_LOGIC (" copying signal parameters " << txParams);
-              Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
-              rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
-              Time delay = MicroSeconds (0);
-
-              Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
-
-              if (txMobility && receiverMobility)
-                {
-                  double pathLossDb = 0;
-                  if (rxParams->txAntenna != 0)
-                    {
-                      Angles txAngles (receiverMobility->GetPosition (), txMobility->GetPosition ());
-                      double txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
-                      NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
-                      pathLossDb -= txAntennaGain;
-                    }
-                  Ptr<AntennaModel> rxAntenna = (*rxPhyIterator)->GetRxAntenna ();
-                  if (rxAntenna != 0)
-                    {
-                      Angles rxAngles (txMobility->GetPosition (), receiverMobility->GetPosition ());
-                      double rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
-                      NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
-                      pathLossDb -= rxAntennaGain;
-                    }
-                  if (m_propagationLoss)
-                    {
-                      double propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, receiverMobility);
-                      NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
-                      pathLossDb -= propagationGainDb;
-                    }                    
-                  NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");    
-                  m_pathLossTrace (txParams->txPhy, *rxPhyIterator, pathLossDb);
-                  if ( pathLossDb > m_maxLossDb)
-                    {
-                      // beyond range
-                      continue;
-                    }
-                  double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
-                  *(rxParams->psd) *= pathGainLinear;              
-
-                  if (m_spectrumPropagationLoss)
-                    {
-                      rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility);
-                    }
-
-                  if (m_propagationDelay)
-                    {
-                      delay = m_propagationDelay->GetDelay (txMobility, receiverMobility);
-                    }
-                }
-
-              Ptr<NetDevice> netDev = (*rxPhyIterator)->GetDevice ();
-              if (netDev)
-                {
-                  // the receiver has a NetDevice, so we expect that it is attached to a Node
-                  uint32_t dstNode =  netDev->GetNode ()->GetId ();
-                  Simulator::ScheduleWithContext (dstNode, delay, &MultiModelSpectrumChannel::StartRx, this,
-                                                  rxParams, *rxPhyIterator);
-                }
-              else
-                {
-                  // the receiver is not attached to a NetDevice, so we cannot assume that it is attached to a node
-                  Simulator::Schedule (delay, &MultiModelSpectrumChannel::StartRx, this,
-                                       rxParams, *rxPhyIterator);
-                }
+              NS_LOG_LOGIC (" converting txPowerSpectrum SpectrumModelUids" << txParams->psd->GetSpectrumModelUid () << " --> " << rxSpectrumModelUid);
+              convertedTxPowerSpectrum = converter->Convert (txParams->psd);
             }
+          Ptr<SpectrumValue> txPowerSpectrum = txParams->psd;
+          txParams->psd = convertedTxPowerSpectrum;
+          rxParams = txParams->Copy ();
+          txParams->psd = txPowerSpectrum;
         }
+      else
+        {
+          rxParams = txParams->Copy ();
+        }
+
+      if (txMobility && receiverMobility)
+        {
+          *(rxParams->psd) *= pathGainLinear;              
 
+          if (m_spectrumPropagationLoss)
+            {
+              rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility);
+            }
+
+          if (m_propagationDelay)
+            {
+              delay = m_propagationDelay->GetDelay (txMobility, receiverMobility);
+            }
+        }
+
+      Ptr<NetDevice> netDev = rxPhy->GetDevice ();
+      if (netDev)
+        {
+          // the receiver has a NetDevice, so we expect that it is attached to a Node
+          uint32_t dstNode =  netDev->GetNode ()->GetId ();
+          Simulator::ScheduleWithContext (dstNode, delay, &MultiModelSpectrumChannel::StartRx, this,
+                                          rxParams, rxPhy);
+        }
+      else
+        {
+          // the receiver is not attached to a NetDevice, so we cannot assume that it is attached to a node
+          Simulator::Schedule (delay, &MultiModelSpectrumChannel::StartRx, this,
+                               rxParams, rxPhy);
+        }
     }
+}
 
+bool
+MultiModelSpectrumChannel::GetReceivers (RxSpectrumModelInfo &rxInfo, Ptr<MobilityModel> txMobility,
+                                         std::vector<Ptr<SpectrumPhy> > &receivers)
+{
+  receivers.clear ();
+  if (m_maxRange <= 0 || txMobility == 0)
+    {
+      return false;
+    }
+  if (rxInfo.m_spatialIndex == 0 || rxInfo.m_spatialIndex->GetCellSize () != m_maxRange)
+    {
+      // the index is built when the phys of the model first take part in a
+      // transmission, once their mobility is set, and again after AddRx
+      NS_LOG_LOGIC ("Indexing the positions of the phys of SpectrumModelUid "
+                    << rxInfo.m_rxSpectrumModel->GetUid () << " with " << m_maxRange << "m cells");
+      rxInfo.m_spatialIndex = Create<SpatialGridIndex> (m_maxRange);
+      rxInfo.m_indexedPhys.clear ();
+      rxInfo.m_unindexedPhys.clear ();
+      rxInfo.m_unindexedRanks.clear ();
+      for (std::set<Ptr<SpectrumPhy> >::const_iterator phy = rxInfo.m_rxPhySet.begin ();
+           phy != rxInfo.m_rxPhySet.end (); ++phy)
+        {
+          Ptr<MobilityModel> mobility = (*phy)->GetMobility ();
+          if (mobility != 0)
+            {
+              rxInfo.m_spatialIndex->Add (mobility);
+              rxInfo.m_indexedPhys.push_back (*phy);
+            }
+          else
+            {
+              // without a path loss, such phys receive every transmission
+              rxInfo.m_unindexedPhys.push_back (*phy);
+              rxInfo.m_unindexedRanks.push_back (rxInfo.m_indexedPhys.size ());
+            }
+        }
+    }
+  rxInfo.m_spatialIndex->GetItemsInRange (txMobility->GetPosition (), m_maxRange, m_inRange);
+  NS_LOG_DEBUG (m_inRange.size () << " of " << rxInfo.m_indexedPhys.size () << " phys in range");
+  // the items in range come sorted, and the items were added in the
+  // order of m_rxPhySet: merge the unindexed phys back at their place
+  // so that the receivers are visited in the same order as without
+  // MaxRange
+  std::size_t unindexed = 0;
+  for (std::vector<uint32_t>::const_iterator i = m_inRange.begin (); i != m_inRange.end (); ++i)
+    {
+      while (unindexed < rxInfo.m_unindexedPhys.size () && rxInfo.m_unindexedRanks[unindexed] <= *i)
+        {
+          receivers.push_back (rxInfo.m_unindexedPhys[unindexed++]);
+        }
+      receivers.push_back (rxInfo.m_indexedPhys[*i]);
+    }
+  receivers.insert (receivers.end (), rxInfo.m_unindexedPhys.begin () + unindexed, rxInfo.m_unindexedPhys.end ());
+  return true;
 }
 
 void
@@ -27,8 +27,10 @@
 #include <ns3/spectrum-channel.h>
 #include <ns3/spectrum-propagation-loss-model.h>
 #include <ns3/propagation-delay-model.h>
+#include <ns3/spatial-grid-index.h>
 #include <map>
 #include <set>
+#include <vector>
 
 namespace ns3 {
 
@@ -81,6 +83,12 @@ public:
 
   Ptr<const SpectrumModel> m_rxSpectrumModel;  //!< Rx Spectrum model.
   std::set<Ptr<SpectrumPhy> > m_rxPhySet;      //!< Container of the Rx Spectrum phy objects.
+  /// Index of the positions of the Rx phys, if MaxRange is set; reset when m_rxPhySet changes
+  Ptr<SpatialGridIndex> m_spatialIndex;
+  std::vector<Ptr<SpectrumPhy> > m_indexedPhys;   //!< Rx phys in the spatial index, by item
+  std::vector<Ptr<SpectrumPhy> > m_unindexedPhys; //!< Rx phys which had no mobility model when indexed
+  /// For each of m_unindexedPhys, the number of indexed phys before it in m_rxPhySet
+  std::vector<uint32_t> m_unindexedRanks;
 };
 
 /**
@@ -149,6 +157,38 @@ private:
    */
   virtual void StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver);
 
+  /**
+   * List the phys of an RX spectrum model which are in range of a
+   * transmission, when MaxRange is set and the transmitter has a
+   * mobility model.
+   *
+   * \param rxInfo the RX spectrum model information
+   * \param txMobility the mobility model of the transmitter, if any
+   * \param [out] receivers the candidate receivers
+   * \return false if no range pruning applies, in which case receivers
+   * is left empty and every phy of rxInfo is a candidate
+   */
+  bool GetReceivers (RxSpectrumModelInfo &rxInfo, Ptr<MobilityModel> txMobility,
+                     std::vector<Ptr<SpectrumPhy> > &receivers);
+
+  /**
+   * Deliver a transmission to one receiver, unless it is the
+   * transmitter or the loss puts it beyond MaxLossDb.
+   *
+   * \param txParams the parameters of the transmission
+   * \param txMobility the mobility model of the transmitter, if any
+   * \param rxPhy the receiver
+   * \param rxSpectrumModelUid the spectrum model of the receiver
+   * \param converter the converter to the model of the receiver, or 0
+   * \param [in,out] convertedTxPowerSpectrum the converted PSD, computed on first use
+   */
+  void StartTxToReceiver (Ptr<SpectrumSignalParameters> const &txParams,
+                          Ptr<MobilityModel> const &txMobility,
+                          Ptr<SpectrumPhy> const &rxPhy,
+                          SpectrumModelUid_t rxSpectrumModelUid,
+                          const SpectrumConverter *converter,
+                          Ptr<SpectrumValue> &convertedTxPowerSpectrum);
+
   /**
    * Data structure holding, for each TX SpectrumModel,  all the
    * converters to any RX SpectrumModel, and all the corresponding
@@ -169,6 +209,11 @@ private:
    */
   std::size_t m_numDevices;
 
+  double m_maxRange; //!< Distance beyond which receivers are skipped, if positive
+
+  std::vector<Ptr<SpectrumPhy> > m_receivers; //!< Receivers in range of the current transmission
+  std::vector<uint32_t> m_inRange;            //!< Indexed receivers in range of the current transmission
+
 };
 
 
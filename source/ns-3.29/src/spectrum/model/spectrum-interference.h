@@ -143,6 +143,9 @@ private:
 
   Ptr<const SpectrumValue> m_noise; //!< Noise spectral power density
 
+  SpectrumValue m_interf; //!< Interference of the last chunk, reused across the chunks
+  SpectrumValue m_sinr;   //!< SINR of the last chunk, reused across the chunks
+
   Time m_lastChangeTime;     //!< the time of the last change in m_TotalPower
 
   Ptr<SpectrumErrorModel> m_errorModel; //!< Error model
@@ -409,6 +409,17 @@ public:
    */
   SpectrumValue& operator= (double rhs);
 
+  /**
+   * Add to *this the product of a SpectrumValue by a scalar, as
+   * *this += x * s does but without its temporary SpectrumValue
+   *
+   * @param x the SpectrumValue to add
+   * @param s the scalar x is multiplied by
+   *
+   * @return a reference to *this
+   */
+  SpectrumValue& AddScaled (const SpectrumValue& x, double s);
+
 
 
   /**
@@ -497,6 +508,18 @@ public:
    */
   friend double Integral (const SpectrumValue&  arg);
 
+  /**
+   * Integrate the product of two SpectrumValues, e.g. a power spectral
+   * density and a spectral mask, without the temporary SpectrumValue of
+   * Integral (lhs * rhs)
+   *
+   * @param lhs the first factor
+   * @param rhs the second factor
+   *
+   * @return the value of the integral \f$\int_F g(f) h(f) df  \f$
+   */
+  friend double Integral (const SpectrumValue& lhs, const SpectrumValue& rhs);
+
   /**
    *
    * @return a Ptr to a copy of this instance
@@ -619,6 +642,7 @@ SpectrumValue Log10 (const SpectrumValue& arg);
 SpectrumValue Log2 (const SpectrumValue& arg);
 SpectrumValue Log (const SpectrumValue& arg);
 double Integral (const SpectrumValue& arg);
+double Integral (const SpectrumValue& lhs, const SpectrumValue& rhs);
 
 
 } // namespace ns3
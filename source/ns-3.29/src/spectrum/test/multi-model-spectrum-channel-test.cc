@@ -0,0 +1,246 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+#include <algorithm>
+#include <ns3/test.h>
+#include <ns3/simulator.h>
+#include <ns3/double.h>
+#include <ns3/net-device.h>
+#include <ns3/antenna-model.h>
+#include <ns3/spectrum-phy.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/spectrum-signal-parameters.h>
+#include <ns3/multi-model-spectrum-channel.h>
+#include <ns3/constant-position-mobility-model.h>
+
+using namespace ns3;
+
+/**
+ * A SpectrumPhy counting the signals it receives
+ */
+class CountingSpectrumPhy : public SpectrumPhy
+{
+public:
+  /**
+   * \param rxSpectrumModel the RX spectrum model
+   */
+  CountingSpectrumPhy (Ptr<const SpectrumModel> rxSpectrumModel)
+    : m_rxSpectrumModel (rxSpectrumModel),
+      m_rxCount (0),
+      m_rxOrder (0)
+  {
+  }
+  virtual void SetDevice (Ptr<NetDevice> d)
+  {
+  }
+  virtual Ptr<NetDevice> GetDevice () const
+  {
+    return 0;
+  }
+  virtual void SetMobility (Ptr<MobilityModel> m)
+  {
+    m_mobility = m;
+  }
+  virtual Ptr<MobilityModel> GetMobility ()
+  {
+    return m_mobility;
+  }
+  virtual void SetChannel (Ptr<SpectrumChannel> c)
+  {
+  }
+  virtual Ptr<const SpectrumModel> GetRxSpectrumModel () const
+  {
+    return m_rxSpectrumModel;
+  }
+  virtual Ptr<AntennaModel> GetRxAntenna ()
+  {
+    return 0;
+  }
+  virtual void StartRx (Ptr<SpectrumSignalParameters> params)
+  {
+    NS_ASSERT (params->psd->GetSpectrumModel () == m_rxSpectrumModel);
+    m_rxCount++;
+    if (m_rxOrder != 0)
+      {
+        m_rxOrder->push_back (this);
+      }
+  }
+
+  Ptr<const SpectrumModel> m_rxSpectrumModel; ///< the RX spectrum model
+  Ptr<MobilityModel> m_mobility; ///< the mobility model
+  uint32_t m_rxCount; ///< the number of received signals
+  std::vector<const SpectrumPhy *> *m_rxOrder; ///< where to log the receptions, if not 0
+};
+
+/**
+ * Make sure that MultiModelSpectrumChannel skips the receivers beyond
+ * MaxRange, whatever their spectrum model, and still delivers the
+ * signals to the receivers without a mobility model, in the same
+ * order as without MaxRange.
+ *
+ * A phy at the origin transmits with spectrum model A to:
+ *   - phys 1 and 2, with spectrum model A, at 10 m and 500 m;
+ *   - phys 3 and 4, with spectrum model B, at 10 m and 500 m;
+ *   - phy 5, with spectrum model A, without a mobility model.
+ */
+class MultiModelSpectrumChannelRangeTestCase : public TestCase
+{
+public:
+  MultiModelSpectrumChannelRangeTestCase ();
+  virtual ~MultiModelSpectrumChannelRangeTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Run the scenario
+   * \param maxRange the value of the MaxRange attribute
+   * \return the number of frames received by each phy
+   */
+  std::vector<uint32_t> Run (double maxRange);
+  /**
+   * Count the path loss computations
+   * \param txPhy the transmitter
+   * \param rxPhy the receiver
+   * \param lossDb the path loss
+   */
+  void PathLoss (Ptr<const SpectrumPhy> txPhy, Ptr<const SpectrumPhy> rxPhy, double lossDb);
+
+  uint32_t m_pathLossCount; ///< the number of path loss computations
+  std::vector<const SpectrumPhy *> m_rxOrder; ///< the receivers, in the order of the receptions
+};
+
+MultiModelSpectrumChannelRangeTestCase::MultiModelSpectrumChannelRangeTestCase ()
+  : TestCase ("Check the receiver pruning of MultiModelSpectrumChannel")
+{
+}
+
+MultiModelSpectrumChannelRangeTestCase::~MultiModelSpectrumChannelRangeTestCase ()
+{
+}
+
+void
+MultiModelSpectrumChannelRangeTestCase::PathLoss (Ptr<const SpectrumPhy> txPhy, Ptr<const SpectrumPhy> rxPhy, double lossDb)
+{
+  m_pathLossCount++;
+}
+
+std::vector<uint32_t>
+MultiModelSpectrumChannelRangeTestCase::Run (double maxRange)
+{
+  std::vector<double> freqs;
+  for (int i = 0; i < 4; i++)
+    {
+      freqs.push_back (1e9 + i * 1e6);
+    }
+  Ptr<SpectrumModel> modelA = Create<SpectrumModel> (freqs);
+  freqs.clear ();
+  for (int i = 0; i < 8; i++)
+    {
+      freqs.push_back (1e9 + i * 0.5e6);
+    }
+  Ptr<SpectrumModel> modelB = Create<SpectrumModel> (freqs);
+
+  Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel> ();
+  channel->SetAttribute ("MaxRange", DoubleValue (maxRange));
+  channel->TraceConnectWithoutContext ("PathLoss", MakeCallback (&MultiModelSpectrumChannelRangeTestCase::PathLoss, this));
+  m_pathLossCount = 0;
+  m_rxOrder.clear ();
+
+  Ptr<const SpectrumModel> models[] = {modelA, modelA, modelA, modelB, modelB, modelA};
+  double distances[] = {0, 10, 500, 10, 500, -1};
+  // the phys are created backwards, so that the phy without a mobility
+  // model is usually not the last one of the receiver set
+  std::vector<Ptr<CountingSpectrumPhy> > phys (6);
+  for (uint32_t i = 6; i-- > 0; )
+    {
+      Ptr<CountingSpectrumPhy> phy = Create<CountingSpectrumPhy> (models[i]);
+      if (distances[i] >= 0)
+        {
+          Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+          mobility->SetPosition (Vector (distances[i], 0, 0));
+          phy->SetMobility (mobility);
+        }
+      phy->m_rxOrder = &m_rxOrder;
+      channel->AddRx (phy);
+      phys[i] = phy;
+    }
+
+  Ptr<SpectrumSignalParameters> txParams = Create<SpectrumSignalParameters> ();
+  txParams->txPhy = phys[0];
+  txParams->psd = Create<SpectrumValue> (modelA);
+  (*txParams->psd) = 1e-9;
+  txParams->duration = MicroSeconds (100);
+  Simulator::Schedule (Seconds (1), &MultiModelSpectrumChannel::StartTx, channel, txParams);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  std::vector<uint32_t> rxCounts;
+  for (uint32_t i = 0; i < phys.size (); i++)
+    {
+      rxCounts.push_back (phys[i]->m_rxCount);
+    }
+  channel->Dispose ();
+  return rxCounts;
+}
+
+void
+MultiModelSpectrumChannelRangeTestCase::DoRun (void)
+{
+  uint32_t all[] = {0, 1, 1, 1, 1, 1};
+  std::vector<uint32_t> rxCounts = Run (0);
+  NS_TEST_EXPECT_MSG_EQ (m_pathLossCount, 4, "Wrong number of path losses without MaxRange");
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (rxCounts[i], all[i], "Wrong number of signals received by phy " << i << " without MaxRange");
+    }
+
+  uint32_t inRange[] = {0, 1, 0, 1, 0, 1};
+  rxCounts = Run (100);
+  NS_TEST_EXPECT_MSG_EQ (m_pathLossCount, 2, "Wrong number of path losses with MaxRange");
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (rxCounts[i], inRange[i], "Wrong number of signals received by phy " << i << " with MaxRange");
+    }
+
+  // all the phys in range: the signals are delivered in the order of
+  // the receiver set of each model, which sorts the phys by address
+  rxCounts = Run (1000);
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (rxCounts[i], all[i], "Wrong number of signals received by phy " << i << " with a large MaxRange");
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_rxOrder.size (), 5, "Wrong number of receptions");
+  std::vector<const SpectrumPhy *> modelA (m_rxOrder.begin (), m_rxOrder.begin () + 3);
+  NS_TEST_EXPECT_MSG_EQ (std::is_sorted (modelA.begin (), modelA.end ()), true, "Receivers of model A not in the order of the receiver set");
+}
+
+/**
+ * MultiModelSpectrumChannel test suite
+ */
+class MultiModelSpectrumChannelTestSuite : public TestSuite
+{
+public:
+  MultiModelSpectrumChannelTestSuite ();
+};
+
+MultiModelSpectrumChannelTestSuite::MultiModelSpectrumChannelTestSuite ()
+  : TestSuite ("multi-model-spectrum-channel", UNIT)
+{
+  AddTestCase (new MultiModelSpectrumChannelRangeTestCase, TestCase::QUICK);
+}
+
+static MultiModelSpectrumChannelTestSuite g_multiModelSpectrumChannelTestSuite; ///< the test suite
@@ -82,6 +82,38 @@ SpectrumValueTestCase::DoRun (void)
 
 
 
+class SpectrumValueIntegralTestCase : public TestCase
+{
+public:
+  SpectrumValueIntegralTestCase (SpectrumValue a, SpectrumValue b);
+  virtual ~SpectrumValueIntegralTestCase ();
+  virtual void DoRun (void);
+
+private:
+  SpectrumValue m_a;
+  SpectrumValue m_b;
+};
+
+SpectrumValueIntegralTestCase::SpectrumValueIntegralTestCase (SpectrumValue a, SpectrumValue b)
+  : TestCase ("Integral (a, b) == Integral (a * b)"),
+    m_a (a),
+    m_b (b)
+{
+}
+
+SpectrumValueIntegralTestCase::~SpectrumValueIntegralTestCase ()
+{
+}
+
+void
+SpectrumValueIntegralTestCase::DoRun (void)
+{
+  NS_TEST_ASSERT_MSG_EQ_TOL (Integral (m_a, m_b), Integral (m_a * m_b), TOLERANCE, "");
+}
+
+
+
+
 class SpectrumValueTestSuite : public TestSuite
 {
 public:
@@ -242,6 +274,14 @@ SpectrumValueTestSuite::SpectrumValueTestSuite ()
   AddTestCase (new SpectrumValueTestCase (tv1rs3, v1rs3, "tv1rs3 = v1 >> 3"), TestCase::QUICK);
 
 
+  SpectrumValue tv11 (f);
+  tv11 = v1;
+  tv11.AddScaled (v2, doubleValue);
+  AddTestCase (new SpectrumValueTestCase (tv11, v1 + v2 * doubleValue, "tv11 = v1, tv11.AddScaled (v2, doubleValue)"), TestCase::QUICK);
+
+  AddTestCase (new SpectrumValueIntegralTestCase (v1, v2), TestCase::QUICK);
+
+
 }
 
 
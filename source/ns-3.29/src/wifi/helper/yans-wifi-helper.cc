@@ -135,6 +135,15 @@ YansWifiPhyHelper::Default (void)
   return helper;
 }
 
+YansWifiPhyHelper
+YansWifiPhyHelper::Abstraction (void)
+{
+  YansWifiPhyHelper helper;
+  helper.m_phy.SetTypeId ("ns3::AbstractionWifiPhy");
+  helper.SetErrorRateModel ("ns3::TableErrorRateModel");
+  return helper;
+}
+
 void
 YansWifiPhyHelper::SetChannel (Ptr<YansWifiChannel> channel)
 {
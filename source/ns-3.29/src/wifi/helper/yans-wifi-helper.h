@@ -171,6 +171,12 @@ public:
    * \returns a default YansWifiPhyHelper
    */
   static YansWifiPhyHelper Default (void);
+  /**
+   * Create a phy helper which creates AbstractionWifiPhy objects, with
+   * a TableErrorRateModel interpolating the NistErrorRateModel.
+   * \returns a YansWifiPhyHelper for the PHY abstraction
+   */
+  static YansWifiPhyHelper Abstraction (void);
 
   /**
    * \param channel the channel to associate to this helper
@@ -0,0 +1,280 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <functional>
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/random-variable-stream.h"
+#include "abstraction-wifi-phy.h"
+#include "error-rate-model.h"
+#include "wifi-phy-state-helper.h"
+#include "wifi-phy-tag.h"
+#include "wifi-utils.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AbstractionWifiPhy");
+
+NS_OBJECT_ENSURE_REGISTERED (AbstractionWifiPhy);
+
+TypeId
+AbstractionWifiPhy::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::AbstractionWifiPhy")
+    .SetParent<YansWifiPhy> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<AbstractionWifiPhy> ()
+  ;
+  return tid;
+}
+
+AbstractionWifiPhy::AbstractionWifiPhy ()
+  : m_rxInterferenceW (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+AbstractionWifiPhy::~AbstractionWifiPhy ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+double
+AbstractionWifiPhy::AddSignal (double rxPowerW, Time rxDuration)
+{
+  Time now = Simulator::Now ();
+  double otherW = 0;
+  std::vector<std::pair<Time, double> >::iterator j = m_signals.begin ();
+  for (std::vector<std::pair<Time, double> >::const_iterator i = m_signals.begin (); i != m_signals.end (); ++i)
+    {
+      if (i->first > now)
+        {
+          otherW += i->second;
+          *j++ = *i;
+        }
+    }
+  m_signals.erase (j, m_signals.end ());
+  m_signals.push_back (std::make_pair (now + rxDuration, rxPowerW));
+  return otherW;
+}
+
+void
+AbstractionWifiPhy::MaybeCcaBusy (void)
+{
+  // the energy is above the threshold until the end of the signal which
+  // brings the power of the signals ending after it above the threshold
+  std::sort (m_signals.begin (), m_signals.end (), std::greater<std::pair<Time, double> > ());
+  double thresholdW = DbmToW (GetCcaMode1Threshold ());
+  double powerW = 0;
+  for (std::vector<std::pair<Time, double> >::const_iterator i = m_signals.begin (); i != m_signals.end (); ++i)
+    {
+      powerW += i->second;
+      if (powerW > thresholdW)
+        {
+          Time delay = i->first - Simulator::Now ();
+          if (delay.IsStrictlyPositive ())
+            {
+              m_state->SwitchMaybeToCcaBusy (delay);
+            }
+          return;
+        }
+    }
+}
+
+void
+AbstractionWifiPhy::StartReceivePreambleAndHeader (Ptr<const Packet> packet, double rxPowerW, Time rxDuration)
+{
+  WifiPhyTag tag;
+  bool found = packet->PeekPacketTag (tag);
+  if (!found)
+    {
+      NS_FATAL_ERROR ("Received Wi-Fi Signal with no WifiPhyTag");
+      return;
+    }
+  WifiTxVector txVector = tag.GetWifiTxVector ();
+  double interferenceW = AddSignal (rxPowerW, rxDuration);
+
+  if (m_state->GetState () == WifiPhyState::OFF)
+    {
+      NS_LOG_DEBUG ("Cannot start RX because device is OFF");
+      return;
+    }
+
+  NS_LOG_FUNCTION (this << packet << WToDbm (rxPowerW) << rxDuration);
+
+  if (tag.GetFrameComplete () == 0)
+    {
+      NS_LOG_DEBUG ("drop packet because of incomplete frame");
+      NotifyRxDrop (packet);
+      m_plcpSuccess = false;
+      return;
+    }
+
+  if (txVector.GetNss () > GetMaxSupportedRxSpatialStreams ())
+    {
+      NS_LOG_DEBUG ("drop packet because not enough RX antennas");
+      NotifyRxDrop (packet);
+      m_plcpSuccess = false;
+      MaybeCcaBusy ();
+      return;
+    }
+
+  switch (m_state->GetState ())
+    {
+    case WifiPhyState::RX:
+      NS_ASSERT (m_currentEvent != 0);
+      NS_LOG_DEBUG ("drop packet because already in Rx (power=" << rxPowerW << "W)");
+      m_rxInterferenceW = std::max (m_rxInterferenceW, interferenceW + rxPowerW - m_currentEvent->GetRxPowerW ());
+      NotifyRxDrop (packet);
+      MaybeCcaBusy ();
+      break;
+    case WifiPhyState::SWITCHING:
+      NS_LOG_DEBUG ("drop packet because of channel switching");
+      NotifyRxDrop (packet);
+      m_plcpSuccess = false;
+      MaybeCcaBusy ();
+      break;
+    case WifiPhyState::TX:
+      NS_LOG_DEBUG ("drop packet because already in Tx (power=" << rxPowerW << "W)");
+      NotifyRxDrop (packet);
+      MaybeCcaBusy ();
+      break;
+    case WifiPhyState::CCA_BUSY:
+    case WifiPhyState::IDLE:
+      StartRx (packet, txVector, tag.GetMpduType (), rxPowerW, rxDuration, interferenceW);
+      break;
+    case WifiPhyState::SLEEP:
+      NS_LOG_DEBUG ("drop packet because in sleep mode");
+      NotifyRxDrop (packet);
+      m_plcpSuccess = false;
+      break;
+    default:
+      NS_FATAL_ERROR ("Invalid WifiPhy state.");
+      break;
+    }
+}
+
+void
+AbstractionWifiPhy::StartRx (Ptr<const Packet> packet, WifiTxVector txVector, MpduType mpdutype,
+                             double rxPowerW, Time rxDuration, double interferenceW)
+{
+  NS_LOG_FUNCTION (this << packet << txVector << +mpdutype << rxPowerW << rxDuration << interferenceW);
+  if (rxPowerW <= DbmToW (GetEdThreshold ()))
+    {
+      NS_LOG_DEBUG ("drop packet because signal power too Small (" << rxPowerW << "W)");
+      NotifyRxDrop (packet);
+      m_plcpSuccess = false;
+      MaybeCcaBusy ();
+      return;
+    }
+  WifiPreamble preamble = txVector.GetPreambleType ();
+  if (preamble == WIFI_PREAMBLE_NONE && !m_plcpSuccess)
+    {
+      NS_LOG_DEBUG ("drop packet because no PLCP preamble/header has been received");
+      NotifyRxDrop (packet);
+      MaybeCcaBusy ();
+      return;
+    }
+  if (preamble != WIFI_PREAMBLE_NONE)
+    {
+      m_rxMpduReferenceNumber++;
+    }
+  NS_LOG_DEBUG ("sync to signal (power=" << rxPowerW << "W)");
+  m_currentEvent = Create<Event> (packet, txVector, rxDuration, rxPowerW);
+  m_rxInterferenceW = interferenceW;
+  m_state->SwitchToRx (rxDuration);
+  NotifyRxBegin (packet);
+  NS_ASSERT (m_endRxEvent.IsExpired ());
+  m_endRxEvent = Simulator::Schedule (rxDuration, &AbstractionWifiPhy::EndRx, this,
+                                      packet, txVector, mpdutype);
+}
+
+void
+AbstractionWifiPhy::EndRx (Ptr<const Packet> packet, WifiTxVector txVector, MpduType mpdutype)
+{
+  NS_LOG_FUNCTION (this << packet << txVector << +mpdutype);
+  NS_ASSERT (IsStateRx ());
+  double rxPowerW = m_currentEvent->GetRxPowerW ();
+  m_currentEvent = 0;
+  double snr = m_interference.CalculateSnr (rxPowerW, m_rxInterferenceW, txVector.GetChannelWidth ());
+  Ptr<ErrorRateModel> errorRateModel = m_interference.GetErrorRateModel ();
+  WifiPreamble preamble = txVector.GetPreambleType ();
+  WifiMode txMode = txVector.GetMode ();
+
+  if (preamble != WIFI_PREAMBLE_NONE)
+    {
+      WifiMode headerMode = GetPlcpHeaderMode (txVector);
+      uint64_t headerBits = static_cast<uint64_t> (GetPlcpHeaderDuration (txVector).GetSeconds ()
+                                                   * headerMode.GetPhyRate (txVector));
+      double headerPer = 1 - errorRateModel->GetChunkSuccessRate (headerMode, txVector, snr, headerBits);
+      if (m_random->GetValue () <= headerPer)
+        {
+          NS_LOG_DEBUG ("drop packet because plcp preamble/header reception failed");
+          NotifyRxDrop (packet);
+          m_plcpSuccess = false;
+        }
+      else if (!IsModeSupported (txMode) && !IsMcsSupported (txMode))
+        {
+          NS_LOG_DEBUG ("drop packet because it was sent using an unsupported mode (" << txMode << ")");
+          NotifyRxDrop (packet);
+          m_plcpSuccess = false;
+        }
+      else
+        {
+          m_plcpSuccess = true;
+        }
+    }
+
+  if (m_plcpSuccess)
+    {
+      double per = 1 - errorRateModel->GetChunkSuccessRate (txMode, txVector, snr, packet->GetSize () * 8);
+      NS_LOG_DEBUG ("mode=" << txMode.GetDataRate (txVector) << ", snr(dB)=" << RatioToDb (snr)
+                            << ", per=" << per << ", size=" << packet->GetSize ());
+      if (m_random->GetValue () > per)
+        {
+          NotifyRxEnd (packet);
+          SignalNoiseDbm signalNoise;
+          signalNoise.signal = WToDbm (rxPowerW);
+          signalNoise.noise = WToDbm (rxPowerW / snr);
+          MpduInfo aMpdu;
+          aMpdu.type = mpdutype;
+          aMpdu.mpduRefNumber = m_rxMpduReferenceNumber;
+          NotifyMonitorSniffRx (packet, GetFrequency (), txVector, aMpdu, signalNoise);
+          Ptr<Packet> copy = packet->Copy ();
+          WifiPhyTag tag;
+          copy->RemovePacketTag (tag);
+          m_state->SwitchFromRxEndOk (copy, snr, txVector);
+        }
+      else
+        {
+          NotifyRxDrop (packet);
+          m_state->SwitchFromRxEndError (packet, snr);
+        }
+    }
+  else
+    {
+      m_state->SwitchFromRxEndError (packet, snr);
+    }
+
+  if (preamble == WIFI_PREAMBLE_NONE && mpdutype == LAST_MPDU_IN_AGGREGATE)
+    {
+      m_plcpSuccess = false;
+    }
+}
+
+} //namespace ns3
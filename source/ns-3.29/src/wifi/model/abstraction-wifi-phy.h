@@ -0,0 +1,113 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ABSTRACTION_WIFI_PHY_H
+#define ABSTRACTION_WIFI_PHY_H
+
+#include <utility>
+#include <vector>
+#include "yans-wifi-phy.h"
+
+namespace ns3 {
+
+/**
+ * \brief 802.11 PHY abstraction for large scale MAC and network studies
+ * \ingroup wifi
+ *
+ * This PHY connects to a YansWifiChannel like the YansWifiPhy, and keeps
+ * the PHY state machine seen by the MAC (RX, TX, CCA busy, ...), but
+ * replaces the reception of the PLCP preamble, header and payload by a
+ * single decision taken when the frame ends:
+ *
+ *  - a frame is received when the PHY is idle or CCA busy and its power
+ *    is above the energy detection threshold; the frames arriving during
+ *    a reception are dropped (there is no frame capture);
+ *  - the SNR of the frame is computed from the highest power of the
+ *    other signals seen during its reception;
+ *  - the success rates of the PLCP header and of the payload are looked
+ *    up from the error rate model, for the size of the packet, without
+ *    splitting the frame in chunks of constant interference.
+ *
+ * The error rate model is best a TableErrorRateModel, so that each lookup
+ * is an interpolation in a precomputed table: see
+ * YansWifiPhyHelper::Abstraction.
+ *
+ * The signals are tracked in a list of their powers and end times instead
+ * of the InterferenceHelper: the PHY only takes one event per received
+ * frame, besides the arrival of each signal. The medium is sensed busy
+ * while the total power of the signals is above the CCA mode 1 threshold,
+ * but not again after a channel switch or a sleep period.
+ */
+class AbstractionWifiPhy : public YansWifiPhy
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  AbstractionWifiPhy ();
+  virtual ~AbstractionWifiPhy ();
+
+  virtual void StartReceivePreambleAndHeader (Ptr<const Packet> packet,
+                                              double rxPowerW,
+                                              Time rxDuration);
+
+
+private:
+  /**
+   * Start the reception of a frame.
+   *
+   * \param packet the packet
+   * \param txVector the TXVECTOR of the packet
+   * \param mpdutype the type of the MPDU
+   * \param rxPowerW the receive power in W
+   * \param rxDuration the duration of the frame
+   * \param interferenceW the power of the other signals in W
+   */
+  void StartRx (Ptr<const Packet> packet, WifiTxVector txVector, MpduType mpdutype,
+                double rxPowerW, Time rxDuration, double interferenceW);
+  /**
+   * End the reception of a frame, and decide whether it was received.
+   *
+   * \param packet the packet
+   * \param txVector the TXVECTOR of the packet
+   * \param mpdutype the type of the MPDU
+   */
+  void EndRx (Ptr<const Packet> packet, WifiTxVector txVector, MpduType mpdutype);
+  /**
+   * Add a signal to the signals on the medium.
+   *
+   * \param rxPowerW the power of the signal in W
+   * \param rxDuration the duration of the signal
+   * \return the total power of the other signals in W
+   */
+  double AddSignal (double rxPowerW, Time rxDuration);
+  /**
+   * Switch to CCA busy for as long as the total power of the signals is
+   * above the CCA mode 1 threshold.
+   */
+  void MaybeCcaBusy (void);
+
+  /// end time and power in W of the signals on the medium
+  std::vector<std::pair<Time, double> > m_signals;
+  double m_rxInterferenceW; //!< highest power of the other signals during the frame received
+};
+
+} //namespace ns3
+
+#endif /* ABSTRACTION_WIFI_PHY_H */
@@ -87,6 +87,21 @@ MpduAggregator::Aggregate (Ptr<const Packet> packet, Ptr<Packet> aggregatedPacke
   return false;
 }
 
+bool
+MpduAggregator::AggregateLength (uint32_t mpduSize, Ptr<Packet> ampdu) const
+{
+  NS_LOG_FUNCTION (this << mpduSize << ampdu->GetSize ());
+  uint32_t size = GetSizeIfAggregated (mpduSize, ampdu->GetSize ());
+  if (size <= GetMaxAmpduSize ())
+    {
+      // the zero area of a packet of zeros is virtual, and the buffer of
+      // ampdu only extends its own zero area, so nothing is allocated
+      ampdu->AddAtEnd (Create<Packet> (size - ampdu->GetSize ()));
+      return true;
+    }
+  return false;
+}
+
 void
 MpduAggregator::AggregateSingleMpdu (Ptr<const Packet> packet, Ptr<Packet> aggregatedPacket) const
 {
@@ -152,6 +167,13 @@ MpduAggregator::CanBeAggregated (uint32_t packetSize, Ptr<Packet> aggregatedPack
     }
 }
 
+uint32_t
+MpduAggregator::GetSizeIfAggregated (uint32_t mpduSize, uint32_t ampduSize)
+{
+  uint32_t padding = (4 - (ampduSize % 4)) % 4;
+  return ampduSize + padding + AmpduSubframeHeader ().GetSerializedSize () + mpduSize;
+}
+
 uint8_t
 MpduAggregator::CalculatePadding (Ptr<const Packet> packet) const
 {
@@ -79,6 +79,20 @@ public:
    * specified how and if <i>packet</i> can be added to <i>aggregatedPacket</i>.
    */
   bool Aggregate (Ptr<const Packet> packet, Ptr<Packet> aggregatedPacket) const;
+  /**
+   * \param mpduSize the size of the MPDU, MAC header and FCS included, we want to account for in <i>ampdu</i>.
+   * \param ampdu the A-MPDU whose length is to be extended, if aggregation is possible.
+   *
+   * \return true if the MPDU can be aggregated to <i>ampdu</i>, false otherwise.
+   *
+   * Extends <i>ampdu</i> by the padding of the previous subframe, the A-MPDU subframe
+   * header and the MPDU, as Aggregate does, but with (virtual) zero bytes and without
+   * copying the MPDU. This is used when the MPDUs are kept apart until they are sent,
+   * such as by MacLow in its aggregate queue, and the A-MPDU only accounts for its length:
+   * the bytes of each subframe are then built by AddHeaderAndPad when the MPDU is passed
+   * to the PHY.
+   */
+  bool AggregateLength (uint32_t mpduSize, Ptr<Packet> ampdu) const;
   /**
    * \param packet the packet we want to insert into <i>aggregatedPacket</i>.
    * \param aggregatedPacket packet that will contain the packet of size <i>packetSize</i>, if aggregation is possible.
@@ -105,6 +119,15 @@ public:
    */
   bool CanBeAggregated (uint32_t packetSize, Ptr<Packet> aggregatedPacket, uint8_t blockAckSize) const;
 
+  /**
+   * \param mpduSize the size of the MPDU, MAC header and FCS included.
+   * \param ampduSize the size of the A-MPDU the MPDU is added to, 0 if none.
+   *
+   * \return the size of the A-MPDU once the padding of its last subframe, the
+   * A-MPDU subframe header and the MPDU are added to it.
+   */
+  static uint32_t GetSizeIfAggregated (uint32_t mpduSize, uint32_t ampduSize);
+
   /**
    * Deaggregates an A-MPDU by removing the A-MPDU subframe header and padding.
    *
@@ -81,10 +81,12 @@ MsduAggregator::Aggregate (Ptr<const Packet> packet, Ptr<Packet> aggregatedPacke
       currentHdr.SetDestinationAddr (dest);
       currentHdr.SetSourceAddr (src);
       currentHdr.SetLength (static_cast<uint16_t> (packet->GetSize ()));
-      currentPacket = packet->Copy ();
-
+      // append the subframe header and the MSDU, rather than a copy of the
+      // MSDU with the header added, which would copy the MSDU twice
+      currentPacket = Create<Packet> ();
       currentPacket->AddHeader (currentHdr);
       aggregatedPacket->AddAtEnd (currentPacket);
+      aggregatedPacket->AddAtEnd (packet);
       return true;
     }
   return false;
@@ -0,0 +1,269 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/double.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+#include "table-error-rate-model.h"
+#include "nist-error-rate-model.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TableErrorRateModel");
+
+NS_OBJECT_ENSURE_REGISTERED (TableErrorRateModel);
+
+/**
+ * Lowest ln pe stored: the error rate of a bit is then below the
+ * smallest double, and keeping it finite keeps infinities out of the
+ * interpolation.
+ */
+static const double MIN_LN_PE = -745;
+
+TypeId
+TableErrorRateModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TableErrorRateModel")
+    .SetParent<ErrorRateModel> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<TableErrorRateModel> ()
+    .AddAttribute ("ErrorRateModel",
+                   "The error rate model tabulated; a NistErrorRateModel if null.",
+                   PointerValue (),
+                   MakePointerAccessor (&TableErrorRateModel::SetErrorRateModel,
+                                        &TableErrorRateModel::GetErrorRateModel),
+                   MakePointerChecker<ErrorRateModel> ())
+    .AddAttribute ("MinSnr",
+                   "The lowest SNR tabulated, in dB. Lower SNRs are passed to the tabulated model.",
+                   DoubleValue (-10),
+                   MakeDoubleAccessor (&TableErrorRateModel::m_minSnrDb),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxSnr",
+                   "The highest SNR tabulated, in dB. Higher SNRs are passed to the tabulated model.",
+                   DoubleValue (60),
+                   MakeDoubleAccessor (&TableErrorRateModel::m_maxSnrDb),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("SnrStep",
+                   "The SNR step of the tables, in dB.",
+                   DoubleValue (0.05),
+                   MakeDoubleAccessor (&TableErrorRateModel::m_stepDb),
+                   MakeDoubleChecker<double> (1e-3))
+    .AddAttribute ("TableFile",
+                   "The file to read the tables from, as written by SaveTables. "
+                   "The tables not found in the file are built from the tabulated model.",
+                   StringValue (""),
+                   MakeStringAccessor (&TableErrorRateModel::m_filename),
+                   MakeStringChecker ())
+  ;
+  return tid;
+}
+
+TableErrorRateModel::TableErrorRateModel ()
+  : m_model (CreateObject<NistErrorRateModel> ()),
+    m_loaded (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TableErrorRateModel::~TableErrorRateModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+TableErrorRateModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_model = 0;
+  m_tables.clear ();
+  ErrorRateModel::DoDispose ();
+}
+
+void
+TableErrorRateModel::SetErrorRateModel (Ptr<ErrorRateModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  m_model = model;
+  if (m_model == 0)
+    {
+      m_model = CreateObject<NistErrorRateModel> ();
+    }
+  m_tables.clear ();
+  m_loaded = false;
+}
+
+Ptr<ErrorRateModel>
+TableErrorRateModel::GetErrorRateModel (void) const
+{
+  return m_model;
+}
+
+TableErrorRateModel::Table
+TableErrorRateModel::BuildTable (WifiMode mode, const WifiTxVector &txVector) const
+{
+  NS_LOG_FUNCTION (this << mode << txVector.GetChannelWidth () << txVector.GetGuardInterval () << +txVector.GetNss ());
+  Table table;
+  table.mode = mode;
+  table.channelWidth = txVector.GetChannelWidth ();
+  table.guardInterval = txVector.GetGuardInterval ();
+  table.nss = txVector.GetNss ();
+  table.minSnrDb = m_minSnrDb;
+  table.step = m_stepDb;
+  uint32_t n = static_cast<uint32_t> (std::ceil ((m_maxSnrDb - m_minSnrDb) / m_stepDb)) + 1;
+  table.lnPe.reserve (n);
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      double snr = std::pow (10.0, (m_minSnrDb + i * m_stepDb) / 10.0);
+      double pe = 1 - m_model->GetChunkSuccessRate (mode, txVector, snr, 1);
+      double lnPe = pe > 0 ? std::log (std::min (pe, 1.0)) : MIN_LN_PE;
+      table.lnPe.push_back (std::max (lnPe, MIN_LN_PE));
+    }
+  return table;
+}
+
+const TableErrorRateModel::Table &
+TableErrorRateModel::GetTable (WifiMode mode, const WifiTxVector &txVector) const
+{
+  uint32_t uid = mode.GetUid ();
+  if (uid >= m_tables.size ())
+    {
+      m_tables.resize (uid + 1);
+    }
+  std::vector<Table> &tables = m_tables[uid];
+  for (std::vector<Table>::const_iterator i = tables.begin (); i != tables.end (); ++i)
+    {
+      if (i->channelWidth == txVector.GetChannelWidth ()
+          && i->guardInterval == txVector.GetGuardInterval ()
+          && i->nss == txVector.GetNss ())
+        {
+          return *i;
+        }
+    }
+  tables.push_back (BuildTable (mode, txVector));
+  return tables.back ();
+}
+
+double
+TableErrorRateModel::GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint64_t nbits) const
+{
+  NS_LOG_FUNCTION (this << mode << txVector.GetMode () << snr << nbits);
+  if (!m_loaded)
+    {
+      LoadTables ();
+    }
+  const Table &table = GetTable (mode, txVector);
+  double x = (10.0 * std::log10 (snr) - table.minSnrDb) / table.step;
+  // also false for a NaN, and for the -inf of a null SNR
+  if (!(x >= 0 && x < table.lnPe.size () - 1))
+    {
+      return m_model->GetChunkSuccessRate (mode, txVector, snr, nbits);
+    }
+  std::size_t i = static_cast<std::size_t> (x);
+  if ((table.lnPe[i] == 0) != (table.lnPe[i + 1] == 0))
+    {
+      // the error rate reaches 1 with a kink the interpolation would smooth
+      return m_model->GetChunkSuccessRate (mode, txVector, snr, nbits);
+    }
+  double t = x - i;
+  double pe = std::exp (table.lnPe[i] + t * (table.lnPe[i + 1] - table.lnPe[i]));
+  return std::pow (1 - pe, static_cast<double> (nbits));
+}
+
+void
+TableErrorRateModel::LoadTables (void) const
+{
+  NS_LOG_FUNCTION (this << m_filename);
+  m_loaded = true;
+  if (m_filename.empty ())
+    {
+      return;
+    }
+  std::ifstream is (m_filename.c_str ());
+  NS_ABORT_MSG_IF (!is.is_open (), "TableErrorRateModel: unable to open " << m_filename);
+  // one line per table:
+  // <mode> <channel width> <guard interval> <nss> <min snr> <step> <n> <ln pe>...
+  std::string line;
+  while (std::getline (is, line))
+    {
+      if (line.empty () || line[0] == '#')
+        {
+          continue;
+        }
+      std::istringstream iss (line);
+      std::string name;
+      uint32_t channelWidth, guardInterval, nss, n;
+      Table table;
+      iss >> name >> channelWidth >> guardInterval >> nss >> table.minSnrDb >> table.step >> n;
+      NS_ABORT_MSG_IF (iss.fail () || table.step <= 0 || n < 2,
+                       "TableErrorRateModel: malformed table in " << m_filename << ": " << name);
+      table.mode = WifiMode (name);
+      table.channelWidth = channelWidth;
+      table.guardInterval = guardInterval;
+      table.nss = nss;
+      table.lnPe.resize (n);
+      for (uint32_t i = 0; i < n; ++i)
+        {
+          iss >> table.lnPe[i];
+        }
+      NS_ABORT_MSG_IF (iss.fail (), "TableErrorRateModel: truncated table in " << m_filename << ": " << name);
+      uint32_t uid = table.mode.GetUid ();
+      if (uid >= m_tables.size ())
+        {
+          m_tables.resize (uid + 1);
+        }
+      m_tables[uid].push_back (table);
+    }
+}
+
+void
+TableErrorRateModel::SaveTables (std::string filename, std::vector<WifiTxVector> txVectors) const
+{
+  NS_LOG_FUNCTION (this << filename);
+  if (!m_loaded)
+    {
+      LoadTables ();
+    }
+  for (std::vector<WifiTxVector>::const_iterator i = txVectors.begin (); i != txVectors.end (); ++i)
+    {
+      GetTable (i->GetMode (), *i);
+    }
+  std::ofstream os (filename.c_str ());
+  NS_ABORT_MSG_IF (!os.is_open (), "TableErrorRateModel: unable to open " << filename);
+  os << std::setprecision (17);
+  for (uint32_t uid = 0; uid < m_tables.size (); ++uid)
+    {
+      for (std::vector<Table>::const_iterator i = m_tables[uid].begin (); i != m_tables[uid].end (); ++i)
+        {
+          os << i->mode.GetUniqueName () << " "
+             << i->channelWidth << " " << i->guardInterval << " " << +i->nss << " "
+             << i->minSnrDb << " " << i->step << " " << i->lnPe.size ();
+          for (std::vector<double>::const_iterator j = i->lnPe.begin (); j != i->lnPe.end (); ++j)
+            {
+              os << " " << *j;
+            }
+          os << std::endl;
+        }
+    }
+}
+
+} //namespace ns3
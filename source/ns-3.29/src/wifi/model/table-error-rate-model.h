@@ -0,0 +1,137 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TABLE_ERROR_RATE_MODEL_H
+#define TABLE_ERROR_RATE_MODEL_H
+
+#include <string>
+#include <vector>
+#include "error-rate-model.h"
+#include "wifi-tx-vector.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * An error rate model which interpolates the chunk success rate of
+ * another (analytic) error rate model from precomputed tables.
+ *
+ * The NIST, YANS and DSSS models all compute the success rate of a chunk
+ * of n bits as (1 - pe(snr))^(n/k), with pe the coded bit (or symbol)
+ * error rate of the mode and k a constant of the mode, which is also
+ *
+ *   csr(snr, n) = (1 - pe1(snr))^n, with pe1(snr) = 1 - csr(snr, 1).
+ *
+ * For each WifiMode used, pe1 is sampled once from the wrapped model on
+ * a uniform grid of SNR in dB, and ln pe1 is linearly interpolated on
+ * this grid: ln pe1 is smooth in the SNR in dB, from the waterfall region
+ * down to the vanishing error rates of high SNRs. A lookup then costs a
+ * log10, an exp and a pow instead of the erfc and power series of the
+ * analytic models. The SNRs outside the grid are passed to the wrapped
+ * model.
+ *
+ * The tables are built when a mode is first used, or read from the file
+ * given by the TableFile attribute, as written by SaveTables.
+ *
+ * The tables are kept per mode and per channel width, guard interval
+ * and number of spatial streams of the TXVECTOR, the only parts of the
+ * TXVECTOR the models of this module depend on (through the PHY rate,
+ * for the YansErrorRateModel).
+ */
+class TableErrorRateModel : public ErrorRateModel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  TableErrorRateModel ();
+  virtual ~TableErrorRateModel ();
+
+  double GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint64_t nbits) const;
+
+  /**
+   * \param model the error rate model to tabulate, a NistErrorRateModel
+   *        if null
+   */
+  void SetErrorRateModel (Ptr<ErrorRateModel> model);
+  /**
+   * \return the error rate model tabulated
+   */
+  Ptr<ErrorRateModel> GetErrorRateModel (void) const;
+
+  /**
+   * Write the tables already built, and the ones of the TXVECTORs
+   * given, to a file which can be read back through the TableFile
+   * attribute.
+   *
+   * \param filename the name of the file
+   * \param txVectors the TXVECTORs whose mode is to be tabulated in
+   *        addition to the tables already built
+   */
+  void SaveTables (std::string filename, std::vector<WifiTxVector> txVectors = std::vector<WifiTxVector> ()) const;
+
+
+private:
+  virtual void DoDispose (void);
+
+  /// the table of one mode
+  struct Table
+  {
+    WifiMode mode;          ///< the mode
+    uint16_t channelWidth;  ///< channel width of the TXVECTOR, in MHz
+    uint16_t guardInterval; ///< guard interval of the TXVECTOR, in ns
+    uint8_t nss;     ///< number of spatial streams of the TXVECTOR
+    double minSnrDb; ///< SNR of the first sample, in dB
+    double step;     ///< SNR step between two samples, in dB
+    std::vector<double> lnPe; ///< ln pe1 at each SNR
+  };
+
+  /**
+   * \param mode the mode
+   * \param txVector the TXVECTOR of the transmission
+   * \return the table of the mode, built if needed
+   */
+  const Table & GetTable (WifiMode mode, const WifiTxVector &txVector) const;
+  /**
+   * Sample the wrapped model for a mode.
+   *
+   * \param mode the mode
+   * \param txVector the TXVECTOR of the transmission
+   * \return the table
+   */
+  Table BuildTable (WifiMode mode, const WifiTxVector &txVector) const;
+  /**
+   * Read the tables of the file given by m_filename.
+   */
+  void LoadTables (void) const;
+
+  Ptr<ErrorRateModel> m_model; ///< the error rate model tabulated
+  double m_minSnrDb;           ///< lowest SNR tabulated, in dB
+  double m_maxSnrDb;           ///< highest SNR tabulated, in dB
+  double m_stepDb;             ///< SNR step of the tables, in dB
+  std::string m_filename;      ///< file to read the tables from
+  mutable bool m_loaded;       ///< whether m_filename was read
+  /// tables of each mode, indexed by WifiMode UID
+  mutable std::vector<std::vector<Table> > m_tables;
+};
+
+} //namespace ns3
+
+#endif /* TABLE_ERROR_RATE_MODEL_H */
@@ -21,6 +21,7 @@
  *          Stefano Avallone <stavallo@unina.it>
  */
 
+#include <iterator>
 #include "ns3/simulator.h"
 #include "wifi-mac-queue.h"
 #include "qos-blocked-destinations.h"
@@ -74,106 +75,125 @@ WifiMacQueue::GetMaxDelay (void) const
   return m_maxDelay;
 }
 
-bool
-WifiMacQueue::TtlExceeded (ConstIterator &it)
+uint64_t
+WifiMacQueue::GetKey (uint8_t tid, Mac48Address dest)
 {
-  NS_LOG_FUNCTION (this);
-
-  if (Simulator::Now () > (*it)->GetTimeStamp () + m_maxDelay)
+  uint8_t buffer[6];
+  dest.CopyTo (buffer);
+  uint64_t key = tid;
+  for (uint8_t i = 0; i < 6; i++)
     {
-      NS_LOG_DEBUG ("Removing packet that stayed in the queue for too long (" <<
-                    Simulator::Now () - (*it)->GetTimeStamp () << ")");
-      auto curr = it++;
-      DoRemove (curr);
-      return true;
+      key = (key << 8) | buffer[i];
     }
-  return false;
+  return key;
 }
 
 bool
-WifiMacQueue::Enqueue (Ptr<WifiMacQueueItem> item)
+WifiMacQueue::Insert (bool front, Ptr<WifiMacQueueItem> item)
 {
-  NS_LOG_FUNCTION (this << item);
+  NS_LOG_FUNCTION (this << item << front);
   NS_ASSERT_MSG (GetMaxSize ().GetUnit () == QueueSizeUnit::PACKETS,
                  "WifiMacQueues must be in packet mode");
 
-  // if the queue is full, remove the first stale packet (if any) encountered
-  // starting from the head of the queue, in order to make room for the new packet.
+  // if the queue is full, remove the stale packets (if any) in order to
+  // make room for the new packet.
   if (QueueBase::GetNPackets () == GetMaxSize ().GetValue ())
     {
-      auto it = Head ();
-      while (it != Tail () && !TtlExceeded (it))
-        {
-          it++;
-        }
+      Cleanup ();
     }
 
   if (QueueBase::GetNPackets () == GetMaxSize ().GetValue () && m_dropPolicy == DROP_OLDEST)
     {
       NS_LOG_DEBUG ("Remove the oldest item in the queue");
-      DoRemove (Head ());
+      Extract (Head (), true);
     }
 
-  return DoEnqueue (Tail (), item);
+  ConstIterator pos = front ? Head () : Tail ();
+  if (!DoEnqueue (pos, item))
+    {
+      return false;
+    }
+  NS_ASSERT_MSG (m_positions.find (PeekPointer (item)) == m_positions.end (),
+                 "Item " << item << " enqueued twice");
+  Position &position = m_positions[PeekPointer (item)];
+  position.it = std::prev (pos);
+  position.indexed = item->GetHeader ().IsQosData ();
+  if (position.indexed)
+    {
+      TidAddressItems &items = m_tidAddressItems[GetKey (item->GetHeader ().GetQosTid (),
+                                                         item->GetDestinationAddress ())];
+      position.tidIt = items.insert (front ? items.begin () : items.end (), position.it);
+    }
+  m_expiry.insert (std::make_pair (item->GetTimeStamp (), PeekPointer (item)));
+  return true;
 }
 
-bool
-WifiMacQueue::PushFront (Ptr<WifiMacQueueItem> item)
+Ptr<WifiMacQueueItem>
+WifiMacQueue::Extract (ConstIterator it, bool drop)
 {
-  NS_LOG_FUNCTION (this << item);
-  NS_ASSERT_MSG (GetMaxSize ().GetUnit () == QueueSizeUnit::PACKETS,
-                 "WifiMacQueues must be in packet mode");
-
-  // if the queue is full, remove the first stale packet (if any) encountered
-  // starting from the head of the queue, in order to make room for the new packet.
-  if (QueueBase::GetNPackets () == GetMaxSize ().GetValue ())
+  NS_LOG_FUNCTION (this << *it << drop);
+  Ptr<WifiMacQueueItem> item = *it;
+  std::unordered_map<const WifiMacQueueItem *, Position>::iterator position = m_positions.find (PeekPointer (item));
+  NS_ASSERT (position != m_positions.end ());
+  if (position->second.indexed)
     {
-      auto it = Head ();
-      while (it != Tail () && !TtlExceeded (it))
-        {
-          it++;
-        }
+      m_tidAddressItems[GetKey (item->GetHeader ().GetQosTid (),
+                                item->GetDestinationAddress ())].erase (position->second.tidIt);
     }
+  m_positions.erase (position);
+  m_expiry.erase (std::make_pair (item->GetTimeStamp (), PeekPointer (item)));
+  return drop ? DoRemove (it) : DoDequeue (it);
+}
 
-  if (QueueBase::GetNPackets () == GetMaxSize ().GetValue () && m_dropPolicy == DROP_OLDEST)
+void
+WifiMacQueue::Cleanup (void)
+{
+  Time now = Simulator::Now ();
+  while (!m_expiry.empty () && now > m_expiry.begin ()->first + m_maxDelay)
     {
-      NS_LOG_DEBUG ("Remove the oldest item in the queue");
-      DoRemove (Head ());
+      NS_LOG_DEBUG ("Removing packet that stayed in the queue for too long (" <<
+                    now - m_expiry.begin ()->first << ")");
+      Extract (m_positions[m_expiry.begin ()->second].it, true);
     }
+}
 
-  return DoEnqueue (Head (), item);
+bool
+WifiMacQueue::Enqueue (Ptr<WifiMacQueueItem> item)
+{
+  NS_LOG_FUNCTION (this << item);
+  return Insert (false, item);
+}
+
+bool
+WifiMacQueue::PushFront (Ptr<WifiMacQueueItem> item)
+{
+  NS_LOG_FUNCTION (this << item);
+  return Insert (true, item);
 }
 
 Ptr<WifiMacQueueItem>
 WifiMacQueue::Dequeue (void)
 {
   NS_LOG_FUNCTION (this);
-  for (auto it = Head (); it != Tail (); )
+  Cleanup ();
+  if (QueueBase::IsEmpty ())
     {
-      if (!TtlExceeded (it))
-        {
-          return DoDequeue (it);
-        }
+      NS_LOG_DEBUG ("The queue is empty");
+      return 0;
     }
-  NS_LOG_DEBUG ("The queue is empty");
-  return 0;
+  return Extract (Head (), false);
 }
 
 Ptr<WifiMacQueueItem>
 WifiMacQueue::DequeueByAddress (Mac48Address dest)
 {
   NS_LOG_FUNCTION (this << dest);
-
-  for (auto it = Head (); it != Tail (); )
+  Cleanup ();
+  for (auto it = Head (); it != Tail (); it++)
     {
-      if (!TtlExceeded (it))
+      if ((*it)->GetHeader ().IsData () && (*it)->GetDestinationAddress () == dest)
         {
-          if ((*it)->GetHeader ().IsData () && (*it)->GetDestinationAddress () == dest)
-            {
-              return DoDequeue (it);
-            }
-
-          it++;
+          return Extract (it, false);
         }
     }
   NS_LOG_DEBUG ("The queue is empty");
@@ -184,38 +204,27 @@ Ptr<WifiMacQueueItem>
 WifiMacQueue::DequeueByTidAndAddress (uint8_t tid, Mac48Address dest)
 {
   NS_LOG_FUNCTION (this << dest);
-  for (auto it = Head (); it != Tail (); )
+  Cleanup ();
+  std::unordered_map<uint64_t, TidAddressItems>::const_iterator items = m_tidAddressItems.find (GetKey (tid, dest));
+  if (items == m_tidAddressItems.end () || items->second.empty ())
     {
-      if (!TtlExceeded (it))
-        {
-          if ((*it)->GetHeader ().IsQosData () && (*it)->GetDestinationAddress () == dest
-              && (*it)->GetHeader ().GetQosTid () == tid)
-            {
-              return DoDequeue (it);
-            }
-
-          it++;
-        }
+      NS_LOG_DEBUG ("The queue is empty");
+      return 0;
     }
-  NS_LOG_DEBUG ("The queue is empty");
-  return 0;
+  return Extract (items->second.front (), false);
 }
 
 Ptr<WifiMacQueueItem>
 WifiMacQueue::DequeueFirstAvailable (const Ptr<QosBlockedDestinations> blockedPackets)
 {
   NS_LOG_FUNCTION (this);
-  for (auto it = Head (); it != Tail (); )
+  Cleanup ();
+  for (auto it = Head (); it != Tail (); it++)
     {
-      if (!TtlExceeded (it))
+      if (!(*it)->GetHeader ().IsQosData ()
+          || !blockedPackets->IsBlocked ((*it)->GetHeader ().GetAddr1 (), (*it)->GetHeader ().GetQosTid ()))
         {
-          if (!(*it)->GetHeader ().IsQosData ()
-              || !blockedPackets->IsBlocked ((*it)->GetHeader ().GetAddr1 (), (*it)->GetHeader ().GetQosTid ()))
-            {
-              return DoDequeue (it);
-            }
-
-          it++;
+          return Extract (it, false);
         }
     }
   NS_LOG_DEBUG ("The queue is empty");
@@ -243,38 +252,27 @@ Ptr<const WifiMacQueueItem>
 WifiMacQueue::PeekByTidAndAddress (uint8_t tid, Mac48Address dest)
 {
   NS_LOG_FUNCTION (this << dest);
-  for (auto it = Head (); it != Tail (); )
+  Cleanup ();
+  std::unordered_map<uint64_t, TidAddressItems>::const_iterator items = m_tidAddressItems.find (GetKey (tid, dest));
+  if (items == m_tidAddressItems.end () || items->second.empty ())
     {
-      if (!TtlExceeded (it))
-        {
-          if ((*it)->GetHeader ().IsQosData () && (*it)->GetDestinationAddress () == dest
-              && (*it)->GetHeader ().GetQosTid () == tid)
-            {
-              return DoPeek (it);
-            }
-
-          it++;
-        }
+      NS_LOG_DEBUG ("The queue is empty");
+      return 0;
     }
-  NS_LOG_DEBUG ("The queue is empty");
-  return 0;
+  return DoPeek (items->second.front ());
 }
 
 Ptr<const WifiMacQueueItem>
 WifiMacQueue::PeekFirstAvailable (const Ptr<QosBlockedDestinations> blockedPackets)
 {
   NS_LOG_FUNCTION (this);
-  for (auto it = Head (); it != Tail (); )
+  Cleanup ();
+  for (auto it = Head (); it != Tail (); it++)
     {
-      if (!TtlExceeded (it))
+      if (!(*it)->GetHeader ().IsQosData ()
+          || !blockedPackets->IsBlocked ((*it)->GetHeader ().GetAddr1 (), (*it)->GetHeader ().GetQosTid ()))
         {
-          if (!(*it)->GetHeader ().IsQosData ()
-              || !blockedPackets->IsBlocked ((*it)->GetHeader ().GetAddr1 (), (*it)->GetHeader ().GetQosTid ()))
-            {
-              return DoPeek (it);
-            }
-
-          it++;
+          return DoPeek (it);
         }
     }
   NS_LOG_DEBUG ("The queue is empty");
@@ -285,33 +283,26 @@ Ptr<WifiMacQueueItem>
 WifiMacQueue::Remove (void)
 {
   NS_LOG_FUNCTION (this);
-
-  for (auto it = Head (); it != Tail (); )
+  Cleanup ();
+  if (QueueBase::IsEmpty ())
     {
-      if (!TtlExceeded (it))
-        {
-          return DoRemove (it);
-        }
+      NS_LOG_DEBUG ("The queue is empty");
+      return 0;
     }
-  NS_LOG_DEBUG ("The queue is empty");
-  return 0;
+  return Extract (Head (), true);
 }
 
 bool
 WifiMacQueue::Remove (Ptr<const Packet> packet)
 {
   NS_LOG_FUNCTION (this << packet);
-  for (auto it = Head (); it != Tail (); )
+  Cleanup ();
+  for (auto it = Head (); it != Tail (); it++)
     {
-      if (!TtlExceeded (it))
+      if ((*it)->GetPacket () == packet)
         {
-          if ((*it)->GetPacket () == packet)
-            {
-              DoRemove (it);
-              return true;
-            }
-
-          it++;
+          Extract (it, true);
+          return true;
         }
     }
   NS_LOG_DEBUG ("Packet " << packet << " not found in the queue");
@@ -322,19 +313,13 @@ uint32_t
 WifiMacQueue::GetNPacketsByAddress (Mac48Address dest)
 {
   NS_LOG_FUNCTION (this << dest);
-
+  Cleanup ();
   uint32_t nPackets = 0;
-
-  for (auto it = Head (); it != Tail (); )
+  for (auto it = Head (); it != Tail (); it++)
     {
-      if (!TtlExceeded (it))
+      if ((*it)->GetHeader ().IsData () && (*it)->GetDestinationAddress () == dest)
         {
-          if ((*it)->GetHeader ().IsData () && (*it)->GetDestinationAddress () == dest)
-            {
-              nPackets++;
-            }
-
-          it++;
+          nPackets++;
         }
     }
   NS_LOG_DEBUG ("returns " << nPackets);
@@ -345,20 +330,9 @@ uint32_t
 WifiMacQueue::GetNPacketsByTidAndAddress (uint8_t tid, Mac48Address dest)
 {
   NS_LOG_FUNCTION (this << dest);
-  uint32_t nPackets = 0;
-  for (auto it = Head (); it != Tail (); )
-    {
-      if (!TtlExceeded (it))
-        {
-          if ((*it)->GetHeader ().IsQosData () && (*it)->GetDestinationAddress () == dest
-              && (*it)->GetHeader ().GetQosTid () == tid)
-            {
-              nPackets++;
-            }
-
-          it++;
-        }
-    }
+  Cleanup ();
+  std::unordered_map<uint64_t, TidAddressItems>::const_iterator items = m_tidAddressItems.find (GetKey (tid, dest));
+  uint32_t nPackets = (items == m_tidAddressItems.end () ? 0 : items->second.size ());
   NS_LOG_DEBUG ("returns " << nPackets);
   return nPackets;
 }
@@ -367,16 +341,10 @@ bool
 WifiMacQueue::IsEmpty (void)
 {
   NS_LOG_FUNCTION (this);
-  for (auto it = Head (); it != Tail (); )
-    {
-      if (!TtlExceeded (it))
-        {
-          NS_LOG_DEBUG ("returns false");
-          return false;
-        }
-    }
-  NS_LOG_DEBUG ("returns true");
-  return true;
+  Cleanup ();
+  bool empty = QueueBase::IsEmpty ();
+  NS_LOG_DEBUG ("returns " << empty);
+  return empty;
 }
 
 uint32_t
@@ -384,13 +352,7 @@ WifiMacQueue::GetNPackets (void)
 {
   NS_LOG_FUNCTION (this);
   // remove packets that stayed in the queue for too long
-  for (auto it = Head (); it != Tail (); )
-    {
-      if (!TtlExceeded (it))
-        {
-          it++;
-        }
-    }
+  Cleanup ();
   return QueueBase::GetNPackets ();
 }
 
@@ -399,13 +361,7 @@ WifiMacQueue::GetNBytes (void)
 {
   NS_LOG_FUNCTION (this);
   // remove packets that stayed in the queue for too long
-  for (auto it = Head (); it != Tail (); )
-    {
-      if (!TtlExceeded (it))
-        {
-          it++;
-        }
-    }
+  Cleanup ();
   return QueueBase::GetNBytes ();
 }
 
@@ -24,6 +24,9 @@
 #ifndef WIFI_MAC_QUEUE_H
 #define WIFI_MAC_QUEUE_H
 
+#include <list>
+#include <set>
+#include <unordered_map>
 #include "wifi-mac-queue-item.h"
 
 namespace ns3 {
@@ -44,6 +47,12 @@ class QosBlockedDestinations;
  * to verify whether or not it should be dropped. If
  * dot11EDCATableMSDULifetime has elapsed, it is dropped.
  * Otherwise, it is returned to the caller.
+ *
+ * Besides the list of the items in queue order, the queue indexes the QoS
+ * data items by TID and receiver, so that the MAC finds the next MPDU of
+ * a Block Ack agreement, or counts them, without going through the items
+ * of the other agreements, and keeps the items ordered by timestamp, so
+ * that each operation only visits the items whose lifetime has elapsed.
  */
 class WifiMacQueue : public Queue<WifiMacQueueItem>
 {
@@ -219,18 +228,52 @@ public:
   uint32_t GetNBytes (void);
 
 private:
+  /// the QoS data items of a TID and a receiver, in queue order
+  typedef std::list<ConstIterator> TidAddressItems;
+
+  /// the position of an item in the queue and in the indexes
+  struct Position
+  {
+    ConstIterator it;                 //!< the item in the queue
+    TidAddressItems::iterator tidIt;  //!< the item in the items of its TID and receiver
+    bool indexed;                     //!< whether the item is a QoS data item, indexed by TID and receiver
+  };
+
+  /**
+   * \param tid the TID
+   * \param dest the receiver address
+   * \return the key of the TID and receiver in the index
+   */
+  static uint64_t GetKey (uint8_t tid, Mac48Address dest);
   /**
-   * Remove the item pointed to by the iterator <i>it</i> if it has been in the
-   * queue for too long. If the item is removed, the iterator is updated to
-   * point to the item that followed the erased one.
+   * Enqueue an item at the front or at the end of the queue, and index it.
+   *
+   * \param front whether to enqueue the item at the front of the queue
+   * \param item the item
+   * \return true if success, false if the packet has been dropped
+   */
+  bool Insert (bool front, Ptr<WifiMacQueueItem> item);
+  /**
+   * Dequeue or remove an item from the queue and from the indexes.
    *
    * \param it an iterator pointing to the item
-   * \return true if the item is removed, false otherwise
+   * \param drop whether the item is dropped (removed) rather than dequeued
+   * \return the item
+   */
+  Ptr<WifiMacQueueItem> Extract (ConstIterator it, bool drop);
+  /**
+   * Remove the items which have been in the queue for too long.
    */
-  bool TtlExceeded (ConstIterator &it);
+  void Cleanup (void);
 
   Time m_maxDelay;                          //!< Time to live for packets in the queue
   DropPolicy m_dropPolicy;                  //!< Drop behavior of queue
+  /// the QoS data items, by TID and receiver
+  std::unordered_map<uint64_t, TidAddressItems> m_tidAddressItems;
+  /// the position of each item
+  std::unordered_map<const WifiMacQueueItem *, Position> m_positions;
+  /// the items, by timestamp
+  std::set<std::pair<Time, const WifiMacQueueItem *> > m_expiry;
 
   NS_LOG_TEMPLATE_DECLARE;                  //!< redefinition of the log component
 };
@@ -46,7 +46,7 @@ typedef Callback<void, Ptr<Packet>, double, WifiTxVector> RxOkCallback;
  * arg1: packet received unsuccessfully
  * arg2: snr of packet
  */
-typedef Callback<void, Ptr<Packet>, double> RxErrorCallback;
+typedef Callback<void, Ptr<const Packet>, double> RxErrorCallback;
 
 /**
  * \ingroup wifi
@@ -184,7 +184,7 @@ public:
    * \param packet the packet that we failed to received
    * \param snr the SNR of the received packet
    */
-  void SwitchFromRxEndError (Ptr<Packet> packet, double snr);
+  void SwitchFromRxEndError (Ptr<const Packet> packet, double snr);
   /**
    * Switch to CCA busy.
    *
@@ -18,6 +18,7 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 
+#include <algorithm>
 #include "ns3/log.h"
 #include "ns3/boolean.h"
 #include "ns3/uinteger.h"
@@ -1637,16 +1638,87 @@ WifiRemoteStationManager::GetInfo (Mac48Address address)
   return state->m_info;
 }
 
+std::size_t
+WifiRemoteStationManager::HashStation (Mac48Address address, uint8_t tid, std::size_t tableSize)
+{
+  uint8_t buffer[6];
+  address.CopyTo (buffer);
+  uint64_t key = tid;
+  for (uint8_t i = 0; i < 6; i++)
+    {
+      key = (key << 8) | buffer[i];
+    }
+  // Fibonacci hashing: only the top bits of the product depend on all the
+  // bits of the key, so the slot is made of the log2 (tableSize) top bits,
+  // i.e., the product shifted right by 64 - log2 (tableSize) bits
+  uint64_t product = key * 0x9e3779b97f4a7c15ULL;
+  return static_cast<std::size_t> (((product >> 32) * tableSize) >> 32);
+}
+
+/**
+ * Insert an entry into an open addressing hash table with a free entry.
+ *
+ * \param index the table
+ * \param entry the entry
+ * \param slot the slot of the entry, where its probe sequence starts
+ */
+template <typename T>
+static void
+InsertIndex (std::vector<T *> &index, T *entry, std::size_t slot)
+{
+  std::size_t mask = index.size () - 1;
+  std::size_t i = slot;
+  while (index[i] != 0)
+    {
+      i = (i + 1) & mask;
+    }
+  index[i] = entry;
+}
+
+void
+WifiRemoteStationManager::IndexState (WifiRemoteStationState *state)
+{
+  if (2 * m_states.size () > m_stateIndex.size ())
+    {
+      m_stateIndex.assign (std::max<std::size_t> (16, 2 * m_stateIndex.size ()), 0);
+      for (StationStates::const_iterator i = m_states.begin (); i != m_states.end (); i++)
+        {
+          InsertIndex (m_stateIndex, *i, HashStation ((*i)->m_address, 0, m_stateIndex.size ()));
+        }
+      return;
+    }
+  InsertIndex (m_stateIndex, state, HashStation (state->m_address, 0, m_stateIndex.size ()));
+}
+
+void
+WifiRemoteStationManager::IndexStation (WifiRemoteStation *station)
+{
+  if (2 * m_stations.size () > m_stationIndex.size ())
+    {
+      m_stationIndex.assign (std::max<std::size_t> (16, 2 * m_stationIndex.size ()), 0);
+      for (Stations::const_iterator i = m_stations.begin (); i != m_stations.end (); i++)
+        {
+          InsertIndex (m_stationIndex, *i, HashStation ((*i)->m_state->m_address, (*i)->m_tid, m_stationIndex.size ()));
+        }
+      return;
+    }
+  InsertIndex (m_stationIndex, station, HashStation (station->m_state->m_address, station->m_tid, m_stationIndex.size ()));
+}
+
 WifiRemoteStationState *
 WifiRemoteStationManager::LookupState (Mac48Address address) const
 {
   NS_LOG_FUNCTION (this << address);
-  for (StationStates::const_iterator i = m_states.begin (); i != m_states.end (); i++)
+  if (!m_stateIndex.empty ())
     {
-      if ((*i)->m_address == address)
+      std::size_t mask = m_stateIndex.size () - 1;
+      for (std::size_t i = HashStation (address, 0, m_stateIndex.size ()); m_stateIndex[i] != 0; i = (i + 1) & mask)
         {
-          NS_LOG_DEBUG ("WifiRemoteStationManager::LookupState returning existing state");
-          return (*i);
+          if (m_stateIndex[i]->m_address == address)
+            {
+              NS_LOG_DEBUG ("WifiRemoteStationManager::LookupState returning existing state");
+              return m_stateIndex[i];
+            }
         }
     }
   WifiRemoteStationState *state = new WifiRemoteStationState ();
@@ -1668,6 +1740,7 @@ WifiRemoteStationManager::LookupState (Mac48Address address) const
   state->m_vhtSupported = false;
   state->m_heSupported = false;
   const_cast<WifiRemoteStationManager *> (this)->m_states.push_back (state);
+  const_cast<WifiRemoteStationManager *> (this)->IndexState (state);
   NS_LOG_DEBUG ("WifiRemoteStationManager::LookupState returning new state");
   return state;
 }
@@ -1691,12 +1764,16 @@ WifiRemoteStation *
 WifiRemoteStationManager::Lookup (Mac48Address address, uint8_t tid) const
 {
   NS_LOG_FUNCTION (this << address << +tid);
-  for (Stations::const_iterator i = m_stations.begin (); i != m_stations.end (); i++)
+  if (!m_stationIndex.empty ())
     {
-      if ((*i)->m_tid == tid
-          && (*i)->m_state->m_address == address)
+      std::size_t mask = m_stationIndex.size () - 1;
+      for (std::size_t i = HashStation (address, tid, m_stationIndex.size ()); m_stationIndex[i] != 0; i = (i + 1) & mask)
         {
-          return (*i);
+          if (m_stationIndex[i]->m_tid == tid
+              && m_stationIndex[i]->m_state->m_address == address)
+            {
+              return m_stationIndex[i];
+            }
         }
     }
   WifiRemoteStationState *state = LookupState (address);
@@ -1707,6 +1784,7 @@ WifiRemoteStationManager::Lookup (Mac48Address address, uint8_t tid) const
   station->m_ssrc = 0;
   station->m_slrc = 0;
   const_cast<WifiRemoteStationManager *> (this)->m_stations.push_back (station);
+  const_cast<WifiRemoteStationManager *> (this)->IndexStation (station);
   return station;
 }
 
@@ -1872,11 +1950,13 @@ WifiRemoteStationManager::Reset (void)
       delete (*i);
     }
   m_states.clear ();
+  m_stateIndex.clear ();
   for (Stations::const_iterator i = m_stations.begin (); i != m_stations.end (); i++)
     {
       delete (*i);
     }
   m_stations.clear ();
+  m_stationIndex.clear ();
   m_bssBasicRateSet.clear ();
   m_bssBasicMcsSet.clear ();
 }
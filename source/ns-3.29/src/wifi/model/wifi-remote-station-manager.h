@@ -29,6 +29,8 @@
 #include "wifi-mode.h"
 #include "wifi-preamble.h"
 
+class WifiRemoteStationHashTestCase;
+
 namespace ns3 {
 
 struct WifiRemoteStation;
@@ -93,6 +95,8 @@ private:
 class WifiRemoteStationManager : public Object
 {
 public:
+  /// Allow test cases to access private members
+  friend class ::WifiRemoteStationHashTestCase;
   /**
    * \brief Get the type ID.
    * \return the object TypeId
@@ -1340,6 +1344,28 @@ private:
    * \return WifiRemoteStation corresponding to the address
    */
   WifiRemoteStation* Lookup (Mac48Address address, const WifiMacHeader *header) const;
+  /**
+   * Add a state to the index of the states, which is rebuilt from
+   * m_states when it gets more than half full.
+   *
+   * \param state the state, already in m_states
+   */
+  void IndexState (WifiRemoteStationState *state);
+  /**
+   * Add a station to the index of the stations, which is rebuilt from
+   * m_stations when it gets more than half full.
+   *
+   * \param station the station, already in m_stations
+   */
+  void IndexStation (WifiRemoteStation *station);
+  /**
+   * \param address the address of a station
+   * \param tid the TID
+   * \param tableSize the size of the index, a power of two
+   * \return the slot of the index where the probe sequence of the address
+   * and TID starts
+   */
+  static std::size_t HashStation (Mac48Address address, uint8_t tid, std::size_t tableSize);
 
   /**
    * Return whether the modulation class of the selected mode for the
@@ -1426,6 +1452,13 @@ private:
 
   StationStates m_states;  //!< States of known stations
   Stations m_stations;     //!< Information for each known stations
+  /**
+   * Open addressing hash tables, with linear probing, of the states by
+   * address and of the stations by address and TID. Their size is a
+   * power of two, and null entries are free.
+   */
+  StationStates m_stateIndex;
+  Stations m_stationIndex; //!< \copydoc m_stateIndex
 
   WifiMode m_defaultTxMode; //!< The default transmission mode
   WifiMode m_defaultTxMcs;   //!< The default transmission modulation-coding scheme (MCS)
@@ -18,15 +18,20 @@
  * Author: Mathieu Lacage, <mathieu.lacage@sophia.inria.fr>
  */
 
+#include <algorithm>
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include "ns3/pointer.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/abort.h"
 #include "ns3/net-device.h"
 #include "ns3/node.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/propagation-delay-model.h"
 #include "ns3/mobility-model.h"
+#include "ns3/constant-acceleration-mobility-model.h"
 #include "yans-wifi-channel.h"
 #include "yans-wifi-phy.h"
 #include "wifi-utils.h"
@@ -52,11 +57,32 @@ YansWifiChannel::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&YansWifiChannel::m_delay),
                    MakePointerChecker<PropagationDelayModel> ())
+    .AddAttribute ("MaxRange",
+                   "The distance (m) beyond which PHYs do not receive the transmissions; "
+                   "0 disables the limit.",
+                   DoubleValue (0),
+                   MakeDoubleAccessor (&YansWifiChannel::m_maxRange),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("MinRxPower",
+                   "The receive power (dBm), before the receiver gain, below which PHYs do "
+                   "not receive the transmissions; the default keeps all the receivers.",
+                   DoubleValue (-1000),
+                   MakeDoubleAccessor (&YansWifiChannel::m_minRxPowerDbm),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("CacheLinks",
+                   "Cache the receive power and delay of each link until either end moves; "
+                   "only valid with deterministic propagation models.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&YansWifiChannel::m_cacheLinks),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 YansWifiChannel::YansWifiChannel ()
+  : m_maxRange (0),
+    m_minRxPowerDbm (-1000),
+    m_cacheLinks (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -67,6 +93,26 @@ YansWifiChannel::~YansWifiChannel ()
   m_phyList.clear ();
 }
 
+void
+YansWifiChannel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_spatialIndex = 0;
+  for (std::map<const MobilityModel *, std::vector<uint32_t> >::const_iterator i = m_linkPhys.begin ();
+       i != m_linkPhys.end (); ++i)
+    {
+      Ptr<MobilityModel> mobility = m_linkMobility[i->second.front ()];
+      mobility->TraceDisconnectWithoutContext ("CourseChange",
+                                               MakeCallback (&YansWifiChannel::CourseChanged, this));
+    }
+  m_linkPhys.clear ();
+  m_linkMobility.clear ();
+  m_links.clear ();
+  m_linkLoss = 0;
+  m_linkDelay = 0;
+  Channel::DoDispose ();
+}
+
 void
 YansWifiChannel::SetPropagationLossModel (const Ptr<PropagationLossModel> loss)
 {
@@ -87,42 +133,198 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
   NS_LOG_FUNCTION (this << sender << packet << txPowerDbm << duration.GetSeconds ());
   Ptr<MobilityModel> senderMobility = sender->GetMobility ();
   NS_ASSERT (senderMobility != 0);
-  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++)
+  uint32_t senderIndex = 0;
+  if (m_cacheLinks)
+    {
+      senderIndex = GetPhyIndex (sender);
+      UpdateLinkCache ();
+    }
+  if (m_maxRange > 0)
     {
-      if (sender != (*i))
+      UpdateSpatialIndex ();
+      m_spatialIndex->GetItemsInRange (senderMobility->GetPosition (), m_maxRange, m_receivers);
+      NS_LOG_DEBUG (m_receivers.size () << " of " << m_phyList.size () << " PHYs in range");
+      for (std::vector<uint32_t>::const_iterator i = m_receivers.begin (); i != m_receivers.end (); i++)
         {
-          //For now don't account for inter channel interference nor channel bonding
-          if ((*i)->GetChannelNumber () != sender->GetChannelNumber ())
-            {
-              continue;
-            }
+          SendTo (sender, senderMobility, senderIndex, *i, packet, txPowerDbm, duration);
+        }
+      return;
+    }
+  // only the PHYs on the channel of the sender can receive the transmission
+  std::map<uint8_t, std::vector<uint32_t> >::const_iterator phys = m_channelPhys.find (sender->GetChannelNumber ());
+  NS_ASSERT (phys != m_channelPhys.end ());
+  NS_LOG_DEBUG (phys->second.size () << " of " << m_phyList.size () << " PHYs on channel "
+                << +sender->GetChannelNumber ());
+  for (std::vector<uint32_t>::const_iterator i = phys->second.begin (); i != phys->second.end (); i++)
+    {
+      SendTo (sender, senderMobility, senderIndex, *i, packet, txPowerDbm, duration);
+    }
+}
 
-          Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
-          Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
-          double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
-          NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
-                        "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
-          Ptr<Packet> copy = packet->Copy ();
-          Ptr<NetDevice> dstNetDevice = (*i)->GetDevice ();
-          uint32_t dstNode;
-          if (dstNetDevice == 0)
-            {
-              dstNode = 0xffffffff;
-            }
-          else
+void
+YansWifiChannel::SendTo (Ptr<YansWifiPhy> sender, Ptr<MobilityModel> senderMobility,
+                         uint32_t senderIndex, uint32_t receiverIndex,
+                         Ptr<const Packet> packet, double txPowerDbm, Time duration) const
+{
+  Ptr<YansWifiPhy> receiver = m_phyList[receiverIndex];
+  if (sender == receiver)
+    {
+      return;
+    }
+  //For now don't account for inter channel interference nor channel bonding
+  if (receiver->GetChannelNumber () != sender->GetChannelNumber ())
+    {
+      return;
+    }
+
+  Time delay;
+  double rxPowerDbm = GetLink (senderMobility, senderIndex, receiverIndex, txPowerDbm, delay);
+  NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, delay=" << delay);
+  if (rxPowerDbm < m_minRxPowerDbm)
+    {
+      NS_LOG_DEBUG ("rxPower below " << m_minRxPowerDbm << "dbm, skipping the receiver");
+      return;
+    }
+  Ptr<NetDevice> dstNetDevice = receiver->GetDevice ();
+  uint32_t dstNode;
+  if (dstNetDevice == 0)
+    {
+      dstNode = 0xffffffff;
+    }
+  else
+    {
+      dstNode = dstNetDevice->GetNode ()->GetId ();
+    }
+
+  Simulator::ScheduleWithContext (dstNode,
+                                  delay, &YansWifiChannel::Receive,
+                                  receiver, packet, rxPowerDbm, duration);
+}
+
+YansWifiChannel::Link::Link ()
+  : valid (false),
+    txPowerDbm (0),
+    rxPowerDbm (0)
+{
+}
+
+double
+YansWifiChannel::GetLink (Ptr<MobilityModel> senderMobility, uint32_t senderIndex, uint32_t receiverIndex,
+                          double txPowerDbm, Time &delay) const
+{
+  Ptr<MobilityModel> receiverMobility = m_phyList[receiverIndex]->GetMobility ();
+  if (!m_cacheLinks || m_moving[senderIndex] || m_moving[receiverIndex])
+    {
+      delay = m_delay->GetDelay (senderMobility, receiverMobility);
+      return m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
+    }
+  std::vector<Link> &links = m_links[senderIndex];
+  if (links.size () <= receiverIndex)
+    {
+      links.resize (m_phyList.size ());
+    }
+  Link &link = links[receiverIndex];
+  if (!link.valid || link.txPowerDbm != txPowerDbm)
+    {
+      NS_LOG_LOGIC ("caching link " << senderIndex << "->" << receiverIndex);
+      link.delay = m_delay->GetDelay (senderMobility, receiverMobility);
+      link.txPowerDbm = txPowerDbm;
+      link.rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
+      link.valid = true;
+    }
+  delay = link.delay;
+  return link.rxPowerDbm;
+}
+
+void
+YansWifiChannel::UpdateLinkCache (void) const
+{
+  if (m_linkLoss != m_loss || m_linkDelay != m_delay)
+    {
+      NS_LOG_LOGIC ("Flushing the link cache");
+      m_linkLoss = m_loss;
+      m_linkDelay = m_delay;
+      m_links.clear ();
+    }
+  m_links.resize (m_phyList.size ());
+  // as for the spatial index, the PHYs are tracked when they first take
+  // part in a transmission, once their mobility is set
+  while (m_moving.size () < m_phyList.size ())
+    {
+      uint32_t index = m_moving.size ();
+      Ptr<MobilityModel> mobility = m_phyList[index]->GetMobility ();
+      NS_ABORT_MSG_IF (mobility == 0, "YansWifiChannel: CacheLinks needs the mobility of all the PHYs");
+      m_moving.push_back (IsMoving (mobility));
+      m_linkMobility.push_back (mobility);
+      std::vector<uint32_t> &phys = m_linkPhys[PeekPointer (mobility)];
+      if (phys.empty ())
+        {
+          mobility->TraceConnectWithoutContext ("CourseChange",
+                                                MakeCallback (&YansWifiChannel::CourseChanged, this));
+        }
+      phys.push_back (index);
+    }
+}
+
+void
+YansWifiChannel::CourseChanged (Ptr<const MobilityModel> mobility) const
+{
+  NS_LOG_FUNCTION (this << mobility);
+  std::map<const MobilityModel *, std::vector<uint32_t> >::const_iterator i = m_linkPhys.find (PeekPointer (mobility));
+  NS_ASSERT (i != m_linkPhys.end ());
+  bool moving = IsMoving (mobility);
+  for (std::vector<uint32_t>::const_iterator phy = i->second.begin (); phy != i->second.end (); ++phy)
+    {
+      m_moving[*phy] = moving;
+      m_links[*phy].clear ();
+      for (std::vector<std::vector<Link> >::iterator links = m_links.begin (); links != m_links.end (); ++links)
+        {
+          if (*phy < links->size ())
             {
-              dstNode = dstNetDevice->GetNode ()->GetId ();
+              (*links)[*phy].valid = false;
             }
-
-          Simulator::ScheduleWithContext (dstNode,
-                                          delay, &YansWifiChannel::Receive,
-                                          (*i), copy, rxPowerDbm, duration);
         }
     }
 }
 
+bool
+YansWifiChannel::IsMoving (Ptr<const MobilityModel> mobility)
+{
+  Vector velocity = mobility->GetVelocity ();
+  // the velocity of a ConstantAccelerationMobilityModel changes without
+  // course change notifications
+  return velocity.x != 0 || velocity.y != 0 || velocity.z != 0
+         || DynamicCast<const ConstantAccelerationMobilityModel> (mobility) != 0;
+}
+
+uint32_t
+YansWifiChannel::GetPhyIndex (Ptr<const YansWifiPhy> phy) const
+{
+  std::map<const YansWifiPhy *, uint32_t>::const_iterator i = m_phyIndex.find (PeekPointer (phy));
+  NS_ASSERT_MSG (i != m_phyIndex.end (), "YansWifiChannel: the PHY is not on the channel");
+  return i->second;
+}
+
+void
+YansWifiChannel::UpdateSpatialIndex (void) const
+{
+  if (m_spatialIndex == 0 || m_spatialIndex->GetCellSize () != m_maxRange)
+    {
+      NS_LOG_LOGIC ("Indexing the PHY positions with " << m_maxRange << "m cells");
+      m_spatialIndex = Create<SpatialGridIndex> (m_maxRange);
+    }
+  // the mobility of a PHY is usually set after the PHY is added, so the
+  // PHYs are indexed when they first take part in a transmission
+  while (m_spatialIndex->GetNItems () < m_phyList.size ())
+    {
+      Ptr<MobilityModel> mobility = m_phyList[m_spatialIndex->GetNItems ()]->GetMobility ();
+      NS_ABORT_MSG_IF (mobility == 0, "YansWifiChannel: MaxRange needs the mobility of all the PHYs");
+      m_spatialIndex->Add (mobility);
+    }
+}
+
 void
-YansWifiChannel::Receive (Ptr<YansWifiPhy> phy, Ptr<Packet> packet, double rxPowerDbm, Time duration)
+YansWifiChannel::Receive (Ptr<YansWifiPhy> phy, Ptr<const Packet> packet, double rxPowerDbm, Time duration)
 {
   NS_LOG_FUNCTION (phy << packet << rxPowerDbm << duration.GetSeconds ());
   phy->StartReceivePreambleAndHeader (packet, DbmToW (rxPowerDbm + phy->GetRxGain ()), duration);
@@ -144,7 +346,37 @@ void
 YansWifiChannel::Add (Ptr<YansWifiPhy> phy)
 {
   NS_LOG_FUNCTION (this << phy);
+  uint32_t index = m_phyList.size ();
+  m_phyIndex[PeekPointer (phy)] = index;
   m_phyList.push_back (phy);
+  m_phyChannelNumber.push_back (phy->GetChannelNumber ());
+  m_channelPhys[phy->GetChannelNumber ()].push_back (index);
+}
+
+void
+YansWifiChannel::UpdateChannelNumber (Ptr<const YansWifiPhy> phy)
+{
+  NS_LOG_FUNCTION (this << phy);
+  uint32_t index = GetPhyIndex (phy);
+  uint8_t channelNumber = phy->GetChannelNumber ();
+  if (m_phyChannelNumber[index] == channelNumber)
+    {
+      return;
+    }
+  NS_LOG_DEBUG ("PHY " << index << " moved from channel " << +m_phyChannelNumber[index]
+                << " to channel " << +channelNumber);
+  std::map<uint8_t, std::vector<uint32_t> >::iterator phys = m_channelPhys.find (m_phyChannelNumber[index]);
+  NS_ASSERT (phys != m_channelPhys.end ());
+  phys->second.erase (std::lower_bound (phys->second.begin (), phys->second.end (), index));
+  if (phys->second.empty ())
+    {
+      m_channelPhys.erase (phys);
+    }
+  // the lists are kept sorted so that the receptions are scheduled in
+  // the order the PHYs were added, whatever their channel history
+  std::vector<uint32_t> &newPhys = m_channelPhys[channelNumber];
+  newPhys.insert (std::lower_bound (newPhys.begin (), newPhys.end (), index), index);
+  m_phyChannelNumber[index] = channelNumber;
 }
 
 int64_t
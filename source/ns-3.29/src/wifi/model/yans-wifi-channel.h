@@ -21,7 +21,11 @@
 #ifndef YANS_WIFI_CHANNEL_H
 #define YANS_WIFI_CHANNEL_H
 
+#include <map>
+#include <vector>
 #include "ns3/channel.h"
+#include "ns3/nstime.h"
+#include "ns3/spatial-grid-index.h"
 
 namespace ns3 {
 
@@ -30,7 +34,7 @@ class PropagationLossModel;
 class PropagationDelayModel;
 class YansWifiPhy;
 class Packet;
-class Time;
+class MobilityModel;
 
 /**
  * \brief a channel to interconnect ns3::YansWifiPhy objects.
@@ -40,6 +44,24 @@ class Time;
  * class and supports an ns3::PropagationLossModel and an
  * ns3::PropagationDelayModel.  By default, no propagation models are set;
  * it is the caller's responsibility to set them before using the channel.
+ *
+ * By default, each transmission is delivered to all the other PHYs of the
+ * channel.  Two attributes bound the set of receivers, for scenarios where
+ * most PHYs are too far from each other to hear anything: with MaxRange,
+ * PHYs farther than this distance from the sender are skipped, and are
+ * found in constant time with a SpatialGridIndex of the PHY positions; with
+ * MinRxPower, the PHYs which would receive the signal below this power are
+ * skipped.  In both cases, the skipped PHYs are not scheduled any event and
+ * the signal adds nothing to their interference.
+ *
+ * With the CacheLinks attribute, the receive power and delay of each
+ * (sender, receiver) link are computed once and reused for the next
+ * transmissions on the link at the same power, until the "CourseChange"
+ * trace source of the mobility model of either end fires.  The links to or
+ * from a PHY with a non-null velocity are not cached, since its position
+ * changes without notifications.  The cache is only valid with
+ * deterministic propagation models: not with, e.g., the Nakagami fading
+ * or the random delay model.
  */
 class YansWifiChannel : public Channel
 {
@@ -86,6 +108,15 @@ public:
    */
   void Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double txPowerDbm, Time duration) const;
 
+  /**
+   * \param phy the PHY whose channel number may have changed
+   *
+   * This method should not be invoked by normal users. It is invoked
+   * by YansWifiPhy whenever its channel number may have changed, to
+   * move it to the receiver list of its new channel number.
+   */
+  void UpdateChannelNumber (Ptr<const YansWifiPhy> phy);
+
   /**
    * Assign a fixed random variable stream number to the random variables
    * used by this model.  Return the number of streams (possibly zero) that
@@ -114,11 +145,97 @@ private:
    * \param txPowerDbm the tx power associated to the packet being sent (dBm)
    * \param duration the transmission duration associated with the packet being sent
    */
-  static void Receive (Ptr<YansWifiPhy> receiver, Ptr<Packet> packet, double txPowerDbm, Time duration);
+  static void Receive (Ptr<YansWifiPhy> receiver, Ptr<const Packet> packet, double txPowerDbm, Time duration);
+
+  /**
+   * Schedule the reception of a packet by one PHY.
+   *
+   * \param sender the phy object from which the packet is originating
+   * \param senderMobility the mobility model of the sender
+   * \param senderIndex the index of the sender in the PHY list, if the
+   *        links are cached
+   * \param receiverIndex the index of the receiver in the PHY list
+   * \param packet the packet to send
+   * \param txPowerDbm the tx power associated to the packet, in dBm
+   * \param duration the transmission duration associated with the packet
+   */
+  void SendTo (Ptr<YansWifiPhy> sender, Ptr<MobilityModel> senderMobility,
+               uint32_t senderIndex, uint32_t receiverIndex,
+               Ptr<const Packet> packet, double txPowerDbm, Time duration) const;
+
+  /// the cached propagation of a link
+  struct Link
+  {
+    Link ();
+    bool valid;        //!< whether the link is cached
+    double txPowerDbm; //!< the tx power the rx power was computed for, in dBm
+    double rxPowerDbm; //!< the rx power, in dBm
+    Time delay;        //!< the propagation delay
+  };
+
+  /**
+   * Compute the propagation of a link, or get it from the cache.
+   *
+   * \param senderMobility the mobility model of the sender
+   * \param senderIndex the index of the sender in the PHY list
+   * \param receiverIndex the index of the receiver in the PHY list
+   * \param txPowerDbm the tx power, in dBm
+   * \param [out] delay the propagation delay
+   * \return the rx power, in dBm
+   */
+  double GetLink (Ptr<MobilityModel> senderMobility, uint32_t senderIndex, uint32_t receiverIndex,
+                  double txPowerDbm, Time &delay) const;
+  /**
+   * Connect to the mobility models of the PHYs added since the last
+   * call, and flush the cache if the propagation models were replaced.
+   */
+  void UpdateLinkCache (void) const;
+  /**
+   * Invalidate the cached links of the PHYs of a mobility model.
+   *
+   * \param mobility the mobility model whose course changed
+   */
+  void CourseChanged (Ptr<const MobilityModel> mobility) const;
+  /**
+   * \param mobility the mobility model
+   * \return whether the mobility model has a non-null velocity
+   */
+  static bool IsMoving (Ptr<const MobilityModel> mobility);
+  /**
+   * \param phy a PHY of the channel
+   * \return the index of the PHY in the PHY list
+   */
+  uint32_t GetPhyIndex (Ptr<const YansWifiPhy> phy) const;
+
+  /**
+   * Add the PHYs added since the last call to the spatial index,
+   * creating it if needed.
+   */
+  void UpdateSpatialIndex (void) const;
+
+  virtual void DoDispose (void);
 
   PhyList m_phyList;                   //!< List of YansWifiPhys connected to this YansWifiChannel
   Ptr<PropagationLossModel> m_loss;    //!< Propagation loss model
   Ptr<PropagationDelayModel> m_delay;  //!< Propagation delay model
+  double m_maxRange;                   //!< Distance beyond which receivers are skipped, if positive
+  double m_minRxPowerDbm;              //!< Receive power below which receivers are skipped
+
+  mutable Ptr<SpatialGridIndex> m_spatialIndex; //!< Index of the PHY positions, if m_maxRange is positive
+  mutable std::vector<uint32_t> m_receivers;    //!< Receivers in range of the current transmission
+  std::map<const YansWifiPhy *, uint32_t> m_phyIndex; //!< Index of each PHY in the PHY list
+  std::vector<uint8_t> m_phyChannelNumber;            //!< Channel number each PHY is listed under
+  /// Indices of the PHYs in the PHY list, sorted, by channel number
+  std::map<uint8_t, std::vector<uint32_t> > m_channelPhys;
+
+  bool m_cacheLinks;                             //!< Whether the propagation of the links is cached
+  mutable std::vector<std::vector<Link> > m_links; //!< Cached links, by sender and receiver index
+  mutable std::vector<bool> m_moving;            //!< Whether each PHY tracked by the cache is moving
+  mutable std::vector<Ptr<MobilityModel> > m_linkMobility; //!< Mobility model of each PHY tracked by the cache
+  /// The PHYs tracked by the cache, by mobility model
+  mutable std::map<const MobilityModel *, std::vector<uint32_t> > m_linkPhys;
+  mutable Ptr<PropagationLossModel> m_linkLoss;   //!< Loss model of the cached links
+  mutable Ptr<PropagationDelayModel> m_linkDelay; //!< Delay model of the cached links
 };
 
 } //namespace ns3
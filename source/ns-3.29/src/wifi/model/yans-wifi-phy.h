@@ -74,6 +74,10 @@ public:
 
   virtual Ptr<Channel> GetChannel (void) const;
 
+  // Inherited
+  virtual void SetChannelNumber (uint8_t id);
+  virtual void SetFrequency (uint16_t freq);
+
 
 protected:
   // Inherited
@@ -0,0 +1,320 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ctime>
+#include <iostream>
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/object-factory.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/yans-wifi-channel.h"
+#include "ns3/abstraction-wifi-phy.h"
+#include "ns3/nist-error-rate-model.h"
+#include "ns3/table-error-rate-model.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/wifi-helper.h"
+#include "ns3/wifi-mac-helper.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-mac.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("AbstractionWifiPhyTest");
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Check that the AbstractionWifiPhy receives the frames the
+ * YansWifiPhy receives: strong frames, frames too weak to be detected,
+ * frames at the edge of the range of their mode, and colliding frames.
+ */
+class AbstractionWifiPhyReceptionTestCase : public TestCase
+{
+public:
+  AbstractionWifiPhyReceptionTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Send frames from the first PHYs to the last one, and count the
+   * frames received by the last one.
+   *
+   * \param phyType the type of the PHYs
+   * \param rssDbm the receive power of all the frames, in dBm
+   * \param mode the mode of the frames
+   * \param nSenders the number of PHYs sending a frame at the same time
+   * \param nFrames the number of frames sent by each sender
+   */
+  void Run (std::string phyType, double rssDbm, WifiMode mode, uint32_t nSenders, uint32_t nFrames);
+  /**
+   * \param p the packet received
+   * \param snr the SNR of the packet
+   * \param txVector the TXVECTOR of the packet
+   */
+  void RxOk (Ptr<Packet> p, double snr, WifiTxVector txVector);
+  /**
+   * \param p the packet received in error
+   * \param snr the SNR of the packet
+   */
+  void RxError (Ptr<const Packet> p, double snr);
+
+  uint32_t m_rxOk;    ///< number of frames received
+  uint32_t m_rxError; ///< number of frames received in error
+};
+
+AbstractionWifiPhyReceptionTestCase::AbstractionWifiPhyReceptionTestCase ()
+  : TestCase ("Compare the receptions of the AbstractionWifiPhy and of the YansWifiPhy"),
+    m_rxOk (0),
+    m_rxError (0)
+{
+}
+
+void
+AbstractionWifiPhyReceptionTestCase::RxOk (Ptr<Packet> p, double snr, WifiTxVector txVector)
+{
+  m_rxOk++;
+}
+
+void
+AbstractionWifiPhyReceptionTestCase::RxError (Ptr<const Packet> p, double snr)
+{
+  m_rxError++;
+}
+
+void
+AbstractionWifiPhyReceptionTestCase::Run (std::string phyType, double rssDbm, WifiMode mode, uint32_t nSenders, uint32_t nFrames)
+{
+  m_rxOk = 0;
+  m_rxError = 0;
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  Ptr<FixedRssLossModel> loss = CreateObject<FixedRssLossModel> ();
+  loss->SetRss (rssDbm);
+  channel->SetPropagationLossModel (loss);
+
+  ObjectFactory factory;
+  factory.SetTypeId (phyType);
+  Ptr<TableErrorRateModel> error = CreateObject<TableErrorRateModel> ();
+  std::vector<Ptr<YansWifiPhy> > phys;
+  for (uint32_t i = 0; i <= nSenders; i++)
+    {
+      Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector (i, 0.0, 0.0));
+      Ptr<YansWifiPhy> phy = factory.Create<YansWifiPhy> ();
+      phy->SetErrorRateModel (error);
+      phy->SetChannel (channel);
+      phy->SetMobility (mobility);
+      phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+      phy->AssignStreams (i);
+      phys.push_back (phy);
+    }
+  phys[nSenders]->SetReceiveOkCallback (MakeCallback (&AbstractionWifiPhyReceptionTestCase::RxOk, this));
+  phys[nSenders]->SetReceiveErrorCallback (MakeCallback (&AbstractionWifiPhyReceptionTestCase::RxError, this));
+
+  WifiTxVector txVector = WifiTxVector (mode, 0, WIFI_PREAMBLE_LONG, 800, 1, 1, 0, 20, false, false);
+  for (uint32_t f = 0; f < nFrames; f++)
+    {
+      for (uint32_t i = 0; i < nSenders; i++)
+        {
+          Simulator::Schedule (MilliSeconds (10 * (f + 1)), &WifiPhy::SendPacket, phys[i],
+                               Create<Packet> (1000), txVector, NORMAL_MPDU);
+        }
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+AbstractionWifiPhyReceptionTestCase::DoRun (void)
+{
+  const char *types[] = {"ns3::YansWifiPhy", "ns3::AbstractionWifiPhy"};
+  uint32_t marginal[2];
+  for (uint32_t t = 0; t < 2; t++)
+    {
+      // strong frames are all received
+      Run (types[t], -50, WifiPhy::GetOfdmRate54Mbps (), 1, 20);
+      NS_TEST_EXPECT_MSG_EQ (m_rxOk, 20, types[t] << ": strong frames lost");
+      // frames below the energy detection threshold are not even detected
+      Run (types[t], -100, WifiPhy::GetOfdmRate6Mbps (), 1, 20);
+      NS_TEST_EXPECT_MSG_EQ (m_rxOk + m_rxError, 0, types[t] << ": weak frames detected");
+      // frames too weak for their mode are received in error
+      Run (types[t], -85, WifiPhy::GetOfdmRate54Mbps (), 1, 20);
+      NS_TEST_EXPECT_MSG_EQ (m_rxOk, 0, types[t] << ": frames received below the SNR of their mode");
+      NS_TEST_EXPECT_MSG_EQ (m_rxError, 20, types[t] << ": frames not received in error");
+      // frames at the edge of the range of their mode
+      Run (types[t], -72, WifiPhy::GetOfdmRate54Mbps (), 1, 200);
+      NS_TEST_EXPECT_MSG_EQ (m_rxOk + m_rxError, 200, types[t] << ": frames not detected");
+      marginal[t] = m_rxOk;
+      // colliding frames of the same power are lost
+      Run (types[t], -50, WifiPhy::GetOfdmRate6Mbps (), 2, 20);
+      NS_TEST_EXPECT_MSG_EQ (m_rxOk, 0, types[t] << ": colliding frames received");
+      NS_TEST_EXPECT_MSG_EQ (m_rxError, 20, types[t] << ": colliding frames not received in error");
+    }
+  NS_TEST_EXPECT_MSG_GT (marginal[0], 20, "Test not at the edge of the range of the mode");
+  NS_TEST_EXPECT_MSG_LT (marginal[0], 180, "Test not at the edge of the range of the mode");
+  NS_TEST_EXPECT_MSG_EQ_TOL (marginal[1], marginal[0], 40, "Different reception rates at the edge of the range");
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Benchmark an ad hoc network of broadcasting nodes with the
+ * YansWifiPhy and with the AbstractionWifiPhy.
+ */
+class AbstractionWifiPhyBenchmarkTestCase : public TestCase
+{
+public:
+  AbstractionWifiPhyBenchmarkTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \param phy the PHY helper
+   * \param name the name of the PHY
+   * \return the number of packets received by the MACs
+   */
+  uint64_t Bench (YansWifiPhyHelper phy, std::string name);
+  /**
+   * \param device the device sending
+   */
+  void Send (Ptr<NetDevice> device);
+  /**
+   * \param p the packet received
+   */
+  void MacRx (Ptr<const Packet> p);
+
+  uint64_t m_rx; ///< number of packets received by the MACs
+};
+
+AbstractionWifiPhyBenchmarkTestCase::AbstractionWifiPhyBenchmarkTestCase ()
+  : TestCase ("Benchmark the AbstractionWifiPhy in an ad hoc network"),
+    m_rx (0)
+{
+}
+
+void
+AbstractionWifiPhyBenchmarkTestCase::Send (Ptr<NetDevice> device)
+{
+  device->Send (Create<Packet> (500), device->GetBroadcast (), 0x800);
+  Simulator::Schedule (MilliSeconds (100), &AbstractionWifiPhyBenchmarkTestCase::Send, this, device);
+}
+
+void
+AbstractionWifiPhyBenchmarkTestCase::MacRx (Ptr<const Packet> p)
+{
+  m_rx++;
+}
+
+uint64_t
+AbstractionWifiPhyBenchmarkTestCase::Bench (YansWifiPhyHelper phy, std::string name)
+{
+  m_rx = 0;
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  const uint32_t n = 200;
+  NodeContainer nodes;
+  nodes.Create (n);
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "DeltaX", DoubleValue (20),
+                                 "DeltaY", DoubleValue (20),
+                                 "GridWidth", UintegerValue (20));
+  mobility.Install (nodes);
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  phy.SetChannel (channel.Create ());
+  WifiHelper wifi;
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("OfdmRate6Mbps"));
+  WifiMacHelper mac;
+  mac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (devices.Get (i));
+      device->GetMac ()->TraceConnectWithoutContext ("MacRx", MakeCallback (&AbstractionWifiPhyBenchmarkTestCase::MacRx, this));
+      Simulator::Schedule (MicroSeconds (1 + 487 * i), &AbstractionWifiPhyBenchmarkTestCase::Send, this, devices.Get (i));
+    }
+  Simulator::Stop (Seconds (2));
+  clock_t start = clock ();
+  Simulator::Run ();
+  clock_t elapsed = clock () - start;
+  Simulator::Destroy ();
+  std::cout << "wifi-abstraction-phy-perf: " << name << ", " << n << " nodes: "
+            << 1e3 * elapsed / CLOCKS_PER_SEC << " ms, " << m_rx << " packets received" << std::endl;
+  return m_rx;
+}
+
+void
+AbstractionWifiPhyBenchmarkTestCase::DoRun (void)
+{
+  uint64_t yans = Bench (YansWifiPhyHelper::Default (), "YansWifiPhy");
+  uint64_t abstraction = Bench (YansWifiPhyHelper::Abstraction (), "AbstractionWifiPhy");
+  NS_TEST_ASSERT_MSG_EQ_TOL (abstraction, yans, yans / 10, "Different numbers of packets received");
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief AbstractionWifiPhy TestSuite
+ */
+class AbstractionWifiPhyTestSuite : public TestSuite
+{
+public:
+  AbstractionWifiPhyTestSuite ();
+};
+
+AbstractionWifiPhyTestSuite::AbstractionWifiPhyTestSuite ()
+  : TestSuite ("wifi-abstraction-phy", UNIT)
+{
+  AddTestCase (new AbstractionWifiPhyReceptionTestCase, TestCase::QUICK);
+}
+
+static AbstractionWifiPhyTestSuite g_abstractionWifiPhyTestSuite; ///< the test suite
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief AbstractionWifiPhy performance TestSuite
+ */
+class AbstractionWifiPhyPerformanceTestSuite : public TestSuite
+{
+public:
+  AbstractionWifiPhyPerformanceTestSuite ();
+};
+
+AbstractionWifiPhyPerformanceTestSuite::AbstractionWifiPhyPerformanceTestSuite ()
+  : TestSuite ("wifi-abstraction-phy-perf", PERFORMANCE)
+{
+  AddTestCase (new AbstractionWifiPhyBenchmarkTestCase, TestCase::QUICK);
+}
+
+static AbstractionWifiPhyPerformanceTestSuite g_abstractionWifiPhyPerformanceTestSuite; ///< the performance test suite
@@ -0,0 +1,295 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ctime>
+#include <iostream>
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/interference-helper.h"
+#include "ns3/nist-error-rate-model.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/wifi-utils.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("InterferenceHelperTest");
+
+/**
+ * \param mode the mode of the signal
+ * \param preamble the preamble of the signal
+ * \returns the TXVECTOR of a 20 MHz signal
+ */
+static WifiTxVector
+MakeTxVector (WifiMode mode, WifiPreamble preamble)
+{
+  return WifiTxVector (mode, 0, preamble, 800, 1, 1, 0, 20, false, false);
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Check the SNR and PER computed by the InterferenceHelper for
+ * a frame overlapped by signals which start and end during its reception.
+ */
+class InterferenceHelperOverlapTestCase : public TestCase
+{
+public:
+  InterferenceHelperOverlapTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Add a signal.
+   * \param txVector the TXVECTOR of the signal
+   * \param duration the duration of the signal
+   * \param rxPowerDbm the receive power of the signal, in dBm
+   */
+  void AddSignal (WifiTxVector txVector, Time duration, double rxPowerDbm);
+  /**
+   * Start the reception of the first signal.
+   */
+  void StartRx (void);
+  /**
+   * Compute the SNR and PER of the PLCP header of the first signal.
+   */
+  void CheckHeader (void);
+  /**
+   * Compute the SNR and PER of the payload of the first signal and end
+   * its reception.
+   */
+  void CheckPayload (void);
+  /**
+   * Check the time the energy stays above a threshold.
+   * \param thresholdDbm the threshold, in dBm
+   * \param expected the expected duration
+   */
+  void CheckEnergyDuration (double thresholdDbm, Time expected);
+
+  InterferenceHelper m_interference; ///< the helper under test
+  std::vector<Ptr<Event> > m_events; ///< the signals added
+  InterferenceHelper::SnrPer m_header; ///< SNR and PER of the PLCP header of the first signal
+  InterferenceHelper::SnrPer m_payload; ///< SNR and PER of the payload of the first signal
+};
+
+InterferenceHelperOverlapTestCase::InterferenceHelperOverlapTestCase ()
+  : TestCase ("Check the SNR and PER of overlapping signals")
+{
+}
+
+void
+InterferenceHelperOverlapTestCase::AddSignal (WifiTxVector txVector, Time duration, double rxPowerDbm)
+{
+  m_events.push_back (m_interference.Add (0, txVector, duration, DbmToW (rxPowerDbm)));
+}
+
+void
+InterferenceHelperOverlapTestCase::StartRx (void)
+{
+  m_interference.NotifyRxStart ();
+}
+
+void
+InterferenceHelperOverlapTestCase::CheckHeader (void)
+{
+  m_header = m_interference.CalculatePlcpHeaderSnrPer (m_events[0]);
+}
+
+void
+InterferenceHelperOverlapTestCase::CheckPayload (void)
+{
+  m_payload = m_interference.CalculatePlcpPayloadSnrPer (m_events[0]);
+  m_interference.NotifyRxEnd ();
+}
+
+void
+InterferenceHelperOverlapTestCase::CheckEnergyDuration (double thresholdDbm, Time expected)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_interference.GetEnergyDuration (DbmToW (thresholdDbm)), expected,
+                         "Wrong energy duration above " << thresholdDbm << " dBm");
+}
+
+void
+InterferenceHelperOverlapTestCase::DoRun (void)
+{
+  m_interference.SetNoiseFigure (DbToRatio (7));
+  m_interference.SetErrorRateModel (CreateObject<NistErrorRateModel> ());
+
+  WifiTxVector ht = MakeTxVector (WifiPhy::GetHtMcs6 (), WIFI_PREAMBLE_HT_MF);
+  WifiTxVector ofdm = MakeTxVector (WifiPhy::GetOfdmRate6Mbps (), WIFI_PREAMBLE_LONG);
+  // the frame received, from 1 s to 1 s + 200 us
+  Simulator::Schedule (Seconds (1), &InterferenceHelperOverlapTestCase::AddSignal, this,
+                       ht, MicroSeconds (200), -60);
+  Simulator::Schedule (Seconds (1), &InterferenceHelperOverlapTestCase::StartRx, this);
+  // an interferer during the HT-SIG
+  Simulator::Schedule (Seconds (1) + MicroSeconds (22), &InterferenceHelperOverlapTestCase::AddSignal, this,
+                       ofdm, MicroSeconds (10), -64);
+  Simulator::Schedule (Seconds (1) + MicroSeconds (40), &InterferenceHelperOverlapTestCase::CheckHeader, this);
+  // interferers during the payload, one ending after the frame
+  Simulator::Schedule (Seconds (1) + MicroSeconds (60), &InterferenceHelperOverlapTestCase::AddSignal, this,
+                       ofdm, MicroSeconds (50), -86);
+  Simulator::Schedule (Seconds (1) + MicroSeconds (80), &InterferenceHelperOverlapTestCase::AddSignal, this,
+                       ht, MicroSeconds (60), -84);
+  Simulator::Schedule (Seconds (1) + MicroSeconds (150), &InterferenceHelperOverlapTestCase::AddSignal, this,
+                       ofdm, MicroSeconds (100), -83);
+  Simulator::Schedule (Seconds (1) + MicroSeconds (160), &InterferenceHelperOverlapTestCase::CheckEnergyDuration, this,
+                       -63, MicroSeconds (40));
+  Simulator::Schedule (Seconds (1) + MicroSeconds (160), &InterferenceHelperOverlapTestCase::CheckEnergyDuration, this,
+                       -90, MicroSeconds (90));
+  Simulator::Schedule (Seconds (1) + MicroSeconds (200), &InterferenceHelperOverlapTestCase::CheckPayload, this);
+  // signals added after the reception prune the past changes
+  Simulator::Schedule (Seconds (1) + MicroSeconds (220), &InterferenceHelperOverlapTestCase::AddSignal, this,
+                       ofdm, MicroSeconds (10), -80);
+  Simulator::Schedule (Seconds (1) + MicroSeconds (225), &InterferenceHelperOverlapTestCase::CheckEnergyDuration, this,
+                       -90, MicroSeconds (25));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  // the SNR is the one at the start of the frame, before any interferer
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_header.snr, 2492.2896758686629, 1e-9, "Wrong PLCP header SNR");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_header.per, 0.00099042167589358243, 1e-12, "Wrong PLCP header PER");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_payload.snr, 2492.2896758686629, 1e-9, "Wrong payload SNR");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_payload.per, 0.34848032222296099, 1e-12, "Wrong payload PER");
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Benchmark the InterferenceHelper with many overlapping signals.
+ *
+ * A frame is received while n other signals, starting every 10 us,
+ * overlap it; the PLCP header SNR and PER of each newcomer is computed
+ * when it arrives, as a PHY looking for a preamble would do, and the
+ * payload SNR and PER of the frame at its end.
+ */
+class InterferenceHelperBenchmarkTestCase : public TestCase
+{
+public:
+  InterferenceHelperBenchmarkTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \param n the number of overlapping signals
+   * \param reps the number of repetitions
+   */
+  void Bench (uint32_t n, uint32_t reps);
+  /**
+   * Add an overlapping signal and compute the SNR and PER of its header.
+   */
+  void AddSignal (void);
+
+  InterferenceHelper *m_interference; ///< the helper being benchmarked
+  WifiTxVector m_txVector; ///< the TXVECTOR of the signals
+  double m_sum; ///< sum of the PER computed, to use the results
+};
+
+InterferenceHelperBenchmarkTestCase::InterferenceHelperBenchmarkTestCase ()
+  : TestCase ("Benchmark InterferenceHelper with overlapping signals"),
+    m_interference (0),
+    m_sum (0)
+{
+}
+
+void
+InterferenceHelperBenchmarkTestCase::AddSignal (void)
+{
+  Ptr<Event> event = m_interference->Add (0, m_txVector, MilliSeconds (4), DbmToW (-85));
+  m_sum += m_interference->CalculatePlcpHeaderSnrPer (event).per;
+}
+
+void
+InterferenceHelperBenchmarkTestCase::Bench (uint32_t n, uint32_t reps)
+{
+  clock_t start = clock ();
+  for (uint32_t r = 0; r < reps; ++r)
+    {
+      InterferenceHelper interference;
+      interference.SetNoiseFigure (DbToRatio (7));
+      interference.SetErrorRateModel (CreateObject<NistErrorRateModel> ());
+      m_interference = &interference;
+      Ptr<Event> frame = interference.Add (0, m_txVector, MilliSeconds (5), DbmToW (-50));
+      interference.NotifyRxStart ();
+      for (uint32_t i = 1; i <= n; ++i)
+        {
+          Simulator::Schedule (MicroSeconds (10 * i), &InterferenceHelperBenchmarkTestCase::AddSignal, this);
+        }
+      Simulator::Run ();
+      Simulator::Stop (MilliSeconds (5) - Simulator::Now ());
+      Simulator::Run ();
+      m_sum += interference.CalculatePlcpPayloadSnrPer (frame).per;
+      interference.NotifyRxEnd ();
+      Simulator::Destroy ();
+      m_interference = 0;
+    }
+  clock_t elapsed = clock () - start;
+  std::cout << "wifi-interference-helper-perf: " << n << " overlapping signals, reps " << reps
+            << ": " << 1e3 * elapsed / CLOCKS_PER_SEC << " ms" << std::endl;
+}
+
+void
+InterferenceHelperBenchmarkTestCase::DoRun (void)
+{
+  m_txVector = MakeTxVector (WifiPhy::GetOfdmRate6Mbps (), WIFI_PREAMBLE_LONG);
+  Bench (100, 200);
+  Bench (200, 100);
+  Bench (400, 50);
+  NS_TEST_ASSERT_MSG_GT (m_sum, 0, "No PER computed");
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Interference helper TestSuite
+ */
+class InterferenceHelperTestSuite : public TestSuite
+{
+public:
+  InterferenceHelperTestSuite ();
+};
+
+InterferenceHelperTestSuite::InterferenceHelperTestSuite ()
+  : TestSuite ("wifi-interference-helper", UNIT)
+{
+  AddTestCase (new InterferenceHelperOverlapTestCase, TestCase::QUICK);
+}
+
+static InterferenceHelperTestSuite g_interferenceHelperTestSuite; ///< the test suite
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Interference helper performance TestSuite
+ */
+class InterferenceHelperPerformanceTestSuite : public TestSuite
+{
+public:
+  InterferenceHelperPerformanceTestSuite ();
+};
+
+InterferenceHelperPerformanceTestSuite::InterferenceHelperPerformanceTestSuite ()
+  : TestSuite ("wifi-interference-helper-perf", PERFORMANCE)
+{
+  AddTestCase (new InterferenceHelperBenchmarkTestCase, TestCase::QUICK);
+}
+
+static InterferenceHelperPerformanceTestSuite g_interferenceHelperPerformanceTestSuite; ///< the performance test suite
@@ -405,6 +405,50 @@ TwoLevelAggregationTest::DoRun (void)
 }
 
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Check that the length-only aggregation of MPDUs, used by MacLow to
+ * build A-MPDUs without copying the MPDUs, matches the aggregation of their bytes
+ */
+class AmpduLengthAggregationTest : public TestCase
+{
+public:
+  AmpduLengthAggregationTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+AmpduLengthAggregationTest::AmpduLengthAggregationTest ()
+  : TestCase ("Check the length-only aggregation of MPDUs")
+{
+}
+
+void
+AmpduLengthAggregationTest::DoRun (void)
+{
+  Ptr<MpduAggregator> mpduAggregator = CreateObject<MpduAggregator> ();
+  mpduAggregator->SetMaxAmpduSize (4095);
+
+  Ptr<Packet> ampdu = Create<Packet> ();
+  Ptr<Packet> lengthOnly = Create<Packet> ();
+  // MPDU sizes which are not multiple of 4 bytes, to exercise the padding
+  uint32_t sizes[] = {1, 1500, 30, 1023, 1498, 100};
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      bool aggregated = mpduAggregator->Aggregate (Create<Packet> (sizes[i]), ampdu);
+      NS_TEST_EXPECT_MSG_EQ (mpduAggregator->AggregateLength (sizes[i], lengthOnly), aggregated,
+                             "MPDU " << i << " should be aggregated by both methods or by none");
+      NS_TEST_EXPECT_MSG_EQ (lengthOnly->GetSize (), ampdu->GetSize (),
+                             "the lengths of the A-MPDUs should match after MPDU " << i);
+    }
+  // the last MPDU does not fit within the maximum A-MPDU size
+  NS_TEST_EXPECT_MSG_EQ (lengthOnly->GetSize (), 4078, "unexpected A-MPDU size");
+}
+
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -422,6 +466,7 @@ WifiAggregationTestSuite::WifiAggregationTestSuite ()
 {
   AddTestCase (new AmpduAggregationTest, TestCase::QUICK);
   AddTestCase (new TwoLevelAggregationTest, TestCase::QUICK);
+  AddTestCase (new AmpduLengthAggregationTest, TestCase::QUICK);
 }
 
 static WifiAggregationTestSuite g_wifiAggregationTestSuite; ///< the test suite
@@ -19,9 +19,18 @@
  */
 
 #include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+#include <vector>
 #include "ns3/test.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
 #include "ns3/nist-error-rate-model.h"
+#include "ns3/yans-error-rate-model.h"
 #include "ns3/dsss-error-rate-model.h"
+#include "ns3/table-error-rate-model.h"
+#include "ns3/wifi-phy.h"
 #include "ns3/wifi-tx-vector.h"
 
 using namespace ns3;
@@ -291,6 +300,198 @@ WifiErrorRateModelsTestCaseNist::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (ps, 0.999, 0.001, "Not equal within tolerance");
 }
 
+/**
+ * \returns the TXVECTORs of the modes checked against the table error
+ * rate model, one per modulation and coding rate
+ */
+static std::vector<WifiTxVector>
+GetTableTestTxVectors (void)
+{
+  std::vector<WifiMode> modes;
+  modes.push_back (WifiPhy::GetDsssRate1Mbps ());
+  modes.push_back (WifiPhy::GetDsssRate2Mbps ());
+  modes.push_back (WifiPhy::GetDsssRate5_5Mbps ());
+  modes.push_back (WifiPhy::GetDsssRate11Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate6Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate9Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate12Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate18Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate24Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate36Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate48Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate54Mbps ());
+  modes.push_back (WifiPhy::GetHtMcs7 ());
+  modes.push_back (WifiPhy::GetVhtMcs8 ());
+  modes.push_back (WifiPhy::GetVhtMcs9 ());
+  modes.push_back (WifiPhy::GetHeMcs10 ());
+  modes.push_back (WifiPhy::GetHeMcs11 ());
+  std::vector<WifiTxVector> txVectors;
+  for (std::vector<WifiMode>::const_iterator i = modes.begin (); i != modes.end (); ++i)
+    {
+      WifiPreamble preamble = WIFI_PREAMBLE_LONG;
+      uint16_t channelWidth = 20;
+      switch (i->GetModulationClass ())
+        {
+        case WIFI_MOD_CLASS_HT:
+          preamble = WIFI_PREAMBLE_HT_MF;
+          break;
+        case WIFI_MOD_CLASS_VHT:
+          preamble = WIFI_PREAMBLE_VHT;
+          // VHT-MCS 9 is not allowed on 20 MHz channels
+          channelWidth = 40;
+          break;
+        case WIFI_MOD_CLASS_HE:
+          preamble = WIFI_PREAMBLE_HE_SU;
+          channelWidth = 40;
+          break;
+        default:
+          break;
+        }
+      txVectors.push_back (WifiTxVector (*i, 0, preamble, 800, 1, 1, 0, channelWidth, false, false));
+    }
+  return txVectors;
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Check the success rates interpolated by the TableErrorRateModel
+ * against the ones of the NIST and YANS models it tabulates, and the
+ * tables written to and read back from a file.
+ */
+class TableErrorRateModelTestCase : public TestCase
+{
+public:
+  TableErrorRateModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Check the table model against the model it tabulates, for all the
+   * modes and a range of SNRs and chunk sizes.
+   *
+   * \param table the table model
+   * \param model the model tabulated
+   * \param tolerance the largest absolute error on the success rate
+   */
+  void CheckAccuracy (Ptr<ErrorRateModel> table, Ptr<ErrorRateModel> model, double tolerance);
+};
+
+TableErrorRateModelTestCase::TableErrorRateModelTestCase ()
+  : TestCase ("Check the accuracy of the table error rate model")
+{
+}
+
+void
+TableErrorRateModelTestCase::CheckAccuracy (Ptr<ErrorRateModel> table, Ptr<ErrorRateModel> model, double tolerance)
+{
+  std::vector<WifiTxVector> txVectors = GetTableTestTxVectors ();
+  const uint64_t sizes[] = {1, 14 * 8, 1500 * 8, 65535 * 8};
+  for (std::vector<WifiTxVector>::const_iterator i = txVectors.begin (); i != txVectors.end (); ++i)
+    {
+      // from below to above the tabulated range, off the table grid
+      for (double snrDb = -15; snrDb < 65; snrDb += 0.13)
+        {
+          double snr = std::pow (10.0, snrDb / 10.0);
+          for (uint32_t j = 0; j < sizeof (sizes) / sizeof (sizes[0]); ++j)
+            {
+              double expected = model->GetChunkSuccessRate (i->GetMode (), *i, snr, sizes[j]);
+              double actual = table->GetChunkSuccessRate (i->GetMode (), *i, snr, sizes[j]);
+              NS_TEST_ASSERT_MSG_EQ_TOL (actual, expected, tolerance,
+                                         "Wrong success rate for " << i->GetMode () << " at " << snrDb
+                                                                   << " dB for " << sizes[j] << " bits");
+            }
+        }
+    }
+}
+
+void
+TableErrorRateModelTestCase::DoRun (void)
+{
+  Ptr<NistErrorRateModel> nist = CreateObject<NistErrorRateModel> ();
+  Ptr<TableErrorRateModel> table = CreateObject<TableErrorRateModel> ();
+  table->SetErrorRateModel (nist);
+  CheckAccuracy (table, nist, 1e-3);
+
+  Ptr<YansErrorRateModel> yans = CreateObject<YansErrorRateModel> ();
+  Ptr<TableErrorRateModel> yansTable = CreateObject<TableErrorRateModel> ();
+  yansTable->SetErrorRateModel (yans);
+  CheckAccuracy (yansTable, yans, 1e-3);
+
+  // tables read back from a file give the same success rates
+  std::string filename = CreateTempDirFilename ("table-error-rate-model.txt");
+  table->SaveTables (filename, GetTableTestTxVectors ());
+  Ptr<TableErrorRateModel> loaded = CreateObject<TableErrorRateModel> ();
+  loaded->SetAttribute ("TableFile", StringValue (filename));
+  // tables built with this step would fail the test
+  loaded->SetAttribute ("SnrStep", DoubleValue (5));
+  loaded->SetErrorRateModel (nist);
+  CheckAccuracy (loaded, table, 1e-15);
+  std::remove (filename.c_str ());
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Benchmark the TableErrorRateModel against the NIST model.
+ */
+class TableErrorRateModelBenchmarkTestCase : public TestCase
+{
+public:
+  TableErrorRateModelBenchmarkTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param name the name of the model
+   * \param model the model to benchmark
+   * \return the sum of the success rates computed
+   */
+  double Bench (std::string name, Ptr<ErrorRateModel> model);
+};
+
+TableErrorRateModelBenchmarkTestCase::TableErrorRateModelBenchmarkTestCase ()
+  : TestCase ("Benchmark the table error rate model")
+{
+}
+
+double
+TableErrorRateModelBenchmarkTestCase::Bench (std::string name, Ptr<ErrorRateModel> model)
+{
+  std::vector<WifiTxVector> txVectors = GetTableTestTxVectors ();
+  double sum = 0;
+  clock_t start = clock ();
+  for (uint32_t r = 0; r < 20; ++r)
+    {
+      for (std::vector<WifiTxVector>::const_iterator i = txVectors.begin (); i != txVectors.end (); ++i)
+        {
+          for (double snrDb = 0; snrDb < 40; snrDb += 0.01)
+            {
+              sum += model->GetChunkSuccessRate (i->GetMode (), *i, std::pow (10.0, snrDb / 10.0), 12000);
+            }
+        }
+    }
+  clock_t elapsed = clock () - start;
+  std::cout << "wifi-error-rate-models-perf: " << name << ": "
+            << 1e3 * elapsed / CLOCKS_PER_SEC << " ms" << std::endl;
+  return sum;
+}
+
+void
+TableErrorRateModelBenchmarkTestCase::DoRun (void)
+{
+  Ptr<TableErrorRateModel> table = CreateObject<TableErrorRateModel> ();
+  // build the tables out of the timed loop
+  std::string filename = CreateTempDirFilename ("table-error-rate-model.txt");
+  table->SaveTables (filename, GetTableTestTxVectors ());
+  std::remove (filename.c_str ());
+  double nist = Bench ("NistErrorRateModel", CreateObject<NistErrorRateModel> ());
+  double tabulated = Bench ("TableErrorRateModel", table);
+  NS_TEST_ASSERT_MSG_EQ_TOL (tabulated, nist, 1e-3 * nist, "Different success rates");
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -308,7 +509,28 @@ WifiErrorRateModelsTestSuite::WifiErrorRateModelsTestSuite ()
 {
   AddTestCase (new WifiErrorRateModelsTestCaseDsss, TestCase::QUICK);
   AddTestCase (new WifiErrorRateModelsTestCaseNist, TestCase::QUICK);
+  AddTestCase (new TableErrorRateModelTestCase, TestCase::QUICK);
 }
 
 static WifiErrorRateModelsTestSuite wifiErrorRateModelsTestSuite; ///< the test suite
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Wifi Error Rate Models performance Test Suite
+ */
+class WifiErrorRateModelsPerformanceTestSuite : public TestSuite
+{
+public:
+  WifiErrorRateModelsPerformanceTestSuite ();
+};
+
+WifiErrorRateModelsPerformanceTestSuite::WifiErrorRateModelsPerformanceTestSuite ()
+  : TestSuite ("wifi-error-rate-models-perf", PERFORMANCE)
+{
+  AddTestCase (new TableErrorRateModelBenchmarkTestCase, TestCase::QUICK);
+}
+
+static WifiErrorRateModelsPerformanceTestSuite wifiErrorRateModelsPerformanceTestSuite; ///< the performance test suite
+
@@ -30,6 +30,9 @@
 #include "ns3/propagation-loss-model.h"
 #include "ns3/yans-error-rate-model.h"
 #include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
 #include "ns3/test.h"
 #include "ns3/pointer.h"
 #include "ns3/rng-seed-manager.h"
@@ -43,6 +46,8 @@
 #include "ns3/wifi-phy-tag.h"
 #include "ns3/yans-wifi-phy.h"
 #include "ns3/mgt-headers.h"
+#include "ns3/constant-rate-wifi-manager.h"
+#include "ns3/wifi-mac-queue.h"
 
 using namespace ns3;
 
@@ -1690,6 +1695,760 @@ StaWifiMacScanningTestCase::DoRun (void)
   }
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that the MaxRange and MinRxPower attributes of YansWifiChannel
+ * skip the expected receivers, including the receivers which moved into
+ * range since the previous transmission.
+ *
+ * A PHY at the origin transmits three frames, 1 s apart, to four PHYs:
+ *   - PHY 1 at 50 m, always in range;
+ *   - PHY 2 at 500 m, moved to 80 m before the second frame;
+ *   - PHY 3 at 500 m, never in range;
+ *   - PHY 4 moving from 1000 m toward the origin at 480 m/s, in range
+ *     only for the second frame.
+ * The third frame is sent with a MinRxPower above the receive power.
+ */
+class YansWifiChannelRangeTestCase : public TestCase
+{
+public:
+  YansWifiChannelRangeTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Send a frame from the PHY at the origin
+   */
+  void Send (void);
+  /**
+   * Callback triggered when a frame is received by a PHY
+   * \param phy the index of the PHY
+   * \param p the received packet
+   */
+  void RxBegin (uint32_t phy, Ptr<const Packet> p);
+  /**
+   * Set the MinRxPower attribute of the channel
+   * \param channel the channel
+   * \param minRxPowerDbm the value of the attribute, in dBm
+   */
+  void SetMinRxPower (Ptr<YansWifiChannel> channel, double minRxPowerDbm);
+
+  std::vector<Ptr<YansWifiPhy> > m_phys; ///< the PHYs
+  std::vector<uint32_t> m_rxCount; ///< number of frames received by each PHY
+};
+
+YansWifiChannelRangeTestCase::YansWifiChannelRangeTestCase ()
+  : TestCase ("Test the receiver culling of YansWifiChannel"),
+    m_rxCount (5, 0)
+{
+}
+
+void
+YansWifiChannelRangeTestCase::Send (void)
+{
+  WifiTxVector txVector = WifiTxVector (WifiPhy::GetOfdmRate6Mbps (), 0, WIFI_PREAMBLE_LONG, false, 1, 1, 0, 20, false, false);
+  m_phys[0]->SendPacket (Create<Packet> (1000), txVector);
+}
+
+void
+YansWifiChannelRangeTestCase::RxBegin (uint32_t phy, Ptr<const Packet> p)
+{
+  m_rxCount[phy]++;
+}
+
+void
+YansWifiChannelRangeTestCase::SetMinRxPower (Ptr<YansWifiChannel> channel, double minRxPowerDbm)
+{
+  channel->SetAttribute ("MinRxPower", DoubleValue (minRxPowerDbm));
+}
+
+void
+YansWifiChannelRangeTestCase::DoRun (void)
+{
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  Ptr<FixedRssLossModel> loss = CreateObject<FixedRssLossModel> ();
+  loss->SetRss (-50);
+  channel->SetPropagationLossModel (loss);
+  channel->SetAttribute ("MaxRange", DoubleValue (100));
+
+  Ptr<ErrorRateModel> error = CreateObject<YansErrorRateModel> ();
+  std::vector<Ptr<MobilityModel> > mobility;
+  Ptr<ConstantPositionMobilityModel> position = CreateObject<ConstantPositionMobilityModel> ();
+  position->SetPosition (Vector (0.0, 0.0, 0.0));
+  mobility.push_back (position);
+  position = CreateObject<ConstantPositionMobilityModel> ();
+  position->SetPosition (Vector (50.0, 0.0, 0.0));
+  mobility.push_back (position);
+  Ptr<ConstantPositionMobilityModel> moved = CreateObject<ConstantPositionMobilityModel> ();
+  moved->SetPosition (Vector (500.0, 0.0, 0.0));
+  mobility.push_back (moved);
+  position = CreateObject<ConstantPositionMobilityModel> ();
+  position->SetPosition (Vector (0.0, 500.0, 0.0));
+  mobility.push_back (position);
+  Ptr<ConstantVelocityMobilityModel> velocity = CreateObject<ConstantVelocityMobilityModel> ();
+  velocity->SetPosition (Vector (1000.0, 0.0, 0.0));
+  velocity->SetVelocity (Vector (-480.0, 0.0, 0.0));
+  mobility.push_back (velocity);
+
+  for (uint32_t i = 0; i < mobility.size (); i++)
+    {
+      Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+      phy->SetErrorRateModel (error);
+      phy->SetChannel (channel);
+      phy->SetMobility (mobility[i]);
+      phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+      phy->TraceConnectWithoutContext ("PhyRxBegin", MakeCallback (&YansWifiChannelRangeTestCase::RxBegin, this).Bind (i));
+      m_phys.push_back (phy);
+    }
+
+  Simulator::Schedule (Seconds (1.0), &YansWifiChannelRangeTestCase::Send, this);
+  Simulator::Schedule (Seconds (1.5), &ConstantPositionMobilityModel::SetPosition, moved, Vector (80.0, 0.0, 0.0));
+  Simulator::Schedule (Seconds (2.0), &YansWifiChannelRangeTestCase::Send, this);
+  Simulator::Schedule (Seconds (2.5), &YansWifiChannelRangeTestCase::SetMinRxPower, this, channel, -40);
+  Simulator::Schedule (Seconds (3.0), &YansWifiChannelRangeTestCase::Send, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_rxCount[0], 0, "The sender received its own frames");
+  NS_TEST_ASSERT_MSG_EQ (m_rxCount[1], 2, "PHY in range did not receive the frames");
+  NS_TEST_ASSERT_MSG_EQ (m_rxCount[2], 1, "Repositioned PHY not (only) in range after the move");
+  NS_TEST_ASSERT_MSG_EQ (m_rxCount[3], 0, "PHY out of range received frames");
+  NS_TEST_ASSERT_MSG_EQ (m_rxCount[4], 1, "Moving PHY not (only) in range for the second frame");
+  m_phys.clear ();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that the receivers of a transmission share the packet sent on
+ * the channel instead of receiving a copy each.
+ */
+class WifiSharedRxPacketTestCase : public TestCase
+{
+public:
+  WifiSharedRxPacketTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Callback triggered when a frame is received by a PHY
+   * \param p the received packet
+   */
+  void RxBegin (Ptr<const Packet> p);
+
+  std::vector<const Packet *> m_rxPackets; ///< the packets received by the PHYs
+};
+
+WifiSharedRxPacketTestCase::WifiSharedRxPacketTestCase ()
+  : TestCase ("Test that the receivers of a frame share its packet")
+{
+}
+
+void
+WifiSharedRxPacketTestCase::RxBegin (Ptr<const Packet> p)
+{
+  m_rxPackets.push_back (PeekPointer (p));
+}
+
+void
+WifiSharedRxPacketTestCase::DoRun (void)
+{
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  Ptr<FixedRssLossModel> loss = CreateObject<FixedRssLossModel> ();
+  loss->SetRss (-50);
+  channel->SetPropagationLossModel (loss);
+
+  Ptr<ErrorRateModel> error = CreateObject<YansErrorRateModel> ();
+  std::vector<Ptr<YansWifiPhy> > phys;
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector (i, 0.0, 0.0));
+      Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+      phy->SetErrorRateModel (error);
+      phy->SetChannel (channel);
+      phy->SetMobility (mobility);
+      phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+      phy->TraceConnectWithoutContext ("PhyRxBegin", MakeCallback (&WifiSharedRxPacketTestCase::RxBegin, this));
+      phys.push_back (phy);
+    }
+
+  WifiTxVector txVector = WifiTxVector (WifiPhy::GetOfdmRate6Mbps (), 0, WIFI_PREAMBLE_LONG, false, 1, 1, 0, 20, false, false);
+  Simulator::Schedule (Seconds (1.0), &WifiPhy::SendPacket, phys[0], Create<Packet> (1000), txVector, NORMAL_MPDU);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_rxPackets.size (), 3, "The frame was not received by all the other PHYs");
+  NS_TEST_ASSERT_MSG_EQ (m_rxPackets[1], m_rxPackets[0], "The receivers got different packets");
+  NS_TEST_ASSERT_MSG_EQ (m_rxPackets[2], m_rxPackets[0], "The receivers got different packets");
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that the remote station manager keeps the state of each
+ * station, and the retry counters of each station and TID, apart when
+ * it knows many stations.
+ */
+class WifiRemoteStationLookupTestCase : public TestCase
+{
+public:
+  WifiRemoteStationLookupTestCase ();
+  virtual void DoRun (void);
+};
+
+WifiRemoteStationLookupTestCase::WifiRemoteStationLookupTestCase ()
+  : TestCase ("Test the lookup of many remote stations")
+{
+}
+
+void
+WifiRemoteStationLookupTestCase::DoRun (void)
+{
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  Ptr<ConstantRateWifiManager> manager = CreateObject<ConstantRateWifiManager> ();
+  manager->SetupPhy (phy);
+  Ptr<Packet> packet = Create<Packet> (100);
+  const uint32_t n = 500;
+  std::vector<Mac48Address> addresses;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      addresses.push_back (Mac48Address::Allocate ());
+    }
+  for (uint32_t i = 0; i < n; i++)
+    {
+      if (i % 3 == 0)
+        {
+          manager->RecordWaitAssocTxOk (addresses[i]);
+        }
+      else if (i % 3 == 1)
+        {
+          manager->RecordGotAssocTxOk (addresses[i]);
+        }
+      // exhaust the retries of one TID of each station
+      WifiMacHeader hdr;
+      hdr.SetType (WIFI_MAC_QOSDATA);
+      hdr.SetQosTid (i % 8);
+      for (uint32_t j = 0; j < 7; j++)
+        {
+          manager->ReportDataFailed (addresses[i], &hdr, packet->GetSize ());
+        }
+    }
+  for (uint32_t i = 0; i < n; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (manager->IsWaitAssocTxOk (addresses[i]), (i % 3 == 0), "Wrong state for station " << i);
+      NS_TEST_EXPECT_MSG_EQ (manager->IsAssociated (addresses[i]), (i % 3 == 1), "Wrong state for station " << i);
+      NS_TEST_EXPECT_MSG_EQ (manager->IsBrandNew (addresses[i]), (i % 3 == 2), "Wrong state for station " << i);
+      WifiMacHeader hdr;
+      hdr.SetType (WIFI_MAC_QOSDATA);
+      hdr.SetQosTid (i % 8);
+      NS_TEST_EXPECT_MSG_EQ (manager->NeedRetransmission (addresses[i], &hdr, packet), false,
+                             "Retries left for station " << i << " TID " << i % 8);
+      hdr.SetQosTid ((i + 1) % 8);
+      NS_TEST_EXPECT_MSG_EQ (manager->NeedRetransmission (addresses[i], &hdr, packet), true,
+                             "No retries left for station " << i << " TID " << (i + 1) % 8);
+    }
+  NS_TEST_EXPECT_MSG_EQ (manager->IsBrandNew (Mac48Address::Allocate ()), true, "Unknown station not brand new");
+  manager->Reset ();
+  NS_TEST_EXPECT_MSG_EQ (manager->IsAssociated (addresses[1]), false, "Station kept across a reset");
+  Simulator::Destroy ();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * A propagation loss model counting its invocations, to be chained in
+ * front of the actual loss model.
+ */
+class CountingPropagationLossModel : public PropagationLossModel
+{
+public:
+  CountingPropagationLossModel ()
+    : m_count (0)
+  {
+  }
+  uint32_t m_count; ///< number of invocations
+private:
+  virtual double DoCalcRxPower (double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+  {
+    const_cast<CountingPropagationLossModel *> (this)->m_count++;
+    return txPowerDbm;
+  }
+  virtual int64_t DoAssignStreams (int64_t stream)
+  {
+    return 0;
+  }
+};
+
+/**
+ * Make sure that the link cache of YansWifiChannel skips the propagation
+ * loss model for the links whose ends did not move, and gives the same
+ * receive powers as without the cache.
+ *
+ * A PHY at the origin transmits four frames to three PHYs:
+ *   - PHY 1 at 10 m;
+ *   - PHY 2 at 20 m, moved to 40 m between the second and third frames;
+ *   - PHY 3 moving from 30 m at 1 m/s.
+ */
+class YansWifiChannelLinkCacheTestCase : public TestCase
+{
+public:
+  YansWifiChannelLinkCacheTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Run the scenario.
+   * \param cacheLinks the value of the CacheLinks attribute
+   * \return the number of invocations of the propagation loss model
+   */
+  uint32_t Run (bool cacheLinks);
+  /**
+   * Send a frame from the PHY at the origin
+   */
+  void Send (void);
+  /**
+   * Callback triggered when a frame is received by a PHY
+   * \param phy the index of the PHY
+   * \param packet the received packet
+   * \param channelFreqMhz the frequency of the channel
+   * \param txVector the TXVECTOR of the packet
+   * \param aMpdu the A-MPDU information
+   * \param signalNoise the signal and noise power of the packet
+   */
+  void MonitorSnifferRx (uint32_t phy, Ptr<const Packet> packet, uint16_t channelFreqMhz,
+                         WifiTxVector txVector, MpduInfo aMpdu, SignalNoiseDbm signalNoise);
+
+  std::vector<Ptr<YansWifiPhy> > m_phys; ///< the PHYs
+  std::vector<std::vector<double> > m_rxPowers; ///< rx power of the frames received by each PHY, in dBm
+};
+
+YansWifiChannelLinkCacheTestCase::YansWifiChannelLinkCacheTestCase ()
+  : TestCase ("Test the link cache of YansWifiChannel")
+{
+}
+
+void
+YansWifiChannelLinkCacheTestCase::Send (void)
+{
+  WifiTxVector txVector = WifiTxVector (WifiPhy::GetOfdmRate6Mbps (), 0, WIFI_PREAMBLE_LONG, false, 1, 1, 0, 20, false, false);
+  m_phys[0]->SendPacket (Create<Packet> (1000), txVector);
+}
+
+void
+YansWifiChannelLinkCacheTestCase::MonitorSnifferRx (uint32_t phy, Ptr<const Packet> packet, uint16_t channelFreqMhz,
+                                                    WifiTxVector txVector, MpduInfo aMpdu, SignalNoiseDbm signalNoise)
+{
+  m_rxPowers[phy].push_back (signalNoise.signal);
+}
+
+uint32_t
+YansWifiChannelLinkCacheTestCase::Run (bool cacheLinks)
+{
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  Ptr<CountingPropagationLossModel> loss = CreateObject<CountingPropagationLossModel> ();
+  loss->SetNext (CreateObject<LogDistancePropagationLossModel> ());
+  channel->SetPropagationLossModel (loss);
+  channel->SetAttribute ("CacheLinks", BooleanValue (cacheLinks));
+
+  Ptr<ErrorRateModel> error = CreateObject<YansErrorRateModel> ();
+  std::vector<Ptr<MobilityModel> > mobility;
+  Ptr<ConstantPositionMobilityModel> position = CreateObject<ConstantPositionMobilityModel> ();
+  position->SetPosition (Vector (0.0, 0.0, 0.0));
+  mobility.push_back (position);
+  position = CreateObject<ConstantPositionMobilityModel> ();
+  position->SetPosition (Vector (10.0, 0.0, 0.0));
+  mobility.push_back (position);
+  Ptr<ConstantPositionMobilityModel> moved = CreateObject<ConstantPositionMobilityModel> ();
+  moved->SetPosition (Vector (20.0, 0.0, 0.0));
+  mobility.push_back (moved);
+  Ptr<ConstantVelocityMobilityModel> velocity = CreateObject<ConstantVelocityMobilityModel> ();
+  velocity->SetPosition (Vector (30.0, 0.0, 0.0));
+  velocity->SetVelocity (Vector (1.0, 0.0, 0.0));
+  mobility.push_back (velocity);
+
+  m_phys.clear ();
+  m_rxPowers.assign (mobility.size (), std::vector<double> ());
+  for (uint32_t i = 0; i < mobility.size (); i++)
+    {
+      Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+      phy->SetErrorRateModel (error);
+      phy->SetChannel (channel);
+      phy->SetMobility (mobility[i]);
+      phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+      phy->TraceConnectWithoutContext ("MonitorSnifferRx", MakeCallback (&YansWifiChannelLinkCacheTestCase::MonitorSnifferRx, this).Bind (i));
+      m_phys.push_back (phy);
+    }
+
+  Simulator::Schedule (Seconds (1.0), &YansWifiChannelLinkCacheTestCase::Send, this);
+  Simulator::Schedule (Seconds (1.2), &YansWifiChannelLinkCacheTestCase::Send, this);
+  Simulator::Schedule (Seconds (1.5), &ConstantPositionMobilityModel::SetPosition, moved, Vector (40.0, 0.0, 0.0));
+  Simulator::Schedule (Seconds (2.0), &YansWifiChannelLinkCacheTestCase::Send, this);
+  Simulator::Schedule (Seconds (2.2), &YansWifiChannelLinkCacheTestCase::Send, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_phys.clear ();
+  return loss->m_count;
+}
+
+void
+YansWifiChannelLinkCacheTestCase::DoRun (void)
+{
+  NS_TEST_ASSERT_MSG_EQ (Run (false), 12, "Wrong number of loss computations without the cache");
+  std::vector<std::vector<double> > rxPowers = m_rxPowers;
+  // the static links are computed once, and again after the move of PHY 2
+  NS_TEST_ASSERT_MSG_EQ (Run (true), 7, "Wrong number of loss computations with the cache");
+  for (uint32_t i = 1; i < rxPowers.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_rxPowers[i].size (), 4, "PHY " << i << " did not receive all the frames");
+      NS_TEST_ASSERT_MSG_EQ (rxPowers[i].size (), 4, "PHY " << i << " did not receive all the frames");
+      for (uint32_t j = 0; j < 4; j++)
+        {
+          NS_TEST_EXPECT_MSG_EQ_TOL (m_rxPowers[i][j], rxPowers[i][j], 1e-9,
+                                     "Different rx power with the cache for PHY " << i << " frame " << j);
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_rxPowers[1][3], m_rxPowers[1][0], 1e-9, "Static link changed");
+  NS_TEST_EXPECT_MSG_GT (m_rxPowers[2][1], m_rxPowers[2][2] + 1, "Cached link not invalidated by the move");
+  NS_TEST_EXPECT_MSG_GT (m_rxPowers[3][0], m_rxPowers[3][3], "Moving link cached");
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that YansWifiChannel only computes the propagation to the PHYs
+ * on the channel of the sender, following the channel switches.
+ *
+ * PHY 0 and PHY 1 start on channel 36 and PHY 2 on channel 40. PHY 0
+ * transmits a frame, then PHY 2 switches to channel 36, PHY 0 transmits
+ * another frame, then PHY 1 switches to channel 40 and PHY 0 transmits a
+ * last frame.
+ */
+class YansWifiChannelNumberTestCase : public TestCase
+{
+public:
+  YansWifiChannelNumberTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Send a frame from PHY 0
+   */
+  void Send (void);
+  /**
+   * Check the frames received so far and the loss model invocations
+   * \param count the expected number of loss model invocations
+   * \param rx1 the expected number of frames received by PHY 1
+   * \param rx2 the expected number of frames received by PHY 2
+   */
+  void Check (uint32_t count, uint32_t rx1, uint32_t rx2);
+  /**
+   * Callback triggered when a frame is received by a PHY
+   * \param phy the index of the PHY
+   * \param packet the received packet
+   * \param channelFreqMhz the frequency of the channel
+   * \param txVector the TXVECTOR of the packet
+   * \param aMpdu the A-MPDU information
+   * \param signalNoise the signal and noise power of the packet
+   */
+  void MonitorSnifferRx (uint32_t phy, Ptr<const Packet> packet, uint16_t channelFreqMhz,
+                         WifiTxVector txVector, MpduInfo aMpdu, SignalNoiseDbm signalNoise);
+
+  std::vector<Ptr<YansWifiPhy> > m_phys;      ///< the PHYs
+  std::vector<uint32_t> m_rx;                 ///< number of frames received by each PHY
+  Ptr<CountingPropagationLossModel> m_loss;   ///< the loss model
+};
+
+YansWifiChannelNumberTestCase::YansWifiChannelNumberTestCase ()
+  : TestCase ("Test the per-channel receiver lists of YansWifiChannel")
+{
+}
+
+void
+YansWifiChannelNumberTestCase::Send (void)
+{
+  WifiTxVector txVector = WifiTxVector (WifiPhy::GetOfdmRate6Mbps (), 0, WIFI_PREAMBLE_LONG, false, 1, 1, 0, 20, false, false);
+  m_phys[0]->SendPacket (Create<Packet> (1000), txVector);
+}
+
+void
+YansWifiChannelNumberTestCase::Check (uint32_t count, uint32_t rx1, uint32_t rx2)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_loss->m_count, count, "Wrong number of loss computations at " << Simulator::Now ());
+  NS_TEST_EXPECT_MSG_EQ (m_rx[1], rx1, "Wrong number of frames received by PHY 1 at " << Simulator::Now ());
+  NS_TEST_EXPECT_MSG_EQ (m_rx[2], rx2, "Wrong number of frames received by PHY 2 at " << Simulator::Now ());
+}
+
+void
+YansWifiChannelNumberTestCase::MonitorSnifferRx (uint32_t phy, Ptr<const Packet> packet, uint16_t channelFreqMhz,
+                                                 WifiTxVector txVector, MpduInfo aMpdu, SignalNoiseDbm signalNoise)
+{
+  m_rx[phy]++;
+}
+
+void
+YansWifiChannelNumberTestCase::DoRun (void)
+{
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  m_loss = CreateObject<CountingPropagationLossModel> ();
+  m_loss->SetNext (CreateObject<LogDistancePropagationLossModel> ());
+  channel->SetPropagationLossModel (m_loss);
+
+  Ptr<ErrorRateModel> error = CreateObject<YansErrorRateModel> ();
+  uint8_t channelNumbers[] = {36, 36, 40};
+  m_rx.assign (3, 0);
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      Ptr<ConstantPositionMobilityModel> position = CreateObject<ConstantPositionMobilityModel> ();
+      position->SetPosition (Vector (10.0 * i, 0.0, 0.0));
+      Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+      phy->SetErrorRateModel (error);
+      phy->SetChannel (channel);
+      phy->SetMobility (position);
+      phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+      phy->SetChannelNumber (channelNumbers[i]);
+      phy->TraceConnectWithoutContext ("MonitorSnifferRx", MakeCallback (&YansWifiChannelNumberTestCase::MonitorSnifferRx, this).Bind (i));
+      m_phys.push_back (phy);
+    }
+
+  Simulator::Schedule (Seconds (1.0), &YansWifiChannelNumberTestCase::Send, this);
+  Simulator::Schedule (Seconds (1.5), &YansWifiChannelNumberTestCase::Check, this, 1, 1, 0);
+  Simulator::Schedule (Seconds (1.5), &YansWifiPhy::SetChannelNumber, m_phys[2], 36);
+  Simulator::Schedule (Seconds (2.0), &YansWifiChannelNumberTestCase::Send, this);
+  Simulator::Schedule (Seconds (2.5), &YansWifiChannelNumberTestCase::Check, this, 3, 2, 1);
+  Simulator::Schedule (Seconds (2.5), &YansWifiPhy::SetChannelNumber, m_phys[1], 40);
+  Simulator::Schedule (Seconds (3.0), &YansWifiChannelNumberTestCase::Send, this);
+  Simulator::Schedule (Seconds (3.5), &YansWifiChannelNumberTestCase::Check, this, 4, 2, 2);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_phys.clear ();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that the WifiMacQueue finds the items of a TID and receiver in
+ * queue order, whether they were enqueued at the end or at the front, and
+ * drops the items whose lifetime elapsed.
+ */
+class WifiMacQueueIndexTestCase : public TestCase
+{
+public:
+  WifiMacQueueIndexTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \param tid the TID
+   * \param dest the receiver
+   * \param size the size of the packet, identifying the item
+   * \return a QoS data item
+   */
+  Ptr<WifiMacQueueItem> CreateItem (uint8_t tid, Mac48Address dest, uint32_t size);
+  /**
+   * Enqueue a new QoS data item
+   * \param tid the TID
+   * \param dest the receiver
+   * \param size the size of the packet, identifying the item
+   */
+  void Enqueue (uint8_t tid, Mac48Address dest, uint32_t size);
+  /**
+   * Check the items of the queue once the first ones expired
+   */
+  void CheckExpiry (void);
+
+  Ptr<WifiMacQueue> m_queue; ///< the queue
+  Mac48Address m_dest[3];    ///< the receivers
+};
+
+WifiMacQueueIndexTestCase::WifiMacQueueIndexTestCase ()
+  : TestCase ("Test the TID and receiver index of WifiMacQueue")
+{
+}
+
+Ptr<WifiMacQueueItem>
+WifiMacQueueIndexTestCase::CreateItem (uint8_t tid, Mac48Address dest, uint32_t size)
+{
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetQosTid (tid);
+  hdr.SetAddr1 (dest);
+  return Create<WifiMacQueueItem> (Create<Packet> (size), hdr);
+}
+
+void
+WifiMacQueueIndexTestCase::Enqueue (uint8_t tid, Mac48Address dest, uint32_t size)
+{
+  m_queue->Enqueue (CreateItem (tid, dest, size));
+}
+
+void
+WifiMacQueueIndexTestCase::CheckExpiry (void)
+{
+  // the items of the first second are dropped
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (1, m_dest[0]), 1, "Expired items still queued");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (2, m_dest[1]), 0, "Expired items still queued");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPackets (), 1, "Expired items still queued");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->PeekByTidAndAddress (1, m_dest[0])->GetPacket ()->GetSize (), 500, "Wrong item");
+  // the item removed before also counts as dropped
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetTotalDroppedPackets (), 5, "Wrong number of expired items");
+}
+
+void
+WifiMacQueueIndexTestCase::DoRun (void)
+{
+  m_queue = CreateObject<WifiMacQueue> ();
+  m_queue->SetMaxDelay (Seconds (1.5));
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      m_dest[i] = Mac48Address::Allocate ();
+    }
+  // 60 items for 3 receivers and 2 TIDs, interleaved
+  for (uint32_t i = 0; i < 60; i++)
+    {
+      m_queue->Enqueue (CreateItem (1 + i % 2, m_dest[i % 3], 100 + i));
+    }
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (1, m_dest[0]), 10, "Wrong number of items");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (2, m_dest[0]), 10, "Wrong number of items");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (3, m_dest[0]), 0, "Wrong number of items");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByAddress (m_dest[1]), 20, "Wrong number of items");
+  // the items of TID 1 and receiver 0 are 0, 6, 12, ...
+  NS_TEST_EXPECT_MSG_EQ (m_queue->PeekByTidAndAddress (1, m_dest[0])->GetPacket ()->GetSize (), 100, "Wrong item");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->DequeueByTidAndAddress (1, m_dest[0])->GetPacket ()->GetSize (), 100, "Wrong item");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->DequeueByTidAndAddress (1, m_dest[0])->GetPacket ()->GetSize (), 106, "Wrong item");
+  // dequeuing the head of the queue updates the index of its TID and receiver
+  NS_TEST_EXPECT_MSG_EQ (m_queue->Dequeue ()->GetPacket ()->GetSize (), 101, "Wrong item");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->PeekByTidAndAddress (2, m_dest[1])->GetPacket ()->GetSize (), 107, "Wrong item");
+  // an item pushed at the front comes first
+  m_queue->PushFront (CreateItem (1, m_dest[0], 99));
+  NS_TEST_EXPECT_MSG_EQ (m_queue->PeekByTidAndAddress (1, m_dest[0])->GetPacket ()->GetSize (), 99, "Wrong item");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->Peek ()->GetPacket ()->GetSize (), 99, "Wrong item");
+  // removing an item in the middle of the queue updates the index
+  Ptr<const Packet> packet = m_queue->PeekByTidAndAddress (2, m_dest[1])->GetPacket ();
+  NS_TEST_EXPECT_MSG_EQ (m_queue->Remove (packet), true, "Item not found");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->PeekByTidAndAddress (2, m_dest[1])->GetPacket ()->GetSize (), 113, "Wrong item");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (2, m_dest[1]), 8, "Wrong number of items");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (1, m_dest[0]), 9, "Wrong number of items");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPackets (), 57, "Wrong number of items");
+  // drain the queue by TID and receiver
+  uint32_t n = 0;
+  for (uint8_t tid = 1; tid <= 2; tid++)
+    {
+      for (uint32_t i = 0; i < 3; i++)
+        {
+          uint32_t previous = 0;
+          while (Ptr<WifiMacQueueItem> item = m_queue->DequeueByTidAndAddress (tid, m_dest[i]))
+            {
+              NS_TEST_EXPECT_MSG_GT (item->GetPacket ()->GetSize (), previous, "Items out of order");
+              NS_TEST_EXPECT_MSG_EQ (item->GetHeader ().GetQosTid (), tid, "Wrong TID");
+              NS_TEST_EXPECT_MSG_EQ (item->GetDestinationAddress (), m_dest[i], "Wrong receiver");
+              previous = item->GetPacket ()->GetSize ();
+              n++;
+            }
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (n, 57, "Wrong number of items dequeued");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->IsEmpty (), true, "Queue not empty");
+
+  // 2 items of each of 2 agreements at 0 s, and 1 item at 1 s
+  m_queue->Enqueue (CreateItem (1, m_dest[0], 100));
+  m_queue->Enqueue (CreateItem (2, m_dest[1], 101));
+  m_queue->Enqueue (CreateItem (1, m_dest[0], 102));
+  m_queue->Enqueue (CreateItem (2, m_dest[1], 103));
+  Simulator::Schedule (Seconds (1), &WifiMacQueueIndexTestCase::Enqueue, this, 1, m_dest[0], 500);
+  Simulator::Schedule (Seconds (2), &WifiMacQueueIndexTestCase::CheckExpiry, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_queue = 0;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that the hash tables indexing the remote stations keep short
+ * probe sequences when each station has several TIDs.
+ */
+class WifiRemoteStationHashTestCase : public TestCase
+{
+public:
+  WifiRemoteStationHashTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Check the lengths of the probe sequences of the entries of a table
+   * \param lengths the lengths of the probe sequences
+   * \param name the name of the table
+   */
+  void CheckProbes (const std::vector<uint32_t> &lengths, std::string name);
+};
+
+WifiRemoteStationHashTestCase::WifiRemoteStationHashTestCase ()
+  : TestCase ("Test the probe sequences of the remote station tables")
+{
+}
+
+void
+WifiRemoteStationHashTestCase::CheckProbes (const std::vector<uint32_t> &lengths, std::string name)
+{
+  uint32_t probes = 0;
+  uint32_t maxProbes = 0;
+  for (std::vector<uint32_t>::const_iterator it = lengths.begin (); it != lengths.end (); ++it)
+    {
+      probes += *it;
+      maxProbes = std::max (maxProbes, *it);
+    }
+  // linear probing in a table at most half full takes 1.5 probes on average
+  NS_TEST_EXPECT_MSG_LT (static_cast<double> (probes) / lengths.size (), 2, "Long probe sequences in the " << name << " table");
+  NS_TEST_EXPECT_MSG_LT (maxProbes, 16, "Long probe sequence in the " << name << " table");
+}
+
+void
+WifiRemoteStationHashTestCase::DoRun (void)
+{
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  Ptr<ConstantRateWifiManager> manager = CreateObject<ConstantRateWifiManager> ();
+  manager->SetupPhy (phy);
+  // the allocated addresses only differ in their last bytes, while the TID
+  // is in the top bits of the key
+  for (uint32_t i = 0; i < 256; i++)
+    {
+      Mac48Address address = Mac48Address::Allocate ();
+      for (uint8_t tid = 0; tid < 8; tid++)
+        {
+          manager->Lookup (address, tid);
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (manager->m_states.size (), 256, "Wrong number of states");
+  NS_TEST_ASSERT_MSG_EQ (manager->m_stations.size (), 256 * 8, "Wrong number of stations");
+
+  std::vector<uint32_t> lengths;
+  std::size_t size = manager->m_stateIndex.size ();
+  for (std::size_t i = 0; i < size; i++)
+    {
+      if (manager->m_stateIndex[i] != 0)
+        {
+          std::size_t slot = WifiRemoteStationManager::HashStation (manager->m_stateIndex[i]->m_address, 0, size);
+          lengths.push_back (((i - slot) & (size - 1)) + 1);
+        }
+    }
+  CheckProbes (lengths, "state");
+
+  lengths.clear ();
+  size = manager->m_stationIndex.size ();
+  for (std::size_t i = 0; i < size; i++)
+    {
+      if (manager->m_stationIndex[i] != 0)
+        {
+          std::size_t slot = WifiRemoteStationManager::HashStation (manager->m_stationIndex[i]->m_state->m_address,
+                                                                    manager->m_stationIndex[i]->m_tid, size);
+          lengths.push_back (((i - slot) & (size - 1)) + 1);
+        }
+    }
+  CheckProbes (lengths, "station");
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -1715,6 +2474,13 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new Bug2483TestCase, TestCase::QUICK); //Bug 2483
   AddTestCase (new Bug2831TestCase, TestCase::QUICK); //Bug 2831
   AddTestCase (new StaWifiMacScanningTestCase, TestCase::QUICK); //Bug 2399
+  AddTestCase (new YansWifiChannelRangeTestCase, TestCase::QUICK);
+  AddTestCase (new WifiSharedRxPacketTestCase, TestCase::QUICK);
+  AddTestCase (new WifiRemoteStationLookupTestCase, TestCase::QUICK);
+  AddTestCase (new WifiRemoteStationHashTestCase, TestCase::QUICK);
+  AddTestCase (new YansWifiChannelLinkCacheTestCase, TestCase::QUICK);
+  AddTestCase (new WifiMacQueueIndexTestCase, TestCase::QUICK);
+  AddTestCase (new YansWifiChannelNumberTestCase, TestCase::QUICK);
 }
 
 static WifiTestSuite g_wifiTestSuite; ///< the test suite
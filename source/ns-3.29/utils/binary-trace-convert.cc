@@ -0,0 +1,203 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program converts the binary event logs written by
+// ns3::BinaryTraceFile / ns3::BinaryTraceHelper into other formats:
+//
+//  - ascii:    one line per event, in the style of the ascii traces
+//              ("+", "-", "d" and "r" events), without packet contents
+//  - csv:      one line per event with a header line
+//  - columnar: one raw file per field, in host byte order, named
+//              <output>.<field>.<type>, plus a <output>.schema text file
+//              listing the columns and the number of rows
+//
+// Inputs ending in ".gz", ".zst" or ".lz4" are decompressed with the codec
+// of that extension, when ns-3 was configured with its library.
+//
+// Sample usage:
+//   ./waf --run 'binary-trace-convert --input=trace.btr --format=csv --output=trace.csv'
+
+#include "ns3/command-line.h"
+#include "ns3/binary-trace-file.h"
+#include "ns3/compressed-output-stream.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace ns3;
+
+/**
+ * \param type a BinaryTraceRecord::Type
+ * \returns the ascii trace character of the event
+ */
+static char
+EventChar (uint8_t type)
+{
+  switch (type)
+    {
+    case BinaryTraceRecord::ENQUEUE:
+      return '+';
+    case BinaryTraceRecord::DEQUEUE:
+      return '-';
+    case BinaryTraceRecord::DROP:
+      return 'd';
+    case BinaryTraceRecord::RECEIVE:
+      return 'r';
+    default:
+      return '?';
+    }
+}
+
+/**
+ * \param reader the input
+ * \param out the output
+ * \returns the number of records converted
+ */
+static uint64_t
+ConvertAscii (BinaryTraceReader &reader, std::FILE *out)
+{
+  BinaryTraceRecord r;
+  uint64_t n = 0;
+  while (reader.Read (r))
+    {
+      std::fprintf (out, "%c %lld.%09lld /NodeList/%u/DeviceList/%u uid=%llu size=%u\n",
+                    EventChar (r.type),
+                    (long long)(r.time / 1000000000), (long long)(r.time % 1000000000),
+                    r.node, r.device, (unsigned long long)r.uid, r.size);
+      ++n;
+    }
+  return n;
+}
+
+/**
+ * \param reader the input
+ * \param out the output
+ * \returns the number of records converted
+ */
+static uint64_t
+ConvertCsv (BinaryTraceReader &reader, std::FILE *out)
+{
+  BinaryTraceRecord r;
+  uint64_t n = 0;
+  std::fprintf (out, "time_ns,event,node,device,uid,size\n");
+  while (reader.Read (r))
+    {
+      std::fprintf (out, "%lld,%c,%u,%u,%llu,%u\n",
+                    (long long)r.time, EventChar (r.type),
+                    r.node, r.device, (unsigned long long)r.uid, r.size);
+      ++n;
+    }
+  return n;
+}
+
+/**
+ * \param reader the input
+ * \param output the prefix of the output files
+ * \returns the number of records converted
+ */
+static uint64_t
+ConvertColumnar (BinaryTraceReader &reader, std::string const &output)
+{
+  std::ofstream time ((output + ".time.i64").c_str (), std::ios::binary);
+  std::ofstream event ((output + ".event.u8").c_str (), std::ios::binary);
+  std::ofstream node ((output + ".node.u32").c_str (), std::ios::binary);
+  std::ofstream device ((output + ".device.u32").c_str (), std::ios::binary);
+  std::ofstream uid ((output + ".uid.u64").c_str (), std::ios::binary);
+  std::ofstream size ((output + ".size.u32").c_str (), std::ios::binary);
+  BinaryTraceRecord r;
+  uint64_t n = 0;
+  while (reader.Read (r))
+    {
+      time.write ((const char *)&r.time, sizeof (r.time));
+      event.write ((const char *)&r.type, sizeof (r.type));
+      node.write ((const char *)&r.node, sizeof (r.node));
+      device.write ((const char *)&r.device, sizeof (r.device));
+      uid.write ((const char *)&r.uid, sizeof (r.uid));
+      size.write ((const char *)&r.size, sizeof (r.size));
+      ++n;
+    }
+  std::ofstream schema ((output + ".schema").c_str ());
+  schema << "rows " << n << std::endl
+         << "time int64 ns" << std::endl
+         << "event uint8 0=enqueue,1=dequeue,2=drop,3=receive" << std::endl
+         << "node uint32" << std::endl
+         << "device uint32" << std::endl
+         << "uid uint64" << std::endl
+         << "size uint32 bytes" << std::endl;
+  return n;
+}
+
+int main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+  std::string format = "ascii";
+
+  CommandLine cmd;
+  cmd.Usage ("Convert a binary event trace to ascii, csv or columnar files.");
+  cmd.AddValue ("input", "binary trace file to read", input);
+  cmd.AddValue ("output", "file (or file prefix for columnar) to write; stdout if empty", output);
+  cmd.AddValue ("format", "output format: ascii, csv or columnar", format);
+  cmd.Parse (argc, argv);
+
+  if (CompressionCodec::IsCompressedFilename (input)
+      && DecompressionCodec::CreateForFile (input) == 0)
+    {
+      std::cerr << "No compression support compiled in for \"" << input << "\"" << std::endl;
+      return 1;
+    }
+  BinaryTraceReader reader;
+  if (input.empty () || !reader.Open (input))
+    {
+      std::cerr << "Unable to read binary trace \"" << input << "\"" << std::endl;
+      return 1;
+    }
+
+  uint64_t n;
+  if (format == "columnar")
+    {
+      if (output.empty ())
+        {
+          std::cerr << "The columnar format needs --output" << std::endl;
+          return 1;
+        }
+      n = ConvertColumnar (reader, output);
+    }
+  else if (format == "ascii" || format == "csv")
+    {
+      std::FILE *out = output.empty () ? stdout : std::fopen (output.c_str (), "w");
+      if (out == 0)
+        {
+          std::cerr << "Unable to open \"" << output << "\"" << std::endl;
+          return 1;
+        }
+      n = format == "ascii" ? ConvertAscii (reader, out) : ConvertCsv (reader, out);
+      if (out != stdout)
+        {
+          std::fclose (out);
+        }
+    }
+  else
+    {
+      std::cerr << "Unknown format \"" << format << "\"" << std::endl;
+      return 1;
+    }
+
+  std::cerr << n << " records converted" << std::endl;
+  return 0;
+}
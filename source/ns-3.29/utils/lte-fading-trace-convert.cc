@@ -0,0 +1,58 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program converts a text fading trace of ns3::TraceFadingLossModel
+// to the binary format, which the model maps in memory instead of
+// parsing it.  The binary trace is used by setting the TraceFilename
+// attribute to its name.  It is in the byte order of the host, so it
+// should be generated on the machines which use it.
+//
+// Sample usage:
+//   ./waf --run 'lte-fading-trace-convert --input=src/lte/model/fading-traces/fading_trace_EPA_3kmph.fad
+//                --output=fading_trace_EPA_3kmph.bin --rbNum=100 --samplesNum=10000'
+
+#include "ns3/command-line.h"
+#include "ns3/trace-fading-loss-model.h"
+#include <iostream>
+#include <string>
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+  uint32_t rbNum = 100;
+  uint32_t samplesNum = 10000;
+
+  CommandLine cmd;
+  cmd.Usage ("Convert a text fading trace to the binary format of TraceFadingLossModel.");
+  cmd.AddValue ("input", "text fading trace to read", input);
+  cmd.AddValue ("output", "binary fading trace to write", output);
+  cmd.AddValue ("rbNum", "number of RBs of the trace", rbNum);
+  cmd.AddValue ("samplesNum", "number of samples per RB of the trace", samplesNum);
+  cmd.Parse (argc, argv);
+
+  if (input.empty () || output.empty ())
+    {
+      std::cerr << "Both --input and --output are needed" << std::endl;
+      return 1;
+    }
+  // aborts if the input cannot be read or has too few samples
+  TraceFadingLossModel::ConvertTrace (input, output, rbNum, samplesNum);
+  std::cerr << rbNum << " RBs of " << samplesNum << " samples converted" << std::endl;
+  return 0;
+}